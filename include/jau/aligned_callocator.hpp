@@ -0,0 +1,237 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ALIGNED_CALLOCATOR_HPP
+#define ALIGNED_CALLOCATOR_HPP
+
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <jau/basic_types.hpp>
+#include <jau/callocator.hpp>
+
+namespace jau {
+
+/**
+ * Over-aligned and huge-page backed jau::callocator specialization,
+ * intended for large jau::darray stores.
+ * <p>
+ * Storage below <code>HugePageThreshold</code> bytes is allocated via <code>::posix_memalign()</code>
+ * using the given <code>Alignment</code>, e.g. 64 bytes for a cache line or SIMD aligned loads.
+ * </p>
+ * <p>
+ * Storage of at least <code>HugePageThreshold</code> bytes is mapped via anonymous <code>::mmap()</code>,
+ * hence page aligned, and advised via <code>::madvise(MADV_HUGEPAGE)</code> to be backed by transparent huge pages,
+ * reducing TLB misses on large arrays.<br>
+ * A <code>HugePageThreshold</code> of zero disables the mmap path.
+ * </p>
+ * <p>
+ * reallocate() uses <code>::mremap()</code> for mapped storage on Linux, avoiding to copy the elements.
+ * Storage below the threshold is copied to a new aligned storage,
+ * as <code>::realloc()</code> does not preserve over-alignment.
+ * </p>
+ * <p>
+ * Being derived from jau::callocator, jau::darray uses reallocate() on growth
+ * for trivially relocatable value_type, see jau::darray's <code>use_realloc</code>.
+ * </p>
+ * <p>
+ * This class shall be compliant with <i>C++ named requirements for Allocator</i>.
+ * </p>
+ * <p>
+ * Not implementing deprecated (C++17) and removed (C++20)
+ * methods: address(), max_size(), construct() and destroy().
+ * </p>
+ * @tparam T the value type
+ * @tparam Alignment the storage alignment in bytes, a power of two between <code>alignof(T)</code> and 4096 (page size)
+ * @tparam HugePageThreshold minimum storage size in bytes for mmap with huge pages, defaults to 2 MiB. Zero disables mmap.
+ */
+template <class T, std::size_t Alignment = 64, std::size_t HugePageThreshold = 2*1024*1024>
+struct aligned_callocator : public jau::callocator<T>
+{
+  public:
+    static_assert( 0 == ( Alignment & ( Alignment - 1 ) ), "Alignment must be a power of two" );
+    static_assert( alignof(T) <= Alignment && Alignment <= 4096, "Alignment must be within [alignof(T), 4096]" );
+
+    template <class U> struct rebind {typedef aligned_callocator<U, Alignment, HugePageThreshold> other;};
+
+    // typedefs' for C++ named requirements: Allocator
+    typedef T  value_type;
+
+    constexpr static const std::size_t alignment = Alignment;
+    constexpr static const std::size_t hugepage_threshold = HugePageThreshold;
+
+  private:
+    static std::size_t page_size() noexcept {
+        static const std::size_t ps = static_cast<std::size_t>( ::sysconf(_SC_PAGESIZE) );
+        return ps;
+    }
+
+    constexpr static std::size_t round_up(const std::size_t bytes, const std::size_t align) noexcept {
+        return ( bytes + align - 1 ) & ~( align - 1 );
+    }
+
+    constexpr static bool is_mapped(const std::size_t n) noexcept {
+        return 0 < HugePageThreshold && n * sizeof(value_type) >= HugePageThreshold;
+    }
+
+    static std::size_t mapped_size(const std::size_t n) noexcept {
+        return round_up( n * sizeof(value_type), page_size() );
+    }
+
+    static void advise_hugepage(void * p, const std::size_t len) noexcept {
+#ifdef MADV_HUGEPAGE
+        ::madvise(p, len, MADV_HUGEPAGE); // advisory only, failure is not fatal
+#else
+        (void)p;
+        (void)len;
+#endif
+    }
+
+    static value_type* allocate_impl(const std::size_t n) noexcept {
+        if( is_mapped(n) ) {
+            const std::size_t len = mapped_size(n);
+            void * m = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if( MAP_FAILED == m ) {
+                return nullptr;
+            }
+            advise_hugepage(m, len);
+            return reinterpret_cast<value_type*>(m);
+        } else {
+            void * m = nullptr;
+            if( 0 != ::posix_memalign(&m, std::max<std::size_t>(Alignment, sizeof(void*)), round_up(n * sizeof(value_type), Alignment)) ) {
+                return nullptr;
+            }
+            return reinterpret_cast<value_type*>(m);
+        }
+    }
+
+    static void deallocate_impl(value_type* p, const std::size_t n) noexcept {
+        if( nullptr == p ) {
+            return;
+        }
+        if( is_mapped(n) ) {
+            ::munmap(reinterpret_cast<void*>(p), mapped_size(n));
+        } else {
+            ::free( reinterpret_cast<void*>(p) );
+        }
+    }
+
+  public:
+    aligned_callocator() noexcept
+    : jau::callocator<value_type>()
+    { } // C++11
+
+    aligned_callocator(const aligned_callocator& other) noexcept
+    : jau::callocator<value_type>(other)
+    { }
+
+    template <typename U>
+    aligned_callocator(const aligned_callocator<U, Alignment, HugePageThreshold>& other) noexcept
+    : jau::callocator<value_type>(other)
+    { }
+
+    aligned_callocator& operator=(const aligned_callocator& other) noexcept {
+        jau::callocator<value_type>::operator=(other);
+        return *this;
+    }
+
+    ~aligned_callocator() {}
+
+#if __cplusplus <= 201703L
+    value_type* allocate(std::size_t n, const void * hint) { // C++17 deprecated; C++20 removed
+        (void)hint;
+        return allocate_impl(n);
+    }
+#endif
+
+    /**
+     * Returns <code>Alignment</code> aligned storage for <code>n</code> elements,
+     * mapped with huge pages if exceeding <code>HugePageThreshold</code> bytes.
+     * @return nullptr on failure, otherwise the storage
+     */
+    [[nodiscard]] value_type* allocate(std::size_t n) {
+        return allocate_impl(n);
+    }
+
+    /**
+     * Reallocates the given storage of <code>old_size</code> elements to <code>new_size</code> elements,
+     * preserving the content up to the lesser size and the alignment.
+     * <p>
+     * Mapped storage is remapped via <code>::mremap()</code> on Linux, otherwise a new storage is allocated and the content copied.
+     * </p>
+     * @return nullptr on failure, leaving the given storage untouched, otherwise the new storage
+     */
+    [[nodiscard]] value_type* reallocate(value_type* p, std::size_t old_size, std::size_t new_size) {
+        if( nullptr == p ) {
+            return allocate_impl(new_size);
+        }
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+        if( is_mapped(old_size) && is_mapped(new_size) ) {
+            const std::size_t old_len = mapped_size(old_size);
+            const std::size_t new_len = mapped_size(new_size);
+            if( old_len == new_len ) {
+                return p;
+            }
+            void * m = ::mremap(reinterpret_cast<void*>(p), old_len, new_len, MREMAP_MAYMOVE);
+            if( MAP_FAILED == m ) {
+                return nullptr;
+            }
+            advise_hugepage(m, new_len);
+            return reinterpret_cast<value_type*>(m);
+        }
+#endif
+        value_type * m = allocate_impl(new_size);
+        if( nullptr == m ) {
+            return nullptr;
+        }
+        memcpy(reinterpret_cast<void*>(m), reinterpret_cast<const void*>(p), std::min(old_size, new_size) * sizeof(value_type));
+        deallocate_impl(p, old_size);
+        return m;
+    }
+
+    void deallocate(value_type* p, std::size_t n ) {
+        deallocate_impl(p, n);
+    }
+};
+
+template <class T1, std::size_t A1, std::size_t H1, class T2, std::size_t A2, std::size_t H2>
+    bool operator==(const aligned_callocator<T1, A1, H1>& lhs, const aligned_callocator<T2, A2, H2>& rhs) noexcept {
+        (void)lhs;
+        (void)rhs;
+        return A1 == A2 && H1 == H2;
+    }
+template <class T1, std::size_t A1, std::size_t H1, class T2, std::size_t A2, std::size_t H2>
+    bool operator!=(const aligned_callocator<T1, A1, H1>& lhs, const aligned_callocator<T2, A2, H2>& rhs) noexcept {
+        return !(lhs==rhs);
+    }
+
+} /* namespace jau */
+
+#endif // ALIGNED_CALLOCATOR_HPP
@@ -0,0 +1,424 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_BYTE_RINGBUFFER_HPP_
+#define JAU_BYTE_RINGBUFFER_HPP_
+
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+
+#include <cstring>
+#include <string>
+#include <cstdint>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <jau/basic_types.hpp>
+#include <jau/int_math.hpp>
+#include <jau/ringbuffer_wait.hpp>
+#include <jau/ringbuffer_span.hpp>
+#include <jau/ringbuffer_counter.hpp>
+
+namespace jau {
+
+/**
+ * Byte stream ring buffer, mapping the same memory file twice back-to-back into the address space,
+ * exposing <i>lock-free</i> {@link #getN() get*(..)} and {@link #putN() put*(..)} methods like jau::ringbuffer.
+ * <p>
+ * Due to the mirrored mapping, every readable or writable region of the ring buffer is contiguous in memory.
+ * Hence {@link #peekRead()} and {@link #reserveWrite()} always return a single segment,
+ * which may be passed to <code>read(2)</code>, <code>write(2)</code> or a parser directly, see {@link #readFrom()} and {@link #writeTo()}.
+ * </p>
+ * <p>
+ * The capacity is rounded up to a power of two of at least the page size.
+ * Free running 64-bit read and write counters are used, i.e. no byte must be kept open to distinguish full from empty.
+ * </p>
+ * <p>
+ * Thread safety, the <code>multi_pc</code> and <code>Wait_policy</code> template parameter as well as the blocking semantics
+ * are identical to jau::ringbuffer.
+ * </p>
+ * <p>
+ * Implementation uses Linux <code>memfd_create(2)</code> and <code>mmap(2)</code>.
+ * </p>
+ * @see jau::ringbuffer
+ */
+template <bool multi_pc=true, typename Wait_policy=ringbuffer_wait_cv>
+class byte_ringbuffer {
+    public:
+        /** True if multiple getter and putter threads are supported, otherwise Single Producer Single Consumer (SPSC) mode. */
+        constexpr static const bool uses_multi_pc = multi_pc;
+
+        /** The wait strategy used by the blocking operations, see ringbuffer_wait. */
+        typedef Wait_policy wait_policy_type;
+
+        /** Contiguous view of ring buffer storage, i.e. the second segment is always empty. */
+        typedef ringbuffer_span<uint8_t, std::size_t> span_type;
+
+        /** RAII guard of a read span, returned by peekRead(). */
+        typedef ringbuffer_span_guard<byte_ringbuffer, uint8_t, std::size_t, false> read_span_type;
+
+        /** RAII guard of a write span, returned by reserveWrite(). */
+        typedef ringbuffer_span_guard<byte_ringbuffer, uint8_t, std::size_t, true> write_span_type;
+
+    private:
+        template<typename, typename, typename, bool> friend class ringbuffer_span_guard;
+
+        /** Assumed cache line size, separating getter and putter owned state. */
+        constexpr static const std::size_t cache_line_size = 64;
+
+        typedef ringbuffer_counter<std::size_t, Wait_policy, ringbuffer_pow2_index<std::size_t>> counter_type;
+
+        uint8_t * const array;           // capacity bytes mirrored at array + capacity
+        counter_type counter;            // Read and write counter, cached copies and wait objects on separate cache lines
+
+        alignas(cache_line_size) std::mutex syncMultiRead;  // Memory-Model (MM) guaranteed sequential consistency (SC) between acquire and release
+        alignas(cache_line_size) std::mutex syncMultiWrite; // ditto
+
+        static std::size_t capacityImpl(const std::size_t capacity) noexcept {
+            const std::size_t page_size = static_cast<std::size_t>( ::sysconf(_SC_PAGESIZE) );
+            return round_to_power_of_2<std::size_t>( std::max(capacity, page_size) );
+        }
+
+        /** Maps a memfd of given capacity twice back-to-back, throws RuntimeException on failure. */
+        static uint8_t * mapMirrored(const std::size_t capacity) {
+            const int fd = ::memfd_create("jau_byte_ringbuffer", MFD_CLOEXEC);
+            if( 0 > fd ) {
+                throw RuntimeException("memfd_create failed: errno "+std::to_string(errno)+" "+strerror(errno), E_FILE_LINE);
+            }
+            if( 0 != ::ftruncate(fd, static_cast<off_t>(capacity)) ) {
+                const int err = errno;
+                ::close(fd);
+                throw OutOfMemoryError("ftruncate "+std::to_string(capacity)+" failed: errno "+std::to_string(err)+" "+strerror(err), E_FILE_LINE);
+            }
+            // reserve the address range for both mappings first
+            void * base = ::mmap(nullptr, 2 * capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if( MAP_FAILED == base ) {
+                const int err = errno;
+                ::close(fd);
+                throw OutOfMemoryError("mmap reserve "+std::to_string(2 * capacity)+" failed: errno "+std::to_string(err)+" "+strerror(err), E_FILE_LINE);
+            }
+            uint8_t * const a = static_cast<uint8_t*>(base);
+            if( MAP_FAILED == ::mmap(a, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) ||
+                MAP_FAILED == ::mmap(a + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) )
+            {
+                const int err = errno;
+                ::munmap(base, 2 * capacity);
+                ::close(fd);
+                throw OutOfMemoryError("mmap mirror "+std::to_string(capacity)+" failed: errno "+std::to_string(err)+" "+strerror(err), E_FILE_LINE);
+            }
+            ::close(fd); // mappings keep the memory file alive
+            return a;
+        }
+
+        void lockRead() noexcept {
+            if constexpr ( multi_pc ) {
+                syncMultiRead.lock(); // acquire syncMultiRead
+            }
+        }
+        void unlockRead() noexcept {
+            if constexpr ( multi_pc ) {
+                syncMultiRead.unlock(); // release syncMultiRead
+            }
+        }
+        void lockWrite() noexcept {
+            if constexpr ( multi_pc ) {
+                syncMultiWrite.lock(); // acquire syncMultiWrite
+            }
+        }
+        void unlockWrite() noexcept {
+            if constexpr ( multi_pc ) {
+                syncMultiWrite.unlock(); // release syncMultiWrite
+            }
+        }
+
+        /** Caller holds syncMultiRead in multi_pc mode. */
+        span_type peekReadImpl(std::size_t min_count, const std::size_t max_count, const bool blocking, const int timeoutMS) noexcept {
+            min_count = std::min(min_count, std::min(max_count, counter.capacity()));
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            std::size_t available = counter.available(localReadCount, max_count); // SC-DRF acquire atomic writeCount if less than max_count appear available
+            if( available < min_count ) {
+                if( !blocking || !counter.waitForElements(localReadCount, min_count, timeoutMS) ) {
+                    return span_type();
+                }
+                available = counter.cachedAvailable(localReadCount);
+            }
+            const std::size_t count = std::min(available, max_count);
+            if( 0 == count ) {
+                return span_type();
+            }
+            return span_type{ array + counter.index(localReadCount), count, nullptr, 0 }; // contiguous due to mirror
+        }
+
+        /** Caller holds syncMultiWrite in multi_pc mode. */
+        span_type reserveWriteImpl(std::size_t min_count, const std::size_t max_count, const bool blocking, const int timeoutMS) noexcept {
+            min_count = std::min(min_count, std::min(max_count, counter.capacity()));
+            const uint64_t localWriteCount = counter.loadWriteCount(); // owned by putter
+            std::size_t freeSlots = counter.freeSlots(localWriteCount, max_count); // SC-DRF acquire atomic readCount if less than max_count appear free
+            if( freeSlots < min_count ) {
+                if( !blocking || !counter.waitForFreeSlots(localWriteCount, min_count, timeoutMS) ) {
+                    return span_type();
+                }
+                freeSlots = counter.cachedFreeSlots(localWriteCount);
+            }
+            const std::size_t count = std::min(freeSlots, max_count);
+            if( 0 == count ) {
+                return span_type();
+            }
+            return span_type{ array + counter.index(localWriteCount), count, nullptr, 0 }; // contiguous due to mirror
+        }
+
+        /** Caller holds syncMultiRead in multi_pc mode. */
+        void releaseReadImpl(const std::size_t count) noexcept {
+            if( 0 < count ) {
+                counter.advanceRead(counter.loadReadCount(), count); // SC-DRF release atomic readCount
+            }
+        }
+
+        /** Caller holds syncMultiWrite in multi_pc mode. */
+        void commitWriteImpl(const std::size_t count) noexcept {
+            if( 0 < count ) {
+                counter.advanceWrite(counter.loadWriteCount(), count); // SC-DRF release atomic writeCount
+            }
+        }
+
+        /** Dequeues count bytes and releases syncMultiRead in multi_pc mode, called by read_span_type. */
+        void endRead(const std::size_t count) noexcept {
+            releaseReadImpl(count);
+            unlockRead(); // acquired by peekRead()
+        }
+
+        /** Enqueues count bytes and releases syncMultiWrite in multi_pc mode, called by write_span_type. */
+        void endWrite(const std::size_t count) noexcept {
+            commitWriteImpl(count);
+            unlockWrite(); // acquired by reserveWrite()
+        }
+
+        std::size_t getNImpl(uint8_t * dst, const std::size_t min_count, const std::size_t max_count, const bool blocking, const int timeoutMS) noexcept {
+            lockRead();
+            const span_type s = peekReadImpl(min_count, max_count, blocking, timeoutMS);
+            if( 0 < s.size1 ) {
+                ::memcpy(dst, s.data1, s.size1);
+            }
+            releaseReadImpl(s.size1);
+            unlockRead();
+            return s.size1;
+        }
+
+        std::size_t putNImpl(const uint8_t * src, const std::size_t min_count, const std::size_t count, const bool blocking, const int timeoutMS) noexcept {
+            lockWrite();
+            const span_type s = reserveWriteImpl(min_count, count, blocking, timeoutMS);
+            if( 0 < s.size1 ) {
+                ::memcpy(s.data1, src, s.size1);
+            }
+            commitWriteImpl(s.size1);
+            unlockWrite();
+            return s.size1;
+        }
+
+    public:
+        /** Returns a short string representation incl. size/capacity and internal r/w counter (impl. dependent). */
+        std::string toString() const noexcept {
+            const std::string es = isEmpty() ? ", empty" : "";
+            const std::string fs = isFull() ? ", full" : "";
+            return "byte_ringbuffer[size "+std::to_string(getSize())+" / "+std::to_string(counter.capacity())+
+                    ", writeCount "+std::to_string(counter.state().writeCount.load())+", readCount "+std::to_string(counter.state().readCount.load())+es+fs+"]";
+        }
+
+        /**
+         * Create an empty byte ring buffer instance w/ the given minimum <code>capacity</code>,
+         * rounded up to a power of two of at least the page size.
+         * @param capacity the minimum capacity in bytes
+         * @throws RuntimeException if memfd_create(2) failed
+         * @throws OutOfMemoryError if the mirrored mapping failed
+         */
+        byte_ringbuffer(const std::size_t capacity)
+        : array(mapMirrored(capacityImpl(capacity))), counter(capacityImpl(capacity))
+        { }
+
+        ~byte_ringbuffer() noexcept {
+            ::munmap(array, 2 * counter.capacity());
+        }
+
+        byte_ringbuffer(const byte_ringbuffer &_source) = delete;
+        byte_ringbuffer& operator=(const byte_ringbuffer &_source) = delete;
+
+        /** Returns the capacity in bytes, a power of two of at least the page size. */
+        std::size_t capacity() const noexcept { return counter.capacity(); }
+
+        /** Releasing all bytes, see ringbuffer::clear(). */
+        void clear() noexcept {
+            drop(counter.capacity());
+        }
+
+        /** Returns the number of bytes in this ring buffer. */
+        std::size_t getSize() const noexcept { return counter.getSize(); }
+
+        /** Returns the number of free bytes available to put.  */
+        std::size_t getFreeSlots() const noexcept { return counter.capacity() - counter.getSize(); }
+
+        /** Returns true if this ring buffer is empty, otherwise false. */
+        bool isEmpty() const noexcept { return 0 == counter.getSize(); }
+
+        /** Returns true if this ring buffer is full, otherwise false. */
+        bool isFull() const noexcept { return counter.capacity() <= counter.getSize(); }
+
+        /**
+         * Drops up to {@code count} oldest enqueued bytes.
+         * @return the number of dropped bytes
+         */
+        std::size_t drop(const std::size_t count) noexcept {
+            if constexpr ( multi_pc ) {
+                std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
+                std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock); // otherwise RAII-style relinquish via destructor
+                std::lock(lockMultiRead, lockMultiWrite);
+                const std::size_t n = std::min(count, counter.available(counter.loadReadCount(), count));
+                releaseReadImpl(n);
+                return n;
+            } else {
+                const std::size_t n = std::min(count, counter.available(counter.loadReadCount(), count));
+                releaseReadImpl(n);
+                return n;
+            }
+        }
+
+        /**
+         * Dequeues up to max_count oldest enqueued bytes, copying them into the given dst array.
+         * @see ringbuffer::getN()
+         */
+        std::size_t getN(uint8_t * dst, const std::size_t max_count) noexcept {
+            return getNImpl(dst, 1, max_count, false, 0);
+        }
+
+        /**
+         * Dequeues up to max_count oldest enqueued bytes after blocking until at least min_count bytes are available.
+         * @see ringbuffer::getNBlocking()
+         */
+        std::size_t getNBlocking(uint8_t * dst, const std::size_t min_count, const std::size_t max_count, const int timeoutMS=0) noexcept {
+            return getNImpl(dst, min_count, max_count, true, timeoutMS);
+        }
+
+        /**
+         * Enqueues up to count bytes of the given src array by copying them into this ringbuffer storage.
+         * @see ringbuffer::putN()
+         */
+        std::size_t putN(const uint8_t * src, const std::size_t count) noexcept {
+            return putNImpl(src, 1, count, false, 0);
+        }
+
+        /**
+         * Enqueues up to count bytes of the given src array after blocking until at least min_count free bytes are available.
+         * @see ringbuffer::putNBlocking()
+         */
+        std::size_t putNBlocking(const uint8_t * src, const std::size_t min_count, const std::size_t count, const int timeoutMS=0) noexcept {
+            return putNImpl(src, min_count, count, true, timeoutMS);
+        }
+
+        /**
+         * Returns a contiguous view of up to max_count oldest enqueued bytes w/o dequeuing them.
+         * <p>
+         * The returned guard dequeues all viewed bytes at destruction,
+         * or the first <code>count</code> viewed bytes at its explicit early read_span_type::release().
+         * In <code>multi_pc</code> mode, the multi-read mutex is held until then, even if the returned span is empty.
+         * </p>
+         * @see ringbuffer::peekRead()
+         */
+        read_span_type peekRead(const std::size_t max_count) noexcept {
+            lockRead(); // released by endRead()
+            return read_span_type(*this, peekReadImpl(1, max_count, false, 0));
+        }
+
+        /**
+         * Returns a contiguous view of up to max_count oldest enqueued bytes w/o dequeuing them,
+         * blocking until at least min_count bytes are available, see {@link #peekRead()}.
+         */
+        read_span_type peekReadBlocking(const std::size_t min_count, const std::size_t max_count, const int timeoutMS=0) noexcept {
+            lockRead(); // released by endRead()
+            return read_span_type(*this, peekReadImpl(min_count, max_count, true, timeoutMS));
+        }
+
+        /**
+         * Returns a contiguous view of up to max_count free bytes within the ring buffer storage.
+         * <p>
+         * The returned guard enqueues all reserved bytes at destruction,
+         * or the first <code>count</code> written bytes at its explicit early write_span_type::commit().
+         * In <code>multi_pc</code> mode, the multi-write mutex is held until then, even if the returned span is empty.
+         * </p>
+         * @see ringbuffer::reserveWrite()
+         */
+        write_span_type reserveWrite(const std::size_t max_count) noexcept {
+            lockWrite(); // released by endWrite()
+            return write_span_type(*this, reserveWriteImpl(1, max_count, false, 0));
+        }
+
+        /**
+         * Returns a contiguous view of up to max_count free bytes within the ring buffer storage,
+         * blocking until at least min_count free bytes are available, see {@link #reserveWrite()}.
+         */
+        write_span_type reserveWriteBlocking(const std::size_t min_count, const std::size_t max_count, const int timeoutMS=0) noexcept {
+            lockWrite(); // released by endWrite()
+            return write_span_type(*this, reserveWriteImpl(min_count, max_count, true, timeoutMS));
+        }
+
+        /**
+         * Enqueues up to max_count bytes read from the given file descriptor via a single <code>read(2)</code>
+         * directly into the ring buffer storage.
+         * <p>
+         * Blocks until at least one free byte is available, as well as <code>read(2)</code> may block.
+         * </p>
+         * @return number of enqueued bytes, zero on end of file, or -1 on error w/ errno set by <code>read(2)</code>
+         */
+        ssize_t readFrom(const int fd, const std::size_t max_count) noexcept {
+            write_span_type s = reserveWriteBlocking(1, max_count);
+            const ssize_t n = 0 < s.size1 ? ::read(fd, s.data1, s.size1) : 0;
+            s.commit( 0 < n ? static_cast<std::size_t>(n) : 0 );
+            return n;
+        }
+
+        /**
+         * Dequeues up to max_count bytes written to the given file descriptor via a single <code>write(2)</code>
+         * directly from the ring buffer storage.
+         * <p>
+         * Blocks until at least one byte is available, as well as <code>write(2)</code> may block.
+         * </p>
+         * @return number of dequeued bytes or -1 on error w/ errno set by <code>write(2)</code>
+         */
+        ssize_t writeTo(const int fd, const std::size_t max_count) noexcept {
+            read_span_type s = peekReadBlocking(1, max_count);
+            const ssize_t n = 0 < s.size1 ? ::write(fd, s.data1, s.size1) : 0;
+            s.release( 0 < n ? static_cast<std::size_t>(n) : 0 );
+            return n;
+        }
+};
+
+} /* namespace jau */
+
+/** \example test_lfringbuffer_perf01.cpp
+ * This C++ benchmark compares in place parsing of jau::byte_ringbuffer's contiguous regions
+ * against copying wrapped around data into a jau::darray<uint8_t>.
+ */
+
+#endif /* JAU_BYTE_RINGBUFFER_HPP_ */
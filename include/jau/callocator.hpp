@@ -79,6 +79,9 @@ struct callocator
     { (void)other; }
 #endif
 
+    callocator& operator=(const callocator& other) noexcept
+    { (void)other; return *this; }
+
 #if __cplusplus > 201703L
     constexpr ~callocator() {} // C++20
 #else
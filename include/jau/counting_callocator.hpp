@@ -29,6 +29,7 @@
 #include <memory>
 
 #include <jau/basic_types.hpp>
+#include <jau/ordered_atomic.hpp>
 #include <jau/callocator.hpp>
 
 namespace jau {
@@ -60,6 +61,15 @@ struct counting_callocator : public jau::callocator<T>
     std::size_t realloc_count;
     ssize_t alloc_balance;
 
+    /**
+     * Process wide allocate() count of all instances for this value_type.
+     * <p>
+     * Other than alloc_count, this counter is neither copied nor flushed,
+     * allowing to count allocations of containers replacing their storage, e.g. jau::cow_darray.
+     * </p>
+     */
+    inline static relaxed_atomic_size_t total_alloc_count {0};
+
   private:
     // inline static relaxed_atomic_size_t next_id = 1;
 
@@ -143,6 +153,21 @@ struct counting_callocator : public jau::callocator<T>
       { }
 #endif
 
+    /**
+     * Assignment takes over the statistics as-is,
+     * as used when a container's storage is moved or swapped along with its allocator.
+     */
+    counting_callocator& operator=(const counting_callocator& other) noexcept {
+        jau::callocator<value_type>::operator=(other);
+        old_stats = other.old_stats;
+        memory_usage = other.memory_usage;
+        alloc_count = other.alloc_count;
+        dealloc_count = other.dealloc_count;
+        realloc_count = other.realloc_count;
+        alloc_balance = other.alloc_balance;
+        return *this;
+    }
+
 #if __cplusplus > 201703L
     constexpr ~counting_callocator() {} // C++20
 #else
@@ -155,6 +180,7 @@ struct counting_callocator : public jau::callocator<T>
         memory_usage += n * sizeof(value_type);
         ++alloc_count;
         ++alloc_balance;
+        total_alloc_count++;
         return jau::callocator<value_type>::allocate(n, hint);
     }
 #endif
@@ -165,6 +191,7 @@ struct counting_callocator : public jau::callocator<T>
         memory_usage += n * sizeof(value_type);
         ++alloc_count;
         ++alloc_balance;
+        total_alloc_count++;
         return jau::callocator<value_type>::allocate(n);
     }
 #else
@@ -173,6 +200,7 @@ struct counting_callocator : public jau::callocator<T>
         memory_usage += n * sizeof(value_type);
         ++alloc_count;
         ++alloc_balance;
+        total_alloc_count++;
         return jau::callocator<value_type>::allocate(n);
     }
 #endif
@@ -41,7 +41,9 @@
 #include <jau/basic_types.hpp>
 #include <jau/ordered_atomic.hpp>
 #include <jau/cow_iterator.hpp>
+#include <jau/cow_transaction.hpp>
 #include <jau/callocator.hpp>
+#include <jau/epoch_reclaim.hpp>
 
 namespace jau {
 
@@ -104,10 +106,13 @@ namespace jau {
      * </p>
      * <p>
      * Non-Type Template Parameter <code>use_memmove</code> can be overriden by the user
-     * and has its default value <code>std::is_trivially_copyable_v<Value_type></code>.<br>
-     * The default value has been chosen with care, see C++ Standard section 6.9 Types <i>trivially copyable</i>.<br>
-     * However, one can set <code>use_memmove</code> to true even without the value_type being <i>trivially copyable</i>,
-     * as long certain memory side-effects can be excluded (TBD).
+     * and has its default value <code>jau::is_trivially_relocatable_v<Value_type></code>.<br>
+     * The default value has been chosen with care, see C++ Standard section 6.9 Types <i>trivially copyable</i>,
+     * extended to types which can be relocated bitwise, e.g. <code>std::shared_ptr</code>, see jau::is_trivially_relocatable.<br>
+     * With <code>use_memmove</code>, growing the storage uses <code>realloc</code> or <code>memcpy</code>
+     * and shifting elements on insert or erase uses <code>memmove</code>, both w/o invoking the value_type's constructor or destructor.<br>
+     * One can specialize jau::is_trivially_relocatable for a custom value_type
+     * or set <code>use_memmove</code> to true, as long certain memory side-effects can be excluded.
      * </p>
      * See also:
      * <pre>
@@ -122,7 +127,7 @@ namespace jau {
      * @see jau::cow_rw_iterator::write_back()
      */
     template <typename Value_type, typename Alloc_type = jau::callocator<Value_type>, typename Size_type = jau::nsize_t,
-              bool use_memmove = std::is_trivially_copyable_v<Value_type>,
+              bool use_memmove = jau::is_trivially_relocatable_v<Value_type>,
               bool use_realloc = std::is_base_of_v<jau::callocator<Value_type>, Alloc_type>,
               bool sec_mem = false
              >
@@ -199,6 +204,17 @@ namespace jau {
              */
             typedef cow_rw_iterator<storage_t, storage_ref_t, cow_container_t> iterator;
 
+            /**
+             * Write transaction, holding the write-lock and a store copy until commit, rollback or destruction.
+             * <p>
+             * Exposes the full jau::darray mutation API on its private copy,
+             * publishing all mutations with a single store replacement on commit.
+             * </p>
+             * @see jau::cow_transaction
+             * @see jau::cow_darray::transaction()
+             */
+            typedef cow_transaction<storage_t, storage_ref_t, cow_container_t> transaction_t;
+
             // typedef std::reverse_iterator<iterator>         reverse_iterator;
             // typedef std::reverse_iterator<const_iterator>   const_reverse_iterator;
 
@@ -208,6 +224,180 @@ namespace jau {
             storage_ref_t store_ref;
             mutable sc_atomic_bool sync_atomic;
             mutable std::recursive_mutex mtx_write;
+            /** Raw pointer of store_ref for epoch_view() readers, updated along with store_ref. */
+            ordered_atomic<storage_t*, std::memory_order::memory_order_seq_cst> store_ptr;
+            /** True once epoch_view() has been used, enabling retirement of replaced stores via jau::epoch_domain. */
+            mutable sc_atomic_bool epoch_readers;
+            /** Replaced stores for reuse, guarded by mtx_write, see set_store_pool(). */
+            darray<storage_ref_t> store_pool;
+            /** Maximum number of pooled stores, zero disables the pool. Guarded by mtx_write. */
+            size_type store_pool_max = 0;
+            relaxed_atomic_size_t store_pool_hits_ {0};
+            relaxed_atomic_size_t store_pool_misses_ {0};
+
+            template<typename, typename, typename> friend class cow_transaction;
+
+            /** True while a transaction() is open, guarded by mtx_write. */
+            bool transaction_open = false;
+
+            /**
+             * Throws jau::IllegalStateException if a transaction() is open. Caller must hold mtx_write.
+             * <p>
+             * Only the thread holding the open transaction may pass the recursive write lock,
+             * whose mutation would be silently overwritten by the transaction's commit.
+             * </p>
+             */
+            void check_transaction() const {
+                if( transaction_open ) {
+                    throw jau::IllegalStateException("write operation while transaction is open", E_FILE_LINE);
+                }
+            }
+
+            /**
+             * Aborts if a transaction() is open, used by the noexcept write operations. Caller must hold mtx_write.
+             * <p>
+             * See check_transaction().
+             * </p>
+             */
+            void check_transaction_noexcept() const noexcept {
+                if( transaction_open ) {
+                    ABORT("write operation while transaction is open");
+                }
+            }
+
+            /**
+             * Returns an empty pooled store with at least the given capacity if available, otherwise nullptr.
+             * <p>
+             * A pooled store is only reused if no other shared reference exists,
+             * i.e. it is no more accessed by any reader.
+             * </p>
+             * Caller must hold mtx_write.
+             */
+            storage_ref_t acquire_pooled_store(const size_type capacity) {
+                for(typename darray<storage_ref_t>::iterator it = store_pool.begin(); it != store_pool.end(); ++it) {
+                    if( 1 == it->use_count() && capacity <= (*it)->capacity() ) {
+                        // synchronize with the last reader's release of its reference
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        storage_ref_t res = std::move( *it );
+                        store_pool.erase(it);
+                        res->truncate(0);
+                        store_pool_hits_++;
+                        return res;
+                    }
+                }
+                store_pool_misses_++;
+                return nullptr;
+            }
+
+            /**
+             * Destructs the elements of all pooled stores no more referenced by any reader,
+             * i.e. releases their resources early instead of at reuse. Caller must hold mtx_write.
+             */
+            void clear_pooled_stores() noexcept {
+                for(typename darray<storage_ref_t>::iterator it = store_pool.begin(); it != store_pool.end(); ++it) {
+                    if( 1 == it->use_count() && !(*it)->empty() ) {
+                        // synchronize with the last reader's release of its reference
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        (*it)->truncate(0);
+                    }
+                }
+            }
+
+            /**
+             * Returns a copy of the current store with the given capacity,
+             * reusing a pooled store if enabled and available, see set_store_pool().
+             * Caller must hold mtx_write.
+             */
+            storage_ref_t new_store_copy(const size_type new_capacity) {
+                if( 0 < store_pool_max ) {
+                    storage_ref_t res = acquire_pooled_store(new_capacity);
+                    if( nullptr != res ) {
+                        res->push_back( store_ref->cbegin(), store_ref->cend() );
+                        return res;
+                    }
+                }
+                return std::make_shared<storage_t>( *store_ref, new_capacity,
+                                                    store_ref->growth_factor(),
+                                                    store_ref->get_allocator_ref() );
+            }
+
+            /**
+             * Returns a new store with the given capacity holding a copy of the given range [first, last),
+             * reusing a pooled store if enabled and available, see set_store_pool().
+             * Caller must hold mtx_write.
+             */
+            storage_ref_t new_store_copy(const size_type new_capacity,
+                                         typename storage_t::const_iterator first, typename storage_t::const_iterator last) {
+                if( 0 < store_pool_max ) {
+                    storage_ref_t res = acquire_pooled_store(new_capacity);
+                    if( nullptr != res ) {
+                        res->push_back( first, last );
+                        return res;
+                    }
+                }
+                return std::make_shared<storage_t>( new_capacity, first, last,
+                                                    store_ref->growth_factor(),
+                                                    store_ref->get_allocator_ref() );
+            }
+
+            /**
+             * Replaces store_ref with the given new store. Caller must hold mtx_write and sync_atomic's jau::sc_atomic_critical.
+             * <p>
+             * The replaced store is retired via jau::epoch_domain::retire() if epoch_view() has been used,
+             * i.e. its release is deferred until all epoch_view() readers have left their epoch.
+             * </p>
+             * <p>
+             * The replaced store is added to the store pool if enabled, see set_store_pool().
+             * The pool's capacity is reserved by set_store_pool(), hence pooling doesn't allocate.
+             * Elements of all pooled stores no more referenced by readers are destructed, see clear_pooled_stores().
+             * </p>
+             */
+            void replace_store(storage_ref_t && new_store_ref) noexcept {
+                storage_ref_t old_store_ref = std::move(store_ref);
+                store_ref = std::move(new_store_ref);
+                store_ptr = store_ref.get();
+                if( 0 < store_pool_max && nullptr != old_store_ref ) {
+                    if( store_pool.size() >= store_pool_max ) {
+                        store_pool.erase( store_pool.begin() ); // evict oldest
+                    }
+                    store_pool.push_back( old_store_ref ); // within reserved capacity
+                }
+                if( epoch_readers && nullptr != old_store_ref ) {
+                    epoch_domain::get().retire( std::move(old_store_ref) );
+                }
+                if( 0 < store_pool_max ) {
+                    old_store_ref = nullptr;
+                    clear_pooled_stores();
+                }
+            }
+
+            /**
+             * Replaces the store with a copy w/o the elements at position <code>it</code> for which <code>pred(it)</code> returns true,
+             * i.e. performs at most one copy-on-write. Caller must hold mtx_write.
+             * @return number of erased elements
+             */
+            template<class IterPredicate>
+            size_type copy_store_erase(IterPredicate pred) {
+                typename storage_t::const_iterator first = store_ref->cbegin();
+                typename storage_t::const_iterator last = store_ref->cend();
+                typename storage_t::const_iterator it = first;
+                while( it != last && !pred( it ) ) { ++it; }
+                if( it == last ) {
+                    return 0; // no match, no copy
+                }
+                storage_ref_t new_store_ref = new_store_copy( store_ref->capacity(), first, it );
+                for(++it; it != last; ++it) {
+                    if( !pred( it ) ) {
+                        new_store_ref->push_back( *it );
+                    }
+                }
+                const size_type count = store_ref->size() - new_store_ref->size();
+                {
+                    sc_atomic_critical sync(sync_atomic);
+                    replace_store( std::move(new_store_ref) );
+                }
+                return count;
+            }
 
         public:
             // ctor w/o elements
@@ -216,7 +406,7 @@ namespace jau {
              * Default constructor, giving almost zero capacity and zero memory footprint, but the shared empty jau::darray
              */
             constexpr cow_darray() noexcept
-            : store_ref(std::make_shared<storage_t>()), sync_atomic(false) {
+            : store_ref(std::make_shared<storage_t>()), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false) {
                 DARRAY_PRINTF("ctor def: %s\n", get_info().c_str());
             }
 
@@ -227,20 +417,20 @@ namespace jau {
              * @param alloc given allocator_type
              */
             constexpr explicit cow_darray(size_type capacity, const float growth_factor=DEFAULT_GROWTH_FACTOR, const allocator_type& alloc = allocator_type())
-            : store_ref(std::make_shared<storage_t>(capacity, growth_factor, alloc)), sync_atomic(false) {
+            : store_ref(std::make_shared<storage_t>(capacity, growth_factor, alloc)), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false) {
                 DARRAY_PRINTF("ctor 1: %s\n", get_info().c_str());
             }
 
             // conversion ctor on storage_t elements
 
             constexpr cow_darray(const storage_t& x)
-            : store_ref(std::make_shared<storage_t>(x)), sync_atomic(false) {
+            : store_ref(std::make_shared<storage_t>(x)), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false) {
                 DARRAY_PRINTF("ctor copy_0: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("ctor copy_0:    x %s\n", x.get_info().c_str());
             }
 
             constexpr explicit cow_darray(const storage_t& x, const float growth_factor, const allocator_type& alloc)
-            : store_ref(std::make_shared<storage_t>(x, growth_factor, alloc)), sync_atomic(false) {
+            : store_ref(std::make_shared<storage_t>(x, growth_factor, alloc)), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false) {
                 DARRAY_PRINTF("ctor copy_1: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("ctor copy_1:    x %s\n", x.get_info().c_str());
             }
@@ -253,24 +443,25 @@ namespace jau {
              */
             cow_darray& operator=(const storage_t& x) {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
                 DARRAY_PRINTF("assignment copy_0: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("assignment copy_0:    x %s\n", x.get_info().c_str());
                 {
                     sc_atomic_critical sync(sync_atomic);
-                    store_ref = std::move( std::make_shared<storage_t>( x ) );
+                    replace_store( std::make_shared<storage_t>( x ) );
                 }
                 return *this;
             }
 
             constexpr cow_darray(storage_t && x) noexcept
-            : store_ref(std::make_shared<storage_t>(std::move(x))), sync_atomic(false) {
+            : store_ref(std::make_shared<storage_t>(std::move(x))), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false) {
                 DARRAY_PRINTF("ctor move_0: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("ctor move_0:    x %s\n", x.get_info().c_str());
                 // Moved source array has been taken over. darray's move-operator has flushed source
             }
 
             constexpr explicit cow_darray(storage_t && x, const float growth_factor, const allocator_type& alloc) noexcept
-            : store_ref(std::make_shared<storage_t>(std::move(x), growth_factor, alloc)), sync_atomic(false) {
+            : store_ref(std::make_shared<storage_t>(std::move(x), growth_factor, alloc)), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false) {
                 DARRAY_PRINTF("ctor move_1: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("ctor move_1:    x %s\n", x.get_info().c_str());
                 // Moved source array has been taken over. darray's move-operator has flushed source
@@ -284,11 +475,12 @@ namespace jau {
              */
             cow_darray& operator=(storage_t&& x) {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
                 DARRAY_PRINTF("assignment move_0: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("assignment move_0:    x %s\n", x.get_info().c_str());
                 {
                     sc_atomic_critical sync(sync_atomic);
-                    store_ref = std::move( std::make_shared<storage_t>( std::move(x) ) );
+                    replace_store( std::make_shared<storage_t>( std::move(x) ) );
                     // Moved source array has been taken over. darray's move-operator has flushed source
                 }
                 return *this;
@@ -303,7 +495,7 @@ namespace jau {
              */
             constexpr_atomic
             cow_darray(const cow_darray& x)
-            : sync_atomic(false) {
+            : sync_atomic(false), store_ptr(nullptr), epoch_readers(false) {
                 storage_ref_t x_store_ref;
                 {
                     sc_atomic_critical sync_x( x.sync_atomic );
@@ -312,6 +504,7 @@ namespace jau {
                     x_store_ref = x.store_ref;
                 }
                 store_ref = std::make_shared<storage_t>( *x_store_ref );
+                store_ptr = store_ref.get();
             }
 
             /**
@@ -323,7 +516,7 @@ namespace jau {
              */
             constexpr_atomic
             explicit cow_darray(const cow_darray& x, const float growth_factor, const allocator_type& alloc)
-            : sync_atomic(false) {
+            : sync_atomic(false), store_ptr(nullptr), epoch_readers(false) {
                 storage_ref_t x_store_ref;
                 {
                     sc_atomic_critical sync_x( x.sync_atomic );
@@ -332,6 +525,7 @@ namespace jau {
                     x_store_ref = x.store_ref;
                 }
                 store_ref = std::make_shared<storage_t>( *x_store_ref, growth_factor, alloc );
+                store_ptr = store_ref.get();
             }
 
             /**
@@ -347,7 +541,7 @@ namespace jau {
              */
             constexpr_atomic
             explicit cow_darray(const cow_darray& x, const size_type _capacity, const float growth_factor, const allocator_type& alloc)
-            : sync_atomic(false) {
+            : sync_atomic(false), store_ptr(nullptr), epoch_readers(false) {
                 storage_ref_t x_store_ref;
                 {
                     sc_atomic_critical sync_x( x.sync_atomic );
@@ -356,6 +550,7 @@ namespace jau {
                     x_store_ref = x.store_ref;
                 }
                 store_ref = std::make_shared<storage_t>( *x_store_ref, _capacity, growth_factor, alloc );
+                store_ptr = store_ref.get();
             }
 
             /**
@@ -367,6 +562,7 @@ namespace jau {
             constexpr_atomic
             cow_darray& operator=(const cow_darray& x) {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
                 storage_ref_t x_store_ref;
                 {
                     sc_atomic_critical sync_x( x.sync_atomic );
@@ -377,7 +573,7 @@ namespace jau {
                 storage_ref_t new_store_ref = std::make_shared<storage_t>( *x_store_ref );
                 {
                     sc_atomic_critical sync(sync_atomic);
-                    store_ref = std::move(new_store_ref);
+                    replace_store( std::move(new_store_ref) );
                 }
                 return *this;
             }
@@ -385,7 +581,8 @@ namespace jau {
             // move_ctor on cow_darray elements
 
             constexpr_atomic
-            cow_darray(cow_darray && x) noexcept {
+            cow_darray(cow_darray && x) noexcept
+            : sync_atomic(false), store_ptr(nullptr), epoch_readers(false) {
                 // Strategy-1: Acquire lock, blocking
                 // - If somebody else holds the lock, we wait.
                 // - Then we own the lock
@@ -395,11 +592,17 @@ namespace jau {
                     DARRAY_PRINTF("ctor move.0: this %s\n", get_info().c_str());
                     DARRAY_PRINTF("ctor move.0:    x %s\n", x.get_info().c_str());
                     store_ref = std::move(x.store_ref);
+                    store_ptr = store_ref.get();
+                    epoch_readers = x.epoch_readers.load(); // x's epoch readers may still access the taken over store
                     // sync_atomic = std::move(x.sync_atomic); // issues w/ g++ 8.3 (move marked as deleted)
                     // mtx_write will be a fresh one, but we hold the source's lock
 
                     // Moved source array has been taken over, null its store_ref
                     x.store_ref = nullptr;
+                    x.store_ptr = nullptr;
+                    store_pool = std::move(x.store_pool);
+                    store_pool_max = x.store_pool_max;
+                    x.store_pool_max = 0;
                 }
             }
 
@@ -418,16 +621,22 @@ namespace jau {
                 std::unique_lock<std::recursive_mutex> lock1(x.mtx_write, std::defer_lock); // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
                 std::unique_lock<std::recursive_mutex> lock2(  mtx_write, std::defer_lock); // otherwise RAII-style relinquish via destructor
                 std::lock(lock1, lock2);
+                check_transaction_noexcept();
+                x.check_transaction_noexcept();
                 {
                     sc_atomic_critical sync_x( x.sync_atomic );
                     sc_atomic_critical sync  (   sync_atomic );
                     DARRAY_PRINTF("assignment move.0: this %s\n", get_info().c_str());
                     DARRAY_PRINTF("assignment move.0:    x %s\n", x.get_info().c_str());
-                    store_ref = std::move(x.store_ref);
-                    // mtx_write and the atomic will be kept as is, but we hold the source's lock
+                    if( x.epoch_readers ) {
+                        epoch_readers = true; // x's epoch readers may still access the taken over store
+                    }
+                    replace_store( std::move(x.store_ref) ); // pooled by this instance's store pool, if enabled
+                    // mtx_write, the atomic and the store pool will be kept as is, but we hold the source's lock
 
                     // Moved source array has been taken over, null its store_ref
                     x.store_ref = nullptr;
+                    x.store_ptr = nullptr;
                 }
                 return *this;
             }
@@ -449,7 +658,7 @@ namespace jau {
              */
             constexpr cow_darray(const size_type _capacity, const_iterator first, const_iterator last,
                              const float growth_factor=DEFAULT_GROWTH_FACTOR, const allocator_type& alloc = allocator_type())
-            : store_ref(std::make_shared<storage_t>(_capacity, first.underling(), last.underling(), growth_factor, alloc)), sync_atomic(false)
+            : store_ref(std::make_shared<storage_t>(_capacity, first.underling(), last.underling(), growth_factor, alloc)), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false)
             {
                 DARRAY_PRINTF("ctor iters0: %s\n", get_info().c_str());
             }
@@ -471,7 +680,7 @@ namespace jau {
             template< class InputIt >
             constexpr explicit cow_darray(const size_type _capacity, InputIt first, InputIt last,
                                       const float growth_factor=DEFAULT_GROWTH_FACTOR, const allocator_type& alloc = allocator_type())
-            : store_ref(std::make_shared<storage_t>(_capacity, first, last, growth_factor, alloc)), sync_atomic(false)
+            : store_ref(std::make_shared<storage_t>(_capacity, first, last, growth_factor, alloc)), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false)
             {
                 DARRAY_PRINTF("ctor iters1: %s\n", get_info().c_str());
             }
@@ -487,7 +696,7 @@ namespace jau {
              */
             template< class InputIt >
             constexpr cow_darray(InputIt first, InputIt last, const allocator_type& alloc = allocator_type())
-            : store_ref(std::make_shared<storage_t>(first, last, alloc)), sync_atomic(false)
+            : store_ref(std::make_shared<storage_t>(first, last, alloc)), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false)
             {
                 DARRAY_PRINTF("ctor iters2: %s\n", get_info().c_str());
             }
@@ -499,7 +708,7 @@ namespace jau {
              * @param alloc allocator
              */
             constexpr cow_darray(std::initializer_list<value_type> initlist, const allocator_type& alloc = allocator_type())
-            : store_ref(std::make_shared<storage_t>(initlist, alloc)), sync_atomic(false)
+            : store_ref(std::make_shared<storage_t>(initlist, alloc)), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false)
             {
                 DARRAY_PRINTF("ctor initlist: %s\n", get_info().c_str());
             }
@@ -507,6 +716,9 @@ namespace jau {
 
             ~cow_darray() noexcept {
                 DARRAY_PRINTF("dtor: %s\n", get_info().c_str());
+                if( epoch_readers ) {
+                    epoch_domain::get().reclaim(); // release this instance's retired stores not accessed anymore
+                }
             }
 
             /**
@@ -549,7 +761,11 @@ namespace jau {
             constexpr_atomic
             storage_ref_t copy_store() {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
                 DARRAY_PRINTF("copy_store: %s\n", get_info().c_str());
+                if( 0 < store_pool_max ) {
+                    return new_store_copy( store_ref->size() );
+                }
                 return std::make_shared<storage_t>( *store_ref );
             }
 
@@ -586,15 +802,65 @@ namespace jau {
             constexpr_atomic
             void set_store(storage_ref_t && new_store_ref) noexcept {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction_noexcept();
                 sc_atomic_critical sync(sync_atomic);
 #if DEBUG_DARRAY
                 DARRAY_PRINTF("set_store: dest %s\n", get_info().c_str());
                 DARRAY_PRINTF("set_store:  src %s\n", new_store_ref->get_info().c_str());
                 jau::print_backtrace(true, 8);
 #endif
-                store_ref = std::move( new_store_ref );
+                replace_store( std::move(new_store_ref) );
             }
 
+            /**
+             * Enables the opt-in store pool, recycling up to <code>max_stores</code> replaced stores
+             * for subsequent copy-on-write operations, or disables it if <code>max_stores</code> is zero.
+             * <p>
+             * Each copy-on-write write operation allocates a new store, while the replaced store
+             * is released once its last reader drops its reference.<br>
+             * With the store pool enabled, replaced stores are kept and reused for the next copy
+             * once no reader references them anymore and their capacity is sufficient,
+             * avoiding the storage and shared reference allocation with steady writes.
+             * </p>
+             * <p>
+             * The pool evicts its oldest store if full, disabling the pool releases all pooled stores.<br>
+             * Pooled stores keep their memory, hence the footprint may grow by up to <code>max_stores</code> stores.
+             * </p>
+             * <p>
+             * Elements of a pooled store are destructed once no reader references the store anymore,
+             * detected by this instance's next write operation, i.e. their destruction may be deferred until then.
+             * </p>
+             * <p>
+             * The pool and its settings are transferred by move construction.
+             * Move assignment keeps this instance's pool, its settings and statistics, pooling the replaced store.
+             * </p>
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             * @param max_stores maximum number of pooled stores, zero disables the pool
+             * @see store_pool_hits()
+             * @see store_pool_misses()
+             */
+            void set_store_pool(const size_type max_stores) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                store_pool_max = max_stores;
+                if( store_pool.size() > max_stores ) {
+                    store_pool.erase( store_pool.begin(), store_pool.cend() - max_stores );
+                }
+                store_pool.reserve(max_stores); // replace_store() pools w/o allocation
+            }
+
+            /**
+             * Returns the number of copy-on-write operations reusing a pooled store, see set_store_pool().
+             */
+            std::size_t store_pool_hits() const noexcept { return store_pool_hits_; }
+
+            /**
+             * Returns the number of copy-on-write operations w/o a reusable pooled store
+             * while the pool is enabled, see set_store_pool().
+             */
+            std::size_t store_pool_misses() const noexcept { return store_pool_misses_; }
+
             /**
              * Returns the current snapshot of the underlying shared storage by reference.
              * <p>
@@ -612,6 +878,43 @@ namespace jau {
                 return store_ref;
             }
 
+            /**
+             * Immutable, read-only view of the current store, <i>lock-free</i>,
+             * holding a jau::epoch_domain critical section instead of a shared store reference.
+             * @see jau::epoch_ro_view
+             */
+            typedef epoch_ro_view<storage_t> epoch_view_t;
+
+            /**
+             * Returns an immutable, read-only view of the current store using epoch based reclamation.
+             * <p>
+             * Other than snapshot() and cbegin(), the returned view does not copy the shared store reference,
+             * i.e. concurrent readers don't contend on the shared reference counter's cache-line.<br>
+             * Its construction only writes to the calling thread's jau::epoch_domain slot,
+             * hence scaling with the number of reader threads.
+             * </p>
+             * <p>
+             * Replaced stores are retired via jau::epoch_domain and released only after all readers have left their epoch.
+             * Retirement is enabled with the first call of this method on this instance,
+             * otherwise write operations release replaced stores immediately.
+             * </p>
+             * <p>
+             * As with snapshot(), the view will be outdated by the next (concurrent) write operation.<br>
+             * The view shall not outlive this instance and shall remain on the calling thread.
+             * </p>
+             * <p>
+             * This read operation is <i>lock-free</i>, except for the thread's first jau::epoch_domain slot acquisition.
+             * </p>
+             * @see jau::epoch_ro_view
+             * @see jau::epoch_domain
+             */
+            epoch_view_t epoch_view() const {
+                if( !epoch_readers ) {
+                    epoch_readers = true; // prior to loading store_ptr, see replace_store()
+                }
+                return epoch_view_t( [this]() -> const storage_t* { return store_ptr.load(); } );
+            }
+
             // const_iterator, non mutable, read-only
 
             // Removed for clarity: "constexpr const_iterator begin() const noexcept"
@@ -660,6 +963,33 @@ namespace jau {
                 return iterator(*this);
             }
 
+            /**
+             * Returns a new jau::cow_transaction, batching multiple mutations into a single copy-on-write.
+             * <p>
+             * Each mutating method of this class performs its own copy-on-write, if required,
+             * e.g. pop_back() always copies the store.<br>
+             * The returned transaction locks this instances' write mutex and copies the store once,
+             * exposing the full jau::darray mutation API on its private copy until
+             * jau::cow_transaction::commit() replaces this instances' store via set_store().
+             * </p>
+             * <p>
+             * Destruction of the transaction without commit discards all its mutations.
+             * </p>
+             * <p>
+             * While the transaction is open, all write operations of this instance on the same thread
+             * throw jau::IllegalStateException, as their mutation would be overwritten by the commit.
+             * The noexcept write operations, i.e. move assignment, set_store(), clear(), swap() and pop_back(), abort instead.
+             * Use the transaction's store instead.
+             * </p>
+             * @return jau::cow_darray::transaction_t of type jau::cow_transaction
+             * @see jau::cow_transaction
+             * @see jau::cow_transaction::commit()
+             * @see jau::cow_transaction::rollback()
+             */
+            transaction_t transaction() {
+                return transaction_t(*this);
+            }
+
             // read access
 
             const allocator_type& get_allocator_ref() const noexcept {
@@ -732,12 +1062,11 @@ namespace jau {
              */
             void reserve(size_type new_capacity) {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
                 if( new_capacity > store_ref->capacity() ) {
-                    storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref, new_capacity,
-                                                                               store_ref->growth_factor(),
-                                                                               store_ref->get_allocator_ref() );
+                    storage_ref_t new_store_ref = new_store_copy( new_capacity );
                     sc_atomic_critical sync( sync_atomic );
-                    store_ref = std::move(new_store_ref);
+                    replace_store( std::move(new_store_ref) );
                 }
             }
 
@@ -750,10 +1079,14 @@ namespace jau {
             constexpr_atomic
             void clear() noexcept {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction_noexcept();
                 storage_ref_t new_store_ref = std::make_shared<storage_t>();
                 {
                     sc_atomic_critical sync(sync_atomic);
-                    store_ref = std::move(new_store_ref);
+                    replace_store( std::move(new_store_ref) );
+                }
+                if( epoch_readers ) {
+                    epoch_domain::get().reclaim();
                 }
             }
 
@@ -768,12 +1101,21 @@ namespace jau {
                 std::unique_lock<std::recursive_mutex> lock(mtx_write, std::defer_lock); // utilize std::lock(a, b), allowing mixed order waiting on either object
                 std::unique_lock<std::recursive_mutex> lock_x(x.mtx_write, std::defer_lock); // otherwise RAII-style relinquish via destructor
                 std::lock(lock, lock_x);
+                check_transaction_noexcept();
+                x.check_transaction_noexcept();
                 {
                     sc_atomic_critical sync_x( x.sync_atomic );
                     sc_atomic_critical sync(sync_atomic);
                     storage_ref_t x_store_ref = x.store_ref;
                     x.store_ref = store_ref;
                     store_ref = x_store_ref;
+                    x.store_ptr = x.store_ref.get();
+                    store_ptr = store_ref.get();
+                    if( epoch_readers || x.epoch_readers ) {
+                        // either's epoch readers may still access the swapped store
+                        epoch_readers = true;
+                        x.epoch_readers = true;
+                    }
                 }
             }
 
@@ -786,15 +1128,12 @@ namespace jau {
             constexpr_atomic
             void pop_back() noexcept {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction_noexcept();
                 if( !store_ref->empty() ) {
-                    storage_ref_t new_store_ref = std::make_shared<storage_t>( store_ref->capacity(),
-                                                                               store_ref->cbegin(),
-                                                                               store_ref->cend()-1,
-                                                                               store_ref->growth_factor(),
-                                                                               store_ref->get_allocator_ref() );
+                    storage_ref_t new_store_ref = new_store_copy( store_ref->capacity(), store_ref->cbegin(), store_ref->cend()-1 );
                     {
                         sc_atomic_critical sync(sync_atomic);
-                        store_ref = std::move(new_store_ref);
+                        replace_store( std::move(new_store_ref) );
                     }
                 }
             }
@@ -809,15 +1148,14 @@ namespace jau {
             constexpr_atomic
             void push_back(const value_type& x) {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
                 if( store_ref->capacity_reached() ) {
                     // grow and swap all refs
-                    storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref, store_ref->get_grown_capacity(),
-                                                                               store_ref->growth_factor(),
-                                                                               store_ref->get_allocator_ref() );
+                    storage_ref_t new_store_ref = new_store_copy( store_ref->get_grown_capacity() );
                     new_store_ref->push_back(x);
                     {
                         sc_atomic_critical sync(sync_atomic);
-                        store_ref = std::move(new_store_ref);
+                        replace_store( std::move(new_store_ref) );
                     }
                 } else {
                     // just append ..
@@ -834,15 +1172,14 @@ namespace jau {
             constexpr_atomic
             void push_back(value_type&& x) {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
                 if( store_ref->capacity_reached() ) {
                     // grow and swap all refs
-                    storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref, store_ref->get_grown_capacity(),
-                                                                               store_ref->growth_factor(),
-                                                                               store_ref->get_allocator_ref() );
+                    storage_ref_t new_store_ref = new_store_copy( store_ref->get_grown_capacity() );
                     new_store_ref->push_back( std::move(x) );
                     {
                         sc_atomic_critical sync(sync_atomic);
-                        store_ref = std::move(new_store_ref);
+                        replace_store( std::move(new_store_ref) );
                     }
                 } else {
                     // just append ..
@@ -864,15 +1201,14 @@ namespace jau {
             constexpr_atomic
             reference emplace_back(Args&&... args) {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
                 if( store_ref->capacity_reached() ) {
                     // grow and swap all refs
-                    storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref, store_ref->get_grown_capacity(),
-                                                                               store_ref->growth_factor(),
-                                                                               store_ref->get_allocator_ref() );
+                    storage_ref_t new_store_ref = new_store_copy( store_ref->get_grown_capacity() );
                     reference res = new_store_ref->emplace_back( std::forward<Args>(args)... );
                     {
                         sc_atomic_critical sync(sync_atomic);
-                        store_ref = std::move(new_store_ref);
+                        replace_store( std::move(new_store_ref) );
                     }
                     return res;
                 } else {
@@ -894,17 +1230,16 @@ namespace jau {
             constexpr_atomic
             void push_back( InputIt first, InputIt last ) {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
                 const size_type new_size_ = store_ref->size() + size_type(last - first);
 
                 if( new_size_ > store_ref->capacity() ) {
                     // grow and swap all refs
-                    storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref, new_size_,
-                                                                               store_ref->growth_factor(),
-                                                                               store_ref->get_allocator_ref() );
-                    store_ref->push_back( first, last );
+                    storage_ref_t new_store_ref = new_store_copy( new_size_ );
+                    new_store_ref->push_back( first, last );
                     {
                         sc_atomic_critical sync(sync_atomic);
-                        store_ref = std::move(new_store_ref);
+                        replace_store( std::move(new_store_ref) );
                     }
                 } else {
                     // just append ..
@@ -912,6 +1247,66 @@ namespace jau {
                 }
             }
 
+            /**
+             * Like std::erase_if(std::vector&, pred), removes all elements for which the given predicate returns true.
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             * <p>
+             * Performs exactly one copy-on-write if at least one element matches, none otherwise.
+             * The new store is populated in a single pass by copying all remaining elements,
+             * hence erased elements are neither copied nor moved.
+             * </p>
+             * @tparam UnaryPredicate predicate type, callable as <code>bool pred(const value_type&)</code>
+             * @param pred the predicate returning true for elements to be erased, invoked exactly once per element
+             * @return number of erased elements
+             */
+            template<class UnaryPredicate>
+            constexpr_atomic
+            size_type erase_if(UnaryPredicate pred) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                return copy_store_erase( [&pred](typename storage_t::const_iterator it) -> bool { return pred( *it ); } );
+            }
+
+            /**
+             * Erases all elements at the given positions, see erase_if().
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             * <p>
+             * Throws jau::IllegalArgumentException() if positions are not in ascending order
+             * and jau::IndexOutOfBoundsException() if a position is not less than size(),
+             * both before any element is erased. Duplicate positions are erased once.
+             * </p>
+             * @tparam InputIt forward-iterator type to a range of positions
+             * @param first forward-iterator to first position of range [first, last)
+             * @param last forward-iterator to last position of range [first, last)
+             * @return number of erased elements
+             */
+            template< class InputIt >
+            constexpr_atomic
+            size_type erase_indices(InputIt first, InputIt last) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                const size_type size_ = store_ref->size();
+                for(InputIt p = first, prev = first; p != last; prev = p, ++p) {
+                    if( size_type(*p) >= size_ ) {
+                        throw jau::IndexOutOfBoundsException(size_type(*p), size_, E_FILE_LINE);
+                    }
+                    if( p != prev && *p < *prev ) {
+                        throw jau::IllegalArgumentException("positions not in ascending order: "+
+                                std::to_string(*prev)+" > "+std::to_string(*p), E_FILE_LINE);
+                    }
+                }
+                typename storage_t::const_iterator begin0 = store_ref->cbegin();
+                return copy_store_erase( [&first, &last, begin0](typename storage_t::const_iterator it) -> bool {
+                    const size_type idx = size_type(it - begin0);
+                    while( first != last && size_type(*first) < idx ) { ++first; }
+                    return first != last && size_type(*first) == idx;
+                } );
+            }
+
             /**
              * Generic value_type equal comparator to be user defined for e.g. jau::cow_darray::push_back_unique().
              * @param a one element of the equality test.
@@ -947,6 +1342,7 @@ namespace jau {
             constexpr_atomic
             bool push_back_unique(const value_type& x, equal_comparator comparator) {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
                 for(auto it = store_ref->begin(); it != store_ref->end(); ) {
                     if( comparator( *it, x ) ) {
                         return false; // already included
@@ -978,12 +1374,15 @@ namespace jau {
              * </pre>
              * </p>
              * @param x the value to be added at the tail, if not existing yet.
-             * @param all_matching if true, erase all matching elements, otherwise only the first matching element.
+             * @param all_matching if true, erase all matching elements via erase_if(), otherwise only the first matching element.
              * @param comparator the equal comparator to return true if both given elements are equal
              * @return number of erased elements
              */
             constexpr_atomic
             int erase_matching(const value_type& x, const bool all_matching, equal_comparator comparator) {
+                if( all_matching ) {
+                    return static_cast<int>( erase_if( [&x, comparator](const value_type& e) -> bool { return comparator( e, x ); } ) );
+                }
                 int count = 0;
 
                 iterator it = begin(); // lock mutex and copy_store
@@ -0,0 +1,482 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_COW_FLAT_MAP_HPP_
+#define JAU_COW_FLAT_MAP_HPP_
+
+#include <string>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <initializer_list>
+#include <functional>
+#include <utility>
+
+#include <jau/cpp_lang_util.hpp>
+#include <jau/basic_types.hpp>
+#include <jau/ordered_atomic.hpp>
+#include <jau/callocator.hpp>
+#include <jau/flat_map.hpp>
+
+namespace jau {
+
+    /**
+     * Implementation of a Copy-On-Write (CoW) using jau::flat_map as the underlying storage,
+     * exposing <i>lock-free</i> read operations using SC-DRF atomic synchronization.
+     * <p>
+     * This class is intended for read-mostly maps, e.g. device address to device information,
+     * where lookups are frequent and concurrent while mutations are rare.
+     * </p>
+     * <p>
+     * Since the store is immutable once published, mapped values are retrieved by copy via get()
+     * or accessed via a snapshot().
+     * </p>
+     * <p>
+     * The store is owned using a shared reference to the data structure,
+     * allowing its replacement on Copy-On-Write (CoW).
+     * </p>
+     * <p>
+     * Writing to the store utilizes a mutex lock to avoid data races
+     * on the instances' write operations only, leaving read operations <i>lock-free</i>.<br>
+     * Write operations replace the store reference with a new instance using
+     * jau::sc_atomic_critical to synchronize with read operations.
+     * </p>
+     * <p>
+     * Each write operation performs at most one copy of the store,
+     * including the bulk insert(InputIt, InputIt) and erase_if().<br>
+     * Inserting an element with an already contained key or erasing a non contained key
+     * does not copy the store at all.
+     * </p>
+     * <p>
+     * Reading from the store is <i>lock-free</i> and accesses the store reference using
+     * jau::sc_atomic_critical to synchronizing with write operations.<br>
+     * Multiple lookups on one consistent state shall use snapshot() once.
+     * </p>
+     * <p>
+     * See jau::cow_darray for details about the CoW and SC-DRF synchronization.
+     * </p>
+     *
+     * @see jau::flat_map
+     * @see jau::cow_flat_set
+     * @see jau::cow_darray
+     */
+    template <typename Key, typename T, typename Compare = std::less<Key>,
+              typename Alloc_type = jau::callocator<std::pair<Key, T>>, typename Size_type = jau::nsize_t,
+              bool use_memmove = jau::is_trivially_relocatable_v<std::pair<Key, T>>,
+              bool use_realloc = std::is_base_of_v<jau::callocator<std::pair<Key, T>>, Alloc_type>,
+              bool sec_mem = false
+             >
+    class cow_flat_map
+    {
+        public:
+            /** Default growth factor using the golden ratio 1.618 */
+            constexpr static const float DEFAULT_GROWTH_FACTOR = 1.618f;
+
+            // typedefs' for C++ named requirements: AssociativeContainer
+
+            typedef Key                                         key_type;
+            typedef T                                           mapped_type;
+            typedef std::pair<Key, T>                           value_type;
+            typedef Compare                                     key_compare;
+            typedef const value_type&                           reference;
+            typedef const value_type&                           const_reference;
+            typedef Size_type                                   size_type;
+            typedef typename std::make_signed<size_type>::type  difference_type;
+            typedef Alloc_type                                  allocator_type;
+
+            typedef flat_map<key_type, mapped_type, key_compare, allocator_type, size_type, use_memmove, use_realloc, sec_mem> storage_t;
+            typedef std::shared_ptr<storage_t>                  storage_ref_t;
+
+        private:
+            storage_ref_t store_ref;
+            mutable sc_atomic_bool sync_atomic;
+            mutable std::recursive_mutex mtx_write;
+
+            /** Returns a new copy of the current store with capacity for <code>add_count</code> additional elements, holding mtx_write. */
+            storage_ref_t copy_store_grow(const size_type add_count) {
+                return std::make_shared<storage_t>( *store_ref, store_ref->size() + add_count,
+                                                    store_ref->growth_factor(), store_ref->get_allocator_ref() );
+            }
+
+            /** Replaces the store with the given instance, holding mtx_write. */
+            void publish(storage_ref_t && new_store_ref) noexcept {
+                sc_atomic_critical sync(sync_atomic);
+                store_ref = std::move(new_store_ref);
+            }
+
+        public:
+            /**
+             * Default constructor, giving almost zero capacity and zero memory footprint, but the shared empty jau::flat_map
+             */
+            constexpr cow_flat_map() noexcept
+            : store_ref( std::make_shared<storage_t>() ), sync_atomic(false) { }
+
+            /**
+             * Creating an empty instance with initial capacity and other (default) properties.
+             * @param capacity initial capacity of the new instance.
+             * @param growth_factor given growth factor
+             * @param alloc given allocator_type
+             */
+            constexpr explicit cow_flat_map(size_type capacity, const float growth_factor=DEFAULT_GROWTH_FACTOR, const allocator_type& alloc = allocator_type())
+            : store_ref( std::make_shared<storage_t>(capacity, growth_factor, alloc) ), sync_atomic(false) { }
+
+            /**
+             * Creates a new instance, inserting all elements with unique keys from the given
+             * template input-iterator value_type range [first, last).
+             * @tparam InputIt template input-iterator custom type
+             * @param first template input-iterator to first element of value_type range [first, last)
+             * @param last template input-iterator to last element of value_type range [first, last)
+             */
+            template< class InputIt >
+            constexpr cow_flat_map(InputIt first, InputIt last)
+            : store_ref( std::make_shared<storage_t>(first, last) ), sync_atomic(false) { }
+
+            /**
+             * Create a new instance from an initializer list, inserting all elements with unique keys.
+             *
+             * @param initlist initializer_list.
+             */
+            constexpr cow_flat_map(std::initializer_list<value_type> initlist)
+            : store_ref( std::make_shared<storage_t>(initlist) ), sync_atomic(false) { }
+
+            /**
+             * Creates a new instance, copying all elements from the given map.
+             * @param x the given cow_flat_map, all elements will be copied into the new instance.
+             */
+            constexpr_atomic
+            cow_flat_map(const cow_flat_map& x)
+            : sync_atomic(false) {
+                storage_ref_t x_store_ref = x.snapshot();
+                store_ref = std::make_shared<storage_t>( *x_store_ref );
+            }
+
+            /**
+             * Like std::map::operator=(&), assignment
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             */
+            constexpr_atomic
+            cow_flat_map& operator=(const cow_flat_map& x) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                storage_ref_t x_store_ref = x.snapshot();
+                publish( std::make_shared<storage_t>( *x_store_ref ) );
+                return *this;
+            }
+
+            constexpr_atomic
+            cow_flat_map(cow_flat_map && x) noexcept {
+                std::unique_lock<std::recursive_mutex>  lock(x.mtx_write); // *this doesn't exist yet, not locking ourselves
+                store_ref = std::move(x.store_ref);
+                x.store_ref = nullptr;
+            }
+
+            /**
+             * Like std::map::operator=(&&), move.
+             * <p>
+             * This write operation uses a mutex lock and is blocking both cow_flat_map instance's write operations.
+             * </p>
+             */
+            constexpr_atomic
+            cow_flat_map& operator=(cow_flat_map&& x) noexcept {
+                std::unique_lock<std::recursive_mutex> lock1(x.mtx_write, std::defer_lock);
+                std::unique_lock<std::recursive_mutex> lock2(  mtx_write, std::defer_lock);
+                std::lock(lock1, lock2);
+                {
+                    sc_atomic_critical sync_x( x.sync_atomic );
+                    sc_atomic_critical sync  (   sync_atomic );
+                    store_ref = std::move(x.store_ref);
+                    x.store_ref = nullptr;
+                }
+                return *this;
+            }
+
+            ~cow_flat_map() noexcept = default;
+
+            // cow_vector features
+
+            /**
+             * Returns this instances' recursive write mutex, allowing user to
+             * implement more complex mutable write operations.
+             * @see jau::cow_darray::get_write_mutex()
+             */
+            constexpr std::recursive_mutex & get_write_mutex() noexcept { return mtx_write; }
+
+            /**
+             * Returns a new shared_ptr copy of the underlying store.
+             * <p>
+             * This special operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             * @see jau::cow_darray::copy_store()
+             */
+            constexpr_atomic
+            storage_ref_t copy_store() {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                return std::make_shared<storage_t>( *store_ref );
+            }
+
+            /**
+             * Replace the current store with the given instance,
+             * potentially acquired via copy_store() and mutated while holding the get_write_mutex() lock.
+             * @see jau::cow_darray::set_store()
+             */
+            constexpr_atomic
+            void set_store(storage_ref_t && new_store_ref) noexcept {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                publish( std::move(new_store_ref) );
+            }
+
+            /**
+             * Returns the current snapshot of the underlying shared jau::flat_map by reference.
+             * <p>
+             * Note that this snapshot will be outdated by the next (concurrent) write operation.<br>
+             * The returned referenced map is still valid and not mutated,
+             * but does not represent the current content of this cow_flat_map instance.
+             * </p>
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             */
+            constexpr_atomic
+            storage_ref_t snapshot() const noexcept {
+                sc_atomic_critical sync( sync_atomic );
+                return store_ref;
+            }
+
+            // read access
+
+            /**
+             * Like std::map::empty().
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             */
+            constexpr_atomic
+            bool empty() const noexcept {
+                sc_atomic_critical sync( sync_atomic );
+                return store_ref->empty();
+            }
+
+            /**
+             * Like std::map::size().
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             */
+            constexpr_atomic
+            size_type size() const noexcept {
+                sc_atomic_critical sync( sync_atomic );
+                return store_ref->size();
+            }
+
+            /**
+             * Like std::map::contains() of C++20.
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             */
+            constexpr_atomic
+            bool contains(const key_type& key) const {
+                sc_atomic_critical sync( sync_atomic );
+                return store_ref->contains(key);
+            }
+
+            /**
+             * Copies the mapped value of the given key into <code>res</code>, if contained.
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             * @param key the key to look up
+             * @param res storage for the mapped value, only written if the key is contained
+             * @return true if the key is contained, otherwise false
+             */
+            constexpr_atomic
+            bool get(const key_type& key, mapped_type& res) const {
+                storage_ref_t sr = snapshot();
+                const typename storage_t::const_iterator it = sr->find(key);
+                if( it != sr->cend() ) {
+                    res = it->second;
+                    return true;
+                }
+                return false;
+            }
+
+            // write access
+
+            /**
+             * Like std::map::clear(), but ending up with zero capacity.
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations.
+             * </p>
+             */
+            constexpr_atomic
+            void clear() noexcept {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                publish( std::make_shared<storage_t>() );
+            }
+
+            /**
+             * Like std::map::insert(), copy
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.<br>
+             * The store is only copied if the key is not contained yet.
+             * </p>
+             * @param x the value to be inserted
+             * @return true if inserted, otherwise false if the key is already contained.
+             */
+            constexpr_atomic
+            bool insert(const value_type& x) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                if( store_ref->contains(x.first) ) {
+                    return false;
+                }
+                storage_ref_t new_store_ref = copy_store_grow(1);
+                new_store_ref->insert(x);
+                publish( std::move(new_store_ref) );
+                return true;
+            }
+
+            /**
+             * Like std::map::insert(), move
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.<br>
+             * The store is only copied if the key is not contained yet.
+             * </p>
+             * @param x the value to be moved into
+             * @return true if inserted, otherwise false if the key is already contained.
+             */
+            constexpr_atomic
+            bool insert(value_type&& x) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                if( store_ref->contains(x.first) ) {
+                    return false;
+                }
+                storage_ref_t new_store_ref = copy_store_grow(1);
+                new_store_ref->insert( std::move(x) );
+                publish( std::move(new_store_ref) );
+                return true;
+            }
+
+            /**
+             * Like std::map::insert_or_assign(), inserts the given mapped value
+             * or assigns it to an existing element with the given key.
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             * @return true if inserted, otherwise false if assigned.
+             */
+            template<class M>
+            constexpr_atomic
+            bool insert_or_assign(const key_type& key, M&& obj) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                storage_ref_t new_store_ref = copy_store_grow(1);
+                const bool inserted = new_store_ref->insert_or_assign(key, std::forward<M>(obj)).second;
+                publish( std::move(new_store_ref) );
+                return inserted;
+            }
+
+            /**
+             * Bulk insertion of the value_type range [first, last), see jau::flat_map::insert(InputIt, InputIt).
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.<br>
+             * The store is copied once for all elements and only published if at least one element has been added.
+             * </p>
+             * @return number of newly added elements
+             */
+            template< class InputIt >
+            constexpr_atomic
+            size_type insert(InputIt first, InputIt last) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref );
+                const size_type count = new_store_ref->insert(first, last);
+                if( 0 < count ) {
+                    publish( std::move(new_store_ref) );
+                }
+                return count;
+            }
+
+            /**
+             * Like std::map::erase(), erasing the element with the given key.
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.<br>
+             * The store is only copied if the key is contained.
+             * </p>
+             * @return number of erased elements, either 0 or 1.
+             */
+            constexpr_atomic
+            size_type erase(const key_type& key) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                if( !store_ref->contains(key) ) {
+                    return 0;
+                }
+                storage_ref_t new_store_ref = copy_store_grow(0);
+                new_store_ref->erase(key);
+                publish( std::move(new_store_ref) );
+                return 1;
+            }
+
+            /**
+             * Erase all elements satisfying the given predicate in a single pass,
+             * see jau::darray::erase_if().
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.<br>
+             * The store is copied once and only published if at least one element has been erased.
+             * </p>
+             * @return number of erased elements
+             */
+            template<class UnaryPredicate>
+            constexpr_atomic
+            size_type erase_if(UnaryPredicate pred) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                storage_ref_t new_store_ref = copy_store_grow(0);
+                const size_type count = new_store_ref->erase_if(pred);
+                if( 0 < count ) {
+                    publish( std::move(new_store_ref) );
+                }
+                return count;
+            }
+
+            constexpr_cxx20 std::string toString() const noexcept {
+                return snapshot()->toString();
+            }
+
+            constexpr_cxx20 std::string get_info() const noexcept {
+                return ("cow_flat_map[this "+jau::to_hexstring(this)+
+                        ", "+snapshot()->get_info()+
+                        "]");
+            }
+    };
+
+    /****************************************************************************************
+     ****************************************************************************************/
+
+    template<typename Key, typename T, typename Compare, typename Alloc_type>
+    std::ostream & operator << (std::ostream &out, const cow_flat_map<Key, T, Compare, Alloc_type> &c) {
+        out << c.toString();
+        return out;
+    }
+
+} /* namespace jau */
+
+#endif /* JAU_COW_FLAT_MAP_HPP_ */
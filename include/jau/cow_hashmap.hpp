@@ -0,0 +1,625 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef JAU_COW_HASHMAP_HPP_
+#define JAU_COW_HASHMAP_HPP_
+
+#include <string>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <array>
+#include <functional>
+#include <utility>
+
+#include <jau/cpp_lang_util.hpp>
+#include <jau/basic_types.hpp>
+#include <jau/ordered_atomic.hpp>
+#include <jau/type_traits_queries.hpp>
+#include <jau/callocator.hpp>
+#include <jau/darray.hpp>
+#include <jau/epoch_reclaim.hpp>
+
+namespace jau {
+
+    /**
+     * Default hash function object of jau::cow_hashmap,
+     * using the key's <code>std::size_t hash_code() const</code> member if available, otherwise <code>std::hash<Key></code>.
+     */
+    template<typename Key>
+    struct hash_code_hash {
+        std::size_t operator()(const Key& key) const noexcept {
+            if constexpr ( jau::has_hash_code_v<Key> ) {
+                return key.hash_code();
+            } else {
+                return std::hash<Key>()(key);
+            }
+        }
+    };
+
+    /**
+     * Concurrent hash map for read-mostly use cases, exposing <i>lock-free</i> lookups
+     * and fine-grained write locking.
+     * <p>
+     * The map consists of a table of bucket slots, each atomically referencing an immutable bucket,
+     * a jau::darray of its key-value pairs.<br>
+     * A write operation copies the affected bucket only, mutates the copy
+     * and publishes it by atomically replacing the bucket reference,
+     * i.e. Copy-On-Write (CoW) on bucket granularity.
+     * </p>
+     * <p>
+     * Read operations are <i>lock-free</i>:
+     * Within a jau::epoch_domain critical section, readers load the table and bucket references
+     * using sequentially consistent (SC) atomic ordering and search the immutable bucket.<br>
+     * Replaced buckets and tables are retired via the stripe's jau::epoch_retire_list
+     * and released only after all readers have left their epoch.
+     * Hence readers neither lock nor modify a shared reference counter,
+     * scaling with the number of reader threads.
+     * </p>
+     * <p>
+     * Write operations on a single key lock one of <code>stripe_count</code> mutexes,
+     * selected by the key's hash, i.e. writers of different stripes don't block each other.<br>
+     * Each stripe retires its replaced buckets in batches, i.e. writers don't contend on a shared retire list.<br>
+     * Operations on the whole table, e.g. growing the table, clear() and erase_if(),
+     * lock all stripes and publish a new table.
+     * </p>
+     * <p>
+     * The table grows by doubling its bucket count if size() exceeds bucket_count().
+     * </p>
+     * <p>
+     * Since buckets are immutable once published, mapped values are retrieved by copy via get().
+     * There is no consistent snapshot of the whole map, for_each() visits each bucket's current state.
+     * </p>
+     * <p>
+     * Given functions, e.g. the predicate of erase_if(), shall not call mutating methods of this instance.
+     * </p>
+     * @tparam Key key type, must be copy constructible
+     * @tparam T mapped type, must be copy constructible
+     * @tparam Hash hash function object type, defaults to jau::hash_code_hash using the key's <code>hash_code()</code> if available
+     * @tparam KeyEqual key equality function object type
+     * @tparam Size_type size type, defaults to jau::nsize_t
+     * @see jau::cow_flat_map
+     * @see jau::epoch_domain
+     */
+    template <typename Key, typename T, typename Hash = jau::hash_code_hash<Key>, typename KeyEqual = std::equal_to<Key>,
+              typename Size_type = jau::nsize_t>
+    class cow_hashmap
+    {
+        public:
+            // typedefs' for C++ named requirements: UnorderedAssociativeContainer
+
+            typedef Key                                         key_type;
+            typedef T                                           mapped_type;
+            typedef std::pair<Key, T>                           value_type;
+            typedef Hash                                        hasher;
+            typedef KeyEqual                                    key_equal;
+            typedef const value_type&                           reference;
+            typedef const value_type&                           const_reference;
+            typedef Size_type                                   size_type;
+            typedef typename std::make_signed<size_type>::type  difference_type;
+
+            /** Number of write lock stripes, i.e. maximum number of concurrent writers on distinct keys. */
+            constexpr static const size_type stripe_count = 64;
+
+        private:
+            constexpr static const unsigned int stripe_bits = 6;
+            static_assert( ( size_type(1) << stripe_bits ) == stripe_count, "stripe_count must be 1 << stripe_bits" );
+
+            typedef darray<value_type, jau::callocator<value_type>, size_type> bucket_t;
+            typedef std::atomic<bucket_t*> slot_t;
+
+            /** Bucket table of <code>1 << bits</code> slots, owning its referenced buckets. */
+            struct table_t {
+                const unsigned int bits;
+                std::unique_ptr<slot_t[]> slots;
+
+                explicit table_t(const unsigned int bits_)
+                : bits(bits_), slots( new slot_t[ size_type(1) << bits_ ] ) {
+                    for(size_type i=0; i<bucket_count(); ++i) {
+                        slots[i].store(nullptr, std::memory_order_relaxed);
+                    }
+                }
+
+                ~table_t() noexcept {
+                    for(size_type i=0; i<bucket_count(); ++i) {
+                        delete slots[i].load(std::memory_order_relaxed);
+                    }
+                }
+
+                table_t(const table_t&) = delete;
+                table_t& operator=(const table_t&) = delete;
+
+                constexpr size_type bucket_count() const noexcept { return size_type(1) << bits; }
+
+                /** Returns the slot for the given mixed hash, using its upper bits. */
+                slot_t& slot_for(const uint64_t mhash) noexcept { return slots[ mhash >> ( 64 - bits ) ]; }
+            };
+
+            struct alignas(64) stripe_t {
+                std::mutex mtx;
+                /** Replaced buckets of this stripe, guarded by mtx. */
+                epoch_retire_list retired;
+            };
+
+            hasher hash_fn;
+            key_equal equal_fn;
+            std::atomic<table_t*> table;
+            /** Number of elements, relaxed atomic. */
+            std::atomic<size_type> count;
+            mutable std::array<stripe_t, stripe_count> stripes;
+
+            /** Fibonacci hashing, spreading the given hash value to the upper bits used for the table and stripe index. */
+            constexpr static uint64_t mix(const std::size_t h) noexcept {
+                return static_cast<uint64_t>(h) * UINT64_C(0x9E3779B97F4A7C15);
+            }
+
+            stripe_t& stripe_for(const uint64_t mhash) const noexcept {
+                return stripes[ mhash >> ( 64 - stripe_bits ) ];
+            }
+
+            /** RAII-style lock of all stripes, blocking all writers. */
+            class all_stripes_lock {
+                private:
+                    const cow_hashmap& map;
+                public:
+                    explicit all_stripes_lock(const cow_hashmap& m) noexcept
+                    : map(m) {
+                        for(stripe_t& s : map.stripes) { s.mtx.lock(); }
+                    }
+                    ~all_stripes_lock() noexcept {
+                        for(auto it = map.stripes.rbegin(); it != map.stripes.rend(); ++it) { it->mtx.unlock(); }
+                    }
+                    all_stripes_lock(const all_stripes_lock&) = delete;
+                    all_stripes_lock& operator=(const all_stripes_lock&) = delete;
+            };
+
+            const value_type* find_in(const bucket_t* b, const key_type& key) const {
+                if( nullptr != b ) {
+                    for(const value_type& e : *b) {
+                        if( equal_fn(e.first, key) ) {
+                            return &e;
+                        }
+                    }
+                }
+                return nullptr;
+            }
+
+            /** Returns a new mutable copy of the given bucket with capacity for <code>add</code> additional elements. */
+            static bucket_t* copy_bucket(const bucket_t* b, const size_type add) {
+                if( nullptr == b ) {
+                    return new bucket_t(add);
+                }
+                return new bucket_t(*b, b->size() + add, b->growth_factor(), b->get_allocator_ref());
+            }
+
+            /** Publishes the given bucket, retiring the replaced one. Caller must hold the given stripe's lock. */
+            static void publish_bucket(stripe_t& stripe, slot_t& slot, std::unique_ptr<bucket_t>&& nb) {
+                stripe.retired.prepare();
+                bucket_t* ob = slot.load();
+                slot.store( nb.release() );
+                if( nullptr != ob ) {
+                    stripe.retired.retire(ob);
+                }
+            }
+
+            /** Publishes the given table, retiring the replaced one and reclaiming all stripe's retired data. Caller must hold all stripe locks. */
+            void publish_table(std::unique_ptr<table_t>&& nt) {
+                stripes[0].retired.prepare();
+                table_t* ot = table.load();
+                table.store( nt.release() );
+                stripes[0].retired.retire(ot);
+                for(stripe_t& st : stripes) {
+                    st.retired.reclaim();
+                }
+            }
+
+            /** Adds the given element to the mutable table w/o publishing its buckets, used to populate a new table. */
+            void add_to(table_t& t, const value_type& x) {
+                slot_t& slot = t.slot_for( mix( hash_fn(x.first) ) );
+                bucket_t* b = slot.load(std::memory_order_relaxed);
+                if( nullptr == b ) {
+                    b = new bucket_t(1);
+                    slot.store(b, std::memory_order_relaxed);
+                }
+                b->push_back(x);
+            }
+
+            /** Returns the minimum table bits for the given bucket count, at least stripe_bits. */
+            static unsigned int bits_for(const size_type n) noexcept {
+                unsigned int bits = stripe_bits;
+                while( ( size_type(1) << bits ) < n && bits < sizeof(size_type)*8 - 1 ) {
+                    ++bits;
+                }
+                return bits;
+            }
+
+            /** Rebuilds the table with <code>1 << bits</code> buckets, caller must hold all stripe locks. */
+            void rehash_locked(const unsigned int bits) {
+                table_t* ot = table.load();
+                if( bits == ot->bits ) {
+                    return;
+                }
+                std::unique_ptr<table_t> nt( new table_t(bits) );
+                for(size_type i=0; i<ot->bucket_count(); ++i) {
+                    const bucket_t* b = ot->slots[i].load();
+                    if( nullptr != b ) {
+                        for(const value_type& e : *b) {
+                            add_to(*nt, e);
+                        }
+                    }
+                }
+                publish_table( std::move(nt) );
+            }
+
+            /** Returns true if size() exceeds bucket_count(), caller must hold at least one stripe lock. */
+            bool grow_required() const noexcept {
+                return count.load(std::memory_order_relaxed) > table.load()->bucket_count();
+            }
+
+            /** Grows the table if size() exceeds bucket_count(), caller must not hold any stripe lock. */
+            void grow() {
+                all_stripes_lock lock(*this);
+                if( grow_required() ) {
+                    rehash_locked( table.load()->bits + 1 );
+                }
+            }
+
+            template<class V>
+            bool insert_impl(V&& x) {
+                const uint64_t mh = mix( hash_fn(x.first) );
+                bool do_grow;
+                {
+                    stripe_t& stripe = stripe_for(mh);
+                    std::lock_guard<std::mutex> lock( stripe.mtx );
+                    slot_t& slot = table.load()->slot_for(mh);
+                    const bucket_t* b = slot.load();
+                    if( nullptr != find_in(b, x.first) ) {
+                        return false;
+                    }
+                    std::unique_ptr<bucket_t> nb( copy_bucket(b, 1) );
+                    nb->push_back( std::forward<V>(x) );
+                    publish_bucket(stripe, slot, std::move(nb));
+                    count.fetch_add(1, std::memory_order_relaxed);
+                    do_grow = grow_required();
+                }
+                if( do_grow ) {
+                    grow();
+                }
+                return true;
+            }
+
+        public:
+            /**
+             * Creates an empty instance with at least the given number of buckets, at least stripe_count.
+             */
+            explicit cow_hashmap(const size_type bucket_count_ = stripe_count, const hasher& hash = hasher(), const key_equal& equal = key_equal())
+            : hash_fn(hash), equal_fn(equal), table( new table_t( bits_for(bucket_count_) ) ), count(0) {}
+
+            /**
+             * Creates a new instance from an initializer list.
+             */
+            cow_hashmap(std::initializer_list<value_type> initlist)
+            : cow_hashmap( static_cast<size_type>( initlist.size() ) ) {
+                insert(initlist.begin(), initlist.end());
+            }
+
+            /**
+             * Destruction, shall not happen concurrently with any other operation of this instance.
+             */
+            ~cow_hashmap() noexcept {
+                delete table.load();
+            }
+
+            cow_hashmap(const cow_hashmap&) = delete;
+            cow_hashmap& operator=(const cow_hashmap&) = delete;
+            cow_hashmap(cow_hashmap&&) = delete;
+            cow_hashmap& operator=(cow_hashmap&&) = delete;
+
+            // read access
+
+            /**
+             * Like std::unordered_map::size(), relaxed atomic.
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             */
+            size_type size() const noexcept { return count.load(std::memory_order_relaxed); }
+
+            /**
+             * Like std::unordered_map::empty(), relaxed atomic.
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             */
+            bool empty() const noexcept { return 0 == count.load(std::memory_order_relaxed); }
+
+            /**
+             * Like std::unordered_map::bucket_count().
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             */
+            size_type bucket_count() const noexcept {
+                epoch_guard guard;
+                return table.load()->bucket_count();
+            }
+
+            /**
+             * Like std::unordered_map::contains() of C++20.
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             */
+            bool contains(const key_type& key) const {
+                const uint64_t mh = mix( hash_fn(key) );
+                epoch_guard guard;
+                return nullptr != find_in( table.load()->slot_for(mh).load(), key );
+            }
+
+            /**
+             * Copies the mapped value of the given key into <code>res</code>, if contained.
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             * @param key the key to look up
+             * @param res storage for the mapped value, only written if the key is contained
+             * @return true if the key is contained, otherwise false
+             */
+            bool get(const key_type& key, mapped_type& res) const {
+                const uint64_t mh = mix( hash_fn(key) );
+                epoch_guard guard;
+                const value_type* e = find_in( table.load()->slot_for(mh).load(), key );
+                if( nullptr != e ) {
+                    res = e->second;
+                    return true;
+                }
+                return false;
+            }
+
+            /**
+             * Invokes the given function for each element, bucket by bucket.
+             * <p>
+             * Each bucket is visited in its current immutable state,
+             * concurrent writes to other buckets may or may not be visible.
+             * </p>
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             * @tparam UnaryFunction function type, callable as <code>void f(const value_type&)</code>
+             */
+            template<class UnaryFunction>
+            UnaryFunction for_each(UnaryFunction f) const {
+                epoch_guard guard;
+                table_t* t = table.load();
+                for(size_type i=0; i<t->bucket_count(); ++i) {
+                    const bucket_t* b = t->slots[i].load();
+                    if( nullptr != b ) {
+                        for(const value_type& e : *b) {
+                            f(e);
+                        }
+                    }
+                }
+                return f;
+            }
+
+            // write access
+
+            /**
+             * Like std::unordered_map::insert(), copy
+             * <p>
+             * This write operation locks the key's stripe only and copies its bucket, if the key is not contained yet.
+             * </p>
+             * @param x the value to be inserted
+             * @return true if inserted, otherwise false if the key is already contained.
+             */
+            bool insert(const value_type& x) { return insert_impl(x); }
+
+            /**
+             * Like std::unordered_map::insert(), move
+             * <p>
+             * This write operation locks the key's stripe only and copies its bucket, if the key is not contained yet.
+             * </p>
+             * @param x the value to be moved into
+             * @return true if inserted, otherwise false if the key is already contained.
+             */
+            bool insert(value_type&& x) { return insert_impl( std::move(x) ); }
+
+            /**
+             * Inserts all elements of the value_type range [first, last) not contained yet, see insert().
+             * @return number of newly added elements
+             */
+            template< class InputIt >
+            size_type insert(InputIt first, InputIt last) {
+                size_type res = 0;
+                for(; first != last; ++first) {
+                    if( insert_impl(*first) ) {
+                        ++res;
+                    }
+                }
+                return res;
+            }
+
+            /**
+             * Like std::unordered_map::insert_or_assign(), inserts the given mapped value
+             * or assigns it to an existing element with the given key.
+             * <p>
+             * This write operation locks the key's stripe only and copies its bucket.
+             * </p>
+             * @return true if inserted, otherwise false if assigned.
+             */
+            template<class M>
+            bool insert_or_assign(const key_type& key, M&& obj) {
+                const uint64_t mh = mix( hash_fn(key) );
+                bool do_grow;
+                {
+                    stripe_t& stripe = stripe_for(mh);
+                    std::lock_guard<std::mutex> lock( stripe.mtx );
+                    slot_t& slot = table.load()->slot_for(mh);
+                    std::unique_ptr<bucket_t> nb( copy_bucket(slot.load(), 1) );
+                    for(value_type& e : *nb) {
+                        if( equal_fn(e.first, key) ) {
+                            e.second = std::forward<M>(obj);
+                            publish_bucket(stripe, slot, std::move(nb));
+                            return false;
+                        }
+                    }
+                    nb->push_back( value_type( key, std::forward<M>(obj) ) );
+                    publish_bucket(stripe, slot, std::move(nb));
+                    count.fetch_add(1, std::memory_order_relaxed);
+                    do_grow = grow_required();
+                }
+                if( do_grow ) {
+                    grow();
+                }
+                return true;
+            }
+
+            /**
+             * Like std::unordered_map::erase(), erasing the element with the given key.
+             * <p>
+             * This write operation locks the key's stripe only and copies its bucket, if the key is contained.
+             * </p>
+             * @return number of erased elements, either 0 or 1.
+             */
+            size_type erase(const key_type& key) {
+                const uint64_t mh = mix( hash_fn(key) );
+                stripe_t& stripe = stripe_for(mh);
+                std::lock_guard<std::mutex> lock( stripe.mtx );
+                slot_t& slot = table.load()->slot_for(mh);
+                const bucket_t* b = slot.load();
+                if( nullptr == find_in(b, key) ) {
+                    return 0;
+                }
+                std::unique_ptr<bucket_t> nb;
+                if( 1 < b->size() ) {
+                    nb = std::unique_ptr<bucket_t>( new bucket_t( b->size() - 1 ) );
+                    for(const value_type& e : *b) {
+                        if( !equal_fn(e.first, key) ) {
+                            nb->push_back(e);
+                        }
+                    }
+                }
+                publish_bucket(stripe, slot, std::move(nb));
+                count.fetch_sub(1, std::memory_order_relaxed);
+                return 1;
+            }
+
+            /**
+             * Erase all elements satisfying the given predicate.
+             * <p>
+             * This write operation locks all stripes and publishes a new table,
+             * if at least one element has been erased.
+             * </p>
+             * @tparam UnaryPredicate predicate type, callable as <code>bool pred(const value_type&)</code>
+             * @param pred the predicate returning true for elements to be erased, invoked exactly once per element
+             * @return number of erased elements
+             */
+            template<class UnaryPredicate>
+            size_type erase_if(UnaryPredicate pred) {
+                all_stripes_lock lock(*this);
+                table_t* ot = table.load();
+                std::unique_ptr<table_t> nt( new table_t(ot->bits) );
+                size_type erased = 0;
+                for(size_type i=0; i<ot->bucket_count(); ++i) {
+                    const bucket_t* b = ot->slots[i].load();
+                    if( nullptr != b ) {
+                        for(const value_type& e : *b) {
+                            if( pred(e) ) {
+                                ++erased;
+                            } else {
+                                add_to(*nt, e);
+                            }
+                        }
+                    }
+                }
+                if( 0 < erased ) {
+                    publish_table( std::move(nt) );
+                    count.fetch_sub(erased, std::memory_order_relaxed);
+                }
+                return erased;
+            }
+
+            /**
+             * Like std::unordered_map::clear(), keeping the bucket count.
+             * <p>
+             * This write operation locks all stripes and publishes a new table.
+             * </p>
+             */
+            void clear() {
+                all_stripes_lock lock(*this);
+                publish_table( std::unique_ptr<table_t>( new table_t( table.load()->bits ) ) );
+                count.store(0, std::memory_order_relaxed);
+            }
+
+            /**
+             * Like std::unordered_map::reserve(), growing the table to at least the given number of buckets.
+             * <p>
+             * This write operation locks all stripes and publishes a new table, if growing.
+             * </p>
+             */
+            void reserve(const size_type n) {
+                all_stripes_lock lock(*this);
+                const unsigned int bits = bits_for(n);
+                if( bits > table.load()->bits ) {
+                    rehash_locked(bits);
+                }
+            }
+
+            std::string toString() const {
+                std::string res("{ " + std::to_string( size() ) + ": ");
+                int i=0;
+                for_each( [&res, &i](const value_type& e) {
+                    if( 1 < ++i ) { res.append(", "); }
+                    res.append( "[" + jau::to_string(e.first) + ": " + jau::to_string(e.second) + "]" );
+                } );
+                res.append(" }");
+                return res;
+            }
+
+            std::string get_info() const {
+                return ("cow_hashmap[this "+jau::to_hexstring(this)+
+                        ", size "+std::to_string(size())+
+                        ", buckets "+std::to_string(bucket_count())+
+                        "]");
+            }
+    };
+
+    /****************************************************************************************
+     ****************************************************************************************/
+
+    template<typename Key, typename T, typename Hash, typename KeyEqual, typename Size_type>
+    std::ostream & operator << (std::ostream &out, const cow_hashmap<Key, T, Hash, KeyEqual, Size_type> &c) {
+        out << c.toString();
+        return out;
+    }
+
+} /* namespace jau */
+
+/** \example test_cow_hashmap01.cpp
+ * This C++ unit test validates the jau::cow_hashmap implementation with concurrent readers and writers.
+ */
+
+#endif /* JAU_COW_HASHMAP_HPP_ */
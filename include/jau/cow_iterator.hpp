@@ -651,6 +651,7 @@ namespace jau {
         friend cow_rw_iterator<Storage_type, Storage_ref_type, CoW_container>;
         template<typename, typename, typename, bool, bool, bool> friend class cow_darray;
         template<typename, typename> friend class cow_vector;
+        template<typename, typename, unsigned int> friend class cow_pvector;
 
         public:
             typedef Storage_type                                storage_t;
@@ -0,0 +1,687 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef JAU_COW_PVECTOR_HPP_
+#define JAU_COW_PVECTOR_HPP_
+
+#include <cstring>
+#include <string>
+#include <cstdint>
+#include <limits>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <algorithm>
+
+#include <jau/cpp_lang_util.hpp>
+#include <jau/debug.hpp>
+#include <jau/basic_types.hpp>
+#include <jau/ordered_atomic.hpp>
+#include <jau/pvector.hpp>
+#include <jau/basic_algos.hpp>
+#include <jau/cow_iterator.hpp>
+#include <jau/cow_transaction.hpp>
+
+namespace jau {
+
+    /**
+     * Implementation of a Copy-On-Write (CoW) using jau::pvector as the underlying storage,
+     * exposing <i>lock-free</i> read operations using SC-DRF atomic synchronization.
+     * <p>
+     * Other than jau::cow_darray, the store is a persistent vector sharing its fixed-size chunks
+     * between the current and all previous stores.
+     * Copy-on-write hence copies the touched chunk and its path only, i.e. <code>O(log n)</code>,
+     * instead of the whole array.<br>
+     * This suits large lists with frequent single-element writes, e.g. set(), push_back() and pop_back(),
+     * at the cost of <code>O(log n)</code> random access and less cache locality for iteration.
+     * </p>
+     * <p>
+     * The store is owned using a shared reference to the data structure,
+     * allowing its replacement on Copy-On-Write (CoW).<br>
+     * Replaced stores remain valid immutable snapshots for their readers.
+     * </p>
+     * <p>
+     * Writing to the store utilizes a mutex lock to avoid data races
+     * on the instances' write operations only, leaving read operations <i>lock-free</i>.<br>
+     * Write operations replace the store reference with a new instance using
+     * jau::sc_atomic_critical to synchronize with read operations.
+     * </p>
+     * <p>
+     * Reading from the store is <i>lock-free</i> and accesses the store reference using
+     * jau::sc_atomic_critical to synchronizing with write operations.
+     * </p>
+     * <p>
+     * Immutable storage const_iterators are supported via jau::cow_ro_iterator,
+     * which are constructed <i>lock-free</i>.<br>
+     * jau::cow_ro_iterator hold a snapshot retrieved via jau::cow_pvector::snapshot()
+     * until its destruction.
+     * </p>
+     * <p>
+     * Mutable storage iterators are not supported, use set(), transaction()
+     * or jau::cow_pvector::get_write_mutex(), jau::cow_pvector::copy_store() and jau::cow_pvector::set_store().
+     * </p>
+     * <p>
+     * Index operations return a copy of the element via get(size_type),
+     * as a reference would only be valid as long as its snapshot.
+     * </p>
+     * @tparam Value_type element type, must be copy constructible
+     * @tparam Size_type size type, defaults to jau::nsize_t
+     * @tparam Chunk_bits number of bits per trie level of jau::pvector, defaults to 5 for 32 elements per chunk
+     * @see jau::pvector
+     * @see jau::cow_darray
+     * @see jau::cow_ro_iterator
+     * @see jau::cow_transaction
+     */
+    template <typename Value_type, typename Size_type = jau::nsize_t, unsigned int Chunk_bits = 5>
+    class cow_pvector
+    {
+        public:
+            // typedefs' for C++ named requirements: Container
+
+            typedef Value_type                                  value_type;
+            typedef value_type*                                 pointer;
+            typedef const value_type*                           const_pointer;
+            typedef value_type&                                 reference;
+            typedef const value_type&                           const_reference;
+            typedef Size_type                                   size_type;
+            typedef typename std::make_signed<size_type>::type  difference_type;
+
+            typedef pvector<value_type, size_type, Chunk_bits>  storage_t;
+            typedef std::shared_ptr<storage_t>                  storage_ref_t;
+
+            typedef cow_pvector<value_type, size_type, Chunk_bits> cow_container_t;
+
+            /**
+             * Immutable, read-only const_iterator, lock-free,
+             * holding the current shared store reference until destruction.
+             * <p>
+             * Using jau::cow_pvector::snapshot() at construction.
+             * </p>
+             * @see jau::cow_ro_iterator
+             */
+            typedef cow_ro_iterator<storage_t, storage_ref_t, cow_container_t> const_iterator;
+
+            /**
+             * Write transaction, holding the write-lock and a store copy until commit, rollback or destruction.
+             * <p>
+             * The store copy shares all chunks, which are copied on their first mutation only.
+             * </p>
+             * @see jau::cow_transaction
+             * @see jau::cow_pvector::transaction()
+             */
+            typedef cow_transaction<storage_t, storage_ref_t, cow_container_t> transaction_t;
+
+        private:
+            static constexpr size_type DIFF_MAX = std::numeric_limits<difference_type>::max();
+
+            storage_ref_t store_ref;
+            mutable sc_atomic_bool sync_atomic;
+            mutable std::recursive_mutex mtx_write;
+
+            template<typename, typename, typename> friend class cow_transaction;
+
+            /** True while a transaction() is open, guarded by mtx_write. */
+            bool transaction_open = false;
+
+            /**
+             * Throws jau::IllegalStateException if a transaction() is open. Caller must hold mtx_write.
+             * <p>
+             * Only the thread holding the open transaction may pass the recursive write lock,
+             * whose mutation would be silently overwritten by the transaction's commit.
+             * </p>
+             */
+            void check_transaction() const {
+                if( transaction_open ) {
+                    throw jau::IllegalStateException("write operation while transaction is open", E_FILE_LINE);
+                }
+            }
+
+            /**
+             * Aborts if a transaction() is open, used by the noexcept write operations. Caller must hold mtx_write.
+             * <p>
+             * See check_transaction().
+             * </p>
+             */
+            void check_transaction_noexcept() const noexcept {
+                if( transaction_open ) {
+                    ABORT("write operation while transaction is open");
+                }
+            }
+
+            /** Replaces the store with the given one. Caller must hold mtx_write. */
+            void replace_store(storage_ref_t && new_store_ref) noexcept {
+                sc_atomic_critical sync(sync_atomic);
+                store_ref = std::move(new_store_ref);
+            }
+
+        public:
+            // ctor w/o elements
+
+            /**
+             * Default constructor, giving an empty store.
+             */
+            cow_pvector()
+            : store_ref( std::make_shared<storage_t>() ), sync_atomic(false) {}
+
+            // conversion ctor on storage_t elements
+
+            /**
+             * Creates a new instance sharing all chunks with the given store, O(1).
+             */
+            explicit cow_pvector(const storage_t& x)
+            : store_ref( std::make_shared<storage_t>(x) ), sync_atomic(false) {}
+
+            // copy_ctor on cow_pvector elements
+
+            /**
+             * Creates a new instance sharing all chunks with the given instance's current store, O(1).
+             * <p>
+             * Only the given instance's store reference is read, <i>lock-free</i>.
+             * </p>
+             */
+            cow_pvector(const cow_pvector& x)
+            : sync_atomic(false) {
+                storage_ref_t x_store_ref = x.snapshot();
+                store_ref = std::make_shared<storage_t>( *x_store_ref );
+            }
+
+            /**
+             * Like std::vector::operator=(&), assignment, O(1) sharing all chunks.
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             */
+            cow_pvector& operator=(const cow_pvector& x) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                storage_ref_t x_store_ref = x.snapshot();
+                replace_store( std::make_shared<storage_t>( *x_store_ref ) );
+                return *this;
+            }
+
+            // move_ctor on cow_pvector elements
+
+            cow_pvector(cow_pvector && x) noexcept
+            : sync_atomic(false) {
+                // Strategy-1: Acquire lock, blocking, see jau::cow_darray
+                std::unique_lock<std::recursive_mutex> lock(x.mtx_write); // *this doesn't exist yet, not locking ourselves
+                store_ref = std::move(x.store_ref);
+                // Moved source array has been taken over, null its store_ref
+                x.store_ref = nullptr;
+            }
+
+            /**
+             * Like std::vector::operator=(&&), move.
+             * <p>
+             * This write operation uses a mutex lock and is blocking both cow_pvector instance's write operations.
+             * </p>
+             */
+            cow_pvector& operator=(cow_pvector&& x) noexcept {
+                // Strategy-2: Acquire locks of both, blocking, see jau::cow_darray
+                std::unique_lock<std::recursive_mutex> lock1(x.mtx_write, std::defer_lock); // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
+                std::unique_lock<std::recursive_mutex> lock2(  mtx_write, std::defer_lock); // otherwise RAII-style relinquish via destructor
+                std::lock(lock1, lock2);
+                check_transaction_noexcept();
+                x.check_transaction_noexcept();
+                {
+                    sc_atomic_critical sync_x( x.sync_atomic );
+                    replace_store( std::move(x.store_ref) );
+                    // Moved source array has been taken over, null its store_ref
+                    x.store_ref = nullptr;
+                }
+                return *this;
+            }
+
+            /**
+             * Creates a new instance,
+             * copying all elements from the given template input-iterator value_type range [first, last).
+             * @tparam InputIt template input-iterator custom type
+             * @param first template input-iterator to first element of value_type range [first, last)
+             * @param last template input-iterator to last element of value_type range [first, last)
+             */
+            template< class InputIt >
+            cow_pvector(InputIt first, InputIt last)
+            : store_ref( std::make_shared<storage_t>(first, last) ), sync_atomic(false) {}
+
+            /**
+             * Create a new instance from an initializer list.
+             * @param initlist initializer_list.
+             */
+            cow_pvector(std::initializer_list<value_type> initlist)
+            : store_ref( std::make_shared<storage_t>(initlist) ), sync_atomic(false) {}
+
+            ~cow_pvector() noexcept {}
+
+            /**
+             * Returns <code>std::numeric_limits<difference_type>::max()</code> as the maximum array size.
+             */
+            constexpr size_type max_size() const noexcept { return DIFF_MAX; }
+
+            // cow_vector features
+
+            /**
+             * Returns this instances' recursive write mutex, allowing user to
+             * implement more complex mutable write operations.
+             * <p>
+             * See example in jau::cow_darray::set_store()
+             * </p>
+             *
+             * @see jau::cow_pvector::get_write_mutex()
+             * @see jau::cow_pvector::copy_store()
+             * @see jau::cow_pvector::set_store()
+             */
+            constexpr std::recursive_mutex & get_write_mutex() noexcept { return mtx_write; }
+
+            /**
+             * Returns a new shared_ptr copy of the underlying store,
+             * sharing all chunks with the current store, O(1).
+             * <p>
+             * Mutations of the returned copy only copy the touched chunks and their path.
+             * </p>
+             * <p>
+             * This special operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             * @see jau::cow_pvector::get_write_mutex()
+             * @see jau::cow_pvector::copy_store()
+             * @see jau::cow_pvector::set_store()
+             */
+            storage_ref_t copy_store() {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                return std::make_shared<storage_t>( *store_ref );
+            }
+
+            /**
+             * Replace the current store with the given instance,
+             * potentially acquired via jau::cow_pvector::copy_store()
+             * and mutated while holding the jau::cow_pvector::get_write_mutex() lock.
+             * <p>
+             * This is a move operation, i.e. the given new_store_ref is invalid on the caller side
+             * after this operation. See example in jau::cow_darray::set_store().
+             * </p>
+             * @param new_store_ref the user store to be moved here, replacing the current store.
+             *
+             * @see jau::cow_pvector::get_write_mutex()
+             * @see jau::cow_pvector::copy_store()
+             * @see jau::cow_pvector::set_store()
+             */
+            void set_store(storage_ref_t && new_store_ref) noexcept {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction_noexcept();
+                replace_store( std::move(new_store_ref) );
+            }
+
+            /**
+             * Returns the current snapshot of the underlying shared jau::pvector reference.
+             * <p>
+             * Note that this snapshot will be outdated by the next (concurrent) write operation.<br>
+             * The returned referenced pvector is still valid and not mutated,
+             * but does not represent the current content of this cow_pvector instance.
+             * </p>
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             */
+            storage_ref_t snapshot() const noexcept {
+                sc_atomic_critical sync( sync_atomic );
+                return store_ref;
+            }
+
+            // const_iterator, non mutable, read-only
+
+            /**
+             * Returns an jau::cow_ro_iterator to the first element of this CoW storage.
+             * <p>
+             * See description in jau::cow_darray::cbegin()
+             * </p>
+             * @return jau::cow_pvector::const_iterator of type jau::cow_ro_iterator
+             * @see jau::cow_ro_iterator
+             */
+            const_iterator cbegin() const noexcept {
+                storage_ref_t sr = snapshot();
+                return const_iterator(sr, sr->cbegin());
+            }
+
+            /**
+             * Returns a new jau::cow_transaction, batching multiple mutations into a single copy-on-write.
+             * <p>
+             * The transaction's store copy shares all chunks with the current store,
+             * copying each touched chunk and its path at most once.
+             * </p>
+             * @return jau::cow_pvector::transaction_t of type jau::cow_transaction
+             * @see jau::cow_darray::transaction()
+             * @see jau::cow_transaction
+             */
+            transaction_t transaction() {
+                return transaction_t(*this);
+            }
+
+            // read access
+
+            /**
+             * Like std::vector::empty().
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             */
+            bool empty() const noexcept {
+                sc_atomic_critical sync( sync_atomic );
+                return store_ref->empty();
+            }
+
+            /**
+             * Like std::vector::size().
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             */
+            size_type size() const noexcept {
+                sc_atomic_critical sync( sync_atomic );
+                return store_ref->size();
+            }
+
+            /**
+             * Returns a copy of the element at given index of the current store, O(log n).
+             * <p>
+             * Throws jau::IndexOutOfBoundsException if index is not less than size().
+             * </p>
+             * <p>
+             * This read operation is <i>lock-free</i>.
+             * </p>
+             */
+            value_type get(const size_type i) const {
+                storage_ref_t sr = snapshot();
+                return sr->at(i);
+            }
+
+            // write access
+
+            /**
+             * Like std::vector::clear().
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             */
+            void clear() {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                replace_store( std::make_shared<storage_t>() );
+            }
+
+            /**
+             * Like std::vector::swap().
+             * <p>
+             * This write operation uses a mutex lock and is blocking both cow_pvector instance's write operations.
+             * </p>
+             */
+            void swap(cow_pvector& x) noexcept {
+                std::unique_lock<std::recursive_mutex> lock(mtx_write, std::defer_lock); // utilize std::lock(a, b), allowing mixed order waiting on either object
+                std::unique_lock<std::recursive_mutex> lock_x(x.mtx_write, std::defer_lock); // otherwise RAII-style relinquish via destructor
+                std::lock(lock, lock_x);
+                check_transaction_noexcept();
+                x.check_transaction_noexcept();
+                {
+                    sc_atomic_critical sync_x( x.sync_atomic );
+                    sc_atomic_critical sync(sync_atomic);
+                    store_ref.swap(x.store_ref);
+                }
+            }
+
+            /**
+             * Replaces the element at given index with a copy of the given value.
+             * <p>
+             * Copies the touched chunk and its path only, O(log n).
+             * </p>
+             * <p>
+             * Throws jau::IndexOutOfBoundsException if index is not less than size().
+             * </p>
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             */
+            void set(const size_type i, const value_type& x) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref );
+                new_store_ref->set(i, x);
+                replace_store( std::move(new_store_ref) );
+            }
+
+            /**
+             * Replaces the element at given index with the given value, moved.
+             * <p>
+             * See set(size_type, const value_type&).
+             * </p>
+             */
+            void set(const size_type i, value_type&& x) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref );
+                new_store_ref->set(i, std::move(x));
+                replace_store( std::move(new_store_ref) );
+            }
+
+            /**
+             * Like std::vector::pop_back(), O(log n).
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             */
+            void pop_back() {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                if( !store_ref->empty() ) {
+                    storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref );
+                    new_store_ref->pop_back();
+                    replace_store( std::move(new_store_ref) );
+                }
+            }
+
+            /**
+             * Like std::vector::push_back(), copy, O(log n).
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             * @param x the value to be added at the tail.
+             */
+            void push_back(const value_type& x) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref );
+                new_store_ref->push_back(x);
+                replace_store( std::move(new_store_ref) );
+            }
+
+            /**
+             * Like std::vector::push_back(), move, O(log n).
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             * @param x the value to be added at the tail.
+             */
+            void push_back(value_type&& x) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref );
+                new_store_ref->push_back( std::move(x) );
+                replace_store( std::move(new_store_ref) );
+            }
+
+            /**
+             * Like std::vector::emplace_back(), construct a new element in place at the end(), O(log n).
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             * @param args arguments to forward to the constructor of the element
+             */
+            template<typename... Args>
+            reference emplace_back(Args&&... args) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref );
+                reference res = new_store_ref->emplace_back( std::forward<Args>(args)... );
+                replace_store( std::move(new_store_ref) );
+                return res;
+            }
+
+            /**
+             * Like std::vector::push_back(), but appends the whole value_type range [first, last),
+             * using a single copy-on-write.
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             * @tparam InputIt foreign input-iterator to range of value_type [first, last)
+             * @param first first foreign input-iterator to range of value_type [first, last)
+             * @param last last foreign input-iterator to range of value_type [first, last)
+             */
+            template< class InputIt >
+            void push_back( InputIt first, InputIt last ) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref );
+                new_store_ref->push_back(first, last);
+                replace_store( std::move(new_store_ref) );
+            }
+
+            /**
+             * Like std::erase_if(std::vector&, pred), removes all elements for which the given predicate returns true.
+             * <p>
+             * All chunks before the first erased element stay shared with the current store, see jau::pvector::erase_if().
+             * </p>
+             * <p>
+             * This write operation uses a mutex lock and is blocking this instances' write operations only.
+             * </p>
+             * @tparam UnaryPredicate predicate type, callable as <code>bool pred(const value_type&)</code>
+             * @param pred the predicate returning true for elements to be erased, invoked exactly once per element
+             * @return number of erased elements
+             */
+            template<class UnaryPredicate>
+            size_type erase_if(UnaryPredicate pred) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                storage_ref_t new_store_ref = std::make_shared<storage_t>( *store_ref );
+                const size_type count = new_store_ref->erase_if(pred);
+                if( 0 < count ) {
+                    replace_store( std::move(new_store_ref) );
+                }
+                return count;
+            }
+
+            /**
+             * Generic value_type equal comparator to be user defined for e.g. jau::cow_pvector::push_back_unique().
+             * @param a one element of the equality test.
+             * @param b the other element of the equality test.
+             * @return true if both are equal
+             */
+            typedef bool(*equal_comparator)(const value_type& a, const value_type& b);
+
+            /**
+             * Like std::vector::push_back(), but only if the newly added element does not yet exist.
+             * <p>
+             * See description in jau::cow_darray::push_back_unique()
+             * </p>
+             * @param x the value to be added at the tail, if not existing yet.
+             * @param comparator the equal comparator to return true if both given elements are equal
+             * @return true if the element has been uniquely added, otherwise false
+             */
+            bool push_back_unique(const value_type& x, equal_comparator comparator) {
+                std::lock_guard<std::recursive_mutex> lock(mtx_write);
+                check_transaction();
+                for(auto it = store_ref->cbegin(); it != store_ref->cend(); ++it) {
+                    if( comparator( *it, x ) ) {
+                        return false; // already included
+                    }
+                }
+                push_back(x);
+                return true;
+            }
+
+            /**
+             * Erase either the first matching element or all matching elements.
+             * <p>
+             * See description in jau::cow_darray::erase_matching()
+             * </p>
+             * @param x the value to be erased
+             * @param all_matching if true, erase all matching elements, otherwise only the first matching element.
+             * @param comparator the equal comparator to return true if both given elements are equal
+             * @return number of erased elements
+             */
+            int erase_matching(const value_type& x, const bool all_matching, equal_comparator comparator) {
+                bool done = false;
+                return static_cast<int>( erase_if( [&](const value_type& e) -> bool {
+                    if( !done && comparator( e, x ) ) {
+                        done = !all_matching;
+                        return true;
+                    }
+                    return false;
+                } ) );
+            }
+
+            constexpr_cxx20 std::string toString() const noexcept {
+                std::string res("{ " + std::to_string( size() ) + ": ");
+                int i=0;
+                jau::for_each_const(*this, [&res, &i](const value_type & e) {
+                    if( 1 < ++i ) { res.append(", "); }
+                    res.append( jau::to_string(e) );
+                } );
+                res.append(" }");
+                return res;
+            }
+
+            constexpr_cxx20 std::string get_info() const noexcept {
+                return ("cow_pvector[this "+jau::to_hexstring(this)+
+                        ", "+snapshot()->get_info()+
+                        "]");
+            }
+    };
+
+    /****************************************************************************************
+     ****************************************************************************************/
+
+    template<typename Value_type, typename Size_type, unsigned int Chunk_bits>
+    std::ostream & operator << (std::ostream &out, const cow_pvector<Value_type, Size_type, Chunk_bits> &c) {
+        out << c.toString();
+        return out;
+    }
+
+    template<typename Value_type, typename Size_type, unsigned int Chunk_bits>
+    inline bool operator==(const cow_pvector<Value_type, Size_type, Chunk_bits>& rhs, const cow_pvector<Value_type, Size_type, Chunk_bits>& lhs) {
+        if( &rhs == &lhs ) {
+            return true;
+        }
+        return *rhs.snapshot() == *lhs.snapshot();
+    }
+    template<typename Value_type, typename Size_type, unsigned int Chunk_bits>
+    inline bool operator!=(const cow_pvector<Value_type, Size_type, Chunk_bits>& rhs, const cow_pvector<Value_type, Size_type, Chunk_bits>& lhs) {
+        return !(rhs==lhs);
+    }
+
+    template<typename Value_type, typename Size_type, unsigned int Chunk_bits>
+    inline void swap(cow_pvector<Value_type, Size_type, Chunk_bits>& rhs, cow_pvector<Value_type, Size_type, Chunk_bits>& lhs) noexcept
+    { rhs.swap(lhs); }
+
+} /* namespace jau */
+
+#endif /* JAU_COW_PVECTOR_HPP_ */
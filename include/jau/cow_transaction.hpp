@@ -0,0 +1,177 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef JAU_COW_TRANSACTION_HPP_
+#define JAU_COW_TRANSACTION_HPP_
+
+#include <mutex>
+#include <utility>
+
+#include <jau/cpp_lang_util.hpp>
+#include <jau/basic_types.hpp>
+
+namespace jau {
+
+    /**
+     * Copy-On-Write (CoW) write transaction, batching multiple mutations into a single copy-on-write.<br>
+     * Instance holds a copy of the parents' CoW storage and locks its write mutex until
+     * commit(), rollback() or destruction.
+     * <p>
+     * The full mutable API of the storage is exposed via store(), <code>operator->()</code> and <code>operator*()</code>,
+     * operating on the private copy without further locking or copying.
+     * </p>
+     * <p>
+     * commit() replaces the parents' store with the mutated copy via its <code>set_store()</code>,
+     * hence publishing all mutations at once to its <i>lock-free</i> readers.<br>
+     * Destruction without commit() discards all mutations, i.e. performs a rollback().
+     * </p>
+     * <p>
+     * Other than jau::cow_rw_iterator, this transaction is not an iterator
+     * and storage iterators retrieved via store() are valid until commit() or rollback().
+     * </p>
+     * <p>
+     * While the transaction is active, all write operations of the CoW parent on the same thread,
+     * passing its recursive write mutex, throw jau::IllegalStateException,
+     * as their mutation would be silently overwritten by commit().
+     * Its <code>noexcept</code> write operations abort instead.
+     * Write operations of other threads block until commit() or rollback().<br>
+     * The CoW parent must befriend this class and provide the <code>transaction_open</code> flag,
+     * checked by its write operations.
+     * </p>
+     * <pre>
+     *     jau::cow_darray<Thing> list;
+     *     ...
+     *     {
+     *         jau::cow_darray<Thing>::transaction_t tx = list.transaction();
+     *         tx->pop_back();
+     *         tx->push_back(thing);
+     *         tx->erase(tx->begin());
+     *         tx.commit();
+     *     }
+     * </pre>
+     * @see jau::cow_darray::transaction()
+     * @see jau::cow_rw_iterator
+     */
+    template <typename Storage_type, typename Storage_ref_type, typename CoW_container>
+    class cow_transaction {
+        public:
+            typedef Storage_type                                storage_t;
+            typedef Storage_ref_type                            storage_ref_t;
+            typedef CoW_container                               cow_container_t;
+
+        private:
+            cow_container_t*                        cow_parent_;
+            std::unique_lock<std::recursive_mutex>  lock_;
+            storage_ref_t                           store_ref_;
+
+        public:
+            /**
+             * Locks the given CoW parents' write mutex, copies its store via <code>copy_store()</code>
+             * and marks the CoW parent's transaction as open.
+             * <p>
+             * Throws jau::IllegalStateException if the CoW parent has an open transaction on this thread already.
+             * </p>
+             */
+            explicit cow_transaction(cow_container_t& cow_parent)
+            : cow_parent_(&cow_parent), lock_(cow_parent.get_write_mutex()),
+              store_ref_(cow_parent.copy_store()) {
+                cow_parent_->transaction_open = true;
+            }
+
+            cow_transaction(const cow_transaction&) = delete;
+            cow_transaction& operator=(const cow_transaction&) = delete;
+
+            cow_transaction(cow_transaction && o) noexcept
+            : cow_parent_( o.cow_parent_ ), lock_( std::move( o.lock_ ) ),
+              store_ref_( std::move( o.store_ref_ ) ) {
+                // Moved source has been disowned semantically, its dtor won't release resources
+            }
+
+            /**
+             * Discards all uncommitted mutations, see rollback().
+             */
+            ~cow_transaction() noexcept {
+                rollback();
+            }
+
+            /**
+             * Returns true if this transaction is active, i.e. neither committed nor rolled back.
+             */
+            bool is_active() const noexcept { return nullptr != store_ref_; }
+
+            /**
+             * Returns the private mutable storage copy.
+             * <p>
+             * Throws jau::IllegalStateException if not is_active().
+             * </p>
+             */
+            storage_t& store() {
+                if( nullptr == store_ref_ ) {
+                    throw IllegalStateException("cow_transaction not active", E_FILE_LINE);
+                }
+                return *store_ref_;
+            }
+
+            /** See store() */
+            storage_t* operator->() { return &store(); }
+
+            /** See store() */
+            storage_t& operator*() { return store(); }
+
+            /**
+             * Replaces the parents' current store with this transaction's mutated copy,
+             * unlocks the CoW parents' write lock and discards the storage reference.
+             * <p>
+             * After calling commit(), this transaction is no more active.
+             * </p>
+             * @see jau::cow_darray::set_store()
+             */
+            void commit() noexcept {
+                if( nullptr != store_ref_ ) {
+                    cow_parent_->transaction_open = false;
+                    cow_parent_->set_store(std::move(store_ref_));
+                    store_ref_ = nullptr;
+                    lock_ = std::unique_lock<std::recursive_mutex>(); // force-dtor-unlock-null
+                }
+            }
+
+            /**
+             * Discards this transaction's mutated copy and unlocks the CoW parents' write lock.
+             * <p>
+             * After calling rollback(), this transaction is no more active.
+             * </p>
+             */
+            void rollback() noexcept {
+                if( nullptr != store_ref_ ) {
+                    cow_parent_->transaction_open = false;
+                }
+                store_ref_ = nullptr;
+                lock_ = std::unique_lock<std::recursive_mutex>(); // force-dtor-unlock-null
+            }
+    };
+
+} /* namespace jau */
+
+#endif /* JAU_COW_TRANSACTION_HPP_ */
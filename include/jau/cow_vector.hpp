@@ -42,6 +42,7 @@
 #include <jau/basic_types.hpp>
 #include <jau/ordered_atomic.hpp>
 #include <jau/cow_iterator.hpp>
+#include <jau/epoch_reclaim.hpp>
 
 namespace jau {
 
@@ -140,34 +141,52 @@ namespace jau {
             storage_ref_t store_ref;
             mutable sc_atomic_bool sync_atomic;
             mutable std::recursive_mutex mtx_write;
+            /** Raw pointer of store_ref for epoch_view() readers, updated along with store_ref. */
+            ordered_atomic<storage_t*, std::memory_order::memory_order_seq_cst> store_ptr;
+            /** True once epoch_view() has been used, enabling retirement of replaced stores via jau::epoch_domain. */
+            mutable sc_atomic_bool epoch_readers;
+
+            /**
+             * Replaces store_ref with the given new store. Caller must hold mtx_write and sync_atomic's jau::sc_atomic_critical.
+             * See jau::cow_darray::replace_store().
+             */
+            void replace_store(storage_ref_t && new_store_ref) {
+                storage_ref_t old_store_ref = std::move(store_ref);
+                store_ref = std::move(new_store_ref);
+                store_ptr = store_ref.get();
+                if( epoch_readers && nullptr != old_store_ref ) {
+                    epoch_domain::get().retire( std::move(old_store_ref) );
+                }
+            }
 
         public:
             // ctor
 
             constexpr cow_vector() noexcept
-            : store_ref( std::make_shared<storage_t>() ), sync_atomic(false) {}
+            : store_ref( std::make_shared<storage_t>() ), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false) {}
 
             constexpr explicit cow_vector(const allocator_type & a) noexcept
-            : store_ref( std::make_shared<storage_t>(a) ), sync_atomic(false) { }
+            : store_ref( std::make_shared<storage_t>(a) ), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false) { }
 
             constexpr explicit cow_vector(size_type n, const allocator_type& a = allocator_type())
-            : store_ref( std::make_shared<storage_t>(n, a) ), sync_atomic(false) { }
+            : store_ref( std::make_shared<storage_t>(n, a) ), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false) { }
 
             constexpr cow_vector(size_type n, const value_type& value, const allocator_type& a = allocator_type())
-            : store_ref( std::make_shared<storage_t>(n, value, a) ), sync_atomic(false) { }
+            : store_ref( std::make_shared<storage_t>(n, value, a) ), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false) { }
 
             constexpr explicit cow_vector(const storage_t& x)
-            : store_ref( std::make_shared<storage_t>(x, x->get_allocator()) ), sync_atomic(false) { }
+            : store_ref( std::make_shared<storage_t>(x, x->get_allocator()) ), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false) { }
 
             constexpr_atomic
             cow_vector(const cow_vector& x)
-            : sync_atomic(false) {
+            : sync_atomic(false), store_ptr(nullptr), epoch_readers(false) {
                 storage_ref_t x_store_ref;
                 {
                     sc_atomic_critical sync_x( x.sync_atomic );
                     x_store_ref = x.store_ref;
                 }
                 store_ref = std::make_shared<storage_t>( *x_store_ref, x_store_ref->get_allocator() );
+                store_ptr = store_ref.get();
             }
 
             /**
@@ -186,13 +205,14 @@ namespace jau {
                 storage_ref_t new_store_ref = std::make_shared<storage_t>( *x_store_ref, x_store_ref->get_allocator() );
                 {
                     sc_atomic_critical sync(sync_atomic);
-                    store_ref = std::move(new_store_ref);
+                    replace_store( std::move(new_store_ref) );
                 }
                 return *this;
             }
 
             constexpr_atomic
-            cow_vector(cow_vector && x) noexcept {
+            cow_vector(cow_vector && x) noexcept
+            : sync_atomic(false), store_ptr(nullptr), epoch_readers(false) {
                 // Strategy-1: Acquire lock, blocking
                 // - If somebody else holds the lock, we wait.
                 // - Then we own the lock
@@ -200,11 +220,14 @@ namespace jau {
                 std::unique_lock<std::recursive_mutex>  lock(x.mtx_write); // *this doesn't exist yet, not locking ourselves
                 {
                     store_ref = std::move(x.store_ref);
+                    store_ptr = store_ref.get();
+                    epoch_readers = x.epoch_readers.load(); // x's epoch readers may still access the taken over store
                     // sync_atomic = std::move(x.sync_atomic);
                     // mtx_write will be a fresh one, but we hold the source's lock
 
                     // Moved source array has been taken over, null its store_ref
                     x.store_ref = nullptr;
+                    x.store_ptr = nullptr;
                 }
             }
 
@@ -226,11 +249,15 @@ namespace jau {
                 {
                     sc_atomic_critical sync_x( x.sync_atomic );
                     sc_atomic_critical sync  (   sync_atomic );
-                    store_ref = std::move(x.store_ref);
+                    if( x.epoch_readers ) {
+                        epoch_readers = true; // x's epoch readers may still access the taken over store
+                    }
+                    replace_store( std::move(x.store_ref) );
                     // mtx_write and the atomic will be kept as is, but we hold the source's lock
 
                     // Moved source array has been taken over, null its store_ref
                     x.store_ref = nullptr;
+                    x.store_ptr = nullptr;
                 }
                 return *this;
             }
@@ -246,7 +273,7 @@ namespace jau {
              */
             template< class InputIt >
             constexpr cow_vector(InputIt first, InputIt last, const allocator_type& alloc = allocator_type())
-            : store_ref(std::make_shared<storage_t>(first, last, alloc)), sync_atomic(false)
+            : store_ref(std::make_shared<storage_t>(first, last, alloc)), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false)
             { }
 
             /**
@@ -256,10 +283,14 @@ namespace jau {
              * @param alloc allocator
              */
             constexpr cow_vector(std::initializer_list<value_type> initlist, const allocator_type& alloc = allocator_type())
-            : store_ref(std::make_shared<storage_t>(initlist, alloc)), sync_atomic(false)
+            : store_ref(std::make_shared<storage_t>(initlist, alloc)), sync_atomic(false), store_ptr(store_ref.get()), epoch_readers(false)
             { }
 
-            ~cow_vector() noexcept { }
+            ~cow_vector() noexcept {
+                if( epoch_readers ) {
+                    epoch_domain::get().reclaim(); // release this instance's retired stores not accessed anymore
+                }
+            }
 
             /**
              * Returns <code>std::numeric_limits<difference_type>::max()</code> as the maximum array size.
@@ -335,7 +366,7 @@ namespace jau {
             void set_store(storage_ref_t && new_store_ref) noexcept {
                 std::lock_guard<std::recursive_mutex> lock(mtx_write);
                 sc_atomic_critical sync(sync_atomic);
-                store_ref = std::move( new_store_ref );
+                replace_store( std::move(new_store_ref) );
             }
 
             /**
@@ -356,6 +387,18 @@ namespace jau {
                 return store_ref;
             }
 
+            typedef epoch_ro_view<storage_t> epoch_view_t;
+
+            /**
+             * See description in jau::cow_darray::epoch_view()
+             */
+            epoch_view_t epoch_view() const {
+                if( !epoch_readers ) {
+                    epoch_readers = true; // prior to loading store_ptr, see replace_store()
+                }
+                return epoch_view_t( [this]() -> const storage_t* { return store_ptr.load(); } );
+            }
+
             // const_iterator, non mutable, read-only
 
             // Removed for clarity: "constexpr const_iterator begin() const noexcept"
@@ -422,7 +465,7 @@ namespace jau {
                     storage_ref_t new_store_ref = std::make_shared<storage_t>( *old_store_ref, old_store_ref->get_allocator() );
                     new_store_ref->reserve(new_capacity);
                     sc_atomic_critical sync( sync_atomic );
-                    store_ref = std::move(new_store_ref);
+                    replace_store( std::move(new_store_ref) );
                 }
             }
 
@@ -438,7 +481,10 @@ namespace jau {
                 storage_ref_t new_store_ref = std::make_shared<storage_t>();
                 {
                     sc_atomic_critical sync(sync_atomic);
-                    store_ref = std::move(new_store_ref);
+                    replace_store( std::move(new_store_ref) );
+                }
+                if( epoch_readers ) {
+                    epoch_domain::get().reclaim();
                 }
             }
 
@@ -459,6 +505,13 @@ namespace jau {
                     storage_ref_t x_store_ref = x.store_ref;
                     x.store_ref = store_ref;
                     store_ref = x_store_ref;
+                    x.store_ptr = x.store_ref.get();
+                    store_ptr = store_ref.get();
+                    if( epoch_readers || x.epoch_readers ) {
+                        // either's epoch readers may still access the swapped store
+                        epoch_readers = true;
+                        x.epoch_readers = true;
+                    }
                 }
             }
 
@@ -477,7 +530,7 @@ namespace jau {
                     new_store_ref->pop_back();
                     {
                         sc_atomic_critical sync(sync_atomic);
-                        store_ref = std::move(new_store_ref);
+                        replace_store( std::move(new_store_ref) );
                     }
                 }
             }
@@ -496,7 +549,7 @@ namespace jau {
                 new_store_ref->push_back(x);
                 {
                     sc_atomic_critical sync(sync_atomic);
-                    store_ref = std::move(new_store_ref);
+                    replace_store( std::move(new_store_ref) );
                 }
             }
 
@@ -513,7 +566,7 @@ namespace jau {
                 new_store_ref->push_back( std::move(x) );
                 {
                     sc_atomic_critical sync(sync_atomic);
-                    store_ref = std::move(new_store_ref);
+                    replace_store( std::move(new_store_ref) );
                 }
             }
 
@@ -535,7 +588,7 @@ namespace jau {
                 reference res = new_store_ref->emplace_back( std::forward<Args>(args)... );
                 {
                     sc_atomic_critical sync(sync_atomic);
-                    store_ref = std::move(new_store_ref);
+                    replace_store( std::move(new_store_ref) );
                 }
                 return res;
             }
@@ -628,7 +681,7 @@ namespace jau {
                 }
                 if( 0 < count ) { // mutated new_store_ref?
                     sc_atomic_critical sync(sync_atomic);
-                    store_ref = std::move(new_store_ref);
+                    replace_store( std::move(new_store_ref) );
                 } // else throw away new_store_ref
                 return count;
             }
@@ -26,6 +26,9 @@
 #define CPP_LANG_EXT_HPP_
 
 #include <type_traits>
+#include <memory>
+#include <string>
+#include <utility>
 
 namespace jau {
 
@@ -309,6 +312,63 @@ namespace jau {
         }
     }
 
+    /**
+    // *************************************************
+    // *************************************************
+    // *************************************************
+     */
+
+    /**
+     * <code>template< class T > is_trivially_relocatable<T>::value</code> compile-time Type Trait,
+     * determining whether an instance of the given type can be relocated to a new storage
+     * by a bitwise copy of its object representation, i.e. `memcpy`, `memmove` or `realloc`,
+     * while the source storage is not destructed.
+     * <p>
+     * Relocation only consists of a move-construction followed by the destruction of the moved source,
+     * hence a type holding only pointer to the heap like `std::shared_ptr`, `std::unique_ptr` or jau::FunctionDef
+     * can be relocated bitwise, even though it is not trivially copyable.
+     * </p>
+     * <p>
+     * A type holding a pointer into its own storage is not trivially relocatable,
+     * e.g. `std::string` of GNU's libstdc++ using its small string optimization.
+     * </p>
+     * <p>
+     * Defaults to `std::is_trivially_copyable<T>` and may be specialized by the user for their own types.<br>
+     * Specialized for `std::shared_ptr`, `std::weak_ptr`, `std::unique_ptr` w/ a trivially relocatable deleter,
+     * `std::string` of LLVM's libc++ and jau::FunctionDef.
+     * </p>
+     * <p>
+     * jau::darray and jau::cow_darray use this trait as the default value of their <code>use_memmove</code> template parameter.
+     * </p>
+     * @tparam T the type to query
+     */
+    template< class T >
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> { };
+
+    template< class T >
+    struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type { };
+
+    template< class T >
+    struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type { };
+
+    template< class T, class D >
+    struct is_trivially_relocatable<std::unique_ptr<T, D>> : is_trivially_relocatable<D> { };
+
+    template< class T1, class T2 >
+    struct is_trivially_relocatable<std::pair<T1, T2>>
+    : std::bool_constant< is_trivially_relocatable<T1>::value && is_trivially_relocatable<T2>::value > { };
+
+#if defined(_LIBCPP_VERSION)
+    template<>
+    struct is_trivially_relocatable<std::string> : std::true_type { };
+#endif
+
+    /**
+     * Value access of is_trivially_relocatable type trait for convenience ..
+     * @tparam T the type to query
+     * @see is_trivially_relocatable
+     */
+    template< class T > constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
 
 } // namespace jau
 
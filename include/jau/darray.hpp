@@ -53,6 +53,32 @@ namespace jau {
     #define DARRAY_PRINTF(...)
 #endif
 
+    namespace impl {
+        /**
+         * Inline element storage of jau::darray with an inline capacity of <code>N</code> elements.
+         */
+        template<typename Value_type, jau::nsize_t N>
+        struct darray_inline_store {
+            alignas(Value_type) uint8_t inline_store_[N * sizeof(Value_type)];
+
+            constexpr Value_type* inline_store() noexcept {
+                return static_cast<Value_type*>( static_cast<void*>( inline_store_ ) );
+            }
+            constexpr const Value_type* inline_store() const noexcept {
+                return static_cast<const Value_type*>( static_cast<const void*>( inline_store_ ) );
+            }
+        };
+
+        /**
+         * Empty inline element storage of jau::darray w/o inline capacity, i.e. zero footprint as a base class.
+         */
+        template<typename Value_type>
+        struct darray_inline_store<Value_type, 0> {
+            constexpr Value_type* inline_store() noexcept { return nullptr; }
+            constexpr const Value_type* inline_store() const noexcept { return nullptr; }
+        };
+    }
+
     /**
      * Implementation of a dynamic linear array storage, aka vector.<br>
      * Goals are to support a high-performance CoW dynamic array implementation, jau::cow_darray,<br>
@@ -87,18 +113,38 @@ namespace jau {
      * </p>
      * <p>
      * Non-Type Template Parameter <code>use_memmove</code> can be overriden by the user
-     * and has its default value <code>std::is_trivially_copyable_v<Value_type></code>.<br>
-     * The default value has been chosen with care, see C++ Standard section 6.9 Types <i>trivially copyable</i>.<br>
-     * However, one can set <code>use_memmove</code> to true even without the value_type being <i>trivially copyable</i>,
-     * as long certain memory side-effects can be excluded (TBD).
+     * and has its default value <code>jau::is_trivially_relocatable_v<Value_type></code>.<br>
+     * The default value has been chosen with care, see C++ Standard section 6.9 Types <i>trivially copyable</i>,
+     * extended to types which can be relocated bitwise, e.g. <code>std::shared_ptr</code>, see jau::is_trivially_relocatable.<br>
+     * With <code>use_memmove</code>, growing the storage uses <code>realloc</code> or <code>memcpy</code>
+     * and shifting elements on insert or erase uses <code>memmove</code>, both w/o invoking the value_type's constructor or destructor.<br>
+     * One can specialize jau::is_trivially_relocatable for a custom value_type
+     * or set <code>use_memmove</code> to true, as long certain memory side-effects can be excluded.
+     * </p>
+     * <p>
+     * Non-Type Template Parameter <code>N</code> gives an inline capacity of <code>N</code> elements stored within the instance itself,
+     * i.e. small-buffer optimization, default zero. See jau::small_darray.<br>
+     * With <code>0 < N</code>:
+     * <ul>
+     * <li>Storage is only allocated via allocator_type if its capacity exceeds <code>N</code>,
+     *     hence short lists up to <code>N</code> elements cause no allocation at all.</li>
+     * <li>Minimum capacity is <code>N</code>, i.e. capacity() is never below <code>N</code>.</li>
+     * <li>Growing beyond the inline capacity <i>spills</i> all elements into a newly allocated storage,
+     *     further growth uses the <code>realloc</code> path if <code>use_realloc</code> and <code>use_memmove</code> are enabled.</li>
+     * <li>clear() ends with the inline capacity <code>N</code> and releases an allocated storage.</li>
+     * <li>A move operation or swap() of an instance using its inline storage moves its elements, i.e. is O(size()).</li>
+     * <li>The instance footprint grows by <code>N * sizeof(value_type)</code>.</li>
+     * </ul>
      * </p>
+     * @tparam N the inline capacity in elements, defaults to zero, i.e. no inline storage.
      */
     template <typename Value_type, typename Alloc_type = jau::callocator<Value_type>, typename Size_type = jau::nsize_t,
-              bool use_memmove = std::is_trivially_copyable_v<Value_type>,
+              bool use_memmove = jau::is_trivially_relocatable_v<Value_type>,
               bool use_realloc = std::is_base_of_v<jau::callocator<Value_type>, Alloc_type>,
-              bool sec_mem = false
+              bool sec_mem = false,
+              jau::nsize_t N = 0
              >
-    class darray
+    class darray : private impl::darray_inline_store<Value_type, N>
     {
         public:
             /** Default growth factor using the golden ratio 1.618 */
@@ -126,6 +172,15 @@ namespace jau {
             /** Used to determine whether this type is a darray or has a darray, see ::is_darray_type<T> */
             typedef bool                                        darray_tag;
 
+            /** The inline capacity in elements, stored within this instance. Zero if not using an inline storage. */
+            constexpr static const size_type inline_capacity = N;
+
+            /**
+             * True if move construction, move assignment and swap() don't throw, i.e. no inline capacity,
+             * <code>use_memmove</code> or a nothrow move constructible value_type relocating inline elements.
+             */
+            constexpr static const bool nothrow_move = 0 == N || use_memmove || std::is_nothrow_move_constructible_v<Value_type>;
+
         private:
             constexpr static const size_type DIFF_MAX = std::numeric_limits<difference_type>::max();
             constexpr static const size_type MIN_SIZE_AT_GROW = 10;
@@ -181,7 +236,8 @@ namespace jau {
                 }
                 value_type * m = alloc_inst.reallocate(begin_, storage_end_-begin_, new_capacity_);
                 if( nullptr == m ) {
-                    free(begin_); // has not been touched by realloc
+                    // storage has not been touched by reallocate and remains owned by this instance,
+                    // as it might not originate from malloc, e.g. jau::aligned_callocator.
                     throw jau::OutOfMemoryError("realloc "+std::to_string(new_capacity_)+" elements * "+
                             std::to_string(sizeof(value_type))+" bytes/element = "+
                             std::to_string(new_capacity_ * sizeof(value_type))+" bytes -> nullptr", E_FILE_LINE);
@@ -199,15 +255,47 @@ namespace jau {
                 throw jau::UnsupportedOperationException("realloc not supported on non allocator_type not based upon jau::callocator", E_FILE_LINE);
             }
 
+            /**
+             * Returns the capacity of a storage for <code>capacity_</code> elements, i.e. never below the inline capacity <code>N</code>.
+             */
+            constexpr static size_type store_capacity(const size_type capacity_) noexcept {
+                return std::max<size_type>(capacity_, N);
+            }
+
+            /**
+             * Returns the inline storage if <code>capacity_ <= N</code>, otherwise a newly allocated storage via allocStore().
+             * <p>
+             * The resulting capacity is store_capacity(capacity_).
+             * </p>
+             */
+            constexpr value_type * acquireStore(const size_type capacity_) {
+                if constexpr ( 0 < N ) {
+                    if( capacity_ <= N ) {
+                        return this->inline_store();
+                    }
+                }
+                return allocStore(capacity_);
+            }
+
+            /** Releases an allocated storage, an inline storage is only cleared if <code>sec_mem</code>. */
             constexpr void freeStore() {
                 if( nullptr != begin_ ) {
                     if( sec_mem ) {
                         explicit_bzero((void*)begin_, (storage_end_-begin_)*sizeof(value_type));
                     }
-                    alloc_inst.deallocate(begin_, storage_end_-begin_);
+                    if( !is_inline() ) {
+                        alloc_inst.deallocate(begin_, storage_end_-begin_);
+                    }
                 }
             }
 
+            /** Resets all iterator to the empty initial storage, i.e. the inline storage or nullptr, not releasing any resources. */
+            constexpr void reset_store() noexcept {
+                begin_       = this->inline_store();
+                end_         = begin_;
+                storage_end_ = begin_ + N;
+            }
+
             constexpr void set_iterator(pointer new_storage_, difference_type size_, difference_type capacity_) noexcept {
                 begin_       = new_storage_;
                 end_         = new_storage_+size_;
@@ -247,17 +335,17 @@ namespace jau {
             }
             constexpr pointer clone_range(iterator first, const_iterator last) {
                 DARRAY_PRINTF("clone_range [%zd .. %zd], count %zd\n", (first-begin_), (last-begin_)-1, (last-first));
-                pointer dest = allocStore(size_type(last-first));
+                pointer dest = acquireStore(size_type(last-first));
                 ctor_copy_range(dest, first, last);
                 return dest;
             }
             constexpr pointer clone_range(const size_type dest_capacity, iterator first, const_iterator last) {
                 DARRAY_PRINTF("clone_range [%zd .. %zd], count %zd -> %d\n", (first-begin_), (last-begin_)-1, (last-first), (int)dest_capacity);
-                pointer dest = allocStore(dest_capacity);
+                pointer dest = acquireStore(dest_capacity);
                 ctor_copy_range(dest, first, last);
                 return dest;
             }
-            constexpr void ctor_copy_range_check(pointer dest, iterator first, const_iterator last) {
+            constexpr void ctor_copy_range_check(pointer dest, const_iterator first, const_iterator last) {
                 DARRAY_PRINTF("ctor_copy_range_check [%zd .. %zd] -> ??, dist %zd\n", (first-begin_), (last-begin_)-1, (last-first));
                 if( first > last ) {
                     throw jau::IllegalArgumentException("first "+to_hexstring(first)+" > last "+to_hexstring(last), E_FILE_LINE);
@@ -266,13 +354,13 @@ namespace jau {
                     new (dest) value_type( *first ); // placement new
                 }
             }
-            constexpr pointer clone_range_check(const size_type dest_capacity, iterator first, const_iterator last) {
+            constexpr pointer clone_range_check(const size_type dest_capacity, const_iterator first, const_iterator last) {
                 DARRAY_PRINTF("clone_range_check [%zd .. %zd], count %zd -> %d\n", (first-begin_), (last-begin_)-1, (last-first), (int)dest_capacity);
                 if( dest_capacity < size_type(last-first) ) {
                     throw jau::IllegalArgumentException("capacity "+std::to_string(dest_capacity)+" < source range "+
                                                         std::to_string(difference_type(last-first)), E_FILE_LINE);
                 }
-                pointer dest = allocStore(dest_capacity);
+                pointer dest = acquireStore(dest_capacity);
                 ctor_copy_range_check(dest, first, last);
                 return dest;
             }
@@ -282,8 +370,18 @@ namespace jau {
                     throw jau::IllegalArgumentException("first "+jau::to_string( first )+" > last "+
                                                                  jau::to_string( last ), E_FILE_LINE);
                 }
-                for(; first != last; ++dest, ++first) {
-                    new (dest) value_type( *first ); // placement new
+                if constexpr ( std::is_trivially_copyable_v<value_type> &&
+                               std::is_pointer_v<InputIt> &&
+                               std::is_same_v<std::remove_cv_t<std::remove_pointer_t<InputIt>>, value_type> )
+                {
+                    // copy construction equals memcpy, potentially aliased dest isn't recognized as such by the compiler
+                    if( first < last ) {
+                        ::memcpy(reinterpret_cast<void*>(dest), reinterpret_cast<const void*>(first), size_type(last - first)*sizeof(value_type));
+                    }
+                } else {
+                    for(; first != last; ++dest, ++first) {
+                        new (dest) value_type( *first ); // placement new
+                    }
                 }
             }
             template< class InputIt >
@@ -292,14 +390,59 @@ namespace jau {
                     throw jau::IllegalArgumentException("capacity "+std::to_string(dest_capacity)+" < source range "+
                                                         std::to_string(difference_type(last-first)), E_FILE_LINE);
                 }
-                pointer dest = allocStore(dest_capacity);
+                pointer dest = acquireStore(dest_capacity);
                 ctor_copy_range_foreign(dest, first, last);
                 return dest;
             }
 
-            constexpr void grow_storage_move(const size_type new_capacity) {
+            /**
+             * Moves the elements [first, last) to the non overlapping and uninitialized dest,
+             * leaving the source range destructed.
+             */
+            constexpr void relocate_range(pointer dest, pointer first, pointer last) noexcept(nothrow_move) {
+                if( use_memmove ) {
+                    memcpy(reinterpret_cast<void*>(dest),
+                           reinterpret_cast<void*>(first), (uint8_t*)last-(uint8_t*)first); // we can simply copy the memory over, also no overlap
+                    if( sec_mem ) {
+                        explicit_bzero((void*)first, (uint8_t*)last-(uint8_t*)first);
+                    }
+                } else {
+                    for(; first < last; ++dest, ++first) {
+                        new (dest) value_type( std::move( *first ) ); // placement new
+                        dtor_one(first); // manual destruction, even after std::move (object still exists)
+                    }
+                }
+            }
+
+            /**
+             * Takes over the storage of given x, whose iterator have been copied to this instance already,
+             * leaving x empty.
+             * <p>
+             * Elements of an inline storage are relocated into this instance's inline storage.
+             * </p>
+             */
+            constexpr void take_store(darray& x) noexcept(nothrow_move) {
+                if constexpr ( 0 < N ) {
+                    if( x.is_inline() ) {
+                        const difference_type size_ = x.end_ - x.begin_;
+                        reset_store();
+                        relocate_range(begin_, x.begin_, x.end_);
+                        end_ = begin_ + size_;
+                    }
+                    x.reset_store();
+                } else {
+                    // Moved source array has been taken over, flush sources' pointer to avoid value_type dtor releasing taken resources!
+                    explicit_bzero((void*)&x, sizeof(x));
+                }
+            }
+
+            constexpr void grow_storage_move(size_type new_capacity) {
+                new_capacity = store_capacity(new_capacity);
+                if( is_inline() && N == new_capacity ) {
+                    return; // already at minimum capacity
+                }
                 if( !use_memmove ) {
-                    pointer new_storage = allocStore(new_capacity);
+                    pointer new_storage = acquireStore(new_capacity);
                     {
                         iterator dest = new_storage;
                         iterator first = begin_;
@@ -310,11 +453,11 @@ namespace jau {
                     }
                     freeStore();
                     set_iterator(new_storage, size(), new_capacity);
-                } else if( use_realloc ) {
+                } else if( use_realloc && ( 0 == N || ( !is_inline() && N < new_capacity ) ) ) {
                     pointer new_storage = reallocStore<allocator_type>(new_capacity);
                     set_iterator(new_storage, size(), new_capacity);
                 } else {
-                    pointer new_storage = allocStore(new_capacity);
+                    pointer new_storage = acquireStore(new_capacity);
                     memcpy(reinterpret_cast<void*>(new_storage),
                            reinterpret_cast<void*>(begin_), (uint8_t*)end_-(uint8_t*)begin_); // we can simply copy the memory over, also no overlap
 
@@ -367,16 +510,65 @@ namespace jau {
                 }
             }
 
+            /**
+             * Erases all elements at position <code>it</code> for which <code>pred(it)</code> returns true in a single pass,
+             * compacting the remaining elements via one move_elements() per run of kept elements.
+             * <p>
+             * <code>pred</code> is invoked exactly once per element in ascending order.
+             * </p>
+             * <p>
+             * If <code>pred</code> throws, the elements erased so far stay erased
+             * and all remaining elements are compacted before the exception is rethrown,
+             * i.e. <code>[begin_, end_)</code> never contains a destructed element.
+             * </p>
+             * @return number of erased elements
+             */
+            template<class IterPredicate>
+            size_type compact_erase(IterPredicate pred) {
+                iterator dest = begin_;  // end of compacted range
+                iterator run = begin_;   // begin of current kept run, not yet moved
+                try {
+                    for(iterator it = begin_; it < end_; ++it) {
+                        if( pred( const_iterator(it) ) ) {
+                            const difference_type run_count = it - run;
+                            if( 0 < run_count && dest != run ) {
+                                move_elements(dest, run, run_count); // move kept run left
+                            }
+                            dest += run_count;
+                            dtor_one(it);
+                            run = it + 1;
+                        }
+                    }
+                } catch (...) {
+                    // [dest, run) holds destructed elements only: close the gap, then rethrow
+                    const difference_type run_count = end_ - run;
+                    if( 0 < run_count && dest != run ) {
+                        move_elements(dest, run, run_count);
+                    }
+                    end_ = dest + run_count;
+                    throw;
+                }
+                const difference_type run_count = end_ - run;
+                if( 0 < run_count && dest != run ) {
+                    move_elements(dest, run, run_count); // move last kept run left
+                }
+                dest += run_count;
+                const size_type count = size_type(end_ - dest);
+                end_ = dest;
+                return count;
+            }
+
 
         public:
 
             // ctor w/o elements
 
             /**
-             * Default constructor, giving zero capacity and zero memory footprint.
+             * Default constructor, giving zero capacity and zero memory footprint,
+             * or the inline capacity <code>N</code> w/o allocation.
              */
             constexpr darray() noexcept
-            : alloc_inst(), begin_( nullptr ), end_( nullptr ), storage_end_( nullptr ),
+            : alloc_inst(), begin_( this->inline_store() ), end_( begin_ ), storage_end_( begin_ + N ),
               growth_factor_(DEFAULT_GROWTH_FACTOR) {
                 DARRAY_PRINTF("ctor def: %s\n", get_info().c_str());
             }
@@ -388,7 +580,7 @@ namespace jau {
              * @param alloc given allocator_type
              */
             constexpr explicit darray(size_type capacity, const float growth_factor=DEFAULT_GROWTH_FACTOR, const allocator_type& alloc = allocator_type())
-            : alloc_inst( alloc ), begin_( allocStore(capacity) ), end_( begin_ ), storage_end_( begin_ + capacity ),
+            : alloc_inst( alloc ), begin_( acquireStore(capacity) ), end_( begin_ ), storage_end_( begin_ + store_capacity(capacity) ),
               growth_factor_( growth_factor ) {
                 DARRAY_PRINTF("ctor 1: %s\n", get_info().c_str());
             }
@@ -397,26 +589,28 @@ namespace jau {
 
             /**
              * Creates a new instance, copying all elements from the given darray.<br>
-             * Capacity and size will equal the given array, i.e. the result is a trimmed jau::darray.
+             * Capacity and size will equal the given array, i.e. the result is a trimmed jau::darray,
+             * while capacity is at least the inline capacity <code>N</code>.
              * @param x the given darray, all elements will be copied into the new instance.
              */
             constexpr darray(const darray& x)
             : alloc_inst( x.alloc_inst ), begin_( clone_range(x.begin_, x.end_) ), end_( begin_ + x.size() ),
-              storage_end_( begin_ + x.size() ), growth_factor_( x.growth_factor_ ) {
+              storage_end_( begin_ + store_capacity(x.size()) ), growth_factor_( x.growth_factor_ ) {
                 DARRAY_PRINTF("ctor copy0: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("ctor copy0:    x %s\n", x.get_info().c_str());
             }
 
             /**
              * Creates a new instance, copying all elements from the given darray.<br>
-             * Capacity and size will equal the given array, i.e. the result is a trimmed jau::darray.
+             * Capacity and size will equal the given array, i.e. the result is a trimmed jau::darray,
+             * while capacity is at least the inline capacity <code>N</code>.
              * @param x the given darray, all elements will be copied into the new instance.
              * @param growth_factor custom growth factor
              * @param alloc custom allocator_type instance
              */
             constexpr explicit darray(const darray& x, const float growth_factor, const allocator_type& alloc)
             : alloc_inst( alloc ), begin_( clone_range(x.begin_, x.end_) ), end_( begin_ + x.size() ),
-              storage_end_( begin_ + x.size() ), growth_factor_( growth_factor ) {
+              storage_end_( begin_ + store_capacity(x.size()) ), growth_factor_( growth_factor ) {
                 DARRAY_PRINTF("ctor copy1: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("ctor copy1:    x %s\n", x.get_info().c_str());
             }
@@ -434,7 +628,7 @@ namespace jau {
              */
             constexpr explicit darray(const darray& x, const size_type _capacity, const float growth_factor, const allocator_type& alloc)
             : alloc_inst( alloc ), begin_( clone_range( _capacity, x.begin_, x.end_) ), end_( begin_ + x.size() ),
-              storage_end_( begin_ + _capacity ), growth_factor_( growth_factor ) {
+              storage_end_( begin_ + store_capacity(_capacity) ), growth_factor_( growth_factor ) {
                 DARRAY_PRINTF("ctor copy2: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("ctor copy2:    x %s\n", x.get_info().c_str());
             }
@@ -466,37 +660,28 @@ namespace jau {
 
             // move_ctor on darray elements
 
-            constexpr darray(darray && x) noexcept
+            constexpr darray(darray && x) noexcept(nothrow_move)
             : alloc_inst( std::move(x.alloc_inst) ), begin_( std::move(x.begin_) ), end_( std::move(x.end_) ),
               storage_end_( std::move(x.storage_end_) ), growth_factor_( std::move(x.growth_factor_) )
             {
                 DARRAY_PRINTF("ctor move0: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("ctor move0:    x %s\n", x.get_info().c_str());
-                // Moved source array has been taken over, flush sources' pointer to avoid value_type dtor releasing taken resources!
-                explicit_bzero((void*)&x, sizeof(x));
+                take_store(x);
             }
 
-            constexpr explicit darray(darray && x, const float growth_factor, const allocator_type& alloc) noexcept
+            constexpr explicit darray(darray && x, const float growth_factor, const allocator_type& alloc) noexcept(nothrow_move)
             : alloc_inst( std::move(alloc) ), begin_( std::move(x.begin_) ), end_( std::move(x.end_) ),
               storage_end_( std::move(x.storage_end_) ), growth_factor_( std::move(growth_factor) )
             {
                 DARRAY_PRINTF("ctor move1: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("ctor move1:    x %s\n", x.get_info().c_str());
-                // Moved source array has been taken over, flush sources' pointer to avoid value_type dtor releasing taken resources!
-#if 1
-                explicit_bzero((void*)&x, sizeof(x));
-#else
-                x.begin_ = nullptr;
-                x.end_ = nullptr;
-                x.storage_end_ = nullptr;
-                x.growth_factor_ = 0.0;
-#endif
+                take_store(x);
             }
 
             /**
              * Like std::vector::operator=(&&), move.
              */
-            constexpr darray& operator=(darray&& x) noexcept {
+            constexpr darray& operator=(darray&& x) noexcept(nothrow_move) {
                 DARRAY_PRINTF("assignment move.0: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("assignment move.0:    x %s\n", x.get_info().c_str());
                 if( this != &x ) {
@@ -506,9 +691,7 @@ namespace jau {
                     end_ = std::move(x.end_);
                     storage_end_ = std::move(x.storage_end_);
                     growth_factor_ = std::move( x.growth_factor_ );
-
-                    // Moved source array has been taken over, flush sources' pointer to avoid value_type dtor releasing taken resources!
-                    explicit_bzero((void*)&x, sizeof(x));
+                    take_store(x);
                 }
                 DARRAY_PRINTF("assignment move.X: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("assignment move.X:    x %s\n", x.get_info().c_str());
@@ -533,7 +716,7 @@ namespace jau {
             constexpr explicit darray(const size_type _capacity, const_iterator first, const_iterator last,
                                       const float growth_factor=DEFAULT_GROWTH_FACTOR, const allocator_type& alloc = allocator_type())
             : alloc_inst( alloc ), begin_( clone_range_check(_capacity, first, last) ), end_(begin_ + size_type(last - first) ),
-              storage_end_( begin_ + _capacity ), growth_factor_( growth_factor ) {
+              storage_end_( begin_ + store_capacity(_capacity) ), growth_factor_( growth_factor ) {
                 DARRAY_PRINTF("ctor iters0: %s\n", get_info().c_str());
             }
 
@@ -555,7 +738,7 @@ namespace jau {
             constexpr explicit darray(const size_type _capacity, InputIt first, InputIt last,
                                       const float growth_factor=DEFAULT_GROWTH_FACTOR, const allocator_type& alloc = allocator_type())
             : alloc_inst( alloc ), begin_( clone_range_foreign(_capacity, first, last) ), end_(begin_ + size_type(last - first) ),
-              storage_end_( begin_ + _capacity ), growth_factor_( growth_factor ) {
+              storage_end_( begin_ + store_capacity(_capacity) ), growth_factor_( growth_factor ) {
                 DARRAY_PRINTF("ctor iters1: %s\n", get_info().c_str());
             }
 
@@ -571,7 +754,7 @@ namespace jau {
             template< class InputIt >
             constexpr darray(InputIt first, InputIt last, const allocator_type& alloc = allocator_type())
             : alloc_inst( alloc ), begin_( clone_range_foreign(size_type(last - first), first, last) ), end_(begin_ + size_type(last - first) ),
-              storage_end_( begin_ + size_type(last - first) ), growth_factor_( DEFAULT_GROWTH_FACTOR ) {
+              storage_end_( begin_ + store_capacity(size_type(last - first)) ), growth_factor_( DEFAULT_GROWTH_FACTOR ) {
                 DARRAY_PRINTF("ctor iters2: %s\n", get_info().c_str());
             }
 
@@ -583,7 +766,7 @@ namespace jau {
              */
             constexpr darray(std::initializer_list<value_type> initlist, const allocator_type& alloc = allocator_type())
             : alloc_inst( alloc ), begin_( clone_range_foreign(initlist.size(), initlist.begin(), initlist.end()) ),
-              end_(begin_ + initlist.size() ), storage_end_( begin_ + initlist.size() ), growth_factor_( DEFAULT_GROWTH_FACTOR ) {
+              end_(begin_ + initlist.size() ), storage_end_( begin_ + store_capacity(initlist.size()) ), growth_factor_( DEFAULT_GROWTH_FACTOR ) {
                 DARRAY_PRINTF("ctor initlist: %s\n", get_info().c_str());
             }
 
@@ -638,7 +821,13 @@ namespace jau {
             }
 
             /**
-             * Return the current capacity.
+             * Returns true if the elements are held within the inline storage of this instance,
+             * i.e. no storage has been allocated. Always false w/o inline capacity <code>N</code>.
+             */
+            constexpr bool is_inline() const noexcept { return 0 < N && begin_ == this->inline_store(); }
+
+            /**
+             * Return the current capacity, at least the inline capacity <code>N</code>.
              */
             constexpr size_type capacity() const noexcept { return size_type(storage_end_ - begin_); }
 
@@ -749,6 +938,102 @@ namespace jau {
                 }
             }
 
+            /**
+             * Like std::vector::shrink_to_fit(), reduces this instance's capacity to its size().
+             * <p>
+             * Only creates a new storage and invalidates iterators if the current capacity()
+             * is greater than size(). An empty instance ends with zero capacity, i.e. the inline capacity <code>N</code>.
+             * </p>
+             */
+            void shrink_to_fit() {
+                const size_type size_ = size();
+                if( 0 == size_ ) {
+                    clear();
+                } else if( capacity() > store_capacity(size_) ) {
+                    grow_storage_move(size_);
+                }
+            }
+
+            /**
+             * Reduces this instance's size to <code>new_size</code>, destructing all elements beyond.
+             * <p>
+             * Does nothing if <code>new_size >= size()</code>. The capacity is kept.
+             * </p>
+             * <p>
+             * Used to commit the actually written size after append_uninitialized() or resize_uninitialized().
+             * </p>
+             */
+            constexpr void truncate(size_type new_size) noexcept {
+                if( new_size < size() ) {
+                    iterator new_end = begin_ + new_size;
+                    dtor_range(new_end, end_);
+                    end_ = new_end;
+                }
+            }
+
+            /**
+             * Resizes this instance to <code>new_size</code> elements, leaving new elements uninitialized.
+             * <p>
+             * Allows I/O and decoder to write directly into this storage,
+             * avoiding the redundant initialization of new elements.<br>
+             * If <code>new_size</code> exceeds the capacity(), the storage grows to exactly <code>new_size</code>.<br>
+             * If <code>new_size</code> is less than size(), this instance is truncated.
+             * </p>
+             * <p>
+             * Only available for trivially copyable value_type.
+             * </p>
+             * @param new_size the new size
+             * @return pointer to the first element, i.e. data(), invalidating all previous iterator.
+             * @see append_uninitialized()
+             * @see truncate()
+             */
+            pointer resize_uninitialized(size_type new_size) {
+                static_assert( std::is_trivially_copyable_v<value_type>, "resize_uninitialized requires a trivially copyable value_type" );
+                if( new_size <= size() ) {
+                    truncate(new_size);
+                } else {
+                    if( new_size > capacity() ) {
+                        grow_storage_move(new_size);
+                    }
+                    end_ = begin_ + new_size;
+                }
+                return begin_;
+            }
+
+            /**
+             * Appends <code>count</code> uninitialized elements at the end().
+             * <p>
+             * Allows I/O and decoder to write directly into this storage,
+             * avoiding the redundant initialization of new elements.<br>
+             * If the new size exceeds the capacity(), the storage grows at least by the growth factor,
+             * i.e. same as push_back().
+             * </p>
+             * <p>
+             * Only available for trivially copyable value_type.
+             * </p>
+             * <pre>
+             *     jau::darray<uint8_t> buffer;
+             *     ...
+             *     uint8_t* p = buffer.append_uninitialized(chunk_size);
+             *     const ssize_t n = ::read(fd, p, chunk_size);
+             *     buffer.truncate( buffer.size() - chunk_size + ( 0 < n ? n : 0 ) );
+             * </pre>
+             * @param count the number of elements to be appended
+             * @return pointer to the first appended element, invalidating all previous iterator.
+             * @see resize_uninitialized()
+             * @see truncate()
+             */
+            pointer append_uninitialized(size_type count) {
+                static_assert( std::is_trivially_copyable_v<value_type>, "append_uninitialized requires a trivially copyable value_type" );
+                const size_type new_size = size() + count;
+                if( new_size > capacity() ) {
+                    grow_storage_move( std::max<size_type>(new_size, get_grown_capacity()) );
+                }
+                pointer res = end_;
+                end_ += count;
+                return res;
+            }
+
             /**
              * Like std::vector::assign()
              * @tparam InputIt foreign input-iterator to range of value_type [first, last)
@@ -791,22 +1076,35 @@ namespace jau {
             }
 
             /**
-             * Like std::vector::clear(), but ending with zero capacity.
+             * Like std::vector::clear(), but ending with zero capacity,
+             * i.e. the inline capacity <code>N</code> releasing an allocated storage.
              */
             constexpr void clear() noexcept {
                 dtor_range(begin_, end_);
                 freeStore();
-                begin_ = nullptr;
-                end_ = nullptr;
-                storage_end_ = nullptr;
+                reset_store();
             }
 
             /**
              * Like std::vector::swap().
+             * <p>
+             * With an inline capacity <code>N</code>, only swaps the storage if both instances use an allocated storage,
+             * otherwise the elements are moved.
+             * </p>
              */
-            constexpr void swap(darray& x) noexcept {
+            constexpr void swap(darray& x) noexcept(nothrow_move) {
                 DARRAY_PRINTF("swap.0: this %s\n", get_info().c_str());
                 DARRAY_PRINTF("swap.0:    x %s\n", x.get_info().c_str());
+                if constexpr ( 0 < N ) {
+                    if( is_inline() || x.is_inline() ) {
+                        if( this != &x ) {
+                            darray tmp( std::move(x) );
+                            x = std::move(*this);
+                            *this = std::move(tmp);
+                        }
+                        return;
+                    }
+                }
                 std::swap(alloc_inst, x.alloc_inst);
                 std::swap(begin_, x.begin_);
                 std::swap(end_, x.end_);
@@ -857,6 +1155,53 @@ namespace jau {
                 return begin_ <= const_cast<iterator>(first) && const_cast<iterator>(first) <= end_ ? const_cast<iterator>(first) : end_;
             }
 
+            /**
+             * Like std::erase_if(std::vector&, pred), removes all elements for which the given predicate returns true.
+             * <p>
+             * Compacts the remaining elements in a single pass,
+             * moving each run of remaining elements once, i.e. using one memmove per run with <code>use_memmove</code>.
+             * </p>
+             * @tparam UnaryPredicate predicate type, callable as <code>bool pred(const value_type&)</code>
+             * @param pred the predicate returning true for elements to be erased
+             * @return number of erased elements
+             */
+            template<class UnaryPredicate>
+            constexpr size_type erase_if(UnaryPredicate pred) {
+                return compact_erase( [&pred](const_iterator it) -> bool { return pred( *it ); } );
+            }
+
+            /**
+             * Erases all elements at the given positions in a single pass, see erase_if().
+             * <p>
+             * Throws jau::IllegalArgumentException() if positions are not in ascending order
+             * and jau::IndexOutOfBoundsException() if a position is not less than size(),
+             * both before any element is erased. Duplicate positions are erased once.
+             * </p>
+             * @tparam InputIt forward-iterator type to a range of positions
+             * @param first forward-iterator to first position of range [first, last)
+             * @param last forward-iterator to last position of range [first, last)
+             * @return number of erased elements
+             */
+            template< class InputIt >
+            constexpr size_type erase_indices(InputIt first, InputIt last) {
+                const size_type size_ = size();
+                for(InputIt p = first, prev = first; p != last; prev = p, ++p) {
+                    if( size_type(*p) >= size_ ) {
+                        throw jau::IndexOutOfBoundsException(size_type(*p), size_, E_FILE_LINE);
+                    }
+                    if( p != prev && *p < *prev ) {
+                        throw jau::IllegalArgumentException("positions not in ascending order: "+
+                                std::to_string(*prev)+" > "+std::to_string(*p), E_FILE_LINE);
+                    }
+                }
+                const_iterator begin0 = begin_;
+                return compact_erase( [&first, &last, begin0](const_iterator it) -> bool {
+                    const size_type idx = size_type(it - begin0);
+                    while( first != last && size_type(*first) < idx ) { ++first; }
+                    return first != last && size_type(*first) == idx;
+                } );
+            }
+
             /**
              * Like std::vector::insert(), copy
              * <p>
@@ -1039,7 +1384,7 @@ namespace jau {
             constexpr void push_back( InputIt first, InputIt last ) {
                 const size_type count = size_type(last - first);
 
-                if( end_ + count >= storage_end_ ) {
+                if( end_ + count > storage_end_ ) {
                     grow_storage_move(size() + count);
                 }
                 ctor_copy_range_foreign(end_, first, last);
@@ -1104,11 +1449,14 @@ namespace jau {
              * </pre>
              * </p>
              * @param x the value to be added at the tail, if not existing yet.
-             * @param all_matching if true, erase all matching elements, otherwise only the first matching element.
+             * @param all_matching if true, erase all matching elements in a single pass via erase_if(), otherwise only the first matching element.
              * @param comparator the equal comparator to return true if both given elements are equal
              * @return number of erased elements
              */
             constexpr int erase_matching(const value_type& x, const bool all_matching, equal_comparator comparator) {
+                if( all_matching ) {
+                    return static_cast<int>( erase_if( [&x, comparator](const value_type& e) -> bool { return comparator( e, x ); } ) );
+                }
                 int count = 0;
                 for(auto it = end_-1; begin_ <= it; --it) {
                     if( comparator( *it, x ) ) {
@@ -1142,7 +1490,8 @@ namespace jau {
                                 ", uses[mmm "+std::to_string(uses_memmove)+
                                 ", ralloc "+std::to_string(uses_realloc)+
                                 ", smem "+std::to_string(sec_mem)+
-                                "], begin "+jau::to_hexstring(begin_)+
+                                "]"+( 0 < N ? ", inline "+std::to_string(N)+( is_inline() ? " (in use)" : "" ) : "" )+
+                                ", begin "+jau::to_hexstring(begin_)+
                                 ", end "+jau::to_hexstring(end_)+
                                 ", send "+jau::to_hexstring(storage_end_)+
                                 "]");
@@ -1153,8 +1502,8 @@ namespace jau {
     /****************************************************************************************
      ****************************************************************************************/
 
-    template<typename Value_type, typename Alloc_type>
-    std::ostream & operator << (std::ostream &out, const darray<Value_type, Alloc_type> &c) {
+    template<typename Value_type, typename Alloc_type, typename Size_type, bool use_memmove, bool use_realloc, bool sec_mem, jau::nsize_t N>
+    std::ostream & operator << (std::ostream &out, const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N> &c) {
         out << c.toString();
         return out;
     }
@@ -1162,36 +1511,36 @@ namespace jau {
     /****************************************************************************************
      ****************************************************************************************/
 
-    template<typename Value_type, typename Alloc_type>
-    inline bool operator==(const darray<Value_type, Alloc_type>& rhs, const darray<Value_type, Alloc_type>& lhs) {
+    template<typename Value_type, typename Alloc_type, typename Size_type, bool use_memmove, bool use_realloc, bool sec_mem, jau::nsize_t N>
+    inline bool operator==(const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& rhs, const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& lhs) {
         if( &rhs == &lhs ) {
             return true;
         }
         return (rhs.size() == lhs.size() && std::equal(rhs.cbegin(), rhs.cend(), lhs.cbegin()));
     }
-    template<typename Value_type, typename Alloc_type>
-    inline bool operator!=(const darray<Value_type, Alloc_type>& rhs, const darray<Value_type, Alloc_type>& lhs) {
+    template<typename Value_type, typename Alloc_type, typename Size_type, bool use_memmove, bool use_realloc, bool sec_mem, jau::nsize_t N>
+    inline bool operator!=(const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& rhs, const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& lhs) {
         return !(rhs==lhs);
     }
 
-    template<typename Value_type, typename Alloc_type>
-    inline bool operator<(const darray<Value_type, Alloc_type>& rhs, const darray<Value_type, Alloc_type>& lhs)
+    template<typename Value_type, typename Alloc_type, typename Size_type, bool use_memmove, bool use_realloc, bool sec_mem, jau::nsize_t N>
+    inline bool operator<(const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& rhs, const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& lhs)
     { return std::lexicographical_compare(rhs.cbegin(), rhs.cend(), lhs.cbegin(), lhs.cend()); }
 
-    template<typename Value_type, typename Alloc_type>
-    inline bool operator>(const darray<Value_type, Alloc_type>& rhs, const darray<Value_type, Alloc_type>& lhs)
+    template<typename Value_type, typename Alloc_type, typename Size_type, bool use_memmove, bool use_realloc, bool sec_mem, jau::nsize_t N>
+    inline bool operator>(const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& rhs, const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& lhs)
     { return lhs < rhs; }
 
-    template<typename Value_type, typename Alloc_type>
-    inline bool operator<=(const darray<Value_type, Alloc_type>& rhs, const darray<Value_type, Alloc_type>& lhs)
+    template<typename Value_type, typename Alloc_type, typename Size_type, bool use_memmove, bool use_realloc, bool sec_mem, jau::nsize_t N>
+    inline bool operator<=(const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& rhs, const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& lhs)
     { return !(lhs < rhs); }
 
-    template<typename Value_type, typename Alloc_type>
-    inline bool operator>=(const darray<Value_type, Alloc_type>& rhs, const darray<Value_type, Alloc_type>& lhs)
+    template<typename Value_type, typename Alloc_type, typename Size_type, bool use_memmove, bool use_realloc, bool sec_mem, jau::nsize_t N>
+    inline bool operator>=(const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& rhs, const darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& lhs)
     { return !(rhs < lhs); }
 
-    template<typename Value_type, typename Alloc_type>
-    inline void swap(darray<Value_type, Alloc_type>& rhs, darray<Value_type, Alloc_type>& lhs) noexcept
+    template<typename Value_type, typename Alloc_type, typename Size_type, bool use_memmove, bool use_realloc, bool sec_mem, jau::nsize_t N>
+    inline void swap(darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& rhs, darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>& lhs) noexcept(noexcept(rhs.swap(lhs)))
     { rhs.swap(lhs); }
 
     /****************************************************************************************
@@ -0,0 +1,495 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_EPOCH_RECLAIM_HPP_
+#define JAU_EPOCH_RECLAIM_HPP_
+
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <utility>
+
+#include <jau/basic_types.hpp>
+
+namespace jau {
+
+    /**
+     * Epoch based memory reclamation (EBR) domain,
+     * allowing readers to access shared data via raw pointer within a cheap critical section
+     * while replaced data is released only after all readers have left their epoch.
+     * <p>
+     * Each reader thread owns a cache-line sized slot, announcing its epoch while inside its critical section.<br>
+     * Entering and leaving the critical section only writes to the thread's own slot,
+     * i.e. readers do not contend on a shared cache-line as they would
+     * incrementing and decrementing a <code>std::shared_ptr</code> reference counter.
+     * </p>
+     * <p>
+     * A writer publishes its new data, then retires the replaced data via retire(),
+     * which advances the global epoch and releases all retired data no reader may still access.
+     * Retired data is held as <code>std::shared_ptr<void></code>, i.e. it is only destructed
+     * if no other shared reference exists.
+     * </p>
+     * <p>
+     * All operations use sequentially consistent (SC) atomic ordering,
+     * see jau::sc_atomic_critical.
+     * </p>
+     * <p>
+     * Retired data is released by subsequent retire() or reclaim() calls,
+     * as well as by the last reader leaving its critical section via leave() if retired data is pending.
+     * </p>
+     * <p>
+     * Used by jau::cow_darray::epoch_view() and jau::cow_vector::epoch_view().
+     * </p>
+     * @see jau::epoch_guard
+     * @see jau::epoch_ro_view
+     * @see jau::epoch_retire_list
+     */
+    class epoch_domain {
+        public:
+            typedef uint64_t epoch_t;
+
+        private:
+            friend class epoch_retire_list;
+
+            /** Quiescent epoch value of a slot, i.e. thread not within a critical section. */
+            constexpr static const epoch_t QUIESCENT = 0;
+
+            struct alignas(64) slot_t {
+                /** Announced epoch of the owning thread within its critical section, otherwise QUIESCENT. */
+                std::atomic<epoch_t> epoch;
+                /** True if owned by a thread */
+                std::atomic<bool> in_use;
+                /** Critical section nesting level, only accessed by the owning thread. */
+                jau::nsize_t nesting;
+                /** Next slot, immutable once linked. */
+                slot_t* next;
+
+                slot_t() noexcept
+                : epoch(QUIESCENT), in_use(true), nesting(0), next(nullptr) {}
+            };
+
+            /** Thread local slot owner, relinquishing the slot at thread exit. */
+            struct thread_slot_t {
+                slot_t* slot = nullptr;
+
+                ~thread_slot_t() noexcept {
+                    if( nullptr != slot ) {
+                        slot->nesting = 0;
+                        slot->epoch.store(QUIESCENT);
+                        slot->in_use.store(false);
+                    }
+                }
+            };
+
+            alignas(64) std::atomic<epoch_t> global_epoch;
+            alignas(64) std::atomic<slot_t*> slots;
+            std::mutex mtx_retired;
+            std::vector<std::pair<epoch_t, std::shared_ptr<void>>> retired;
+            /** Number of retired data, written while holding mtx_retired, allowing leave() to skip try_reclaim(). */
+            std::atomic<jau::nsize_t> retired_size;
+
+            epoch_domain() noexcept
+            : global_epoch(QUIESCENT+1), slots(nullptr), retired_size(0) {}
+
+            slot_t* acquire_slot() {
+                for(slot_t* s = slots.load(); nullptr != s; s = s->next) {
+                    bool expected = false;
+                    if( !s->in_use.load() && s->in_use.compare_exchange_strong(expected, true) ) {
+                        return s;
+                    }
+                }
+                slot_t* s = new slot_t();
+                slot_t* head = slots.load();
+                do {
+                    s->next = head;
+                } while( !slots.compare_exchange_weak(head, s) );
+                return s;
+            }
+
+            static thread_slot_t& thread_slot() noexcept {
+                static thread_local thread_slot_t ts;
+                return ts;
+            }
+
+            /** Returns the minimum announced epoch of all readers within their critical section. */
+            epoch_t min_active_epoch() const noexcept {
+                epoch_t res = std::numeric_limits<epoch_t>::max();
+                for(const slot_t* s = slots.load(); nullptr != s; s = s->next) {
+                    const epoch_t e = s->epoch.load();
+                    if( QUIESCENT != e && e < res ) {
+                        res = e;
+                    }
+                }
+                return res;
+            }
+
+            /**
+             * Moves all retired data no reader may still access to given released list. Caller must hold mtx_retired.
+             * <p>
+             * Leaves the retired list untouched if the released list can't be allocated.
+             * </p>
+             */
+            void collect(std::vector<std::shared_ptr<void>>& released) noexcept {
+                try {
+                    released.reserve( released.size() + retired.size() );
+                } catch (...) {
+                    return;
+                }
+                const epoch_t min_epoch = min_active_epoch();
+                std::size_t j = 0;
+                for(std::size_t i = 0; i < retired.size(); ++i) {
+                    if( retired[i].first < min_epoch ) {
+                        released.push_back( std::move( retired[i].second ) );
+                    } else {
+                        if( i != j ) {
+                            retired[j] = std::move( retired[i] );
+                        }
+                        ++j;
+                    }
+                }
+                retired.erase(retired.begin() + static_cast<std::ptrdiff_t>(j), retired.end());
+                retired_size.store( static_cast<jau::nsize_t>( j ) );
+            }
+
+            /** Releases all retired data no reader may still access, if mtx_retired is not held by another thread. */
+            void try_reclaim() noexcept {
+                std::vector<std::shared_ptr<void>> released;
+                std::unique_lock<std::mutex> lock(mtx_retired, std::try_to_lock);
+                if( lock.owns_lock() ) {
+                    collect(released);
+                    lock.unlock();
+                }
+            }
+
+        public:
+            epoch_domain(const epoch_domain&) = delete;
+            epoch_domain& operator=(const epoch_domain&) = delete;
+
+            ~epoch_domain() noexcept {
+                retired.clear();
+                slot_t* s = slots.load();
+                while( nullptr != s ) {
+                    slot_t* n = s->next;
+                    delete s;
+                    s = n;
+                }
+            }
+
+            /**
+             * Returns the process wide epoch_domain singleton.
+             */
+            static epoch_domain& get() noexcept {
+                static epoch_domain instance;
+                return instance;
+            }
+
+            /**
+             * Enters the calling thread's critical section, allowing nested calls.
+             * <p>
+             * Shared data loaded after this call using SC ordering will not be released
+             * until the matching leave().
+             * </p>
+             * <p>
+             * The first call of a thread acquires its slot, all other calls are <i>lock-free</i>.
+             * </p>
+             */
+            void enter() {
+                thread_slot_t& ts = thread_slot();
+                if( nullptr == ts.slot ) {
+                    ts.slot = acquire_slot();
+                }
+                slot_t* s = ts.slot;
+                if( 0 == s->nesting++ ) {
+                    s->epoch.store( global_epoch.load() );
+                }
+            }
+
+            /**
+             * Leaves the calling thread's critical section entered via enter().
+             * <p>
+             * Leaving the outermost critical section while retired data is pending
+             * releases all retired data no reader may still access,
+             * if the retired list's mutex is not held by another thread.<br>
+             * Hence this operation is <i>lock-free</i> and may destruct released data.
+             * </p>
+             */
+            void leave() noexcept {
+                slot_t* s = thread_slot().slot;
+                if( nullptr != s && 0 < s->nesting && 0 == --s->nesting ) {
+                    s->epoch.store(QUIESCENT);
+                    if( 0 < retired_size.load() ) {
+                        try_reclaim();
+                    }
+                }
+            }
+
+            /**
+             * Retires the given shared data, which has been replaced and is no more reachable by new readers.
+             * <p>
+             * The data will be released once no reader may still access it,
+             * potentially within this call.
+             * </p>
+             * <p>
+             * This operation uses a mutex lock. The released data is destructed outside of the lock.
+             * </p>
+             * @param data the replaced shared data
+             */
+            void retire(std::shared_ptr<void> && data) {
+                std::vector<std::shared_ptr<void>> released;
+                const epoch_t e = global_epoch.fetch_add(1);
+                {
+                    std::lock_guard<std::mutex> lock(mtx_retired);
+                    retired.emplace_back( e, std::move(data) );
+                    retired_size.store( static_cast<jau::nsize_t>( retired.size() ) );
+                    collect(released);
+                }
+            }
+
+            /**
+             * Releases all retired data no reader may still access.
+             * <p>
+             * This operation uses a mutex lock. The released data is destructed outside of the lock.
+             * </p>
+             * @return number of released retired data
+             */
+            jau::nsize_t reclaim() noexcept {
+                std::vector<std::shared_ptr<void>> released;
+                {
+                    std::lock_guard<std::mutex> lock(mtx_retired);
+                    collect(released);
+                }
+                return static_cast<jau::nsize_t>( released.size() );
+            }
+
+            /**
+             * Returns the number of retired data not yet released.
+             */
+            jau::nsize_t retired_count() {
+                std::lock_guard<std::mutex> lock(mtx_retired);
+                return static_cast<jau::nsize_t>( retired.size() );
+            }
+
+            /**
+             * Returns the current global epoch.
+             */
+            epoch_t epoch() const noexcept { return global_epoch.load(); }
+    };
+
+    /**
+     * Retired data list of a single writer or a group of writers sharing an external lock,
+     * releasing retired data in batches.
+     * <p>
+     * Other than epoch_domain::retire(), retire() neither locks the domain's shared mutex
+     * nor advances the global epoch, it only appends the data stamped with the current global epoch.<br>
+     * Once the list's size reaches its threshold, retire() advances the global epoch
+     * and releases all data no reader may still access, see reclaim().
+     * The threshold is at least batch_size and twice the number of data still being accessed after reclaim(),
+     * i.e. the amortized cost of retire() is constant.
+     * </p>
+     * <p>
+     * Retired data is exclusively owned by this list and deleted when released,
+     * i.e. no <code>std::shared_ptr</code> control block is allocated per retired data.
+     * </p>
+     * <p>
+     * This class is not thread-safe, its owner shall serialize all operations,
+     * e.g. jau::cow_hashmap uses one instance per write lock stripe.
+     * </p>
+     * <p>
+     * The destructor releases all remaining data, i.e. it shall only be destructed
+     * if no reader may still access the retired data.
+     * </p>
+     * @see jau::epoch_domain
+     */
+    class epoch_retire_list {
+        public:
+            typedef epoch_domain::epoch_t epoch_t;
+
+            /** Minimum number of retired data before retire() calls reclaim(). */
+            constexpr static const std::size_t batch_size = 16;
+
+        private:
+            struct entry_t {
+                epoch_t epoch;
+                void* data;
+                void (*deleter)(void*) noexcept;
+            };
+
+            template<typename T>
+            static void delete_as(void* p) noexcept { delete static_cast<T*>(p); }
+
+            epoch_domain& domain;
+            std::vector<entry_t> retired;
+            std::size_t threshold;
+
+        public:
+            explicit epoch_retire_list(epoch_domain& d = epoch_domain::get()) noexcept
+            : domain(d), retired(), threshold(batch_size) {}
+
+            ~epoch_retire_list() noexcept {
+                for(const entry_t& e : retired) {
+                    e.deleter(e.data);
+                }
+            }
+
+            epoch_retire_list(const epoch_retire_list&) = delete;
+            epoch_retire_list& operator=(const epoch_retire_list&) = delete;
+
+            /**
+             * Ensures capacity for the next retire() call,
+             * to be called before replacing the data to be retired.
+             */
+            void prepare() {
+                if( retired.size() == retired.capacity() ) {
+                    retired.reserve( std::max( batch_size, 2 * retired.size() ) );
+                }
+            }
+
+            /**
+             * Retires the given data, which has been replaced and is no more reachable by new readers.
+             * <p>
+             * The caller must have called prepare() before replacing the data.
+             * </p>
+             * <p>
+             * This operation is <i>lock-free</i> unless reclaim() is triggered.
+             * </p>
+             * @param data the replaced data, exclusively owned by this list from here on.
+             */
+            template<typename T>
+            void retire(T* data) noexcept {
+                retired.push_back( entry_t{ domain.global_epoch.load(), data, &delete_as<T> } );
+                if( retired.size() >= threshold ) {
+                    reclaim();
+                }
+            }
+
+            /**
+             * Advances the global epoch and releases all retired data no reader may still access.
+             * <p>
+             * This operation is <i>lock-free</i>, its cost is linear to the number of retired data and reader threads.
+             * </p>
+             * @return number of released retired data
+             */
+            jau::nsize_t reclaim() noexcept {
+                domain.global_epoch.fetch_add(1);
+                const epoch_t min_epoch = domain.min_active_epoch();
+                std::size_t j = 0;
+                for(std::size_t i = 0; i < retired.size(); ++i) {
+                    if( retired[i].epoch < min_epoch ) {
+                        retired[i].deleter(retired[i].data);
+                    } else {
+                        retired[j++] = retired[i];
+                    }
+                }
+                const std::size_t released = retired.size() - j;
+                retired.resize(j);
+                threshold = std::max( batch_size, 2 * j );
+                return static_cast<jau::nsize_t>( released );
+            }
+
+            /** Returns the number of retired data not yet released. */
+            jau::nsize_t size() const noexcept { return static_cast<jau::nsize_t>( retired.size() ); }
+    };
+
+    /**
+     * RAII-style epoch_domain critical section,
+     * entering via constructor and leaving via destructor.
+     * @see jau::epoch_domain::enter()
+     * @see jau::epoch_domain::leave()
+     */
+    class epoch_guard {
+        private:
+            epoch_domain& domain;
+
+        public:
+            explicit epoch_guard(epoch_domain& d = epoch_domain::get())
+            : domain(d) { domain.enter(); }
+
+            ~epoch_guard() noexcept { domain.leave(); }
+
+            epoch_guard(const epoch_guard&) = delete;
+            epoch_guard& operator=(const epoch_guard&) = delete;
+    };
+
+    /**
+     * Immutable, read-only view of a shared storage, <i>lock-free</i>,
+     * holding an epoch_guard critical section and a raw storage pointer until destruction.
+     * <p>
+     * Other than jau::cow_ro_iterator, no shared reference of the storage is held,
+     * i.e. construction and destruction don't modify a shared reference counter.<br>
+     * The storage stays valid while this view exists, as replaced storages
+     * are released via epoch_domain::retire() only after all readers have left their epoch.
+     * </p>
+     * <p>
+     * This view shall not outlive its originating container and shall remain on the creating thread.
+     * </p>
+     * @tparam Storage_type the storage type, e.g. jau::darray or std::vector
+     * @see jau::cow_darray::epoch_view()
+     * @see jau::cow_vector::epoch_view()
+     */
+    template <typename Storage_type>
+    class epoch_ro_view {
+        public:
+            typedef Storage_type                                storage_t;
+            typedef typename storage_t::value_type              value_type;
+            typedef typename storage_t::size_type               size_type;
+            typedef typename storage_t::const_reference         const_reference;
+            typedef typename storage_t::const_iterator          const_iterator;
+
+        private:
+            epoch_guard guard;
+            const storage_t* store;
+
+        public:
+            /**
+             * Enters the epoch_domain critical section, then loads the storage pointer.
+             * @tparam Loader callable returning <code>const storage_t*</code> using SC atomic ordering
+             */
+            template<typename Loader>
+            explicit epoch_ro_view(Loader loader)
+            : guard(), store( loader() ) {}
+
+            epoch_ro_view(const epoch_ro_view&) = delete;
+            epoch_ro_view& operator=(const epoch_ro_view&) = delete;
+
+            /** Returns the raw storage pointer, valid until destruction of this view. */
+            constexpr const storage_t* storage() const noexcept { return store; }
+
+            constexpr size_type size() const noexcept { return nullptr != store ? store->size() : 0; }
+
+            constexpr bool empty() const noexcept { return nullptr == store || store->empty(); }
+
+            constexpr const_iterator begin() const noexcept { return nullptr != store ? store->cbegin() : const_iterator(); }
+
+            constexpr const_iterator end() const noexcept { return nullptr != store ? store->cend() : const_iterator(); }
+
+            constexpr const_reference operator[](size_type i) const noexcept { return (*store)[i]; }
+    };
+
+} /* namespace jau */
+
+#endif /* JAU_EPOCH_RECLAIM_HPP_ */
@@ -0,0 +1,408 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_FIXED_RINGBUFFER_HPP_
+#define JAU_FIXED_RINGBUFFER_HPP_
+
+#include <type_traits>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+#include <cstring>
+#include <string>
+#include <cstdint>
+
+#include <jau/debug.hpp>
+#include <jau/basic_types.hpp>
+#include <jau/int_math.hpp>
+#include <jau/ordered_atomic.hpp>
+#include <jau/ringbuffer_wait.hpp>
+#include <jau/ringbuffer_counter.hpp>
+
+namespace jau {
+
+/**
+ * Ring buffer implementation with a compile-time <code>Capacity</code> and inline storage,
+ * exposing the same <i>lock-free</i> {@link #get() get*(..)} and {@link #put(Object) put*(..)} API as jau::ringbuffer.
+ * <p>
+ * The elements are stored within this instance, i.e. no array is allocated.
+ * </p>
+ * <p>
+ * Instead of a read and write position, the implementation maintains free running 64-bit read and write counters.
+ * Hence no slot must be kept open to distinguish full from empty, i.e. the internal array holds exactly <code>Capacity</code> elements
+ * and the size is simply <code>writeCount - readCount</code>.<br>
+ * The array index is derived via <code>count % Capacity</code> with a constant divisor,
+ * becoming a bitmask if <code>Capacity</code> is a power of two, see is_pow2_capacity.
+ * </p>
+ * <p>
+ * As with jau::ringbuffer, the getter and putter owned state is placed on separate cache lines
+ * and each side only reloads the opposite counter if its cached copy appears empty or full.
+ * </p>
+ * <p>
+ * Thread safety and the <code>multi_pc</code> and <code>Wait_policy</code> template parameter are identical to jau::ringbuffer.
+ * </p>
+ * <p>
+ * Following methods are getter operations in SPSC mode, i.e. shall only be called by the getter thread:
+ * <ul>
+ *  <li>{@link #clear()}</li>
+ *  <li>{@link #drop(int)}</li>
+ * </ul>
+ * </p>
+ * @see jau::ringbuffer
+ */
+template <typename T, std::nullptr_t nullelem, typename Size_type, Size_type Capacity, bool multi_pc=true, typename Wait_policy=ringbuffer_wait_cv>
+class fixed_ringbuffer {
+    public:
+        static_assert(0 < Capacity, "Capacity must be greater than zero");
+
+        /** True if multiple getter and putter threads are supported, otherwise Single Producer Single Consumer (SPSC) mode. */
+        constexpr static const bool uses_multi_pc = multi_pc;
+
+        /** True if the batch operations getN() and putN() use memcpy, i.e. if T is trivially copyable. */
+        constexpr static const bool uses_memcpy = std::is_trivially_copyable_v<T>;
+
+        /** True if Capacity is a power of two, i.e. the array index is derived via a bitmask. */
+        constexpr static const bool is_pow2_capacity = is_power_of_2<std::make_unsigned_t<Size_type>>(Capacity);
+
+        /** The wait strategy used by the blocking operations, see ringbuffer_wait. */
+        typedef Wait_policy wait_policy_type;
+
+        /** View of up to two contiguous storage segments. */
+        typedef ringbuffer_span<T, Size_type> span_type;
+
+    private:
+        /** Assumed cache line size, separating getter and putter owned state. */
+        constexpr static const std::size_t cache_line_size = 64;
+
+        typedef ringbuffer_counter<Size_type, Wait_policy, ringbuffer_fixed_index<Size_type, Capacity>> counter_type;
+
+        counter_type counter;            // Read and write counter, cached copies and wait objects on separate cache lines
+
+        alignas(cache_line_size) std::mutex syncMultiRead;  // Memory-Model (MM) guaranteed sequential consistency (SC) between acquire and release
+        alignas(cache_line_size) std::mutex syncMultiWrite; // ditto
+
+        alignas(cache_line_size) T array[Capacity]; // Synchronized due to MM's data-race-free SC (SC-DRF) between [atomic] acquire/release
+
+        Size_type dropImpl(const Size_type count) noexcept {
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            const Size_type dropCount = std::min(count, counter.available(localReadCount, count));
+            if( 0 == dropCount ) {
+                return 0;
+            }
+            for(Size_type i=0; i<dropCount; i++) {
+                array[counter.index(localReadCount + i)] = nullelem;
+            }
+            counter.advanceRead(localReadCount, dropCount); // SC-DRF release atomic readCount
+            return dropCount;
+        }
+
+        T moveOutImpl(const bool blocking, const int timeoutMS) noexcept {
+            std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // _not_ sync'ing w/ putImpl
+            if constexpr ( multi_pc ) {
+                lockMultiRead.lock(); // acquire syncMultiRead
+            }
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            if( 0 == counter.available(localReadCount, 1) ) { // SC-DRF acquire atomic writeCount if appearing empty, sync'ing with putImpl
+                if( !blocking || !counter.waitForElements(localReadCount, 1, timeoutMS) ) {
+                    return nullelem;
+                }
+            }
+            const Size_type i = counter.index(localReadCount);
+            T r = std::move( array[i] ); // SC-DRF
+            array[i] = nullelem;
+            counter.advanceRead(localReadCount, 1); // SC-DRF release atomic readCount
+            return r;
+        }
+
+        T peekImpl(const bool blocking, const int timeoutMS) noexcept {
+            std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // _not_ sync'ing w/ putImpl
+            if constexpr ( multi_pc ) {
+                lockMultiRead.lock(); // acquire syncMultiRead
+            }
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            if( 0 == counter.available(localReadCount, 1) ) { // SC-DRF acquire atomic writeCount if appearing empty, sync'ing with putImpl
+                if( !blocking || !counter.waitForElements(localReadCount, 1, timeoutMS) ) {
+                    return nullelem;
+                }
+            }
+            return array[counter.index(localReadCount)]; // SC-DRF
+        }
+
+        template<typename U>
+        bool putImpl(U && e, const bool blocking, const int timeoutMS) noexcept {
+            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock); // _not_ sync'ing w/ getImpl
+            if constexpr ( multi_pc ) {
+                lockMultiWrite.lock(); // acquire syncMultiWrite
+            }
+            const uint64_t localWriteCount = counter.loadWriteCount(); // owned by putter
+            if( 0 == counter.freeSlots(localWriteCount, 1) ) { // SC-DRF acquire atomic readCount if appearing full, sync'ing with getImpl
+                if( !blocking || !counter.waitForFreeSlots(localWriteCount, 1, timeoutMS) ) {
+                    return false;
+                }
+            }
+            array[counter.index(localWriteCount)] = std::forward<U>(e); // SC-DRF
+            counter.advanceWrite(localWriteCount, 1); // SC-DRF release atomic writeCount
+            return true;
+        }
+
+        Size_type getNImpl(T * dst, Size_type min_count, const Size_type max_count, const bool blocking, const int timeoutMS) noexcept {
+            min_count = std::min(min_count, std::min(max_count, Capacity));
+            std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // _not_ sync'ing w/ putImpl
+            if constexpr ( multi_pc ) {
+                lockMultiRead.lock(); // acquire syncMultiRead
+            }
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            Size_type available = counter.available(localReadCount, max_count); // SC-DRF acquire atomic writeCount if less than max_count appear available
+            if( available < min_count ) {
+                if( !blocking || !counter.waitForElements(localReadCount, min_count, timeoutMS) ) {
+                    return 0;
+                }
+                available = counter.cachedAvailable(localReadCount);
+            }
+            const span_type s = counter.span(array, localReadCount, std::min(available, max_count));
+            if( 0 == s.size() ) {
+                return 0;
+            }
+            if constexpr ( uses_memcpy ) {
+                ::memcpy(reinterpret_cast<void*>(dst), reinterpret_cast<const void*>(s.data1), s.size1 * sizeof(T));
+                if( 0 < s.size2 ) {
+                    ::memcpy(reinterpret_cast<void*>(dst + s.size1), reinterpret_cast<const void*>(s.data2), s.size2 * sizeof(T)); // wrap-around
+                }
+            } else {
+                for(Size_type i=0; i<s.size(); i++) {
+                    dst[i] = std::move( s[i] );
+                    s[i] = nullelem;
+                }
+            }
+            counter.advanceRead(localReadCount, s.size()); // SC-DRF release atomic readCount, once per batch
+            return s.size();
+        }
+
+        Size_type putNImpl(const T * src, Size_type min_count, const Size_type count, const bool blocking, const int timeoutMS) noexcept {
+            min_count = std::min(min_count, std::min(count, Capacity));
+            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock); // _not_ sync'ing w/ getImpl
+            if constexpr ( multi_pc ) {
+                lockMultiWrite.lock(); // acquire syncMultiWrite
+            }
+            const uint64_t localWriteCount = counter.loadWriteCount(); // owned by putter
+            Size_type freeSlots = counter.freeSlots(localWriteCount, count); // SC-DRF acquire atomic readCount if less than count appear free
+            if( freeSlots < min_count ) {
+                if( !blocking || !counter.waitForFreeSlots(localWriteCount, min_count, timeoutMS) ) {
+                    return 0;
+                }
+                freeSlots = counter.cachedFreeSlots(localWriteCount);
+            }
+            const span_type s = counter.span(array, localWriteCount, std::min(freeSlots, count));
+            if( 0 == s.size() ) {
+                return 0;
+            }
+            if constexpr ( uses_memcpy ) {
+                ::memcpy(reinterpret_cast<void*>(s.data1), reinterpret_cast<const void*>(src), s.size1 * sizeof(T));
+                if( 0 < s.size2 ) {
+                    ::memcpy(reinterpret_cast<void*>(s.data2), reinterpret_cast<const void*>(src + s.size1), s.size2 * sizeof(T)); // wrap-around
+                }
+            } else {
+                for(Size_type i=0; i<s.size(); i++) {
+                    s[i] = src[i];
+                }
+            }
+            counter.advanceWrite(localWriteCount, s.size()); // SC-DRF release atomic writeCount, once per batch
+            return s.size();
+        }
+
+    public:
+        /** Returns a short string representation incl. size/capacity and internal r/w counter (impl. dependent). */
+        std::string toString() const noexcept {
+            const std::string es = isEmpty() ? ", empty" : "";
+            const std::string fs = isFull() ? ", full" : "";
+            return "fixed_ringbuffer<?>[size "+std::to_string(getSize())+" / "+std::to_string(Capacity)+
+                    ", writeCount "+std::to_string(counter.state().writeCount.load())+", readCount "+std::to_string(counter.state().readCount.load())+es+fs+"]";
+        }
+
+        /**
+         * Create an empty ring buffer instance w/ the compile-time net <code>Capacity</code>.
+         */
+        fixed_ringbuffer() noexcept
+        : counter(), array()
+        { }
+
+        fixed_ringbuffer(const fixed_ringbuffer &_source) = delete;
+        fixed_ringbuffer& operator=(const fixed_ringbuffer &_source) = delete;
+
+        /** Returns the net capacity of this ring buffer. */
+        constexpr Size_type capacity() const noexcept { return Capacity; }
+
+        /**
+         * Releasing all elements by assigning <code>null</code>.
+         * <p>
+         * {@link #isEmpty()} will return <code>true</code> and
+         * {@link #getSize()} will return <code>0</code> after calling this method.
+         * </p>
+         */
+        void clear() noexcept {
+            if constexpr ( multi_pc ) {
+                std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock);          // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
+                std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock);        // otherwise RAII-style relinquish via destructor
+                std::lock(lockMultiRead, lockMultiWrite);
+                dropImpl(Capacity);
+            } else {
+                dropImpl(Capacity);
+            }
+        }
+
+        /** Returns the number of elements in this ring buffer. */
+        Size_type getSize() const noexcept { return counter.getSize(); }
+
+        /** Returns the number of free slots available to put.  */
+        Size_type getFreeSlots() const noexcept { return Capacity - counter.getSize(); }
+
+        /** Returns true if this ring buffer is empty, otherwise false. */
+        bool isEmpty() const noexcept { return 0 == counter.getSize(); }
+
+        /** Returns true if this ring buffer is full, otherwise false. */
+        bool isFull() const noexcept { return Capacity <= counter.getSize(); }
+
+        /**
+         * Dequeues the oldest enqueued element if available, otherwise null.
+         * @see ringbuffer::get()
+         */
+        T get() noexcept {
+            return moveOutImpl(false, 0);
+        }
+
+        /**
+         * Dequeues the oldest enqueued element, blocking up to timeoutMS or infinitely if zero.
+         * @see ringbuffer::getBlocking()
+         */
+        T getBlocking(const int timeoutMS=0) noexcept {
+            return moveOutImpl(true, timeoutMS);
+        }
+
+        /**
+         * Peeks the next element at the read position w/o modifying pointer, nor blocking.
+         * @see ringbuffer::peek()
+         */
+        T peek() noexcept {
+            return peekImpl(false, 0);
+        }
+
+        /**
+         * Peeks the next element at the read position w/o modifying pointer, but with blocking.
+         * @see ringbuffer::peekBlocking()
+         */
+        T peekBlocking(const int timeoutMS=0) noexcept {
+            return peekImpl(true, timeoutMS);
+        }
+
+        /**
+         * Drops up to {@code count} oldest enqueued elements.
+         * @see ringbuffer::drop()
+         */
+        Size_type drop(const Size_type count) noexcept {
+            if constexpr ( multi_pc ) {
+                std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
+                std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock); // otherwise RAII-style relinquish via destructor
+                std::lock(lockMultiRead, lockMultiWrite);
+                return dropImpl(count);
+            } else {
+                return dropImpl(count);
+            }
+        }
+
+        /**
+         * Dequeues up to max_count oldest enqueued elements, moving them into the given dst array.
+         * @see ringbuffer::getN()
+         */
+        Size_type getN(T * dst, const Size_type max_count) noexcept {
+            return getNImpl(dst, 1, max_count, false, 0);
+        }
+
+        /**
+         * Dequeues up to max_count oldest enqueued elements after blocking until at least min_count elements are available.
+         * @see ringbuffer::getNBlocking()
+         */
+        Size_type getNBlocking(T * dst, const Size_type min_count, const Size_type max_count, const int timeoutMS=0) noexcept {
+            return getNImpl(dst, min_count, max_count, true, timeoutMS);
+        }
+
+        /**
+         * Enqueues up to count elements of the given src array by copying them into this ringbuffer storage.
+         * @see ringbuffer::putN()
+         */
+        Size_type putN(const T * src, const Size_type count) noexcept {
+            return putNImpl(src, 1, count, false, 0);
+        }
+
+        /**
+         * Enqueues up to count elements of the given src array after blocking until at least min_count free slots are available.
+         * @see ringbuffer::putNBlocking()
+         */
+        Size_type putNBlocking(const T * src, const Size_type min_count, const Size_type count, const int timeoutMS=0) noexcept {
+            return putNImpl(src, min_count, count, true, timeoutMS);
+        }
+
+        /**
+         * Enqueues the given element by moving it into this ringbuffer storage.
+         * @see ringbuffer::put()
+         */
+        bool put(T && e) noexcept {
+            return putImpl(std::move(e), false, 0);
+        }
+
+        /**
+         * Enqueues the given element by moving it into this ringbuffer storage, blocking up to timeoutMS or infinitely if zero.
+         * @see ringbuffer::putBlocking()
+         */
+        bool putBlocking(T && e, const int timeoutMS=0) noexcept {
+            return putImpl(std::move(e), true, timeoutMS);
+        }
+
+        /**
+         * Enqueues the given element by copying it into this ringbuffer storage.
+         * @see ringbuffer::put()
+         */
+        bool put(const T & e) noexcept {
+            return putImpl(e, false, 0);
+        }
+
+        /**
+         * Enqueues the given element by copying it into this ringbuffer storage, blocking up to timeoutMS or infinitely if zero.
+         * @see ringbuffer::putBlocking()
+         */
+        bool putBlocking(const T & e, const int timeoutMS=0) noexcept {
+            return putImpl(e, true, timeoutMS);
+        }
+};
+
+} /* namespace jau */
+
+/** \example test_lfringbuffer_perf01.cpp
+ * This C++ unit test also benchmarks jau::fixed_ringbuffer against jau::ringbuffer
+ * w/ and w/o power of two capacity.
+ */
+
+#endif /* JAU_FIXED_RINGBUFFER_HPP_ */
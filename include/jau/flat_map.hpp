@@ -0,0 +1,532 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_FLAT_MAP_HPP_
+#define JAU_FLAT_MAP_HPP_
+
+#include <string>
+#include <cstdint>
+#include <memory>
+#include <initializer_list>
+#include <functional>
+#include <algorithm>
+#include <utility>
+#include <tuple>
+
+#include <jau/cpp_lang_util.hpp>
+#include <jau/basic_types.hpp>
+#include <jau/callocator.hpp>
+#include <jau/basic_algos.hpp>
+#include <jau/darray.hpp>
+
+namespace jau {
+
+    /**
+     * Implementation of a sorted associative map of unique keys to mapped values,
+     * stored as <code>std::pair<Key, T></code> in a contiguous jau::darray.
+     * <p>
+     * See jau::flat_set for the storage and complexity properties,
+     * which apply likewise.
+     * </p>
+     * <p>
+     * Mutable iterator are of type <code>value_type*</code> to allow in place modification of the mapped value.
+     * The user shall not modify the key of an element, as it would break the sorted order.
+     * </p>
+     * <p>
+     * See jau::cow_flat_map for a CoW variant with lock-free read access.
+     * </p>
+     *
+     * @tparam Key the key type
+     * @tparam T the mapped type
+     * @tparam Compare less-than key comparator, defaults to <code>std::less<Key></code>
+     * @tparam Alloc_type allocator of the underlying jau::darray storage
+     * @tparam Size_type size type of the underlying jau::darray storage
+     * @tparam use_memmove see jau::darray
+     * @tparam use_realloc see jau::darray
+     * @tparam sec_mem see jau::darray
+     * @see jau::darray
+     * @see jau::flat_set
+     * @see jau::cow_flat_map
+     */
+    template <typename Key, typename T, typename Compare = std::less<Key>,
+              typename Alloc_type = jau::callocator<std::pair<Key, T>>, typename Size_type = jau::nsize_t,
+              bool use_memmove = jau::is_trivially_relocatable_v<std::pair<Key, T>>,
+              bool use_realloc = std::is_base_of_v<jau::callocator<std::pair<Key, T>>, Alloc_type>,
+              bool sec_mem = false
+             >
+    class flat_map
+    {
+        public:
+            /** Default growth factor using the golden ratio 1.618 */
+            constexpr static const float DEFAULT_GROWTH_FACTOR = 1.618f;
+
+            // typedefs' for C++ named requirements: AssociativeContainer
+
+            typedef Key                                         key_type;
+            typedef T                                           mapped_type;
+            typedef std::pair<Key, T>                           value_type;
+            typedef Compare                                     key_compare;
+            typedef value_type*                                 pointer;
+            typedef const value_type*                           const_pointer;
+            typedef value_type&                                 reference;
+            typedef const value_type&                           const_reference;
+            typedef value_type*                                 iterator;
+            typedef const value_type*                           const_iterator;
+            typedef Size_type                                   size_type;
+            typedef typename std::make_signed<size_type>::type  difference_type;
+            typedef Alloc_type                                  allocator_type;
+
+            typedef darray<value_type, allocator_type, size_type, use_memmove, use_realloc, sec_mem> storage_t;
+
+            /** Less-than comparator of value_type, comparing the keys only. */
+            class value_compare {
+                friend class flat_map;
+                private:
+                    key_compare comp;
+                    constexpr value_compare(const key_compare& c) : comp(c) {}
+                public:
+                    constexpr bool operator()(const value_type& a, const value_type& b) const { return comp(a.first, b.first); }
+                    constexpr bool operator()(const value_type& a, const key_type& b) const { return comp(a.first, b); }
+                    constexpr bool operator()(const key_type& a, const value_type& b) const { return comp(a, b.first); }
+            };
+
+        private:
+            storage_t store;
+            value_compare comp;
+
+            template<class M>
+            std::pair<iterator, bool> insert_impl(const key_type& key, M&& obj, const bool assign) {
+                iterator pos = lower_bound(key);
+                if( pos < store.end() && !comp.comp(key, pos->first) ) {
+                    if( assign ) {
+                        pos->second = std::forward<M>(obj);
+                    }
+                    return std::make_pair(pos, false);
+                }
+                return std::make_pair(store.emplace(pos, key, std::forward<M>(obj)), true);
+            }
+
+            /**
+             * Merges the given sorted and unique elements into this sorted storage in one pass,
+             * retaining existing elements in case of equivalent keys.
+             * @return number of newly added elements
+             */
+            size_type merge_sorted_unique(storage_t& x) {
+                if( x.empty() ) {
+                    return 0;
+                }
+                if( store.empty() || comp(store.back(), x.front()) ) {
+                    // append
+                    const size_type count = x.size();
+                    store.reserve( store.size() + count );
+                    for(auto it = x.begin(); it < x.end(); ++it) {
+                        store.push_back( std::move( *it ) );
+                    }
+                    return count;
+                }
+                storage_t merged( store.size() + x.size(), store.growth_factor(), store.get_allocator_ref() );
+                auto a = store.begin(); const auto a_end = store.end();
+                auto b = x.begin(); const auto b_end = x.end();
+                size_type count = 0;
+                while( a < a_end && b < b_end ) {
+                    if( comp(*a, *b) ) {
+                        merged.push_back( std::move( *a++ ) );
+                    } else if( comp(*b, *a) ) {
+                        merged.push_back( std::move( *b++ ) );
+                        ++count;
+                    } else {
+                        merged.push_back( std::move( *a++ ) );
+                        ++b;
+                    }
+                }
+                for(; a < a_end; ++a) {
+                    merged.push_back( std::move( *a ) );
+                }
+                for(; b < b_end; ++b, ++count) {
+                    merged.push_back( std::move( *b ) );
+                }
+                store = std::move( merged );
+                return count;
+            }
+
+        public:
+            /**
+             * Default constructor, giving zero capacity and zero memory footprint.
+             */
+            constexpr flat_map() noexcept
+            : store(), comp(key_compare()) { }
+
+            /**
+             * Creating an empty instance with the given comparator.
+             */
+            constexpr explicit flat_map(const key_compare& comp_) noexcept
+            : store(), comp(comp_) { }
+
+            /**
+             * Creating an empty instance with initial capacity and other (default) properties.
+             * @param capacity initial capacity of the new instance.
+             * @param growth_factor given growth factor
+             * @param alloc given allocator_type
+             */
+            constexpr explicit flat_map(size_type capacity, const float growth_factor=DEFAULT_GROWTH_FACTOR, const allocator_type& alloc = allocator_type())
+            : store(capacity, growth_factor, alloc), comp(key_compare()) { }
+
+            /**
+             * Creates a new instance, inserting all elements with unique keys from the given
+             * template input-iterator value_type range [first, last).
+             * @tparam InputIt template input-iterator custom type
+             * @param first template input-iterator to first element of value_type range [first, last)
+             * @param last template input-iterator to last element of value_type range [first, last)
+             * @param comp_ key comparator
+             */
+            template< class InputIt >
+            constexpr flat_map(InputIt first, InputIt last, const key_compare& comp_ = key_compare())
+            : store(), comp(comp_)
+            { insert(first, last); }
+
+            /**
+             * Create a new instance from an initializer list, inserting all elements with unique keys.
+             *
+             * @param initlist initializer_list.
+             * @param comp_ key comparator
+             */
+            constexpr flat_map(std::initializer_list<value_type> initlist, const key_compare& comp_ = key_compare())
+            : store(), comp(comp_)
+            { insert(initlist.begin(), initlist.end()); }
+
+            /**
+             * Creates a new instance with custom initial storage capacity, copying all elements from the given flat_map.<br>
+             * Size will equal the given map.
+             * <p>
+             * Throws jau::IllegalArgumentException() if <code>_capacity < x.size()</code>.
+             * </p>
+             * @param x the given flat_map, all elements will be copied into the new instance.
+             * @param _capacity custom initial storage capacity
+             * @param growth_factor custom growth factor
+             * @param alloc custom allocator_type instance
+             */
+            constexpr explicit flat_map(const flat_map& x, const size_type _capacity, const float growth_factor, const allocator_type& alloc)
+            : store(x.store, _capacity, growth_factor, alloc), comp(x.comp) { }
+
+            constexpr flat_map(const flat_map& x) = default;
+            constexpr flat_map(flat_map && x) noexcept = default;
+            constexpr flat_map& operator=(const flat_map& x) = default;
+            constexpr flat_map& operator=(flat_map&& x) noexcept = default;
+
+            ~flat_map() noexcept = default;
+
+            // read access
+
+            /** Returns the underlying sorted jau::darray storage. */
+            constexpr const storage_t& storage() const noexcept { return store; }
+
+            const allocator_type& get_allocator_ref() const noexcept { return store.get_allocator_ref(); }
+
+            allocator_type get_allocator() const noexcept { return store.get_allocator(); }
+
+            constexpr key_compare key_comp() const { return comp.comp; }
+
+            constexpr value_compare value_comp() const { return comp; }
+
+            constexpr size_type max_size() const noexcept { return store.max_size(); }
+
+            /** Returns the growth factor of the underlying jau::darray storage. */
+            constexpr float growth_factor() const noexcept { return store.growth_factor(); }
+
+            constexpr iterator begin() noexcept { return store.begin(); }
+
+            constexpr const_iterator begin() const noexcept { return store.cbegin(); }
+
+            constexpr const_iterator cbegin() const noexcept { return store.cbegin(); }
+
+            constexpr iterator end() noexcept { return store.end(); }
+
+            constexpr const_iterator end() const noexcept { return store.cend(); }
+
+            constexpr const_iterator cend() const noexcept { return store.cend(); }
+
+            /** Like std::vector::capacity(). */
+            constexpr size_type capacity() const noexcept { return store.capacity(); }
+
+            /** Like std::map::empty(). */
+            constexpr bool empty() const noexcept { return store.empty(); }
+
+            /** Like std::map::size(). */
+            constexpr size_type size() const noexcept { return store.size(); }
+
+            /** Like std::vector::reserve(), increases this instance's capacity to <code>new_capacity</code>. */
+            void reserve(size_type new_capacity) { store.reserve(new_capacity); }
+
+            // lookup
+
+            /**
+             * Like std::map::lower_bound(), using the branchless jau::lower_bound().
+             * @return iterator to the first element with a key not less than the given key, or end().
+             */
+            constexpr iterator lower_bound(const key_type& key) {
+                return jau::lower_bound(store.begin(), store.end(), key, comp);
+            }
+
+            /**
+             * Like std::map::lower_bound(), using the branchless jau::lower_bound().
+             * @return const_iterator to the first element with a key not less than the given key, or end().
+             */
+            constexpr const_iterator lower_bound(const key_type& key) const {
+                return jau::lower_bound(store.cbegin(), store.cend(), key, comp);
+            }
+
+            /**
+             * Like std::map::upper_bound(), using the branchless jau::upper_bound().
+             * @return const_iterator to the first element with a key greater than the given key, or end().
+             */
+            constexpr const_iterator upper_bound(const key_type& key) const {
+                return jau::upper_bound(store.cbegin(), store.cend(), key, comp);
+            }
+
+            /**
+             * Like std::map::find().
+             * @return iterator to the element with the given key, or end().
+             */
+            constexpr iterator find(const key_type& key) {
+                iterator it = lower_bound(key);
+                return it < store.end() && !comp.comp(key, it->first) ? it : store.end();
+            }
+
+            /**
+             * Like std::map::find().
+             * @return const_iterator to the element with the given key, or end().
+             */
+            constexpr const_iterator find(const key_type& key) const {
+                const_iterator it = lower_bound(key);
+                return it < store.cend() && !comp.comp(key, it->first) ? it : store.cend();
+            }
+
+            /** Like std::map::contains() of C++20. */
+            constexpr bool contains(const key_type& key) const { return find(key) != store.cend(); }
+
+            /** Like std::map::count(), returns either 0 or 1. */
+            constexpr size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+            /**
+             * Like std::map::at(), returns a reference to the mapped value of the given key.
+             * <p>
+             * Throws jau::IllegalArgumentException() if no element with the given key exists.
+             * </p>
+             */
+            mapped_type& at(const key_type& key) {
+                iterator it = find(key);
+                if( it < store.end() ) {
+                    return it->second;
+                }
+                throw jau::IllegalArgumentException("key not found", E_FILE_LINE);
+            }
+
+            /**
+             * Like std::map::at(), returns a const reference to the mapped value of the given key.
+             * <p>
+             * Throws jau::IllegalArgumentException() if no element with the given key exists.
+             * </p>
+             */
+            const mapped_type& at(const key_type& key) const {
+                const_iterator it = find(key);
+                if( it < store.cend() ) {
+                    return it->second;
+                }
+                throw jau::IllegalArgumentException("key not found", E_FILE_LINE);
+            }
+
+            /**
+             * Like std::map::operator[](), returns a reference to the mapped value of the given key,
+             * inserting a default constructed mapped value if not existing yet.
+             */
+            mapped_type& operator[](const key_type& key) {
+                return try_emplace(key).first->second;
+            }
+
+            // write access
+
+            /** Like std::map::clear(), but keeping the storage capacity. */
+            constexpr void clear() noexcept { store.clear(); }
+
+            /** Like std::map::swap(). */
+            constexpr void swap(flat_map& x) noexcept {
+                store.swap(x.store);
+                std::swap(comp, x.comp);
+            }
+
+            /**
+             * Like std::map::insert(), copy
+             * @param x the value to be inserted
+             * @return pair of iterator to the inserted or existing element and true if inserted.
+             */
+            std::pair<iterator, bool> insert(const value_type& x) {
+                return insert_impl(x.first, x.second, false);
+            }
+
+            /**
+             * Like std::map::insert(), move
+             * @param x the value to be moved into
+             * @return pair of iterator to the inserted or existing element and true if inserted.
+             */
+            std::pair<iterator, bool> insert(value_type&& x) {
+                iterator pos = lower_bound(x.first);
+                if( pos < store.end() && !comp.comp(x.first, pos->first) ) {
+                    return std::make_pair(pos, false);
+                }
+                return std::make_pair(store.insert(pos, std::move(x)), true);
+            }
+
+            /**
+             * Like std::map::insert_or_assign(), inserts the given mapped value
+             * or assigns it to an existing element with the given key.
+             * @return pair of iterator to the inserted or assigned element and true if inserted.
+             */
+            template<class M>
+            std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+                return insert_impl(key, std::forward<M>(obj), true);
+            }
+
+            /**
+             * Like std::map::try_emplace(), constructs the mapped value in place
+             * only if no element with the given key exists.
+             * @param key the key of the element
+             * @param args arguments to forward to the constructor of the mapped value
+             * @return pair of iterator to the inserted or existing element and true if inserted.
+             */
+            template<typename... Args>
+            std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+                iterator pos = lower_bound(key);
+                if( pos < store.end() && !comp.comp(key, pos->first) ) {
+                    return std::make_pair(pos, false);
+                }
+                return std::make_pair(store.emplace(pos, std::piecewise_construct, std::forward_as_tuple(key),
+                                                    std::forward_as_tuple(std::forward<Args>(args)...)), true);
+            }
+
+            /**
+             * Bulk insertion of the value_type range [first, last).
+             * <p>
+             * The new elements are sorted and reduced to unique keys first,
+             * then merged with the existing sorted storage in one pass,
+             * retaining existing elements in case of equivalent keys.
+             * See jau::flat_set::insert(InputIt, InputIt).
+             * </p>
+             * @tparam InputIt foreign input-iterator to range of value_type [first, last)
+             * @param first first foreign input-iterator to range of value_type [first, last)
+             * @param last last foreign input-iterator to range of value_type [first, last)
+             * @return number of newly added elements
+             */
+            template< class InputIt >
+            size_type insert(InputIt first, InputIt last) {
+                storage_t x(first, last, store.get_allocator_ref());
+                std::stable_sort(x.begin(), x.end(), comp);
+                x.erase( std::unique(x.begin(), x.end(), [this](const value_type& a, const value_type& b) -> bool {
+                            return !comp(a, b) && !comp(b, a); }),
+                         x.cend() );
+                return merge_sorted_unique(x);
+            }
+
+            /**
+             * Like std::map::erase(), erasing the element with the given key.
+             * @return number of erased elements, either 0 or 1.
+             */
+            size_type erase(const key_type& key) {
+                const_iterator it = find(key);
+                if( it < store.cend() ) {
+                    store.erase(it);
+                    return 1;
+                }
+                return 0;
+            }
+
+            /**
+             * Like std::map::erase(), erasing the element at the given position.
+             * @return iterator following the erased element
+             */
+            iterator erase(const_iterator pos) {
+                return store.erase(pos);
+            }
+
+            /**
+             * Erase all elements satisfying the given predicate in a single pass,
+             * see jau::darray::erase_if().
+             * @param pred unary predicate, like <code>bool pred(const value_type& e)</code>
+             * @return number of erased elements
+             */
+            template<class UnaryPredicate>
+            size_type erase_if(UnaryPredicate pred) {
+                return store.erase_if(pred);
+            }
+
+            constexpr_cxx20 std::string toString() const noexcept {
+                std::string res("{ " + std::to_string( size() ) + ": ");
+                int i=0;
+                for(const_iterator it = store.cbegin(); it < store.cend(); ++it) {
+                    if( 1 < ++i ) { res.append(", "); }
+                    res.append( jau::to_string(it->first) ).append(": ").append( jau::to_string(it->second) );
+                }
+                res.append(" }");
+                return res;
+            }
+
+            constexpr_cxx20 std::string get_info() const noexcept {
+                return "flat_map["+store.get_info()+"]";
+            }
+    };
+
+    /****************************************************************************************
+     ****************************************************************************************/
+
+    template<typename Key, typename T, typename Compare, typename Alloc_type>
+    std::ostream & operator << (std::ostream &out, const flat_map<Key, T, Compare, Alloc_type> &c) {
+        out << c.toString();
+        return out;
+    }
+
+    /****************************************************************************************
+     ****************************************************************************************/
+
+    template<typename Key, typename T, typename Compare, typename Alloc_type>
+    inline bool operator==(const flat_map<Key, T, Compare, Alloc_type>& rhs, const flat_map<Key, T, Compare, Alloc_type>& lhs) {
+        if( &rhs == &lhs ) {
+            return true;
+        }
+        return (rhs.size() == lhs.size() && std::equal(rhs.cbegin(), rhs.cend(), lhs.cbegin()));
+    }
+    template<typename Key, typename T, typename Compare, typename Alloc_type>
+    inline bool operator!=(const flat_map<Key, T, Compare, Alloc_type>& rhs, const flat_map<Key, T, Compare, Alloc_type>& lhs) {
+        return !(rhs==lhs);
+    }
+
+    template<typename Key, typename T, typename Compare, typename Alloc_type>
+    inline void swap(flat_map<Key, T, Compare, Alloc_type>& rhs, flat_map<Key, T, Compare, Alloc_type>& lhs) noexcept
+    { rhs.swap(lhs); }
+
+} /* namespace jau */
+
+/** \example test_flat_map01.cpp
+ * This C++ unit test validates the jau::flat_map and jau::cow_flat_map implementation.
+ */
+
+#endif /* JAU_FLAT_MAP_HPP_ */
@@ -0,0 +1,469 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_FLAT_SET_HPP_
+#define JAU_FLAT_SET_HPP_
+
+#include <string>
+#include <cstdint>
+#include <memory>
+#include <initializer_list>
+#include <functional>
+#include <algorithm>
+#include <utility>
+
+#include <jau/cpp_lang_util.hpp>
+#include <jau/basic_types.hpp>
+#include <jau/callocator.hpp>
+#include <jau/basic_algos.hpp>
+#include <jau/darray.hpp>
+
+namespace jau {
+
+    /**
+     * Implementation of a sorted associative set of unique keys,
+     * stored in a contiguous jau::darray.
+     * <p>
+     * Compared to a node based std::set or a bucket based std::unordered_set,
+     * jau::flat_set trades insertion and erasure costs of <code>O(n)</code> element moves
+     * for a compact cache friendly storage and an <code>O(log n)</code> lookup
+     * via the branchless jau::lower_bound().<br>
+     * Hence it is suitable for read-mostly sets of small value_type,
+     * e.g. known device addresses, replacing linear jau::find_const() scans.
+     * </p>
+     * <p>
+     * Element moves on insert and erase are performed via <code>memmove</code>
+     * if <code>use_memmove</code> is true, see jau::darray and jau::is_trivially_relocatable.
+     * </p>
+     * <p>
+     * Bulk insertion via insert(InputIt, InputIt) sorts the new elements only
+     * and merges them with the existing storage in one pass.
+     * </p>
+     * <p>
+     * Iterator are of type <code>const value_type*</code>, as the keys shall not be mutated in place.
+     * Like jau::darray, any mutation invalidates all iterator.
+     * </p>
+     * <p>
+     * See jau::cow_flat_set for a CoW variant with lock-free read access.
+     * </p>
+     *
+     * @tparam Key the key and value type
+     * @tparam Compare less-than comparator, defaults to <code>std::less<Key></code>
+     * @tparam Alloc_type allocator of the underlying jau::darray storage
+     * @tparam Size_type size type of the underlying jau::darray storage
+     * @tparam use_memmove see jau::darray
+     * @tparam use_realloc see jau::darray
+     * @tparam sec_mem see jau::darray
+     * @see jau::darray
+     * @see jau::flat_map
+     * @see jau::cow_flat_set
+     */
+    template <typename Key, typename Compare = std::less<Key>,
+              typename Alloc_type = jau::callocator<Key>, typename Size_type = jau::nsize_t,
+              bool use_memmove = jau::is_trivially_relocatable_v<Key>,
+              bool use_realloc = std::is_base_of_v<jau::callocator<Key>, Alloc_type>,
+              bool sec_mem = false
+             >
+    class flat_set
+    {
+        public:
+            /** Default growth factor using the golden ratio 1.618 */
+            constexpr static const float DEFAULT_GROWTH_FACTOR = 1.618f;
+
+            // typedefs' for C++ named requirements: AssociativeContainer
+
+            typedef Key                                         key_type;
+            typedef Key                                         value_type;
+            typedef Compare                                     key_compare;
+            typedef Compare                                     value_compare;
+            typedef const value_type*                           pointer;
+            typedef const value_type*                           const_pointer;
+            typedef const value_type&                           reference;
+            typedef const value_type&                           const_reference;
+            typedef const value_type*                           iterator;
+            typedef const value_type*                           const_iterator;
+            typedef Size_type                                   size_type;
+            typedef typename std::make_signed<size_type>::type  difference_type;
+            typedef Alloc_type                                  allocator_type;
+
+            typedef darray<value_type, allocator_type, size_type, use_memmove, use_realloc, sec_mem> storage_t;
+
+        private:
+            storage_t store;
+            key_compare comp;
+
+            constexpr bool equivalent(const key_type& a, const key_type& b) const {
+                return !comp(a, b) && !comp(b, a);
+            }
+
+            /**
+             * Merges the given sorted and unique elements into this sorted storage in one pass,
+             * retaining existing elements in case of equivalence.
+             * @return number of newly added elements
+             */
+            size_type merge_sorted_unique(storage_t& x) {
+                if( x.empty() ) {
+                    return 0;
+                }
+                if( store.empty() || comp(store.back(), x.front()) ) {
+                    // append
+                    const size_type count = x.size();
+                    store.reserve( store.size() + count );
+                    for(auto it = x.begin(); it < x.end(); ++it) {
+                        store.push_back( std::move( *it ) );
+                    }
+                    return count;
+                }
+                storage_t merged( store.size() + x.size(), store.growth_factor(), store.get_allocator_ref() );
+                auto a = store.begin(); const auto a_end = store.end();
+                auto b = x.begin(); const auto b_end = x.end();
+                size_type count = 0;
+                while( a < a_end && b < b_end ) {
+                    if( comp(*a, *b) ) {
+                        merged.push_back( std::move( *a++ ) );
+                    } else if( comp(*b, *a) ) {
+                        merged.push_back( std::move( *b++ ) );
+                        ++count;
+                    } else {
+                        merged.push_back( std::move( *a++ ) );
+                        ++b;
+                    }
+                }
+                for(; a < a_end; ++a) {
+                    merged.push_back( std::move( *a ) );
+                }
+                for(; b < b_end; ++b, ++count) {
+                    merged.push_back( std::move( *b ) );
+                }
+                store = std::move( merged );
+                return count;
+            }
+
+        public:
+            /**
+             * Default constructor, giving zero capacity and zero memory footprint.
+             */
+            constexpr flat_set() noexcept
+            : store(), comp() { }
+
+            /**
+             * Creating an empty instance with the given comparator.
+             */
+            constexpr explicit flat_set(const key_compare& comp_) noexcept
+            : store(), comp(comp_) { }
+
+            /**
+             * Creating an empty instance with initial capacity and other (default) properties.
+             * @param capacity initial capacity of the new instance.
+             * @param growth_factor given growth factor
+             * @param alloc given allocator_type
+             */
+            constexpr explicit flat_set(size_type capacity, const float growth_factor=DEFAULT_GROWTH_FACTOR, const allocator_type& alloc = allocator_type())
+            : store(capacity, growth_factor, alloc), comp() { }
+
+            /**
+             * Creates a new instance, inserting all unique elements from the given
+             * template input-iterator value_type range [first, last).
+             * @tparam InputIt template input-iterator custom type
+             * @param first template input-iterator to first element of value_type range [first, last)
+             * @param last template input-iterator to last element of value_type range [first, last)
+             * @param comp_ comparator
+             */
+            template< class InputIt >
+            constexpr flat_set(InputIt first, InputIt last, const key_compare& comp_ = key_compare())
+            : store(), comp(comp_)
+            { insert(first, last); }
+
+            /**
+             * Create a new instance from an initializer list, inserting all unique elements.
+             *
+             * @param initlist initializer_list.
+             * @param comp_ comparator
+             */
+            constexpr flat_set(std::initializer_list<value_type> initlist, const key_compare& comp_ = key_compare())
+            : store(), comp(comp_)
+            { insert(initlist.begin(), initlist.end()); }
+
+            /**
+             * Creates a new instance with custom initial storage capacity, copying all elements from the given flat_set.<br>
+             * Size will equal the given set.
+             * <p>
+             * Throws jau::IllegalArgumentException() if <code>_capacity < x.size()</code>.
+             * </p>
+             * @param x the given flat_set, all elements will be copied into the new instance.
+             * @param _capacity custom initial storage capacity
+             * @param growth_factor custom growth factor
+             * @param alloc custom allocator_type instance
+             */
+            constexpr explicit flat_set(const flat_set& x, const size_type _capacity, const float growth_factor, const allocator_type& alloc)
+            : store(x.store, _capacity, growth_factor, alloc), comp(x.comp) { }
+
+            constexpr flat_set(const flat_set& x) = default;
+            constexpr flat_set(flat_set && x) noexcept = default;
+            constexpr flat_set& operator=(const flat_set& x) = default;
+            constexpr flat_set& operator=(flat_set&& x) noexcept = default;
+
+            ~flat_set() noexcept = default;
+
+            // read access
+
+            /** Returns the underlying sorted jau::darray storage. */
+            constexpr const storage_t& storage() const noexcept { return store; }
+
+            const allocator_type& get_allocator_ref() const noexcept { return store.get_allocator_ref(); }
+
+            allocator_type get_allocator() const noexcept { return store.get_allocator(); }
+
+            constexpr key_compare key_comp() const { return comp; }
+
+            constexpr value_compare value_comp() const { return comp; }
+
+            constexpr size_type max_size() const noexcept { return store.max_size(); }
+
+            /** Returns the growth factor of the underlying jau::darray storage. */
+            constexpr float growth_factor() const noexcept { return store.growth_factor(); }
+
+            constexpr const_iterator begin() const noexcept { return store.cbegin(); }
+
+            constexpr const_iterator cbegin() const noexcept { return store.cbegin(); }
+
+            constexpr const_iterator end() const noexcept { return store.cend(); }
+
+            constexpr const_iterator cend() const noexcept { return store.cend(); }
+
+            /** Like std::vector::capacity(). */
+            constexpr size_type capacity() const noexcept { return store.capacity(); }
+
+            /** Like std::set::empty(). */
+            constexpr bool empty() const noexcept { return store.empty(); }
+
+            /** Like std::set::size(). */
+            constexpr size_type size() const noexcept { return store.size(); }
+
+            /** Returns the i-th smallest element, no boundary check. */
+            const_reference operator[](size_type i) const noexcept { return store[i]; }
+
+            /** Like std::vector::reserve(), increases this instance's capacity to <code>new_capacity</code>. */
+            void reserve(size_type new_capacity) { store.reserve(new_capacity); }
+
+            // lookup
+
+            /**
+             * Like std::set::lower_bound(), using the branchless jau::lower_bound().
+             * @return const_iterator to the first element not less than key, or end().
+             */
+            constexpr const_iterator lower_bound(const key_type& key) const {
+                return jau::lower_bound(store.cbegin(), store.cend(), key, comp);
+            }
+
+            /**
+             * Like std::set::upper_bound(), using the branchless jau::upper_bound().
+             * @return const_iterator to the first element greater than key, or end().
+             */
+            constexpr const_iterator upper_bound(const key_type& key) const {
+                return jau::upper_bound(store.cbegin(), store.cend(), key, comp);
+            }
+
+            /** Like std::set::equal_range(). */
+            constexpr std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+                const_iterator first = lower_bound(key);
+                if( first < store.cend() && !comp(key, *first) ) {
+                    return std::make_pair(first, first+1);
+                }
+                return std::make_pair(first, first);
+            }
+
+            /**
+             * Like std::set::find().
+             * @return const_iterator to the element equivalent to key, or end().
+             */
+            constexpr const_iterator find(const key_type& key) const {
+                const_iterator it = lower_bound(key);
+                return it < store.cend() && !comp(key, *it) ? it : store.cend();
+            }
+
+            /** Like std::set::contains() of C++20. */
+            constexpr bool contains(const key_type& key) const { return find(key) != store.cend(); }
+
+            /** Like std::set::count(), returns either 0 or 1. */
+            constexpr size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+            // write access
+
+            /** Like std::set::clear(), but keeping the storage capacity. */
+            constexpr void clear() noexcept { store.clear(); }
+
+            /** Like std::set::swap(). */
+            constexpr void swap(flat_set& x) noexcept {
+                store.swap(x.store);
+                std::swap(comp, x.comp);
+            }
+
+            /**
+             * Like std::set::insert(), copy
+             * <p>
+             * Inserts the element at its sorted position if not existing yet,
+             * moving all elements right of it by one.
+             * </p>
+             * @param x the value to be inserted
+             * @return pair of const_iterator to the inserted or existing element and true if inserted.
+             */
+            std::pair<const_iterator, bool> insert(const value_type& x) {
+                const_iterator pos = lower_bound(x);
+                if( pos < store.cend() && !comp(x, *pos) ) {
+                    return std::make_pair(pos, false);
+                }
+                return std::make_pair(store.insert(pos, x), true);
+            }
+
+            /**
+             * Like std::set::insert(), move
+             * @param x the value to be moved into
+             * @return pair of const_iterator to the inserted or existing element and true if inserted.
+             */
+            std::pair<const_iterator, bool> insert(value_type&& x) {
+                const_iterator pos = lower_bound(x);
+                if( pos < store.cend() && !comp(x, *pos) ) {
+                    return std::make_pair(pos, false);
+                }
+                return std::make_pair(store.insert(pos, std::move(x)), true);
+            }
+
+            /**
+             * Like std::set::emplace(), constructing a temporary value for the lookup
+             * and moving it into the storage if not existing yet.
+             * @param args arguments to forward to the constructor of the element
+             * @return pair of const_iterator to the inserted or existing element and true if inserted.
+             */
+            template<typename... Args>
+            std::pair<const_iterator, bool> emplace(Args&&... args) {
+                return insert( value_type( std::forward<Args>(args)... ) );
+            }
+
+            /**
+             * Bulk insertion of the value_type range [first, last).
+             * <p>
+             * The new elements are stably sorted and reduced to unique elements first,
+             * keeping the first of equivalent elements like std::set::insert(InputIt, InputIt),
+             * then merged with the existing sorted storage in one pass, retaining existing equivalent elements.<br>
+             * This reduces the complexity of inserting <code>m</code> elements into <code>n</code>
+             * to <code>O(m log m + n)</code>, compared to <code>O(m * n)</code> for single insertions.
+             * </p>
+             * @tparam InputIt foreign input-iterator to range of value_type [first, last)
+             * @param first first foreign input-iterator to range of value_type [first, last)
+             * @param last last foreign input-iterator to range of value_type [first, last)
+             * @return number of newly added elements
+             */
+            template< class InputIt >
+            size_type insert(InputIt first, InputIt last) {
+                storage_t x(first, last, store.get_allocator_ref());
+                std::stable_sort(x.begin(), x.end(), comp);
+                x.erase( std::unique(x.begin(), x.end(), [this](const value_type& a, const value_type& b) -> bool { return equivalent(a, b); }),
+                         x.cend() );
+                return merge_sorted_unique(x);
+            }
+
+            /**
+             * Like std::set::erase(), erasing the element equivalent to key.
+             * @return number of erased elements, either 0 or 1.
+             */
+            size_type erase(const key_type& key) {
+                const_iterator it = find(key);
+                if( it < store.cend() ) {
+                    store.erase(it);
+                    return 1;
+                }
+                return 0;
+            }
+
+            /**
+             * Like std::set::erase(), erasing the element at the given position.
+             * @return const_iterator following the erased element
+             */
+            const_iterator erase(const_iterator pos) {
+                return store.erase(pos);
+            }
+
+            /**
+             * Like std::set::erase(), erasing the elements in range [first, last).
+             * @return const_iterator following the last erased element
+             */
+            const_iterator erase(const_iterator first, const_iterator last) {
+                return store.erase(const_cast<typename storage_t::iterator>(first), last);
+            }
+
+            /**
+             * Erase all elements satisfying the given predicate in a single pass,
+             * see jau::darray::erase_if().
+             * @return number of erased elements
+             */
+            template<class UnaryPredicate>
+            size_type erase_if(UnaryPredicate pred) {
+                return store.erase_if(pred);
+            }
+
+            constexpr_cxx20 std::string toString() const noexcept {
+                return store.toString();
+            }
+
+            constexpr_cxx20 std::string get_info() const noexcept {
+                return "flat_set["+store.get_info()+"]";
+            }
+    };
+
+    /****************************************************************************************
+     ****************************************************************************************/
+
+    template<typename Key, typename Compare, typename Alloc_type>
+    std::ostream & operator << (std::ostream &out, const flat_set<Key, Compare, Alloc_type> &c) {
+        out << c.toString();
+        return out;
+    }
+
+    /****************************************************************************************
+     ****************************************************************************************/
+
+    template<typename Key, typename Compare, typename Alloc_type>
+    inline bool operator==(const flat_set<Key, Compare, Alloc_type>& rhs, const flat_set<Key, Compare, Alloc_type>& lhs) {
+        if( &rhs == &lhs ) {
+            return true;
+        }
+        return (rhs.size() == lhs.size() && std::equal(rhs.cbegin(), rhs.cend(), lhs.cbegin()));
+    }
+    template<typename Key, typename Compare, typename Alloc_type>
+    inline bool operator!=(const flat_set<Key, Compare, Alloc_type>& rhs, const flat_set<Key, Compare, Alloc_type>& lhs) {
+        return !(rhs==lhs);
+    }
+
+    template<typename Key, typename Compare, typename Alloc_type>
+    inline void swap(flat_set<Key, Compare, Alloc_type>& rhs, flat_set<Key, Compare, Alloc_type>& lhs) noexcept
+    { rhs.swap(lhs); }
+
+} /* namespace jau */
+
+/** \example test_flat_set01.cpp
+ * This C++ unit test validates the jau::flat_set and jau::cow_flat_set implementation.
+ */
+
+#endif /* JAU_FLAT_SET_HPP_ */
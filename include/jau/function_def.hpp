@@ -356,6 +356,13 @@ namespace jau {
             }
     };
 
+    /**
+     * FunctionDef only holds a shared InvocationFunc<R, A...> and hence is trivially relocatable.
+     * @see jau::is_trivially_relocatable
+     */
+    template<typename R, typename... A>
+    struct is_trivially_relocatable<FunctionDef<R, A...>> : std::true_type { };
+
     template<typename R, typename C, typename... A>
     inline jau::FunctionDef<R, A...>
     bindMemberFunc(C *base, R(C::*mfunc)(A...)) noexcept {
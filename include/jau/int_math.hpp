@@ -28,6 +28,7 @@
 
 #include <cstdint>
 #include <cmath>
+#include <type_traits>
 
 #include <jau/int_types.hpp>
 
@@ -153,6 +154,43 @@ namespace jau {
         return digits10<T>(x, jau::sign<T>(x), sign_is_digit);
     }
 
+    /**
+     * Returns true if the given unsigned integral number is a power of two, i.e. has exactly one bit set.
+     * @tparam T an unsigned integral number type
+     * @param x the unsigned integral number
+     * @return function result
+     */
+    template <typename T,
+              std::enable_if_t< std::is_integral_v<T> && std::is_unsigned_v<T>, bool> = true>
+    constexpr bool is_power_of_2(const T x) noexcept
+    {
+        return 0 != x && 0 == ( x & ( x - 1 ) );
+    }
+
+    /**
+     * Returns the smallest power of two greater than or equal to the given unsigned integral number,
+     * one for zero.
+     * <p>
+     * Caller must ensure the result is representable in T.
+     * </p>
+     * @tparam T an unsigned integral number type
+     * @param x the unsigned integral number
+     * @return function result
+     */
+    template <typename T,
+              std::enable_if_t< std::is_integral_v<T> && std::is_unsigned_v<T>, bool> = true>
+    constexpr T round_to_power_of_2(const T x) noexcept
+    {
+        if( 1 >= x ) {
+            return 1;
+        }
+        T r = x - 1;
+        for(std::size_t s=1; s < sizeof(T) * 8; s <<= 1) {
+            r |= r >> s;
+        }
+        return r + 1;
+    }
+
 } // namespace jau
 
 #endif /* JAU_BASIC_INT_MATH_HPP_ */
@@ -0,0 +1,399 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_MPMC_QUEUE_HPP_
+#define JAU_MPMC_QUEUE_HPP_
+
+#include <type_traits>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#include <cstring>
+#include <string>
+#include <cstdint>
+
+#include <jau/debug.hpp>
+#include <jau/basic_types.hpp>
+#include <jau/ordered_atomic.hpp>
+#include <jau/ringbuffer_wait.hpp>
+
+namespace jau {
+
+/**
+ * Bounded <i>lock-free</i> multiple producer multiple consumer (MPMC) queue,
+ * exposing the same {@link #get() get*(..)} and {@link #put(Object) put*(..)} API as jau::ringbuffer.
+ * <p>
+ * Unlike jau::ringbuffer, which serializes all getter and all putter threads via its multi-read and multi-write mutex,
+ * getter and putter threads claim their slot via a CAS on the free running dequeue respectively enqueue position.
+ * Each slot carries its own sequence number, telling whether it is ready to be written or read
+ * for the current round, see Dmitry Vyukov's bounded MPMC queue.
+ * </p>
+ * <p>
+ * Hence all non-blocking operations are lock-free and multiple getter and putter threads proceed in parallel,
+ * as long as they don't hit the same slot.
+ * </p>
+ * <p>
+ * The blocking {@link #getBlocking() getBlocking(..)} and {@link #putBlocking(Object) putBlocking(..)} methods
+ * wait using the given <code>Wait_policy</code>, see ringbuffer_wait.
+ * </p>
+ * <p>
+ * Since getter threads may not operate in sequence, peek() and the batch operations of jau::ringbuffer are not provided.
+ * </p>
+ * <p>
+ * The enqueue and dequeue positions are placed on their own cache line to avoid false sharing.
+ * </p>
+ * @see jau::ringbuffer
+ */
+template <typename T, std::nullptr_t nullelem, typename Size_type, typename Wait_policy=ringbuffer_wait_cv> class mpmc_queue {
+    public:
+        /** The wait strategy used by the blocking operations, see ringbuffer_wait. */
+        typedef Wait_policy wait_policy_type;
+
+    private:
+        /** Assumed cache line size, separating the enqueue and dequeue position. */
+        constexpr static const std::size_t cache_line_size = 64;
+
+        struct Slot {
+            std::atomic<uint64_t> seq;   // Memory-Model (MM) guaranteed acquire (read) and release (write) of value
+            T value;
+        };
+
+        /* final */ Size_type capacity_;
+        /* final */ Slot * slots;
+
+        alignas(cache_line_size) std::atomic<uint64_t> enqueuePos; // free running, claimed by putter via CAS
+        alignas(cache_line_size) std::atomic<uint64_t> dequeuePos; // free running, claimed by getter via CAS
+
+        alignas(cache_line_size) Wait_policy waitRead;  // Blocking getter waiting for a ready slot, SC-DRF w/ Slot::seq
+        Wait_policy waitWrite;                          // Blocking putter waiting for a free slot, SC-DRF w/ Slot::seq
+
+        Slot * newSlots(const Size_type count) noexcept {
+            Slot * s = new Slot[count];
+            for(Size_type i=0; i<count; i++) {
+                s[i].seq.store(i, std::memory_order_relaxed);
+            }
+            return s;
+        }
+
+        Slot & slotAt(const uint64_t pos) noexcept {
+            return slots[pos % capacity_];
+        }
+
+        /** Returns true if the slot at the dequeue position is ready to be read. */
+        bool isReadyImpl() noexcept {
+            const uint64_t pos = dequeuePos.load(std::memory_order_seq_cst);
+            return slotAt(pos).seq.load(std::memory_order_seq_cst) == pos + 1;
+        }
+
+        /** Returns true if the slot at the enqueue position is free to be written. */
+        bool isFreeImpl() noexcept {
+            const uint64_t pos = enqueuePos.load(std::memory_order_seq_cst);
+            return slotAt(pos).seq.load(std::memory_order_seq_cst) == pos;
+        }
+
+        /** Returns the remaining milliseconds until t1, at least one millisecond if not yet expired, otherwise zero. */
+        static int remainingMS(const std::chrono::steady_clock::time_point t1) noexcept {
+            const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+            if( t0 >= t1 ) {
+                return 0;
+            }
+            return std::max<int>(1, static_cast<int>( std::chrono::ceil<std::chrono::milliseconds>(t1 - t0).count() ) );
+        }
+
+        bool tryGetImpl(T & r) noexcept {
+            uint64_t pos = dequeuePos.load(std::memory_order_relaxed);
+            Slot * s;
+            while( true ) {
+                s = &slotAt(pos);
+                const uint64_t seq = s->seq.load(std::memory_order_acquire); // SC-DRF acquire value, sync'ing with tryPutImpl
+                const int64_t diff = static_cast<int64_t>( seq - ( pos + 1 ) );
+                if( 0 == diff ) {
+                    if( dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) ) {
+                        break; // claimed
+                    }
+                } else if( 0 > diff ) {
+                    return false; // empty
+                } else {
+                    pos = dequeuePos.load(std::memory_order_relaxed); // lost the race, retry
+                }
+            }
+            r = std::move( s->value );
+            s->value = nullelem;
+            s->seq.store(pos + capacity_, std::memory_order_release); // SC-DRF release slot for next round's putter
+            if constexpr ( Wait_policy::uses_notify ) {
+                waitWrite.notify();
+            }
+            return true;
+        }
+
+        template<typename U>
+        bool tryPutImpl(U && e) noexcept {
+            uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+            Slot * s;
+            while( true ) {
+                s = &slotAt(pos);
+                const uint64_t seq = s->seq.load(std::memory_order_acquire); // SC-DRF acquire slot, sync'ing with tryGetImpl
+                const int64_t diff = static_cast<int64_t>( seq - pos );
+                if( 0 == diff ) {
+                    if( enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) ) {
+                        break; // claimed
+                    }
+                } else if( 0 > diff ) {
+                    return false; // full
+                } else {
+                    pos = enqueuePos.load(std::memory_order_relaxed); // lost the race, retry
+                }
+            }
+            s->value = std::forward<U>(e);
+            s->seq.store(pos + 1, std::memory_order_release); // SC-DRF release value for getter
+            if constexpr ( Wait_policy::uses_notify ) {
+                waitRead.notify();
+            }
+            return true;
+        }
+
+        T getImpl(const bool blocking, const int timeoutMS) noexcept {
+            T r = nullelem;
+            if( tryGetImpl(r) || !blocking ) {
+                return r;
+            }
+            const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMS);
+            while( true ) {
+                int ms = 0;
+                if( 0 < timeoutMS && 0 == ( ms = remainingMS(t1) ) ) {
+                    return nullelem;
+                }
+                if( !waitRead.wait( [&]() noexcept -> bool { return isReadyImpl(); }, ms) ) {
+                    return nullelem;
+                }
+                if( tryGetImpl(r) ) {
+                    return r;
+                }
+                // another getter claimed the slot
+            }
+        }
+
+        template<typename U>
+        bool putImpl(U && e, const bool blocking, const int timeoutMS) noexcept {
+            if( tryPutImpl(std::forward<U>(e)) ) {
+                return true;
+            }
+            if( !blocking ) {
+                return false;
+            }
+            const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMS);
+            while( true ) {
+                int ms = 0;
+                if( 0 < timeoutMS && 0 == ( ms = remainingMS(t1) ) ) {
+                    return false;
+                }
+                if( !waitWrite.wait( [&]() noexcept -> bool { return isFreeImpl(); }, ms) ) {
+                    return false;
+                }
+                if( tryPutImpl(std::forward<U>(e)) ) { // e remains untouched if not claimed
+                    return true;
+                }
+                // another putter claimed the slot
+            }
+        }
+
+    public:
+        /** Returns a short string representation incl. size/capacity and internal r/w position (impl. dependent). */
+        std::string toString() const noexcept {
+            const std::string es = isEmpty() ? ", empty" : "";
+            const std::string fs = isFull() ? ", full" : "";
+            return "mpmc_queue<?>[size "+std::to_string(getSize())+" / "+std::to_string(capacity_)+
+                    ", enqueuePos "+std::to_string(enqueuePos.load())+", dequeuePos "+std::to_string(dequeuePos.load())+es+fs+"]";
+        }
+
+        /**
+         * Create an empty queue instance w/ the given net <code>capacity</code>.
+         * <p>
+         * Implementation will allocate an internal array of size <code>capacity</code>,
+         * i.e. no slot is wasted.
+         * </p>
+         * <p>
+         * The capacity is at least two, since a single slot's sequence number
+         * could not distinguish a ready element from a free slot of the next round.
+         * </p>
+         * @param capacity the net capacity of the queue, at least two
+         */
+        mpmc_queue(const Size_type capacity) noexcept
+        : capacity_(std::max<Size_type>(2, capacity)), slots(newSlots(capacity_)),
+          enqueuePos(0), dequeuePos(0)
+        { }
+
+        ~mpmc_queue() noexcept {
+            delete[] slots;
+        }
+
+        mpmc_queue(const mpmc_queue &_source) = delete;
+        mpmc_queue& operator=(const mpmc_queue &_source) = delete;
+
+        /** Returns the net capacity of this queue. */
+        Size_type capacity() const noexcept { return capacity_; }
+
+        /**
+         * Returns the number of elements in this queue.
+         * <p>
+         * The value is a snapshot of claimed positions, i.e. it may include elements still being written or read.
+         * </p>
+         */
+        Size_type getSize() const noexcept {
+            const uint64_t d = dequeuePos.load(std::memory_order_acquire); // load first, never passes enqueuePos
+            const uint64_t e = enqueuePos.load(std::memory_order_acquire);
+            return static_cast<Size_type>( std::min<uint64_t>(e - d, capacity_) );
+        }
+
+        /** Returns the number of free slots available to put. */
+        Size_type getFreeSlots() const noexcept { return capacity_ - getSize(); }
+
+        /** Returns true if this queue is empty, otherwise false. */
+        bool isEmpty() const noexcept { return 0 == getSize(); }
+
+        /** Returns true if this queue is full, otherwise false. */
+        bool isFull() const noexcept { return capacity_ <= getSize(); }
+
+        /**
+         * Releasing all elements by dequeuing them.
+         * <p>
+         * Concurrent putter threads may enqueue new elements meanwhile.
+         * </p>
+         */
+        void clear() noexcept {
+            T r = nullelem;
+            while( tryGetImpl(r) ) {
+                r = nullelem;
+            }
+        }
+
+        /**
+         * Dequeues the oldest enqueued element if available, otherwise null.
+         * <p>
+         * The returned queue slot will be set to <code>null</code> to release the reference
+         * and move ownership to the caller.
+         * </p>
+         * <p>
+         * Method is non blocking and lock-free.
+         * </p>
+         * @return the oldest put element if available, otherwise null.
+         */
+        T get() noexcept {
+            return getImpl(false, 0);
+        }
+
+        /**
+         * Dequeues the oldest enqueued element.
+         * <p>
+         * <code>timeoutMS</code> defaults to zero,
+         * i.e. infinitive blocking until an element available via put.<br>
+         * Otherwise this methods blocks for the given milliseconds.
+         * </p>
+         * @return the oldest put element or <code>null</code> if timeout occurred.
+         */
+        T getBlocking(const int timeoutMS=0) noexcept {
+            return getImpl(true, timeoutMS);
+        }
+
+        /**
+         * Drops up to {@code count} oldest enqueued elements.
+         * @param count maximum number of elements to drop from the queue.
+         * @return actual number of dropped elements.
+         */
+        Size_type drop(const Size_type count) noexcept {
+            Size_type i=0;
+            T r = nullelem;
+            while( i < count && tryGetImpl(r) ) {
+                r = nullelem;
+                ++i;
+            }
+            return i;
+        }
+
+        /**
+         * Enqueues the given element by moving it into this queue storage.
+         * <p>
+         * Returns true if successful, otherwise false in case queue is full.
+         * </p>
+         * <p>
+         * Method is non blocking and lock-free.
+         * </p>
+         */
+        bool put(T && e) noexcept {
+            return putImpl(std::move(e), false, 0);
+        }
+
+        /**
+         * Enqueues the given element by moving it into this queue storage.
+         * <p>
+         * <code>timeoutMS</code> defaults to zero,
+         * i.e. infinitive blocking until a free slot becomes available via get.<br>
+         * Otherwise this methods blocks for the given milliseconds.
+         * </p>
+         * <p>
+         * Returns true if successful, otherwise false in case timeout occurred.
+         * </p>
+         */
+        bool putBlocking(T && e, const int timeoutMS=0) noexcept {
+            return putImpl(std::move(e), true, timeoutMS);
+        }
+
+        /**
+         * Enqueues the given element by copying it into this queue storage.
+         * <p>
+         * Returns true if successful, otherwise false in case queue is full.
+         * </p>
+         * <p>
+         * Method is non blocking and lock-free.
+         * </p>
+         */
+        bool put(const T & e) noexcept {
+            return putImpl(e, false, 0);
+        }
+
+        /**
+         * Enqueues the given element by copying it into this queue storage.
+         * <p>
+         * <code>timeoutMS</code> defaults to zero,
+         * i.e. infinitive blocking until a free slot becomes available via get.<br>
+         * Otherwise this methods blocks for the given milliseconds.
+         * </p>
+         * <p>
+         * Returns true if successful, otherwise false in case timeout occurred.
+         * </p>
+         */
+        bool putBlocking(const T & e, const int timeoutMS=0) noexcept {
+            return putImpl(e, true, timeoutMS);
+        }
+};
+
+} /* namespace jau */
+
+/** \example test_mpmc_queue11.cpp
+ * This C++ unit test validates jau::mpmc_queue with parallel processing
+ * and compares its scaling with jau::ringbuffer for 1..N getter and putter threads.
+ */
+
+#endif /* JAU_MPMC_QUEUE_HPP_ */
@@ -0,0 +1,658 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef JAU_PVECTOR_HPP_
+#define JAU_PVECTOR_HPP_
+
+#include <cstring>
+#include <string>
+#include <cstdint>
+#include <limits>
+#include <atomic>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+
+#include <jau/debug.hpp>
+#include <jau/basic_types.hpp>
+#include <jau/callocator.hpp>
+#include <jau/darray.hpp>
+
+namespace jau {
+
+    /**
+     * Persistent vector, a wide fan-out trie of fixed-size chunks with structural sharing.
+     * <p>
+     * Elements are stored in leaf chunks of <code>chunk_size</code> elements, each a jau::darray,
+     * referenced by internal nodes of up to <code>chunk_size</code> children.
+     * The last chunk is kept separately as the <i>tail</i>, hence push_back() and pop_back()
+     * mostly touch the tail only.
+     * </p>
+     * <p>
+     * Copying a pvector is O(1), sharing all chunks and nodes with the source.<br>
+     * Mutating operations never modify a shared chunk or node,
+     * but copy the touched chunk and its path from the root, i.e. <code>O(log n)</code> with base <code>chunk_size</code>.<br>
+     * Chunks and nodes exclusively owned by this instance are modified in place,
+     * hence a sequence of mutations only copies shared paths once.
+     * </p>
+     * <p>
+     * Therefore a pvector can be used as a cheap immutable snapshot of its source,
+     * e.g. as the store of jau::cow_pvector.
+     * </p>
+     * <p>
+     * A pvector instance itself is not thread safe, however,
+     * distinct instances sharing chunks and nodes may be used by different threads concurrently.
+     * </p>
+     * <p>
+     * Only const_iterator are supported, random access and invalidated by mutating operations.
+     * Use set() to replace an element.
+     * </p>
+     * @tparam Value_type element type, must be copy constructible
+     * @tparam Size_type size type, defaults to jau::nsize_t
+     * @tparam Chunk_bits number of bits per trie level, i.e. <code>chunk_size = 1 << Chunk_bits</code>, defaults to 5 for 32 elements
+     * @see jau::cow_pvector
+     */
+    template <typename Value_type, typename Size_type = jau::nsize_t, unsigned int Chunk_bits = 5>
+    class pvector
+    {
+        public:
+            static_assert( 0 < Chunk_bits && Chunk_bits <= 8, "Chunk_bits must be within [1, 8]" );
+
+            // typedefs' for C++ named requirements: Container
+
+            typedef Value_type                                  value_type;
+            typedef value_type*                                 pointer;
+            typedef const value_type*                           const_pointer;
+            typedef value_type&                                 reference;
+            typedef const value_type&                           const_reference;
+            typedef Size_type                                   size_type;
+            typedef typename std::make_signed<size_type>::type  difference_type;
+
+            /** Number of bits per trie level. */
+            constexpr static const unsigned int chunk_bits = Chunk_bits;
+            /** Number of elements per leaf chunk and children per internal node. */
+            constexpr static const size_type chunk_size = size_type(1) << Chunk_bits;
+
+            /** Leaf chunk storage type. */
+            typedef darray<value_type, jau::callocator<value_type>, size_type> chunk_t;
+
+            class const_iterator;
+
+        private:
+            constexpr static const size_type chunk_mask = chunk_size - 1;
+            static constexpr size_type DIFF_MAX = std::numeric_limits<difference_type>::max();
+
+            struct node_t;
+            typedef std::shared_ptr<node_t> node_ref_t;
+            typedef darray<node_ref_t, jau::callocator<node_ref_t>, size_type> children_t;
+
+            /** Trie node, either an internal node using children or a leaf chunk using values. */
+            struct node_t {
+                children_t children;
+                chunk_t values;
+            };
+
+            size_type cnt;
+            /** Bit shift of the root level, i.e. tree depth times chunk_bits. */
+            unsigned int shift;
+            /** Root node of all chunks below tail_offset(), nullptr if none. */
+            node_ref_t root;
+            /** Leaf chunk holding the last elements from tail_offset(), nullptr if empty. */
+            node_ref_t tail;
+
+            static node_ref_t new_leaf() {
+                node_ref_t n = std::make_shared<node_t>();
+                n->values.reserve(chunk_size);
+                return n;
+            }
+
+            static node_ref_t new_internal() {
+                node_ref_t n = std::make_shared<node_t>();
+                n->children.reserve(chunk_size);
+                return n;
+            }
+
+            /**
+             * Returns the given node's mutable instance exclusively owned by this instance,
+             * i.e. copied if shared with another instance or created if nullptr.
+             * <p>
+             * A node exclusively referenced by its exclusively owned parent can't be shared,
+             * hence walking down from the root only copies the shared path.
+             * </p>
+             */
+            static node_t* editable(node_ref_t& n) {
+                if( nullptr == n ) {
+                    n = new_internal();
+                } else if( 1 == n.use_count() ) {
+                    // synchronize with the release of the reference of another instance
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                } else {
+                    const node_t& o = *n;
+                    node_ref_t c = std::make_shared<node_t>();
+                    if( !o.children.empty() ) {
+                        c->children.reserve(chunk_size);
+                        c->children.push_back(o.children.cbegin(), o.children.cend());
+                    } else {
+                        c->values.reserve(chunk_size);
+                        c->values.push_back(o.values.cbegin(), o.values.cend());
+                    }
+                    n = std::move(c);
+                }
+                return n.get();
+            }
+
+            /** Returns the index of the first element within the tail. */
+            constexpr size_type tail_offset() const noexcept {
+                return cnt < chunk_size ? 0 : ( ( cnt - 1 ) >> chunk_bits ) << chunk_bits;
+            }
+
+            /** Returns the leaf node holding the element at given index below tail_offset(). */
+            const node_ref_t& leaf_for(const size_type i) const noexcept {
+                const node_ref_t* n = &root;
+                for(unsigned int level = shift; level > 0; level -= chunk_bits) {
+                    n = &(*n)->children[ ( i >> level ) & chunk_mask ];
+                }
+                return *n;
+            }
+
+            /** Returns the chunk holding the element at given index, which must be less than size(). */
+            const chunk_t& chunk_for(const size_type i) const noexcept {
+                return i >= tail_offset() ? tail->values : leaf_for(i)->values;
+            }
+
+            /** Returns the mutable element at given index, which must be less than size(), copying its shared path. */
+            reference edit(const size_type i) {
+                if( i >= tail_offset() ) {
+                    return editable(tail)->values[ i & chunk_mask ];
+                }
+                node_ref_t* n = &root;
+                for(unsigned int level = shift; level > 0; level -= chunk_bits) {
+                    n = &editable(*n)->children[ ( i >> level ) & chunk_mask ];
+                }
+                return editable(*n)->values[ i & chunk_mask ];
+            }
+
+            static node_ref_t new_path(const unsigned int level, node_ref_t node) {
+                for(unsigned int l = level; l > 0; l -= chunk_bits) {
+                    node_ref_t p = new_internal();
+                    p->children.push_back( std::move(node) );
+                    node = std::move(p);
+                }
+                return node;
+            }
+
+            /** Appends the full tail as the rightmost leaf of the subtree at given level. */
+            void push_tail(const unsigned int level, node_ref_t& parent) {
+                node_t* p = editable(parent);
+                const size_type sub = ( ( cnt - 1 ) >> level ) & chunk_mask;
+                if( chunk_bits == level ) {
+                    p->children.push_back( tail );
+                } else if( sub < p->children.size() ) {
+                    push_tail(level - chunk_bits, p->children[sub]);
+                } else {
+                    p->children.push_back( new_path(level - chunk_bits, tail) );
+                }
+            }
+
+            /** Appends the full tail to the tree, growing the tree by one level if the root is full. */
+            void push_tail() {
+                if( ( cnt >> chunk_bits ) > ( size_type(1) << shift ) ) {
+                    node_ref_t r = new_internal();
+                    r->children.push_back( std::move(root) );
+                    r->children.push_back( new_path(shift, tail) );
+                    root = std::move(r);
+                    shift += chunk_bits;
+                } else {
+                    push_tail(shift, root);
+                }
+            }
+
+            /** Removes the rightmost leaf of the subtree at given level, returns true if the subtree became empty. */
+            bool pop_tail(const unsigned int level, node_ref_t& node) {
+                node_t* n = editable(node);
+                if( level > chunk_bits ) {
+                    const size_type sub = ( ( cnt - 2 ) >> level ) & chunk_mask;
+                    if( pop_tail(level - chunk_bits, n->children[sub]) ) {
+                        n->children.pop_back();
+                    }
+                } else {
+                    n->children.pop_back();
+                }
+                return n->children.empty();
+            }
+
+        public:
+            // ctor w/o elements
+
+            /**
+             * Default constructor, giving an empty pvector without allocation.
+             */
+            constexpr pvector() noexcept
+            : cnt(0), shift(chunk_bits), root(nullptr), tail(nullptr) {}
+
+            /**
+             * Copy constructor in O(1), sharing all chunks with the given source.
+             */
+            pvector(const pvector& x) noexcept = default;
+
+            /**
+             * Copy assignment in O(1), sharing all chunks with the given source.
+             */
+            pvector& operator=(const pvector& x) noexcept = default;
+
+            /**
+             * Move constructor, leaving the given source empty.
+             */
+            pvector(pvector && x) noexcept
+            : cnt(x.cnt), shift(x.shift), root(std::move(x.root)), tail(std::move(x.tail)) {
+                x.cnt = 0;
+                x.shift = chunk_bits;
+            }
+
+            /**
+             * Move assignment, leaving the given source empty.
+             */
+            pvector& operator=(pvector&& x) noexcept {
+                if( this != &x ) {
+                    cnt = x.cnt;
+                    shift = x.shift;
+                    root = std::move(x.root);
+                    tail = std::move(x.tail);
+                    x.cnt = 0;
+                    x.shift = chunk_bits;
+                }
+                return *this;
+            }
+
+            /**
+             * Creates a new instance,
+             * copying all elements from the given template input-iterator value_type range [first, last).
+             * @tparam InputIt template input-iterator custom type
+             * @param first template input-iterator to first element of value_type range [first, last)
+             * @param last template input-iterator to last element of value_type range [first, last)
+             */
+            template< class InputIt >
+            pvector(InputIt first, InputIt last)
+            : pvector() {
+                push_back(first, last);
+            }
+
+            /**
+             * Create a new instance from an initializer list.
+             * @param initlist initializer_list.
+             */
+            pvector(std::initializer_list<value_type> initlist)
+            : pvector() {
+                push_back(initlist.begin(), initlist.end());
+            }
+
+            ~pvector() noexcept = default;
+
+            /**
+             * Returns <code>std::numeric_limits<difference_type>::max()</code> as the maximum array size.
+             */
+            constexpr size_type max_size() const noexcept { return DIFF_MAX; }
+
+            // read access
+
+            constexpr size_type size() const noexcept { return cnt; }
+
+            constexpr bool empty() const noexcept { return 0 == cnt; }
+
+            /**
+             * Returns the depth of the trie below the tail, i.e. number of levels of internal nodes.
+             */
+            constexpr unsigned int depth() const noexcept { return shift / chunk_bits; }
+
+            /**
+             * Like std::vector::operator[](size_type), w/o boundary check, O(log n).
+             */
+            const_reference operator[](size_type i) const noexcept {
+                return chunk_for(i)[ i & chunk_mask ];
+            }
+
+            /**
+             * Like std::vector::at(size_type), w/ boundary check, O(log n).
+             * <p>
+             * Throws jau::IndexOutOfBoundsException if index is not less than size().
+             * </p>
+             */
+            const_reference at(size_type i) const {
+                if( i >= cnt ) {
+                    throw jau::IndexOutOfBoundsException(i, cnt, E_FILE_LINE);
+                }
+                return chunk_for(i)[ i & chunk_mask ];
+            }
+
+            /**
+             * Like std::vector::front(), O(log n).
+             */
+            const_reference front() const { return at(0); }
+
+            /**
+             * Like std::vector::back(), O(1).
+             */
+            const_reference back() const { return at(cnt-1); }
+
+            constexpr const_iterator cbegin() const noexcept { return const_iterator(this, 0); }
+
+            constexpr const_iterator cend() const noexcept { return const_iterator(this, cnt); }
+
+            constexpr const_iterator begin() const noexcept { return cbegin(); }
+
+            constexpr const_iterator end() const noexcept { return cend(); }
+
+            // write access, mutable elements
+
+            /**
+             * Replaces the element at given index with a copy of the given value.
+             * <p>
+             * Copies the shared chunk and its path only, O(log n).
+             * </p>
+             * <p>
+             * Throws jau::IndexOutOfBoundsException if index is not less than size().
+             * </p>
+             */
+            void set(const size_type i, const value_type& x) {
+                if( i >= cnt ) {
+                    throw jau::IndexOutOfBoundsException(i, cnt, E_FILE_LINE);
+                }
+                edit(i) = x;
+            }
+
+            /**
+             * Replaces the element at given index with the given value, moved.
+             * <p>
+             * Copies the shared chunk and its path only, O(log n).
+             * </p>
+             * <p>
+             * Throws jau::IndexOutOfBoundsException if index is not less than size().
+             * </p>
+             */
+            void set(const size_type i, value_type&& x) {
+                if( i >= cnt ) {
+                    throw jau::IndexOutOfBoundsException(i, cnt, E_FILE_LINE);
+                }
+                edit(i) = std::move(x);
+            }
+
+            /**
+             * Like std::vector::clear(), releasing this instance's references of all chunks.
+             */
+            void clear() noexcept {
+                cnt = 0;
+                shift = chunk_bits;
+                root = nullptr;
+                tail = nullptr;
+            }
+
+            /**
+             * Like std::vector::swap().
+             */
+            void swap(pvector& x) noexcept {
+                std::swap(cnt, x.cnt);
+                std::swap(shift, x.shift);
+                root.swap(x.root);
+                tail.swap(x.tail);
+            }
+
+            /**
+             * Like std::vector::emplace_back(), construct a new element in place at the end().
+             * <p>
+             * Copies the tail if shared, otherwise amortized O(1).
+             * </p>
+             * @param args arguments to forward to the constructor of the element
+             * @return reference to the new element, valid until the next mutating operation
+             */
+            template<typename... Args>
+            reference emplace_back(Args&&... args) {
+                if( nullptr != tail && cnt - tail_offset() < chunk_size ) {
+                    reference res = editable(tail)->values.emplace_back( std::forward<Args>(args)... );
+                    ++cnt;
+                    return res;
+                }
+                node_ref_t new_tail = new_leaf();
+                reference res = new_tail->values.emplace_back( std::forward<Args>(args)... );
+                if( nullptr != tail ) {
+                    push_tail();
+                }
+                tail = std::move(new_tail);
+                ++cnt;
+                return res;
+            }
+
+            /**
+             * Like std::vector::push_back(), copy
+             * @param x the value to be added at the tail.
+             */
+            void push_back(const value_type& x) {
+                emplace_back(x);
+            }
+
+            /**
+             * Like std::vector::push_back(), move
+             * @param x the value to be added at the tail.
+             */
+            void push_back(value_type&& x) {
+                emplace_back( std::move(x) );
+            }
+
+            /**
+             * Like std::vector::push_back(), but appends the whole value_type range [first, last).
+             * @tparam InputIt foreign input-iterator to range of value_type [first, last)
+             * @param first first foreign input-iterator to range of value_type [first, last)
+             * @param last last foreign input-iterator to range of value_type [first, last)
+             */
+            template< class InputIt >
+            void push_back( InputIt first, InputIt last ) {
+                for(; first != last; ++first) {
+                    emplace_back( *first );
+                }
+            }
+
+            /**
+             * Like std::vector::pop_back().
+             * <p>
+             * Copies the tail if shared, or the path to the rightmost chunk if the tail becomes empty,
+             * moving the rightmost chunk to the tail.
+             * </p>
+             */
+            void pop_back() {
+                if( 1 >= cnt ) {
+                    clear();
+                    return;
+                }
+                if( cnt - tail_offset() > 1 ) {
+                    editable(tail)->values.pop_back();
+                    --cnt;
+                    return;
+                }
+                node_ref_t new_tail = leaf_for(cnt - 2);
+                pop_tail(shift, root);
+                if( shift > chunk_bits && 1 == root->children.size() ) {
+                    node_ref_t r = root->children[0];
+                    root = std::move(r);
+                    shift -= chunk_bits;
+                }
+                tail = std::move(new_tail);
+                --cnt;
+            }
+
+            /**
+             * Like std::erase_if(std::vector&, pred), removes all elements for which the given predicate returns true.
+             * <p>
+             * All chunks before the first matching element stay shared,
+             * the remaining elements are appended again.
+             * </p>
+             * @tparam UnaryPredicate predicate type, callable as <code>bool pred(const value_type&)</code>
+             * @param pred the predicate returning true for elements to be erased, invoked exactly once per element
+             * @return number of erased elements
+             */
+            template<class UnaryPredicate>
+            size_type erase_if(UnaryPredicate pred) {
+                const pvector src(*this);
+                const_iterator it = src.cbegin();
+                const const_iterator it_end = src.cend();
+                while( it != it_end && !pred(*it) ) {
+                    ++it;
+                }
+                if( it == it_end ) {
+                    return 0;
+                }
+                const size_type first_erased = static_cast<size_type>( it - src.cbegin() );
+                while( cnt > first_erased ) {
+                    pop_back();
+                }
+                for(++it; it != it_end; ++it) {
+                    if( !pred(*it) ) {
+                        push_back(*it);
+                    }
+                }
+                return src.cnt - cnt;
+            }
+
+            constexpr_cxx20 std::string toString() const noexcept {
+                std::string res("{ " + std::to_string( size() ) + ": ");
+                int i=0;
+                for(const_iterator it = cbegin(); it != cend(); ++it) {
+                    if( 1 < ++i ) { res.append(", "); }
+                    res.append( jau::to_string(*it) );
+                }
+                res.append(" }");
+                return res;
+            }
+
+            constexpr_cxx20 std::string get_info() const noexcept {
+                return ("pvector[this "+jau::to_hexstring(this)+
+                        ", size "+std::to_string(cnt)+
+                        ", depth "+std::to_string(depth())+
+                        ", chunk "+std::to_string(chunk_size)+
+                        ", tail "+std::to_string(cnt - tail_offset())+
+                        "]");
+            }
+
+            /**
+             * Random access const_iterator of jau::pvector,
+             * caching the chunk of the last accessed element.
+             * <p>
+             * Invalidated by any mutating operation of its pvector.
+             * </p>
+             */
+            class const_iterator {
+                public:
+                    typedef std::random_access_iterator_tag             iterator_category;
+                    typedef typename pvector::value_type                value_type;
+                    typedef typename pvector::difference_type           difference_type;
+                    typedef typename pvector::size_type                 size_type;
+                    typedef const value_type*                           pointer;
+                    typedef const value_type&                           reference;
+
+                private:
+                    const pvector* pv_;
+                    size_type idx_;
+                    mutable const value_type* chunk_;
+                    mutable size_type chunk_base_;
+
+                    const value_type& deref(const size_type i) const noexcept {
+                        if( nullptr == chunk_ || i < chunk_base_ || i - chunk_base_ >= chunk_size ) {
+                            chunk_ = pv_->chunk_for(i).data();
+                            chunk_base_ = i & ~chunk_mask;
+                        }
+                        return chunk_[ i - chunk_base_ ];
+                    }
+
+                public:
+                    constexpr const_iterator() noexcept
+                    : pv_(nullptr), idx_(0), chunk_(nullptr), chunk_base_(0) {}
+
+                    constexpr const_iterator(const pvector* pv, const size_type idx) noexcept
+                    : pv_(pv), idx_(idx), chunk_(nullptr), chunk_base_(0) {}
+
+                    constexpr size_type index() const noexcept { return idx_; }
+
+                    constexpr bool operator==(const const_iterator& rhs) const noexcept { return idx_ == rhs.idx_ && pv_ == rhs.pv_; }
+                    constexpr bool operator!=(const const_iterator& rhs) const noexcept { return !(*this == rhs); }
+                    constexpr bool operator<(const const_iterator& rhs) const noexcept { return idx_ < rhs.idx_; }
+                    constexpr bool operator<=(const const_iterator& rhs) const noexcept { return idx_ <= rhs.idx_; }
+                    constexpr bool operator>(const const_iterator& rhs) const noexcept { return idx_ > rhs.idx_; }
+                    constexpr bool operator>=(const const_iterator& rhs) const noexcept { return idx_ >= rhs.idx_; }
+
+                    reference operator*() const noexcept { return deref(idx_); }
+                    pointer operator->() const noexcept { return &deref(idx_); }
+                    reference operator[](const difference_type i) const noexcept { return deref( static_cast<size_type>( static_cast<difference_type>(idx_) + i ) ); }
+
+                    const_iterator& operator++() noexcept { ++idx_; return *this; }
+                    const_iterator operator++(int) noexcept { const_iterator r(*this); ++idx_; return r; }
+                    const_iterator& operator--() noexcept { --idx_; return *this; }
+                    const_iterator operator--(int) noexcept { const_iterator r(*this); --idx_; return r; }
+
+                    const_iterator& operator+=(const difference_type i) noexcept
+                    { idx_ = static_cast<size_type>( static_cast<difference_type>(idx_) + i ); return *this; }
+                    const_iterator& operator-=(const difference_type i) noexcept
+                    { idx_ = static_cast<size_type>( static_cast<difference_type>(idx_) - i ); return *this; }
+                    const_iterator operator+(const difference_type i) const noexcept { const_iterator r(*this); return r += i; }
+                    const_iterator operator-(const difference_type i) const noexcept { const_iterator r(*this); return r -= i; }
+
+                    constexpr difference_type operator-(const const_iterator& rhs) const noexcept
+                    { return static_cast<difference_type>(idx_) - static_cast<difference_type>(rhs.idx_); }
+
+                    std::string toString() const noexcept {
+                        return "pvector::iter["+std::to_string(idx_)+"]";
+                    }
+            };
+    };
+
+    /****************************************************************************************
+     ****************************************************************************************/
+
+    template<typename Value_type, typename Size_type, unsigned int Chunk_bits>
+    std::ostream & operator << (std::ostream &out, const pvector<Value_type, Size_type, Chunk_bits> &c) {
+        out << c.toString();
+        return out;
+    }
+
+    template<typename Value_type, typename Size_type, unsigned int Chunk_bits>
+    inline bool operator==(const pvector<Value_type, Size_type, Chunk_bits>& rhs, const pvector<Value_type, Size_type, Chunk_bits>& lhs) {
+        if( &rhs == &lhs ) {
+            return true;
+        }
+        return rhs.size() == lhs.size() && std::equal(rhs.cbegin(), rhs.cend(), lhs.cbegin());
+    }
+    template<typename Value_type, typename Size_type, unsigned int Chunk_bits>
+    inline bool operator!=(const pvector<Value_type, Size_type, Chunk_bits>& rhs, const pvector<Value_type, Size_type, Chunk_bits>& lhs) {
+        return !(rhs==lhs);
+    }
+
+    template<typename Value_type, typename Size_type, unsigned int Chunk_bits>
+    inline void swap(pvector<Value_type, Size_type, Chunk_bits>& rhs, pvector<Value_type, Size_type, Chunk_bits>& lhs) noexcept
+    { rhs.swap(lhs); }
+
+} /* namespace jau */
+
+/** \example test_pvector01.cpp
+ * This C++ unit test validates the jau::pvector and jau::cow_pvector implementation.
+ */
+
+#endif /* JAU_PVECTOR_HPP_ */
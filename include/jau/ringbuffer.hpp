@@ -31,6 +31,7 @@
 #include <memory>
 #include <mutex>
 #include <condition_variable>
+#include <thread>
 #include <chrono>
 #include <algorithm>
 
@@ -40,7 +41,12 @@
 
 #include <jau/debug.hpp>
 #include <jau/basic_types.hpp>
+#include <jau/int_math.hpp>
 #include <jau/ordered_atomic.hpp>
+#include <jau/ringbuffer_wait.hpp>
+#include <jau/ringbuffer_span.hpp>
+#include <jau/ringbuffer_stats.hpp>
+#include <jau/ringbuffer_counter.hpp>
 
 namespace jau {
 
@@ -49,8 +55,8 @@ namespace jau {
  * exposing <i>lock-free</i>
  * {@link #get() get*(..)} and {@link #put(Object) put*(..)} methods.
  * <p>
- * Implementation utilizes the <i>Always Keep One Slot Open</i>,
- * hence implementation maintains an internal array of <code>capacity</code> <i>plus one</i>!
+ * Implementation maintains a read and write counter instead of a read and write position,
+ * hence no slot must be kept open to distinguish full from empty, i.e. the internal array holds exactly <code>capacity</code> elements.
  * </p>
  * <p>
  * Implementation is thread safe if:
@@ -61,22 +67,91 @@ namespace jau {
  * </ul>
  * </p>
  * <p>
- * Following methods acquire the global multi-read _and_ -write mutex:
+ * Above multiple getter and putter thread safety is only given if
+ * Non-Type Template Parameter <code>multi_pc</code> is <code>true</code>, the default.<br>
+ * Here all {@link #get() get*(..)} operations are serialized via the multi-read mutex
+ * and all {@link #put(Object) put*(..)} operations are serialized via the multi-write mutex.
+ * </p>
+ * <p>
+ * With <code>multi_pc</code> set to <code>false</code>, the ringbuffer operates in
+ * <i>Single Producer Single Consumer</i> (SPSC) mode, i.e. only one getter thread and one putter thread
+ * are allowed to operate on this instance concurrently.<br>
+ * Here the non-blocking {@link #get() get*(..)} and {@link #put(Object) put*(..)} methods
+ * only use acquire and release atomic operations on the read and write position and no mutex at all.<br>
+ * </p>
+ * <p>
+ * The blocking {@link #getBlocking() get*Blocking(..)} and {@link #putBlocking(Object) put*Blocking(..)} methods
+ * wait using the given <code>Wait_policy</code> template parameter, see ringbuffer_wait:
+ * <ul>
+ *   <li>ringbuffer_wait_cv, the default, sleeping on a std::condition_variable</li>
+ *   <li>ringbuffer_wait_futex, spinning first and then sleeping on a Linux futex</li>
+ *   <li>ringbuffer_wait_yield, spinning and yielding</li>
+ *   <li>ringbuffer_wait_spin, busy spinning</li>
+ *   <li>ringbuffer_wait_eventfd, polling a Linux eventfd, which may also be multiplexed via epoll</li>
+ * </ul>
+ * Only the sleeping policies notify the opposite side, and only if a blocking getter or putter is actually sleeping.
+ * </p>
+ * <p>
+ * Using ringbuffer_wait_eventfd, one thread may multiplex many ring buffers and other file descriptors
+ * via {@link #getReadEventFD()} and {@link #getWriteEventFD()}, signaled edge-coalesced
+ * on the transition to non-empty for the getter and to not-full for the putter.
+ * </p>
+ * <p>
+ * Runtime statistics are collected via the given <code>Stats_policy</code> template parameter, see ringbuffer_stats:
+ * <ul>
+ *   <li>ringbuffer_stats_none, the default, compiling away to nothing</li>
+ *   <li>ringbuffer_stats_atomic, counting transferred elements, failed non-blocking operations,
+ *       blocking waits and their duration per side, drops as well as the size's high-water mark</li>
+ * </ul>
+ * A snapshot is retrieved via {@link #getStats()} w/o taking the multi-read or -write mutex.
+ * </p>
+ * <p>
+ * The capacity may be rounded up to a power of two at construction, see ringbuffer(const Size_type, const bool).
+ * Here the read and write counter run free as 64-bit integers and the array index is derived via a bitmask.<br>
+ * Otherwise both counter run modulo twice the capacity, i.e. their wrap-around and the array index use a comparison.<br>
+ * Either way, no integer division is performed.<br>
+ * For a compile-time capacity with inline storage, see jau::fixed_ringbuffer.
+ * </p>
+ * <p>
+ * Getter owned state, i.e. read counter and multi-read mutex, and putter owned state,
+ * i.e. write counter and multi-write mutex, are placed on separate cache lines to avoid false sharing.<br>
+ * Each side keeps a cached copy of the opposite counter and only reloads the latter
+ * if the ring buffer appears to be empty for the getter or full for the putter.<br>
+ * The size is derived from the read and write counter.
+ * </p>
+ * <p>
+ * The zero-copy operations {@link #reserveWrite()} and {@link #peekRead()}
+ * expose the ring buffer storage directly via a ringbuffer_span_guard, allowing to construct and parse elements in place.
+ * The guard enqueues respectively dequeues the span at destruction or at its explicit early commit() respectively release().
+ * </p>
+ * <p>
+ * In <code>multi_pc</code> mode, {@link #putOverwrite()} enqueues into a full ring buffer by overwriting the oldest element,
+ * i.e. a lossy mode for telemetry data, acquiring the multi-read mutex only if full.
+ * </p>
+ * <p>
+ * Following methods acquire the global multi-read _and_ -write mutex in <code>multi_pc</code> mode,
+ * and require exclusive access in SPSC mode:
  * <ul>
  *  <li>{@link #resetFull(Object[])}</li>
- *  <li>{@link #clear()}</li>
  *  <li>{@link #growEmptyBuffer(Object[])}</li>
  * </ul>
  * </p>
  * <p>
+ * Following methods are getter operations in SPSC mode, i.e. shall only be called by the getter thread:
+ * <ul>
+ *  <li>{@link #clear()}</li>
+ *  <li>{@link #drop(int)}</li>
+ * </ul>
+ * </p>
+ * <p>
  * Characteristics:
  * <ul>
- *   <li>Read position points to the last read element.</li>
- *   <li>Write position points to the last written element.</li>
+ *   <li>Read counter counts the read elements, its array index points to the next element to read.</li>
+ *   <li>Write counter counts the written elements, its array index points to the next slot to write.</li>
  * </ul>
  * <table border="1">
- *   <tr><td>Empty</td><td>writePos == readPos</td><td>size == 0</td></tr>
- *   <tr><td>Full</td><td>writePos == readPos - 1</td><td>size == capacity</td></tr>
+ *   <tr><td>Empty</td><td>writeCount == readCount</td><td>size == 0</td></tr>
+ *   <tr><td>Full</td><td>writeCount - readCount == capacity</td><td>size == capacity</td></tr>
  * </table>
  * </p>
  * See also:
@@ -86,24 +161,46 @@ namespace jau {
  * </pre>
  * @see jau::sc_atomic_critical
  */
-template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuffer {
+template <typename T, std::nullptr_t nullelem, typename Size_type, bool multi_pc=true, typename Wait_policy=ringbuffer_wait_cv,
+          typename Stats_policy=ringbuffer_stats_none>
+class ringbuffer {
+    public:
+        /** True if multiple getter and putter threads are supported, otherwise Single Producer Single Consumer (SPSC) mode. */
+        constexpr static const bool uses_multi_pc = multi_pc;
+
+        /** The wait strategy used by the blocking operations, see ringbuffer_wait. */
+        typedef Wait_policy wait_policy_type;
+
+        /** The runtime statistics policy, see ringbuffer_stats. */
+        typedef Stats_policy stats_policy_type;
+
+        /** True if the batch operations getN() and putN() use memcpy, i.e. if T is trivially copyable. */
+        constexpr static const bool uses_memcpy = std::is_trivially_copyable_v<T>;
+
+        /** View of up to two contiguous storage segments, returned by the zero-copy operations. */
+        typedef ringbuffer_span<T, Size_type> span_type;
+
+        /** RAII guard of a read span, returned by peekRead(). */
+        typedef ringbuffer_span_guard<ringbuffer, T, Size_type, false> read_span_type;
+
+        /** RAII guard of a write span, returned by reserveWrite(). */
+        typedef ringbuffer_span_guard<ringbuffer, T, Size_type, true> write_span_type;
+
     private:
-        /** SC atomic integral scalar jau::nsize_t. Memory-Model (MM) guaranteed sequential consistency (SC) between acquire (read) and release (write) */
-        typedef ordered_atomic<Size_type, std::memory_order::memory_order_seq_cst> sc_atomic_Size_type;
+        template<typename, typename, typename, bool> friend class ringbuffer_span_guard;
 
-        /** Relaxed non-SC atomic integral scalar jau::nsize_t. Memory-Model (MM) only guarantees the atomic value, _no_ sequential consistency (SC) between acquire (read) and release (write). */
-        typedef ordered_atomic<Size_type, std::memory_order::memory_order_relaxed> relaxed_atomic_Size_type;
+        /** Assumed cache line size, separating getter and putter owned state. */
+        constexpr static const std::size_t cache_line_size = 64;
 
-        std::mutex syncRead, syncMultiRead;   // Memory-Model (MM) guaranteed sequential consistency (SC) between acquire and release
-        std::mutex syncWrite, syncMultiWrite; // ditto
-        std::condition_variable cvRead;
-        std::condition_variable cvWrite;
+        typedef ringbuffer_counter<Size_type, Wait_policy, ringbuffer_index<Size_type>> counter_type;
 
-        /* final */ Size_type capacityPlusOne;  // not final due to grow
         /* final */ T * array;           // Synchronized due to MM's data-race-free SC (SC-DRF) between [atomic] acquire/release
-        sc_atomic_Size_type readPos;     // Memory-Model (MM) guaranteed sequential consistency (SC) between acquire (read) and release (write)
-        sc_atomic_Size_type writePos;    // ditto
-        relaxed_atomic_Size_type size;   // Non-SC atomic size, only atomic value itself is synchronized.
+        counter_type counter;            // Read and write counter, cached copies and wait objects on separate cache lines, capacity not final due to grow
+
+        alignas(cache_line_size) std::mutex syncMultiRead;  // Memory-Model (MM) guaranteed sequential consistency (SC) between acquire and release
+        alignas(cache_line_size) std::mutex syncMultiWrite; // ditto
+
+        Stats_policy stats;              // Getter and putter owned counters, empty if disabled
 
         T * newArray(const Size_type count) noexcept {
             return new T[count];
@@ -114,103 +211,165 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
 
         void cloneFrom(const bool allocArrayAndCapacity, const ringbuffer & source) noexcept {
             if( allocArrayAndCapacity ) {
-                capacityPlusOne = source.capacityPlusOne;
+                counter.setCapacity(source.counter.capacity(), source.counter.isPow2());
                 if( nullptr != array ) {
                     freeArray(array);
                 }
-                array = newArray(capacityPlusOne);
-            } else if( capacityPlusOne != source.capacityPlusOne ) {
-                throw InternalError("capacityPlusOne not equal: this "+toString()+", source "+source.toString(), E_FILE_LINE);
+                array = newArray(counter.capacity());
+            } else if( counter.capacity() != source.counter.capacity() || counter.isPow2() != source.counter.isPow2() ) {
+                throw InternalError("capacity not equal: this "+toString()+", source "+source.toString(), E_FILE_LINE);
             }
 
-            readPos = source.readPos;
-            writePos = source.writePos;
-            size = source.size;
-            Size_type localWritePos = readPos;
-            for(Size_type i=0; i<size; i++) {
-                localWritePos = (localWritePos + 1) % capacityPlusOne;
-                array[localWritePos] = source.array[localWritePos];
+            counter.reset(source.counter.state().readCount.load(), source.counter.state().writeCount.load());
+            const Size_type _size = source.counter.getSize();
+            uint64_t localWriteCount = counter.loadReadCount();
+            for(Size_type i=0; i<_size; i++) {
+                const Size_type j = counter.index(localWriteCount);
+                array[j] = source.array[j];
+                localWriteCount = counter.addCount(localWriteCount, 1);
             }
-            if( writePos != localWritePos ) {
-                throw InternalError("copy segment error: this "+toString()+", localWritePos "+std::to_string(localWritePos)+"; source "+source.toString(), E_FILE_LINE);
+            if( counter.loadWriteCount() != localWriteCount ) {
+                throw InternalError("copy segment error: this "+toString()+", localWriteCount "+std::to_string(localWriteCount)+"; source "+source.toString(), E_FILE_LINE);
             }
         }
 
-        void clearImpl() noexcept {
-            // clear all elements, zero size
-            const Size_type _size = size; // fast access
-            if( 0 < _size ) {
-                Size_type localReadPos = readPos;
-                for(Size_type i=0; i<_size; i++) {
-                    localReadPos = (localReadPos + 1) % capacityPlusOne;
-                    array[localReadPos] = nullelem;
+        /**
+         * Blocks the getter until at least min_count elements are available after the given localReadCount.
+         * @return false if timeout occurred, otherwise true
+         */
+        bool waitForElementsImpl(const uint64_t localReadCount, const Size_type min_count, const int timeoutMS) noexcept {
+            if constexpr ( Stats_policy::enabled ) {
+                const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+                const bool res = counter.waitForElements(localReadCount, min_count, timeoutMS);
+                stats.onGetWait( ringbuffer_stats::elapsedNS(t0) );
+                return res;
+            } else {
+                return counter.waitForElements(localReadCount, min_count, timeoutMS);
+            }
+        }
+
+        /**
+         * Blocks the putter until at least min_count free slots are available after the given localWriteCount.
+         * @return false if timeout occurred, otherwise true
+         */
+        bool waitForFreeSlotsImpl(const uint64_t localWriteCount, const Size_type min_count, const int timeoutMS) noexcept {
+            if constexpr ( Stats_policy::enabled ) {
+                const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+                const bool res = counter.waitForFreeSlots(localWriteCount, min_count, timeoutMS);
+                stats.onPutWait( ringbuffer_stats::elapsedNS(t0) );
+                return res;
+            } else {
+                return counter.waitForFreeSlots(localWriteCount, min_count, timeoutMS);
+            }
+        }
+
+        /** Counts n taken elements, caller is the getter. */
+        void statsGetImpl(const Size_type n) noexcept {
+            if constexpr ( Stats_policy::enabled ) {
+                stats.onGet(n);
+            }
+        }
+
+        /** Counts n put elements and the resulting size, caller is the putter. */
+        void statsPutImpl(const Size_type n, const uint64_t localWriteCount) noexcept {
+            if constexpr ( Stats_policy::enabled ) {
+                stats.onPut(n);
+                stats.onSize( counter.countImpl(counter.loadReadCount(), localWriteCount) );
+            }
+        }
+
+        /** Counts a failed non-blocking get operation, caller is the getter. */
+        void statsGetFailedImpl(const bool blocking) noexcept {
+            if constexpr ( Stats_policy::enabled ) {
+                if( !blocking ) {
+                    stats.onGetFailed();
                 }
-                if( writePos != localReadPos ) {
-                    // Avoid exception, abort!
-                    ABORT("copy segment error: this %s, readPos %d/%d; writePos %d", toString().c_str(), readPos.load(), localReadPos, writePos.load());
+            }
+        }
+
+        /** Counts a failed non-blocking put operation, caller is the putter. */
+        void statsPutFailedImpl(const bool blocking) noexcept {
+            if constexpr ( Stats_policy::enabled ) {
+                if( !blocking ) {
+                    stats.onPutFailed();
                 }
-                readPos = localReadPos;
-                size = 0;
             }
         }
 
+        /** Assigns <code>null</code> to count slots starting at the given counter, releasing remaining references. */
+        void nullifyImpl(const uint64_t startCount, const Size_type count) noexcept {
+            const span_type s = counter.span(array, startCount, count);
+            for(Size_type i=0; i<s.size1; i++) {
+                s.data1[i] = nullelem;
+            }
+            for(Size_type i=0; i<s.size2; i++) { // wrap-around
+                s.data2[i] = nullelem;
+            }
+        }
+
+        /** Drops up to count elements as the getter, caller holds syncMultiRead in multi_pc mode. */
+        Size_type dropImpl(const Size_type count) noexcept {
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            const Size_type dropCount = std::min(count, counter.available(localReadCount, count));
+            if( 0 == dropCount ) {
+                return 0;
+            }
+            nullifyImpl(localReadCount, dropCount);
+            counter.advanceRead(localReadCount, dropCount); // SC-DRF release atomic readCount
+            if constexpr ( Stats_policy::enabled ) {
+                stats.onDrop(dropCount);
+            }
+            return dropCount;
+        }
+
+        void clearImpl() noexcept {
+            // clear all elements, zero size
+            dropImpl(counter.capacity());
+        }
+
         void resetImpl(const T * copyFrom, const Size_type copyFromCount) noexcept {
             clearImpl();
 
             // fill with copyFrom elements
             if( nullptr != copyFrom && 0 < copyFromCount ) {
-                if( copyFromCount > capacityPlusOne-1 ) {
+                if( copyFromCount > counter.capacity() ) {
                     // new blank resized array
                     if( nullptr != array ) {
                         freeArray(array);
                     }
-                    capacityPlusOne = copyFromCount + 1;
-                    array = newArray(capacityPlusOne);
-                    readPos = 0;
-                    writePos = 0;
+                    counter.setCapacity(copyFromCount, counter.isPow2());
+                    array = newArray(counter.capacity());
+                    counter.reset(0, 0);
                 }
-                Size_type localWritePos = writePos;
+                const uint64_t localReadCount = counter.loadReadCount();
+                uint64_t localWriteCount = counter.loadWriteCount();
                 for(Size_type i=0; i<copyFromCount; i++) {
-                    localWritePos = (localWritePos + 1) % capacityPlusOne;
-                    array[localWritePos] = copyFrom[i];
-                    size++;
+                    array[counter.index(localWriteCount)] = copyFrom[i];
+                    localWriteCount = counter.addCount(localWriteCount, 1);
                 }
-                writePos = localWritePos;
+                counter.reset(localReadCount, localWriteCount);
+            } else {
+                counter.reset(counter.loadReadCount(), counter.loadWriteCount());
             }
         }
 
         T moveOutImpl(const bool blocking, const int timeoutMS) noexcept {
-            std::unique_lock<std::mutex> lockMultiRead(syncMultiRead); // acquire syncMultiRead, _not_ sync'ing w/ putImpl
-
-            const Size_type oldReadPos = readPos; // SC-DRF acquire atomic readPos, sync'ing with putImpl
-            Size_type localReadPos = oldReadPos;
-            if( localReadPos == writePos ) {
-                if( blocking ) {
-                    std::unique_lock<std::mutex> lockRead(syncRead); // SC-DRF w/ putImpl via same lock
-                    while( localReadPos == writePos ) {
-                        if( 0 == timeoutMS ) {
-                            cvRead.wait(lockRead);
-                        } else {
-                            std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
-                            std::cv_status s = cvRead.wait_until(lockRead, t0 + std::chrono::milliseconds(timeoutMS));
-                            if( std::cv_status::timeout == s && localReadPos == writePos ) {
-                                return nullelem;
-                            }
-                        }
-                    }
-                } else {
+            std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // _not_ sync'ing w/ putImpl
+            if constexpr ( multi_pc ) {
+                lockMultiRead.lock(); // acquire syncMultiRead
+            }
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            if( 0 == counter.available(localReadCount, 1) ) { // SC-DRF acquire atomic writeCount if appearing empty, sync'ing with putImpl
+                if( !blocking || !waitForElementsImpl(localReadCount, 1, timeoutMS) ) {
+                    statsGetFailedImpl(blocking);
                     return nullelem;
                 }
             }
-            localReadPos = (localReadPos + 1) % capacityPlusOne;
-            T r = std::move( array[localReadPos] ); // SC-DRF
-            array[localReadPos] = nullelem;
-            {
-                std::unique_lock<std::mutex> lockWrite(syncWrite); // SC-DRF w/ putImpl via same lock
-                size--;
-                readPos = localReadPos; // SC-DRF release atomic readPos
-                cvWrite.notify_all(); // notify waiting putter
-            }
+            const Size_type i = counter.index(localReadCount);
+            T r = std::move( array[i] ); // SC-DRF
+            array[i] = nullelem;
+            counter.advanceRead(localReadCount, 1); // SC-DRF release atomic readCount
+            statsGetImpl(1);
             return r;
         }
 
@@ -219,121 +378,232 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
                 ABORT("T is not copy constructible");
                 return nullelem;
             }
-            std::unique_lock<std::mutex> lockMultiRead(syncMultiRead); // acquire syncMultiRead, _not_ sync'ing w/ putImpl
-
-            const Size_type oldReadPos = readPos; // SC-DRF acquire atomic readPos, sync'ing with putImpl
-            Size_type localReadPos = oldReadPos;
-            if( localReadPos == writePos ) {
-                if( blocking ) {
-                    std::unique_lock<std::mutex> lockRead(syncRead); // SC-DRF w/ putImpl via same lock
-                    while( localReadPos == writePos ) {
-                        if( 0 == timeoutMS ) {
-                            cvRead.wait(lockRead);
-                        } else {
-                            std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
-                            std::cv_status s = cvRead.wait_until(lockRead, t0 + std::chrono::milliseconds(timeoutMS));
-                            if( std::cv_status::timeout == s && localReadPos == writePos ) {
-                                return nullelem;
-                            }
-                        }
-                    }
-                } else {
+            std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // _not_ sync'ing w/ putImpl
+            if constexpr ( multi_pc ) {
+                lockMultiRead.lock(); // acquire syncMultiRead
+            }
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            if( 0 == counter.available(localReadCount, 1) ) { // SC-DRF acquire atomic writeCount if appearing empty, sync'ing with putImpl
+                if( !blocking || !waitForElementsImpl(localReadCount, 1, timeoutMS) ) {
                     return nullelem;
                 }
             }
-            localReadPos = (localReadPos + 1) % capacityPlusOne;
-            T r = array[localReadPos]; // SC-DRF
-            readPos = oldReadPos; // SC-DRF release atomic readPos (complete acquire-release even @ peek)
-            return r;
+            return array[counter.index(localReadCount)]; // SC-DRF
         }
 
-        bool moveIntoImpl(T &&e, const bool blocking, const int timeoutMS) noexcept {
-            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite); // acquire syncMultiRead, _not_ sync'ing w/ getImpl
-
-            Size_type localWritePos = writePos; // SC-DRF acquire atomic writePos, sync'ing with getImpl
-            localWritePos = (localWritePos + 1) % capacityPlusOne;
-            if( localWritePos == readPos ) {
-                if( blocking ) {
-                    std::unique_lock<std::mutex> lockWrite(syncWrite); // SC-DRF w/ getImpl via same lock
-                    while( localWritePos == readPos ) {
-                        if( 0 == timeoutMS ) {
-                            cvWrite.wait(lockWrite);
-                        } else {
-                            std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
-                            std::cv_status s = cvWrite.wait_until(lockWrite, t0 + std::chrono::milliseconds(timeoutMS));
-                            if( std::cv_status::timeout == s && localWritePos == readPos ) {
-                                return false;
-                            }
-                        }
-                    }
-                } else {
+        template<typename U>
+        bool putImpl(U && e, const bool blocking, const int timeoutMS) noexcept {
+            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock); // _not_ sync'ing w/ getImpl
+            if constexpr ( multi_pc ) {
+                lockMultiWrite.lock(); // acquire syncMultiWrite
+            }
+            const uint64_t localWriteCount = counter.loadWriteCount(); // owned by putter
+            if( 0 == counter.freeSlots(localWriteCount, 1) ) { // SC-DRF acquire atomic readCount if appearing full, sync'ing with getImpl
+                if( !blocking || !waitForFreeSlotsImpl(localWriteCount, 1, timeoutMS) ) {
+                    statsPutFailedImpl(blocking);
                     return false;
                 }
             }
-            array[localWritePos] = std::move(e); // SC-DRF
-            {
-                std::unique_lock<std::mutex> lockRead(syncRead); // SC-DRF w/ getImpl via same lock
-                size++;
-                writePos = localWritePos; // SC-DRF release atomic writePos
-                cvRead.notify_all(); // notify waiting getter
-            }
+            array[counter.index(localWriteCount)] = std::forward<U>(e); // SC-DRF
+            const uint64_t newWriteCount = counter.advanceWrite(localWriteCount, 1); // SC-DRF release atomic writeCount
+            statsPutImpl(1, newWriteCount);
             return true;
         }
 
-        bool copyIntoImpl(const T &e, const bool blocking, const int timeoutMS) noexcept {
-            if( !std::is_copy_constructible_v<T> ) {
-                ABORT("T is not copy constructible");
-                return false;
-            }
-            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite); // acquire syncMultiRead, _not_ sync'ing w/ getImpl
-
-            Size_type localWritePos = writePos; // SC-DRF acquire atomic writePos, sync'ing with getImpl
-            localWritePos = (localWritePos + 1) % capacityPlusOne;
-            if( localWritePos == readPos ) {
-                if( blocking ) {
-                    std::unique_lock<std::mutex> lockWrite(syncWrite); // SC-DRF w/ getImpl via same lock
-                    while( localWritePos == readPos ) {
-                        if( 0 == timeoutMS ) {
-                            cvWrite.wait(lockWrite);
-                        } else {
-                            std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
-                            std::cv_status s = cvWrite.wait_until(lockWrite, t0 + std::chrono::milliseconds(timeoutMS));
-                            if( std::cv_status::timeout == s && localWritePos == readPos ) {
-                                return false;
-                            }
-                        }
+        template<typename U>
+        bool putOverwriteImpl(U && e) noexcept {
+            static_assert(multi_pc, "putOverwrite() requires multi_pc mode, i.e. a getter holding syncMultiRead");
+            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite); // acquire syncMultiWrite, _not_ sync'ing w/ getImpl
+            const uint64_t localWriteCount = counter.loadWriteCount(); // owned by putter
+            bool overwritten = false;
+            if( 0 == counter.freeSlots(localWriteCount, 1) ) { // SC-DRF acquire atomic readCount if appearing full, sync'ing with getImpl
+                // Full: exclude the getter only now, dropping the oldest element on its behalf.
+                // A blocking getter holds syncMultiRead while waiting for elements, hence only try-lock
+                // and back off as soon as the getter has taken elements meanwhile.
+                std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // lock order write -> read
+                while( !lockMultiRead.try_lock() && 0 == counter.freeSlots(localWriteCount, 1) ) {
+                    std::this_thread::yield();
+                }
+                if( lockMultiRead.owns_lock() ) {
+                    typename counter_type::state_type & cs = counter.state();
+                    cs.cachedReadCount = counter.loadReadCount(); // stable while holding syncMultiRead
+                    if( 0 == counter.cachedFreeSlots(localWriteCount) ) { // getter may have taken elements meanwhile
+                        array[counter.index(cs.cachedReadCount)] = nullelem; // oldest element, same slot as the new one
+                        cs.cachedReadCount = counter.addCount(cs.cachedReadCount, 1);
+                        cs.readCount.store(cs.cachedReadCount, std::memory_order_release); // SC-DRF release atomic readCount
+                        cs.cachedWriteCount = localWriteCount; // getter's cache, may have been passed by readCount
+                        overwritten = true;
                     }
-                } else {
-                    return false;
                 }
             }
-            array[localWritePos] = e; // SC-DRF
-            {
-                std::unique_lock<std::mutex> lockRead(syncRead); // SC-DRF w/ getImpl via same lock
-                size++;
-                writePos = localWritePos; // SC-DRF release atomic writePos
-                cvRead.notify_all(); // notify waiting getter
+            array[counter.index(localWriteCount)] = std::forward<U>(e); // SC-DRF, slot is never accessed by the getter before writeCount is released
+            const uint64_t newWriteCount = counter.advanceWrite(localWriteCount, 1); // SC-DRF release atomic writeCount
+            statsPutImpl(1, newWriteCount);
+            if constexpr ( Stats_policy::enabled ) {
+                if( overwritten ) {
+                    stats.onOverwrite();
+                }
             }
-            return true;
+            return overwritten;
         }
 
-        Size_type dropImpl (const Size_type count) noexcept {
-            // locks ringbuffer completely (read/write), hence no need for local copy nor wait/sync etc
-            std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
-            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock); // otherwise RAII-style relinquish via destructor
-            std::lock(lockMultiRead, lockMultiWrite);
+        /** Moves count elements out of the array starting at pos, w/o wrap-around. */
+        void moveOutSegment(T * dst, const Size_type pos, const Size_type count) noexcept {
+            if constexpr ( uses_memcpy ) {
+                // trivially copyable: no ownership to be released, hence no nullelem reset
+                ::memcpy(reinterpret_cast<void*>(dst), reinterpret_cast<const void*>(array + pos), count * sizeof(T));
+            } else {
+                for(Size_type i=0; i<count; i++) {
+                    dst[i] = std::move( array[pos+i] );
+                    array[pos+i] = nullelem;
+                }
+            }
+        }
 
-            const Size_type dropCount = std::min(count, size.load());
-            if( 0 == dropCount ) {
+        /** Copies count elements into the array starting at pos, w/o wrap-around. */
+        void copyInSegment(const Size_type pos, const T * src, const Size_type count) noexcept {
+            if constexpr ( uses_memcpy ) {
+                ::memcpy(reinterpret_cast<void*>(array + pos), reinterpret_cast<const void*>(src), count * sizeof(T));
+            } else {
+                for(Size_type i=0; i<count; i++) {
+                    array[pos+i] = src[i];
+                }
+            }
+        }
+
+        /**
+         * Moves up to max_count elements out to dst, using at most two contiguous segments
+         * and releasing readCount only once.
+         * @return number of moved elements, zero if less than min_count were available (after timeout)
+         */
+        Size_type getNImpl(T * dst, Size_type min_count, const Size_type max_count, const bool blocking, const int timeoutMS) noexcept {
+            min_count = std::min(min_count, std::min(max_count, counter.capacity()));
+            std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // _not_ sync'ing w/ putImpl
+            if constexpr ( multi_pc ) {
+                lockMultiRead.lock(); // acquire syncMultiRead
+            }
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            Size_type available = counter.available(localReadCount, max_count); // SC-DRF acquire atomic writeCount if less than max_count appear available
+            if( available < min_count ) {
+                if( !blocking || !waitForElementsImpl(localReadCount, min_count, timeoutMS) ) {
+                    statsGetFailedImpl(blocking);
+                    return 0;
+                }
+                available = counter.cachedAvailable(localReadCount);
+            }
+            const Size_type count = std::min(available, max_count);
+            if( 0 == count ) {
                 return 0;
             }
-            for(Size_type i=0; i<dropCount; i++) {
-                readPos = (readPos + 1) % capacityPlusOne;
-                // T r = array[localReadPos];
-                array[readPos] = nullelem;
-                size--;
+            const Size_type start = counter.index(localReadCount);
+            const Size_type count1 = std::min(count, counter.capacity() - start); // up to the array's end
+            moveOutSegment(dst, start, count1);
+            moveOutSegment(dst + count1, 0, count - count1); // wrap-around
+            counter.advanceRead(localReadCount, count); // SC-DRF release atomic readCount, once per batch
+            statsGetImpl(count);
+            return count;
+        }
+
+        /**
+         * Copies up to count elements from src, using at most two contiguous segments
+         * and releasing writeCount only once.
+         * @return number of copied elements, zero if less than min_count free slots were available (after timeout)
+         */
+        Size_type putNImpl(const T * src, Size_type min_count, const Size_type count, const bool blocking, const int timeoutMS) noexcept {
+            min_count = std::min(min_count, std::min(count, counter.capacity()));
+            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock); // _not_ sync'ing w/ getImpl
+            if constexpr ( multi_pc ) {
+                lockMultiWrite.lock(); // acquire syncMultiWrite
+            }
+            const uint64_t localWriteCount = counter.loadWriteCount(); // owned by putter
+            Size_type freeSlots = counter.freeSlots(localWriteCount, count); // SC-DRF acquire atomic readCount if less than count appear free
+            if( freeSlots < min_count ) {
+                if( !blocking || !waitForFreeSlotsImpl(localWriteCount, min_count, timeoutMS) ) {
+                    statsPutFailedImpl(blocking);
+                    return 0;
+                }
+                freeSlots = counter.cachedFreeSlots(localWriteCount);
+            }
+            const Size_type n = std::min(freeSlots, count);
+            if( 0 == n ) {
+                return 0;
+            }
+            const Size_type start = counter.index(localWriteCount);
+            const Size_type n1 = std::min(n, counter.capacity() - start); // up to the array's end
+            copyInSegment(start, src, n1);
+            copyInSegment(0, src + n1, n - n1); // wrap-around
+            const uint64_t newWriteCount = counter.advanceWrite(localWriteCount, n); // SC-DRF release atomic writeCount, once per batch
+            statsPutImpl(n, newWriteCount);
+            return n;
+        }
+
+        /** Acquires syncMultiRead in multi_pc mode, released by endRead(). */
+        span_type peekReadImpl(Size_type min_count, const Size_type max_count, const bool blocking, const int timeoutMS) noexcept {
+            min_count = std::min(min_count, std::min(max_count, counter.capacity()));
+            if constexpr ( multi_pc ) {
+                syncMultiRead.lock(); // acquire syncMultiRead, released by endRead()
+            }
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            Size_type available = counter.available(localReadCount, max_count); // SC-DRF acquire atomic writeCount if less than max_count appear available
+            if( available < min_count ) {
+                if( !blocking || !waitForElementsImpl(localReadCount, min_count, timeoutMS) ) {
+                    statsGetFailedImpl(blocking);
+                    return span_type();
+                }
+                available = counter.cachedAvailable(localReadCount);
+            }
+            return counter.span(array, localReadCount, std::min(available, max_count));
+        }
+
+        /** Acquires syncMultiWrite in multi_pc mode, released by endWrite(). */
+        span_type reserveWriteImpl(Size_type min_count, const Size_type max_count, const bool blocking, const int timeoutMS) noexcept {
+            min_count = std::min(min_count, std::min(max_count, counter.capacity()));
+            if constexpr ( multi_pc ) {
+                syncMultiWrite.lock(); // acquire syncMultiWrite, released by endWrite()
+            }
+            const uint64_t localWriteCount = counter.loadWriteCount(); // owned by putter
+            Size_type freeSlots = counter.freeSlots(localWriteCount, max_count); // SC-DRF acquire atomic readCount if less than max_count appear free
+            if( freeSlots < min_count ) {
+                if( !blocking || !waitForFreeSlotsImpl(localWriteCount, min_count, timeoutMS) ) {
+                    statsPutFailedImpl(blocking);
+                    return span_type();
+                }
+                freeSlots = counter.cachedFreeSlots(localWriteCount);
+            }
+            return counter.span(array, localWriteCount, std::min(freeSlots, max_count));
+        }
+
+        /**
+         * Dequeues the first count elements viewed by the preceding peekReadImpl() call and releases syncMultiRead in multi_pc mode,
+         * called by read_span_type.
+         * <p>
+         * Unless T is trivially copyable, the released slots are set to <code>null</code>
+         * to release remaining references.
+         * </p>
+         */
+        void endRead(const Size_type count) noexcept {
+            if( 0 < count ) {
+                const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+                if constexpr ( !uses_memcpy ) {
+                    nullifyImpl(localReadCount, count);
+                }
+                counter.advanceRead(localReadCount, count); // SC-DRF release atomic readCount
+                statsGetImpl(count);
+            }
+            if constexpr ( multi_pc ) {
+                syncMultiRead.unlock(); // release syncMultiRead, acquired by peekReadImpl()
+            }
+        }
+
+        /** Enqueues the first count slots reserved by the preceding reserveWriteImpl() call and releases syncMultiWrite in multi_pc mode, called by write_span_type. */
+        void endWrite(const Size_type count) noexcept {
+            if( 0 < count ) {
+                const uint64_t localWriteCount = counter.advanceWrite(counter.loadWriteCount(), count); // SC-DRF release atomic writeCount
+                statsPutImpl(count, localWriteCount);
+            }
+            if constexpr ( multi_pc ) {
+                syncMultiWrite.unlock(); // release syncMultiWrite, acquired by reserveWriteImpl()
             }
-            return dropCount;
         }
 
     public:
@@ -341,14 +611,14 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
         std::string toString() const noexcept {
             const std::string es = isEmpty() ? ", empty" : "";
             const std::string fs = isFull() ? ", full" : "";
-            return "ringbuffer<?>[size "+std::to_string(size)+" / "+std::to_string(capacityPlusOne-1)+
-                    ", writePos "+std::to_string(writePos)+", readPos "+std::to_string(readPos)+es+fs+"]";
+            return "ringbuffer<?>[size "+std::to_string(getSize())+" / "+std::to_string(counter.capacity())+
+                    ", writeCount "+std::to_string(counter.state().writeCount.load())+", readCount "+std::to_string(counter.state().readCount.load())+es+fs+"]";
         }
 
         /** Debug functionality - Dumps the contents of the internal array. */
         void dump(FILE *stream, std::string prefix) const noexcept {
             fprintf(stream, "%s %s {\n", prefix.c_str(), toString().c_str());
-            for(Size_type i=0; i<capacityPlusOne; i++) {
+            for(Size_type i=0; i<counter.capacity(); i++) {
                 // fprintf(stream, "\t[%d]: %p\n", i, array[i].get()); // FIXME
             }
             fprintf(stream, "}\n");
@@ -368,22 +638,20 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
          * {@link #isFull()} returns true on the newly created full ring buffer.
          * </p>
          * <p>
-         * Implementation will allocate an internal array with size of array <code>copyFrom</code> <i>plus one</i>,
+         * Implementation will allocate an internal array with size of array <code>copyFrom</code>,
          * and copy all elements from array <code>copyFrom</code> into the internal array.
          * </p>
          * @param copyFrom mandatory source array determining ring buffer's net {@link #capacity()} and initial content.
          * @throws IllegalArgumentException if <code>copyFrom</code> is <code>nullptr</code>
          */
         ringbuffer(const std::vector<T> & copyFrom) noexcept
-        : capacityPlusOne(copyFrom.size() + 1), array(newArray(capacityPlusOne)),
-          readPos(0), writePos(0), size(0)
+        : array(newArray(copyFrom.size())), counter(copyFrom.size(), false)
         {
             resetImpl(copyFrom.data(), copyFrom.size());
         }
 
         ringbuffer(const T * copyFrom, const Size_type copyFromSize) noexcept
-        : capacityPlusOne(copyFromSize + 1), array(newArray(capacityPlusOne)),
-          readPos(0), writePos(0), size(0)
+        : array(newArray(copyFromSize)), counter(copyFromSize, false)
         {
             resetImpl(copyFrom, copyFromSize);
         }
@@ -400,14 +668,28 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
          * {@link #isEmpty()} returns true on the newly created empty ring buffer.
          * </p>
          * <p>
-         * Implementation will allocate an internal array of size <code>capacity</code> <i>plus one</i>.
+         * Implementation will allocate an internal array of size <code>capacity</code>.
          * </p>
          * @param arrayType the array type of the created empty internal array.
          * @param capacity the initial net capacity of the ring buffer
          */
         ringbuffer(const Size_type capacity) noexcept
-        : capacityPlusOne(capacity + 1), array(newArray(capacityPlusOne)),
-          readPos(0), writePos(0), size(0)
+        : array(newArray(capacity)), counter(capacity, false)
+        { }
+
+        /**
+         * Create an empty ring buffer instance w/ the given minimum net <code>capacity</code>.
+         * <p>
+         * If <code>pow2</code> is true, <code>capacity</code> is rounded up to the next power of two,
+         * so the read and write counter run free and their array index becomes a bitmask.
+         * The resulting net {@link #capacity()} may be greater than requested.
+         * This property is kept on {@link #recapacity()}.
+         * </p>
+         * @param capacity the minimum initial net capacity of the ring buffer
+         * @param pow2 if true, round up the capacity to a power of two
+         */
+        ringbuffer(const Size_type capacity, const bool pow2) noexcept
+        : array(newArray(counter_type::roundCapacity(pow2, capacity))), counter(capacity, pow2)
         { }
 
         ~ringbuffer() noexcept {
@@ -418,8 +700,7 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
         }
 
         ringbuffer(const ringbuffer &_source) noexcept
-        : capacityPlusOne(_source.capacityPlusOne), array(newArray(capacityPlusOne)),
-          readPos(0), writePos(0), size(0)
+        : array(newArray(_source.counter.capacity())), counter(_source.counter.capacity(), _source.counter.isPow2())
         {
             std::unique_lock<std::mutex> lockMultiReadS(_source.syncMultiRead, std::defer_lock); // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
             std::unique_lock<std::mutex> lockMultiWriteS(_source.syncMultiWrite, std::defer_lock); // otherwise RAII-style relinquish via destructor
@@ -437,7 +718,7 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
             if( this == &_source ) {
                 return *this;
             }
-            if( capacityPlusOne != _source.capacityPlusOne ) {
+            if( counter.capacity() != _source.counter.capacity() || counter.isPow2() != _source.counter.isPow2() ) {
                 cloneFrom(true, _source);
             } else {
                 clearImpl(); // clear
@@ -450,7 +731,10 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
         ringbuffer& operator=(ringbuffer &&o) noexcept = default;
 
         /** Returns the net capacity of this ring buffer. */
-        Size_type capacity() const noexcept { return capacityPlusOne-1; }
+        Size_type capacity() const noexcept { return counter.capacity(); }
+
+        /** Returns true if the capacity is rounded up to a power of two, see ringbuffer(const Size_type, const bool). */
+        bool isPow2Capacity() const noexcept { return counter.isPow2(); }
 
         /**
          * Releasing all elements by assigning <code>null</code>.
@@ -460,10 +744,14 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
          * </p>
          */
         void clear() noexcept {
-            std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock);          // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
-            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock);        // otherwise RAII-style relinquish via destructor
-            std::lock(lockMultiRead, lockMultiWrite);
-            clearImpl();
+            if constexpr ( multi_pc ) {
+                std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock);          // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
+                std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock);        // otherwise RAII-style relinquish via destructor
+                std::lock(lockMultiRead, lockMultiWrite);
+                clearImpl();
+            } else {
+                clearImpl();
+            }
         }
 
         /**
@@ -484,19 +772,54 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
             resetImpl(copyFrom.data(), copyFrom.size());
         }
 
+        /**
+         * Returns a snapshot of the runtime statistics w/o taking the multi-read or -write mutex,
+         * all zero if the <code>Stats_policy</code> is disabled.
+         * @see ringbuffer_stats
+         */
+        ringbuffer_stats_snapshot getStats() const noexcept { return stats.snapshot(); }
+
+        /**
+         * Returns the getter's eventfd, readable once elements have been enqueued since {@link #acknowledgeRead()}.
+         * <p>
+         * Requires the ringbuffer_wait_eventfd <code>Wait_policy</code>.
+         * The multiplexing getter shall call {@link #acknowledgeRead()} before taking elements until empty.
+         * </p>
+         * @return the non-blocking eventfd or -1 if it could not be created
+         * @see ringbuffer_wait_eventfd
+         */
+        int getReadEventFD() const noexcept { return counter.state().waitRead.getEventFD(); }
+
+        /**
+         * Returns the putter's eventfd, readable once elements have been dequeued since {@link #acknowledgeWrite()}.
+         * <p>
+         * Requires the ringbuffer_wait_eventfd <code>Wait_policy</code>.
+         * The multiplexing putter shall call {@link #acknowledgeWrite()} before putting elements until full.
+         * </p>
+         * @return the non-blocking eventfd or -1 if it could not be created
+         * @see ringbuffer_wait_eventfd
+         */
+        int getWriteEventFD() const noexcept { return counter.state().waitWrite.getEventFD(); }
+
+        /** Acknowledges the getter's eventfd signal, re-arming it, see {@link #getReadEventFD()}. */
+        void acknowledgeRead() noexcept { counter.state().waitRead.acknowledge(); }
+
+        /** Acknowledges the putter's eventfd signal, re-arming it, see {@link #getWriteEventFD()}. */
+        void acknowledgeWrite() noexcept { counter.state().waitWrite.acknowledge(); }
+
         /** Returns the number of elements in this ring buffer. */
-        Size_type getSize() const noexcept { return size; }
+        Size_type getSize() const noexcept { return counter.getSize(); }
 
         /** Returns the number of free slots available to put.  */
-        Size_type getFreeSlots() const noexcept { return capacityPlusOne - 1 - size; }
+        Size_type getFreeSlots() const noexcept { return counter.capacity() - counter.getSize(); }
 
         /** Returns true if this ring buffer is empty, otherwise false. */
-        bool isEmpty() const noexcept { return 0 == size; /* writePos == readPos */ }
-        bool isEmpty2() const noexcept { return writePos == readPos; /* 0 == size */ }
+        bool isEmpty() const noexcept { return 0 == counter.getSize(); /* writeCount == readCount */ }
+        bool isEmpty2() const noexcept { return counter.state().writeCount == counter.state().readCount; /* 0 == size */ }
 
         /** Returns true if this ring buffer is full, otherwise false. */
-        bool isFull() const noexcept { return capacityPlusOne - 1 <= size; /* ( writePos + 1 ) % capacityPlusOne == readPos <==> capacityPlusOne - 1 == size */; }
-        bool isFull2() const noexcept { return ( writePos + 1 ) % capacityPlusOne == readPos; /* capacityPlusOne - 1 == size */; }
+        bool isFull() const noexcept { return counter.capacity() <= counter.getSize(); /* writeCount - readCount == capacity */ }
+        bool isFull2() const noexcept { return counter.capacity() == counter.countImpl(counter.state().readCount, counter.state().writeCount); /* capacity == size */ }
 
         /**
          * Dequeues the oldest enqueued element if available, otherwise null.
@@ -561,7 +884,99 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
          * @return actual number of dropped elements.
          */
         Size_type drop(const Size_type count) noexcept {
-            return dropImpl(count);
+            if constexpr ( multi_pc ) {
+                // locks ringbuffer completely (read/write), hence no need for local copy nor wait/sync etc
+                std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
+                std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock); // otherwise RAII-style relinquish via destructor
+                std::lock(lockMultiRead, lockMultiWrite);
+                return dropImpl(count);
+            } else {
+                return dropImpl(count);
+            }
+        }
+
+        /**
+         * Dequeues up to max_count oldest enqueued elements, moving them into the given dst array.
+         * <p>
+         * The elements are moved in at most two contiguous segments of the internal array,
+         * i.e. via plain memcpy if T is trivially copyable, see uses_memcpy.
+         * The read position is published only once for the whole batch.
+         * </p>
+         * <p>
+         * The returned ring buffer slots will be set to <code>null</code> if T is not trivially copyable
+         * to release the reference and move ownership to the caller.
+         * </p>
+         * <p>
+         * Method is non blocking and returns immediately;.
+         * </p>
+         * @param dst destination array of at least max_count elements
+         * @param max_count maximum number of elements to dequeue
+         * @return actual number of dequeued elements, zero if empty.
+         */
+        Size_type getN(T * dst, const Size_type max_count) noexcept {
+            return getNImpl(dst, 1, max_count, false, 0);
+        }
+
+        /**
+         * Dequeues up to max_count oldest enqueued elements, moving them into the given dst array,
+         * after blocking until at least min_count elements are available.
+         * <p>
+         * <code>timeoutMS</code> defaults to zero,
+         * i.e. infinitive blocking until min_count elements are available via put.<br>
+         * Otherwise this methods blocks for the given milliseconds.
+         * </p>
+         * <p>
+         * min_count is limited to max_count and capacity().
+         * </p>
+         * @param dst destination array of at least max_count elements
+         * @param min_count minimum number of elements to wait for
+         * @param max_count maximum number of elements to dequeue
+         * @param timeoutMS
+         * @return actual number of dequeued elements, zero if timeout occurred.
+         * @see getN()
+         */
+        Size_type getNBlocking(T * dst, const Size_type min_count, const Size_type max_count, const int timeoutMS=0) noexcept {
+            return getNImpl(dst, min_count, max_count, true, timeoutMS);
+        }
+
+        /**
+         * Enqueues up to count elements of the given src array by copying them into this ringbuffer storage.
+         * <p>
+         * The elements are copied in at most two contiguous segments of the internal array,
+         * i.e. via plain memcpy if T is trivially copyable, see uses_memcpy.
+         * The write position is published only once for the whole batch.
+         * </p>
+         * <p>
+         * Method is non blocking and returns immediately;.
+         * </p>
+         * @param src source array of at least count elements
+         * @param count maximum number of elements to enqueue
+         * @return actual number of enqueued elements, limited by the free slots, zero if full.
+         */
+        Size_type putN(const T * src, const Size_type count) noexcept {
+            return putNImpl(src, 1, count, false, 0);
+        }
+
+        /**
+         * Enqueues up to count elements of the given src array by copying them into this ringbuffer storage,
+         * after blocking until at least min_count free slots are available.
+         * <p>
+         * <code>timeoutMS</code> defaults to zero,
+         * i.e. infinitive blocking until min_count free slots become available via get.<br>
+         * Otherwise this methods blocks for the given milliseconds.
+         * </p>
+         * <p>
+         * min_count is limited to count and capacity().
+         * </p>
+         * @param src source array of at least count elements
+         * @param min_count minimum number of free slots to wait for
+         * @param count maximum number of elements to enqueue
+         * @param timeoutMS
+         * @return actual number of enqueued elements, zero if timeout occurred.
+         * @see putN()
+         */
+        Size_type putNBlocking(const T * src, const Size_type min_count, const Size_type count, const int timeoutMS=0) noexcept {
+            return putNImpl(src, min_count, count, true, timeoutMS);
         }
 
         /**
@@ -574,7 +989,7 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
          * </p>
          */
         bool put(T && e) noexcept {
-            return moveIntoImpl(std::move(e), false, 0);
+            return putImpl(std::move(e), false, 0);
         }
 
         /**
@@ -589,7 +1004,7 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
          * </p>
          */
         bool putBlocking(T && e, const int timeoutMS=0) noexcept {
-            return moveIntoImpl(std::move(e), true, timeoutMS);
+            return putImpl(std::move(e), true, timeoutMS);
         }
 
         /**
@@ -602,7 +1017,7 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
          * </p>
          */
         bool put(const T & e) noexcept {
-            return copyIntoImpl(e, false, 0);
+            return putImpl(e, false, 0);
         }
 
         /**
@@ -617,20 +1032,133 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
          * </p>
          */
         bool putBlocking(const T & e, const int timeoutMS=0) noexcept {
-            return copyIntoImpl(e, true, timeoutMS);
+            return putImpl(e, true, timeoutMS);
+        }
+
+        /**
+         * Enqueues the given element by moving it into this ringbuffer storage,
+         * overwriting the oldest element if full, i.e. lossy for telemetry data where the newest elements matter.
+         * <p>
+         * If full, the oldest element is dropped on behalf of the getter and the read position advanced
+         * before the new element is published, all while holding the multi-write and multi-read mutex.
+         * Hence a concurrent getter never observes the dropped element, nor a transient empty ring buffer.<br>
+         * The multi-read mutex is only acquired if the ring buffer appears to be full,
+         * i.e. a non-full putOverwrite() costs the same as put().
+         * </p>
+         * <p>
+         * Requires <code>multi_pc</code> mode, since the getter must hold the multi-read mutex.
+         * The multi-read mutex is only try-locked, since a blocking getter holds it while waiting for elements.
+         * Hence a getter holding the multi-read mutex via the read_span_type of {@link #peekRead()}
+         * lets an overwriting putter yield until either the span guard is released or slots have been freed.
+         * </p>
+         * <p>
+         * Method is non blocking and always enqueues the given element.
+         * Overwritten elements are counted by the <code>Stats_policy</code>, see ringbuffer_stats_snapshot::overwrites.
+         * </p>
+         * @return true if the oldest element has been overwritten, otherwise false
+         */
+        bool putOverwrite(T && e) noexcept {
+            return putOverwriteImpl(std::move(e));
+        }
+
+        /**
+         * Enqueues the given element by copying it into this ringbuffer storage,
+         * overwriting the oldest element if full, see {@link #putOverwrite(T&&)}.
+         * @return true if the oldest element has been overwritten, otherwise false
+         */
+        bool putOverwrite(const T & e) noexcept {
+            return putOverwriteImpl(e);
+        }
+
+        /**
+         * Returns a view of up to max_count oldest enqueued elements within the ring buffer storage w/o dequeuing them,
+         * allowing to parse elements in place.
+         * <p>
+         * The returned guard dequeues all viewed elements at destruction,
+         * or the first <code>count</code> viewed elements at its explicit early read_span_type::release().
+         * In <code>multi_pc</code> mode, the multi-read mutex is held until then, even if the returned span is empty.
+         * </p>
+         * <p>
+         * Method is non blocking and returns immediately;.
+         * </p>
+         * @param max_count maximum number of elements to view
+         * @return span guard of up to max_count elements, empty if none is available
+         * @see ringbuffer_span_guard
+         */
+        read_span_type peekRead(const Size_type max_count) noexcept {
+            return read_span_type(*this, peekReadImpl(1, max_count, false, 0));
+        }
+
+        /**
+         * Returns a view of up to max_count oldest enqueued elements within the ring buffer storage w/o dequeuing them,
+         * blocking until at least min_count elements are available, see {@link #peekRead()}.
+         * <p>
+         * <code>timeoutMS</code> defaults to zero,
+         * i.e. infinitive blocking until at least min_count elements are available via put.<br>
+         * Otherwise this methods blocks for the given milliseconds.
+         * </p>
+         * @param min_count minimum number of elements to view
+         * @param max_count maximum number of elements to view
+         * @param timeoutMS
+         * @return span guard of up to max_count elements, empty if timeout occurred
+         * @see ringbuffer_span_guard
+         */
+        read_span_type peekReadBlocking(const Size_type min_count, const Size_type max_count, const int timeoutMS=0) noexcept {
+            return read_span_type(*this, peekReadImpl(min_count, max_count, true, timeoutMS));
+        }
+
+        /**
+         * Returns a view of up to max_count free slots within the ring buffer storage,
+         * allowing to construct elements in place.
+         * <p>
+         * The returned guard enqueues all reserved slots at destruction,
+         * or the first <code>count</code> written slots at its explicit early write_span_type::commit().
+         * In <code>multi_pc</code> mode, the multi-write mutex is held until then, even if the returned span is empty.
+         * </p>
+         * <p>
+         * Method is non blocking and returns immediately;.
+         * </p>
+         * @param max_count maximum number of slots to reserve
+         * @return span guard of up to max_count slots, empty if the ring buffer is full
+         * @see ringbuffer_span_guard
+         */
+        write_span_type reserveWrite(const Size_type max_count) noexcept {
+            return write_span_type(*this, reserveWriteImpl(1, max_count, false, 0));
+        }
+
+        /**
+         * Returns a view of up to max_count free slots within the ring buffer storage,
+         * blocking until at least min_count free slots are available, see {@link #reserveWrite()}.
+         * <p>
+         * <code>timeoutMS</code> defaults to zero,
+         * i.e. infinitive blocking until at least min_count free slots become available via get.<br>
+         * Otherwise this methods blocks for the given milliseconds.
+         * </p>
+         * @param min_count minimum number of slots to reserve
+         * @param max_count maximum number of slots to reserve
+         * @param timeoutMS
+         * @return span guard of up to max_count slots, empty if timeout occurred
+         * @see ringbuffer_span_guard
+         */
+        write_span_type reserveWriteBlocking(const Size_type min_count, const Size_type max_count, const int timeoutMS=0) noexcept {
+            return write_span_type(*this, reserveWriteImpl(min_count, max_count, true, timeoutMS));
         }
 
         /**
          * Blocks until at least <code>count</code> free slots become available.
+         * <p>
+         * Shall only be called by the putter thread in SPSC mode.
+         * </p>
          * @throws InterruptedException
          */
         void waitForFreeSlots(const Size_type count) noexcept {
-            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock);        // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
-            std::unique_lock<std::mutex> lockRead(syncRead, std::defer_lock);                    // otherwise RAII-style relinquish via destructor
-            std::lock(lockMultiWrite, lockRead);
-
-            while( capacityPlusOne - 1 - size < count ) {
-                cvRead.wait(lockRead);
+            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock);        // _not_ sync'ing w/ getImpl
+            if constexpr ( multi_pc ) {
+                lockMultiWrite.lock(); // acquire syncMultiWrite
+            }
+            const uint64_t localWriteCount = counter.loadWriteCount(); // owned by putter
+            if( counter.freeSlots(localWriteCount, count) < count ) {
+                waitForFreeSlotsImpl(localWriteCount, count, 0);
             }
         }
 
@@ -639,14 +1167,17 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
          * <p>
          * New capacity must be greater than current size.
          * </p>
+         * <p>
+         * If isPow2Capacity(), the new capacity is rounded up to a power of two again.
+         * </p>
          */
         void recapacity(const Size_type newCapacity) {
             std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock);          // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
             std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock);        // otherwise RAII-style relinquish via destructor
             std::lock(lockMultiRead, lockMultiWrite);
-            const Size_type _size = size; // fast access
+            const Size_type _size = counter.getSize(); // fast access
 
-            if( capacityPlusOne == newCapacity+1 ) {
+            if( counter.capacity() == counter_type::roundCapacity(counter.isPow2(), newCapacity) ) {
                 return;
             }
             if( _size > newCapacity ) {
@@ -654,26 +1185,22 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
             }
 
             // save current data
-            Size_type oldCapacityPlusOne = capacityPlusOne;
+            const Size_type oldCapacity = counter.capacity();
             T * oldArray = array;
-            Size_type oldReadPos = readPos;
+            Size_type oldReadIndex = counter.index(counter.loadReadCount());
 
             // new blank resized array
-            capacityPlusOne = newCapacity + 1;
-            array = newArray(capacityPlusOne);
-            readPos = 0;
-            writePos = 0;
+            counter.setCapacity(newCapacity, counter.isPow2());
+            array = newArray(counter.capacity());
 
             // copy saved data
-            if( nullptr != oldArray && 0 < _size ) {
-                Size_type localWritePos = writePos;
+            if( nullptr != oldArray ) {
                 for(Size_type i=0; i<_size; i++) {
-                    localWritePos = (localWritePos + 1) % capacityPlusOne;
-                    oldReadPos = (oldReadPos + 1) % oldCapacityPlusOne;
-                    array[localWritePos] = std::move( oldArray[oldReadPos] );
+                    array[i] = std::move( oldArray[oldReadIndex] );
+                    oldReadIndex = oldReadIndex + 1 < oldCapacity ? oldReadIndex + 1 : 0;
                 }
-                writePos = localWritePos;
             }
+            counter.reset(0, _size);
             freeArray(oldArray); // and release
         }
 };
@@ -694,4 +1221,9 @@ template <typename T, std::nullptr_t nullelem, typename Size_type> class ringbuf
  * </p>
  */
 
+/** \example test_lfringbuffer_perf01.cpp
+ * This C++ unit test benchmarks jau::ringbuffer's throughput in multi_pc and SPSC mode,
+ * using single and batch operations, as well as the handoff latency of each wait policy.
+ */
+
 #endif /* JAU_RINGBUFFER_HPP_ */
@@ -0,0 +1,437 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_RINGBUFFER_COUNTER_HPP_
+#define JAU_RINGBUFFER_COUNTER_HPP_
+
+#include <type_traits>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+
+#include <cstdint>
+
+#include <jau/int_math.hpp>
+#include <jau/ringbuffer_span.hpp>
+
+namespace jau {
+
+/**
+ * Read and write counter state of a ring buffer, incl. the cached opposite counter and the wait objects of both sides.
+ * <p>
+ * Getter owned state, i.e. read counter and its cached copy of the write counter,
+ * and putter owned state, i.e. write counter and its cached copy of the read counter,
+ * as well as each wait object are placed on separate cache lines to avoid false sharing.
+ * </p>
+ * <p>
+ * The state holds no pointer, hence it may reside within a shared memory segment
+ * if <code>Wait_policy</code> is process shared and std::atomic<uint64_t> is address-free, see jau::shm_ringbuffer.
+ * </p>
+ * @see ringbuffer_counter
+ */
+template <typename Wait_policy>
+struct ringbuffer_counter_state {
+    /** Assumed cache line size, separating getter and putter owned state. */
+    constexpr static const std::size_t cache_line_size = 64;
+
+    // Getter owned state
+    alignas(cache_line_size) std::atomic<uint64_t> readCount; // Memory-Model (MM) guaranteed acquire (read) and release (write), owned by getter
+    uint64_t cachedWriteCount;       // Getter's copy of writeCount, reloaded if appearing empty
+
+    // Putter owned state
+    alignas(cache_line_size) std::atomic<uint64_t> writeCount; // ditto, owned by putter
+    uint64_t cachedReadCount;        // Putter's copy of readCount, reloaded if appearing full
+
+    alignas(cache_line_size) Wait_policy waitRead;  // Blocking getter waiting for writeCount, SC-DRF w/ writeCount via notifyGetter()
+    alignas(cache_line_size) Wait_policy waitWrite; // Blocking putter waiting for readCount, SC-DRF w/ readCount via notifyPutter()
+
+    ringbuffer_counter_state() noexcept
+    : readCount(0), cachedWriteCount(0), writeCount(0), cachedReadCount(0)
+    { }
+
+    ringbuffer_counter_state(const ringbuffer_counter_state &_source) = delete;
+    ringbuffer_counter_state& operator=(const ringbuffer_counter_state &_source) = delete;
+};
+
+/**
+ * Index policy of ringbuffer_counter w/ a runtime capacity, optionally rounded up to a power of two, used by jau::ringbuffer.
+ * <p>
+ * If the capacity is a power of two, the read and write counter run free as 64-bit integers and the array index is derived via a bitmask.<br>
+ * Otherwise both counter run modulo twice the capacity, i.e. their wrap-around and the array index use a comparison.<br>
+ * Either way, no integer division is performed.
+ * </p>
+ */
+template <typename Size_type>
+class ringbuffer_index {
+    private:
+        bool pow2Capacity;               // capacity_ is rounded up to a power of two
+        Size_type capacity_;
+        uint64_t indexMask;              // capacity_ - 1 if a power of two greater one, otherwise zero
+        uint64_t countWrap;              // 2 * capacity_, counter modulus if indexMask is zero, otherwise counters run free
+
+    public:
+        /** True if the counters always run free, otherwise they may wrap around at twice the capacity. */
+        constexpr static const bool free_running = false;
+
+        /** Returns the net capacity for the given minimum capacity, i.e. rounded up to a power of two if pow2 is true. */
+        constexpr static Size_type roundCapacity(const bool pow2, const Size_type capacity) noexcept {
+            return pow2 ? static_cast<Size_type>( round_to_power_of_2<std::make_unsigned_t<Size_type>>(capacity) ) : capacity;
+        }
+
+        ringbuffer_index(const Size_type capacity, const bool pow2) noexcept {
+            setCapacity(capacity, pow2);
+        }
+
+        /** Sets the net capacity, rounded up to a power of two if pow2 is true. Caller holds exclusive access. */
+        void setCapacity(const Size_type capacity, const bool pow2) noexcept {
+            pow2Capacity = pow2;
+            capacity_ = roundCapacity(pow2, capacity);
+            indexMask = pow2 && 1 < capacity_ ? capacity_ - 1 : 0;
+            countWrap = 2 * static_cast<uint64_t>(capacity_);
+        }
+
+        /** Returns true if the capacity is rounded up to a power of two. */
+        constexpr bool isPow2() const noexcept { return pow2Capacity; }
+
+        /** Returns the net capacity. */
+        constexpr Size_type capacity() const noexcept { return capacity_; }
+
+        /** Returns the counter count steps after the given one, count <= capacity(). */
+        constexpr uint64_t addCount(const uint64_t c, const Size_type count) const noexcept {
+            if( 0 != indexMask ) {
+                return c + count; // free running
+            }
+            return c + count < countWrap ? c + count : c + count - countWrap;
+        }
+
+        /** Returns the array index of the given counter, w/o an integer division. */
+        constexpr Size_type index(const uint64_t c) const noexcept {
+            if( 0 != indexMask ) {
+                return static_cast<Size_type>( c & indexMask );
+            }
+            return static_cast<Size_type>( c < capacity_ ? c : c - capacity_ );
+        }
+
+        /** Returns the number of elements between the given read- and write-counter. */
+        constexpr Size_type countImpl(const uint64_t r, const uint64_t w) const noexcept {
+            if( 0 != indexMask ) {
+                return static_cast<Size_type>( w - r );
+            }
+            return static_cast<Size_type>( r <= w ? w - r : countWrap - r + w );
+        }
+};
+
+/**
+ * Index policy of ringbuffer_counter w/ a runtime capacity, always rounded up to a power of two,
+ * used by jau::value_ringbuffer, jau::byte_ringbuffer and jau::shm_ringbuffer.
+ * <p>
+ * The read and write counter run free as 64-bit integers and the array index is derived via a bitmask.
+ * </p>
+ */
+template <typename Size_type>
+class ringbuffer_pow2_index {
+    private:
+        Size_type capacity_;             // power of two
+        uint64_t indexMask;              // capacity_ - 1
+
+    public:
+        /** True if the counters always run free, otherwise they may wrap around at twice the capacity. */
+        constexpr static const bool free_running = true;
+
+        /** Returns the net capacity for the given minimum capacity, i.e. rounded up to a power of two. */
+        constexpr static Size_type roundCapacity(const Size_type capacity) noexcept {
+            return static_cast<Size_type>( round_to_power_of_2<std::make_unsigned_t<Size_type>>(capacity) );
+        }
+
+        ringbuffer_pow2_index(const Size_type capacity) noexcept {
+            setCapacity(capacity);
+        }
+
+        /** Sets the net capacity, rounded up to a power of two. Caller holds exclusive access. */
+        void setCapacity(const Size_type capacity) noexcept {
+            capacity_ = roundCapacity(capacity);
+            indexMask = capacity_ - 1;
+        }
+
+        /** Returns the net capacity, a power of two. */
+        constexpr Size_type capacity() const noexcept { return capacity_; }
+
+        /** Returns the counter count steps after the given one. */
+        constexpr uint64_t addCount(const uint64_t c, const Size_type count) const noexcept { return c + count; }
+
+        /** Returns the array index of the given counter via a bitmask. */
+        constexpr Size_type index(const uint64_t c) const noexcept { return static_cast<Size_type>( c & indexMask ); }
+
+        /** Returns the number of elements between the given read- and write-counter. */
+        constexpr Size_type countImpl(const uint64_t r, const uint64_t w) const noexcept { return static_cast<Size_type>( w - r ); }
+};
+
+/**
+ * Index policy of ringbuffer_counter w/ a compile-time <code>Capacity</code>, used by jau::fixed_ringbuffer.
+ * <p>
+ * The read and write counter run free as 64-bit integers and the array index is derived via <code>count % Capacity</code>
+ * with a constant divisor, becoming a bitmask if <code>Capacity</code> is a power of two.
+ * </p>
+ */
+template <typename Size_type, Size_type Capacity>
+class ringbuffer_fixed_index {
+    public:
+        static_assert(0 < Capacity, "Capacity must be greater than zero");
+
+        /** True if the counters always run free, otherwise they may wrap around at twice the capacity. */
+        constexpr static const bool free_running = true;
+
+        /** Returns the net capacity. */
+        constexpr static Size_type capacity() noexcept { return Capacity; }
+
+        /** Returns the counter count steps after the given one. */
+        constexpr static uint64_t addCount(const uint64_t c, const Size_type count) noexcept { return c + count; }
+
+        /** Returns the array index of the given counter. */
+        constexpr static Size_type index(const uint64_t c) noexcept {
+            return static_cast<Size_type>( c % Capacity ); // constant divisor, bitmask if a power of two
+        }
+
+        /** Returns the number of elements between the given read- and write-counter. */
+        constexpr static Size_type countImpl(const uint64_t r, const uint64_t w) noexcept { return static_cast<Size_type>( w - r ); }
+};
+
+/**
+ * Read and write counter core of the ring buffer implementations,
+ * i.e. jau::ringbuffer, jau::fixed_ringbuffer, jau::value_ringbuffer, jau::byte_ringbuffer and jau::shm_ringbuffer.
+ * <p>
+ * Implements the size, the available elements for the getter and free slots for the putter using the cached opposite counter,
+ * the blocking wait and notification via <code>Wait_policy</code> as well as publishing an advanced counter.
+ * The storage and the multi-read and -write mutex remain with the ring buffer implementation.
+ * </p>
+ * <p>
+ * <code>Index_policy</code> derives the array index and the number of elements from the counters,
+ * see ringbuffer_index, ringbuffer_pow2_index and ringbuffer_fixed_index.
+ * </p>
+ * <p>
+ * If <code>shared_state</code> is false, the ringbuffer_counter_state is embedded within this instance.
+ * Otherwise it resides elsewhere, e.g. within a shared memory segment, and is attached via {@link #attach()}.
+ * </p>
+ * <p>
+ * The getter operations shall only be called by the getter,
+ * i.e. holding the multi-read mutex in <code>multi_pc</code> mode, the putter operations likewise.
+ * </p>
+ */
+template <typename Size_type, typename Wait_policy, typename Index_policy, bool shared_state=false>
+class ringbuffer_counter : public Index_policy {
+    public:
+        typedef ringbuffer_counter_state<Wait_policy> state_type;
+
+        /** View of up to two contiguous storage segments. */
+        template<typename T>
+        using span_type = ringbuffer_span<T, Size_type>;
+
+    private:
+        std::conditional_t<shared_state, state_type *, state_type> state_;
+
+    public:
+        /** Creates the counter core, passing the given arguments to the <code>Index_policy</code>. */
+        template<typename... Args>
+        explicit ringbuffer_counter(Args&&... args) noexcept
+        : Index_policy(std::forward<Args>(args)...), state_()
+        { }
+
+        ringbuffer_counter(const ringbuffer_counter &_source) = delete;
+        ringbuffer_counter& operator=(const ringbuffer_counter &_source) = delete;
+
+        /** Attaches the external state, i.e. if <code>shared_state</code> is true. */
+        void attach(state_type * s) noexcept {
+            static_assert(shared_state, "attach() requires shared_state");
+            state_ = s;
+        }
+
+        /** Returns the counter state. */
+        state_type & state() noexcept {
+            if constexpr ( shared_state ) {
+                return *state_;
+            } else {
+                return state_;
+            }
+        }
+
+        /** Returns the counter state. */
+        const state_type & state() const noexcept {
+            if constexpr ( shared_state ) {
+                return *state_;
+            } else {
+                return state_;
+            }
+        }
+
+        /** Returns the read counter, a getter operation. */
+        uint64_t loadReadCount() const noexcept { return state().readCount.load(std::memory_order_relaxed); }
+
+        /** Returns the write counter, a putter operation. */
+        uint64_t loadWriteCount() const noexcept { return state().writeCount.load(std::memory_order_relaxed); }
+
+        /** Returns the size derived from a snapshot of the read- and write-counter. */
+        Size_type getSize() const noexcept {
+            const state_type & s = state();
+            if constexpr ( Index_policy::free_running ) {
+                const uint64_t r = s.readCount.load(std::memory_order_acquire); // load first, never passes writeCount
+                const uint64_t w = s.writeCount.load(std::memory_order_acquire);
+                return static_cast<Size_type>( std::min<uint64_t>(w - r, this->capacity()) );
+            } else {
+                uint64_t r = s.readCount.load(std::memory_order_acquire); // read-counter unchanged while loading the write-counter
+                while( true ) {
+                    const uint64_t w = s.writeCount.load(std::memory_order_acquire);
+                    const uint64_t r2 = s.readCount.load(std::memory_order_acquire);
+                    if( r == r2 ) {
+                        return this->countImpl(r, w);
+                    }
+                    r = r2;
+                }
+            }
+        }
+
+        /**
+         * Returns the number of elements available to the getter after the given localReadCount,
+         * using the cached writeCount and only reloading it if less than the wanted count are available.
+         */
+        Size_type available(const uint64_t localReadCount, const Size_type wanted) noexcept {
+            state_type & s = state();
+            Size_type n = this->countImpl(localReadCount, s.cachedWriteCount);
+            if( n < wanted ) {
+                s.cachedWriteCount = s.writeCount.load(std::memory_order_acquire); // SC-DRF acquire atomic writeCount, sync'ing with putter
+                n = this->countImpl(localReadCount, s.cachedWriteCount);
+            }
+            return n;
+        }
+
+        /**
+         * Returns the number of free slots available to the putter after the given localWriteCount,
+         * using the cached readCount and only reloading it if less than the wanted count are available.
+         */
+        Size_type freeSlots(const uint64_t localWriteCount, const Size_type wanted) noexcept {
+            state_type & s = state();
+            Size_type n = this->capacity() - this->countImpl(s.cachedReadCount, localWriteCount);
+            if( n < wanted ) {
+                s.cachedReadCount = s.readCount.load(std::memory_order_acquire); // SC-DRF acquire atomic readCount, sync'ing with getter
+                n = this->capacity() - this->countImpl(s.cachedReadCount, localWriteCount);
+            }
+            return n;
+        }
+
+        /** Returns the number of elements available to the getter after the given localReadCount w/o reloading writeCount, e.g. after waitForElements(). */
+        Size_type cachedAvailable(const uint64_t localReadCount) const noexcept {
+            return this->countImpl(localReadCount, state().cachedWriteCount);
+        }
+
+        /** Returns the number of free slots available to the putter after the given localWriteCount w/o reloading readCount, e.g. after waitForFreeSlots(). */
+        Size_type cachedFreeSlots(const uint64_t localWriteCount) const noexcept {
+            return this->capacity() - this->countImpl(state().cachedReadCount, localWriteCount);
+        }
+
+        /**
+         * Blocks the getter until at least min_count elements are available after the given localReadCount,
+         * reloading the cached writeCount.
+         * @return false if timeout occurred, otherwise true
+         */
+        bool waitForElements(const uint64_t localReadCount, const Size_type min_count, const int timeoutMS) noexcept {
+            state_type & s = state();
+            const bool res = s.waitRead.wait( [&]() noexcept -> bool {
+                return this->countImpl(localReadCount, s.writeCount.load(std::memory_order_seq_cst)) >= min_count;
+            }, timeoutMS);
+            s.cachedWriteCount = s.writeCount.load(std::memory_order_acquire);
+            return res;
+        }
+
+        /**
+         * Blocks the putter until at least min_count free slots are available after the given localWriteCount,
+         * reloading the cached readCount.
+         * @return false if timeout occurred, otherwise true
+         */
+        bool waitForFreeSlots(const uint64_t localWriteCount, const Size_type min_count, const int timeoutMS) noexcept {
+            state_type & s = state();
+            const bool res = s.waitWrite.wait( [&]() noexcept -> bool {
+                return this->capacity() - this->countImpl(s.readCount.load(std::memory_order_seq_cst), localWriteCount) >= min_count;
+            }, timeoutMS);
+            s.cachedReadCount = s.readCount.load(std::memory_order_acquire);
+            return res;
+        }
+
+        /**
+         * Wakes up a blocking getter, if any, after writeCount has been released.
+         * <p>
+         * Only the sleeping wait policies pay for a notification, and only if a getter is actually sleeping.
+         * </p>
+         */
+        void notifyGetter() noexcept {
+            if constexpr ( Wait_policy::uses_notify ) {
+                state().waitRead.notify();
+            }
+        }
+
+        /** Wakes up a blocking putter, if any, after readCount has been released. See notifyGetter(). */
+        void notifyPutter() noexcept {
+            if constexpr ( Wait_policy::uses_notify ) {
+                state().waitWrite.notify();
+            }
+        }
+
+        /** Dequeues count elements after the given localReadCount and notifies the putter, a getter operation. */
+        uint64_t advanceRead(const uint64_t localReadCount, const Size_type count) noexcept {
+            const uint64_t c = this->addCount(localReadCount, count);
+            state().readCount.store(c, std::memory_order_release); // SC-DRF release atomic readCount
+            notifyPutter();
+            return c;
+        }
+
+        /** Enqueues count elements after the given localWriteCount and notifies the getter, a putter operation. */
+        uint64_t advanceWrite(const uint64_t localWriteCount, const Size_type count) noexcept {
+            const uint64_t c = this->addCount(localWriteCount, count);
+            state().writeCount.store(c, std::memory_order_release); // SC-DRF release atomic writeCount
+            notifyGetter();
+            return c;
+        }
+
+        /** Sets the read- and write-counter as well as their cached copies. Caller holds exclusive access. */
+        void reset(const uint64_t r, const uint64_t w) noexcept {
+            state_type & s = state();
+            s.readCount.store(r, std::memory_order_relaxed);
+            s.writeCount.store(w, std::memory_order_relaxed);
+            s.cachedWriteCount = w;
+            s.cachedReadCount = r;
+        }
+
+        /** Returns the span of count elements of the given array starting at the given counter, w/ wrap-around. */
+        template<typename T>
+        span_type<T> span(T * array, const uint64_t startCount, const Size_type count) const noexcept {
+            if( 0 == count ) {
+                return span_type<T>();
+            }
+            const Size_type start = this->index(startCount);
+            const Size_type count1 = std::min<Size_type>(count, this->capacity() - start); // up to the array's end
+            return span_type<T>{ array + start, count1, array, static_cast<Size_type>( count - count1 ) };
+        }
+};
+
+} /* namespace jau */
+
+#endif /* JAU_RINGBUFFER_COUNTER_HPP_ */
@@ -0,0 +1,154 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_RINGBUFFER_SPAN_HPP_
+#define JAU_RINGBUFFER_SPAN_HPP_
+
+#include <exception>
+
+namespace jau {
+
+/**
+ * View of up to two contiguous segments within a ring buffer's storage,
+ * the second segment continuing the first after the wrap-around at the array's end.
+ * <p>
+ * Returned by the zero-copy operations of jau::ringbuffer and jau::value_ringbuffer,
+ * i.e. <code>reserveWrite()</code> and <code>peekRead()</code>.
+ * </p>
+ * <p>
+ * The view is only valid while its ringbuffer_span_guard exists.
+ * </p>
+ * @see ringbuffer_span_guard
+ */
+template <typename T, typename Size_type>
+struct ringbuffer_span {
+    /** First segment, starting at the current read or write position. */
+    T * data1 = nullptr;
+    /** Number of elements of the first segment. */
+    Size_type size1 = 0;
+    /** Second segment, starting at the array's begin, if wrapped around. */
+    T * data2 = nullptr;
+    /** Number of elements of the second segment, zero if not wrapped around. */
+    Size_type size2 = 0;
+
+    /** Returns the total number of elements of both segments. */
+    constexpr Size_type size() const noexcept { return size1 + size2; }
+
+    /** Returns true if both segments are empty. */
+    constexpr bool empty() const noexcept { return 0 == size1 + size2; }
+
+    /** Returns a reference to the i-th element, crossing over to the second segment. No bounds check. */
+    constexpr T & operator[](const Size_type i) const noexcept {
+        return i < size1 ? data1[i] : data2[i - size1];
+    }
+};
+
+/**
+ * Move-only RAII guard of a ringbuffer_span returned by the zero-copy operations
+ * <code>peekRead()</code> and <code>reserveWrite()</code> of jau::ringbuffer, jau::value_ringbuffer and jau::byte_ringbuffer.
+ * <p>
+ * In <code>multi_pc</code> mode, the ring buffer's multi-read or multi-write mutex is held from creation
+ * until destruction or the explicit early release(), respectively commit().
+ * </p>
+ * <p>
+ * Destruction dequeues all viewed elements of a read span, respectively enqueues all reserved slots of a write span,
+ * unless destructed due to an exception thrown after creation, which dequeues respectively enqueues none.<br>
+ * To dequeue or enqueue only a part of the span, call release(), respectively commit(), with the desired count.
+ * </p>
+ * <p>
+ * The guard shall remain on its creating thread and shall be destructed
+ * before the same thread calls another operation on the same side of the ring buffer.
+ * </p>
+ * @tparam Ringbuffer the ring buffer type
+ * @tparam T the element type
+ * @tparam Size_type the size type
+ * @tparam Write true for a write span of reserveWrite(), otherwise false for a read span of peekRead()
+ */
+template <typename Ringbuffer, typename T, typename Size_type, bool Write>
+class ringbuffer_span_guard : public ringbuffer_span<T, Size_type> {
+    private:
+        Ringbuffer * rb;
+        int uncaught;
+
+        void end(const Size_type count) noexcept {
+            if constexpr ( Write ) {
+                rb->endWrite(count);
+            } else {
+                rb->endRead(count);
+            }
+            rb = nullptr;
+            static_cast<ringbuffer_span<T, Size_type>&>(*this) = ringbuffer_span<T, Size_type>();
+        }
+
+    public:
+        ringbuffer_span_guard(Ringbuffer & rb_, const ringbuffer_span<T, Size_type> & s) noexcept
+        : ringbuffer_span<T, Size_type>(s), rb(&rb_), uncaught(std::uncaught_exceptions()) {}
+
+        ringbuffer_span_guard(ringbuffer_span_guard && o) noexcept
+        : ringbuffer_span<T, Size_type>(o), rb(o.rb), uncaught(o.uncaught) {
+            o.rb = nullptr;
+        }
+
+        ringbuffer_span_guard(const ringbuffer_span_guard &) = delete;
+        ringbuffer_span_guard& operator=(const ringbuffer_span_guard &) = delete;
+        ringbuffer_span_guard& operator=(ringbuffer_span_guard &&) = delete;
+
+        ~ringbuffer_span_guard() noexcept {
+            if( nullptr != rb ) {
+                end( uncaught < std::uncaught_exceptions() ? 0 : this->size() );
+            }
+        }
+
+        /**
+         * Dequeues the first count viewed elements and releases the multi-read mutex, if not yet released.
+         * <p>
+         * The view becomes empty.
+         * </p>
+         * @param count number of elements to dequeue, shall be less or equal to the size of the viewed span.
+         */
+        void release(const Size_type count) noexcept {
+            static_assert(!Write, "release() requires a read span");
+            if( nullptr != rb ) {
+                end(count);
+            }
+        }
+
+        /**
+         * Enqueues the first count written slots and releases the multi-write mutex, if not yet released.
+         * <p>
+         * The view becomes empty.
+         * </p>
+         * @param count number of elements to enqueue, shall be less or equal to the size of the reserved span.
+         */
+        void commit(const Size_type count) noexcept {
+            static_assert(Write, "commit() requires a write span");
+            if( nullptr != rb ) {
+                end(count);
+            }
+        }
+};
+
+} /* namespace jau */
+
+#endif /* JAU_RINGBUFFER_SPAN_HPP_ */
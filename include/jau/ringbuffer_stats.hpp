@@ -0,0 +1,186 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_RINGBUFFER_STATS_HPP_
+#define JAU_RINGBUFFER_STATS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdint>
+
+namespace jau {
+
+/**
+ * Point in time copy of a ring buffer's runtime statistics, see ringbuffer_stats.
+ */
+struct ringbuffer_stats_snapshot {
+    /** Number of elements put, incl. batch and zero-copy operations. */
+    uint64_t puts = 0;
+    /** Number of elements taken, incl. batch and zero-copy operations. */
+    uint64_t gets = 0;
+    /** Number of failed non-blocking put operations, i.e. ring buffer was full. */
+    uint64_t putFailures = 0;
+    /** Number of failed non-blocking get operations, i.e. ring buffer was empty. */
+    uint64_t getFailures = 0;
+    /** Number of times a blocking put operation had to wait for free slots. */
+    uint64_t putWaits = 0;
+    /** Number of times a blocking get operation had to wait for elements. */
+    uint64_t getWaits = 0;
+    /** Total nanoseconds blocking put operations waited for free slots. */
+    uint64_t putBlockedNS = 0;
+    /** Total nanoseconds blocking get operations waited for elements. */
+    uint64_t getBlockedNS = 0;
+    /** Number of elements dropped via drop() or clear(). */
+    uint64_t drops = 0;
+    /** Number of oldest elements overwritten by putOverwrite() on a full ring buffer. */
+    uint64_t overwrites = 0;
+    /** Maximum size observed after a put operation. */
+    uint64_t highWaterMark = 0;
+
+    std::string toString() const noexcept {
+        return "stats[puts "+std::to_string(puts)+", gets "+std::to_string(gets)+
+               ", failed put "+std::to_string(putFailures)+", get "+std::to_string(getFailures)+
+               ", waits put "+std::to_string(putWaits)+" / "+std::to_string(putBlockedNS/1000)+" us"+
+               ", get "+std::to_string(getWaits)+" / "+std::to_string(getBlockedNS/1000)+" us"+
+               ", drops "+std::to_string(drops)+", overwrites "+std::to_string(overwrites)+", high-water "+std::to_string(highWaterMark)+"]";
+    }
+};
+
+/**
+ * Runtime statistics policies for jau::ringbuffer,
+ * passed as its <code>Stats_policy</code> template parameter.
+ * <p>
+ * A statistics policy provides:
+ * <ul>
+ *   <li><code>constexpr static const bool enabled</code>, if false all hooks are skipped at compile time,
+ *       incl. the time measurement of blocking waits.</li>
+ *   <li>Putter hooks <code>onPut(n)</code>, <code>onPutFailed()</code>, <code>onPutWait(ns)</code>, <code>onSize(size)</code> and <code>onOverwrite()</code>,
+ *       invoked by the putter while holding the multi-write mutex in <code>multi_pc</code> mode.</li>
+ *   <li>Getter hooks <code>onGet(n)</code>, <code>onGetFailed()</code>, <code>onGetWait(ns)</code> and <code>onDrop(n)</code>,
+ *       invoked by the getter while holding the multi-read mutex in <code>multi_pc</code> mode.</li>
+ *   <li><code>ringbuffer_stats_snapshot snapshot() const</code>, callable from any thread w/o taking a mutex.</li>
+ * </ul>
+ * </p>
+ * <p>
+ * Since each side is serialized, hooks update their counter via relaxed load and store, i.e. w/o read-modify-write operations.
+ * </p>
+ * @see ringbuffer_stats_none
+ * @see ringbuffer_stats_atomic
+ */
+namespace ringbuffer_stats {
+    /** Returns the elapsed nanoseconds since t0. */
+    inline uint64_t elapsedNS(const std::chrono::steady_clock::time_point t0) noexcept {
+        return static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count() );
+    }
+}
+
+/**
+ * Disabled statistics policy, the default, compiling away to nothing.
+ * @see ringbuffer_stats
+ */
+class ringbuffer_stats_none {
+    public:
+        constexpr static const bool enabled = false;
+
+        void onPut(const uint64_t) noexcept { }
+        void onPutFailed() noexcept { }
+        void onPutWait(const uint64_t) noexcept { }
+        void onSize(const uint64_t) noexcept { }
+        void onOverwrite() noexcept { }
+        void onGet(const uint64_t) noexcept { }
+        void onGetFailed() noexcept { }
+        void onGetWait(const uint64_t) noexcept { }
+        void onDrop(const uint64_t) noexcept { }
+
+        ringbuffer_stats_snapshot snapshot() const noexcept { return ringbuffer_stats_snapshot(); }
+};
+
+/**
+ * Enabled statistics policy using relaxed atomic counters,
+ * placing putter and getter counters on separate cache lines.
+ * @see ringbuffer_stats
+ */
+class ringbuffer_stats_atomic {
+    private:
+        /** Assumed cache line size, separating getter and putter owned counters. */
+        constexpr static const std::size_t cache_line_size = 64;
+
+        // Putter owned counters
+        alignas(cache_line_size) std::atomic<uint64_t> puts = 0;
+        std::atomic<uint64_t> putFailures = 0;
+        std::atomic<uint64_t> putWaits = 0;
+        std::atomic<uint64_t> putBlockedNS = 0;
+        std::atomic<uint64_t> highWaterMark = 0;
+        std::atomic<uint64_t> overwrites = 0;
+
+        // Getter owned counters
+        alignas(cache_line_size) std::atomic<uint64_t> gets = 0;
+        std::atomic<uint64_t> getFailures = 0;
+        std::atomic<uint64_t> getWaits = 0;
+        std::atomic<uint64_t> getBlockedNS = 0;
+        std::atomic<uint64_t> drops = 0;
+
+        /** Increments the counter owned by the calling, serialized side w/o a read-modify-write operation. */
+        static void add(std::atomic<uint64_t>& counter, const uint64_t n) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+    public:
+        constexpr static const bool enabled = true;
+
+        void onPut(const uint64_t n) noexcept { add(puts, n); }
+        void onPutFailed() noexcept { add(putFailures, 1); }
+        void onPutWait(const uint64_t ns) noexcept { add(putWaits, 1); add(putBlockedNS, ns); }
+        void onSize(const uint64_t size) noexcept {
+            if( size > highWaterMark.load(std::memory_order_relaxed) ) {
+                highWaterMark.store(size, std::memory_order_relaxed);
+            }
+        }
+        void onOverwrite() noexcept { add(overwrites, 1); }
+        void onGet(const uint64_t n) noexcept { add(gets, n); }
+        void onGetFailed() noexcept { add(getFailures, 1); }
+        void onGetWait(const uint64_t ns) noexcept { add(getWaits, 1); add(getBlockedNS, ns); }
+        void onDrop(const uint64_t n) noexcept { add(drops, n); }
+
+        ringbuffer_stats_snapshot snapshot() const noexcept {
+            ringbuffer_stats_snapshot s;
+            s.puts = puts.load(std::memory_order_relaxed);
+            s.gets = gets.load(std::memory_order_relaxed);
+            s.putFailures = putFailures.load(std::memory_order_relaxed);
+            s.getFailures = getFailures.load(std::memory_order_relaxed);
+            s.putWaits = putWaits.load(std::memory_order_relaxed);
+            s.getWaits = getWaits.load(std::memory_order_relaxed);
+            s.putBlockedNS = putBlockedNS.load(std::memory_order_relaxed);
+            s.getBlockedNS = getBlockedNS.load(std::memory_order_relaxed);
+            s.drops = drops.load(std::memory_order_relaxed);
+            s.overwrites = overwrites.load(std::memory_order_relaxed);
+            s.highWaterMark = highWaterMark.load(std::memory_order_relaxed);
+            return s;
+        }
+};
+
+} /* namespace jau */
+
+#endif /* JAU_RINGBUFFER_STATS_HPP_ */
@@ -0,0 +1,392 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_RINGBUFFER_WAIT_HPP_
+#define JAU_RINGBUFFER_WAIT_HPP_
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <ctime>
+#include <cerrno>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <jau/ordered_atomic.hpp>
+
+namespace jau {
+
+/**
+ * Hints the CPU that we are in a spin-wait loop, i.e. x86 <code>pause</code> or arm <code>yield</code>.
+ */
+inline void cpu_relax() noexcept {
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+/**
+ * Wait strategies for jau::ringbuffer's blocking operations,
+ * passed as its <code>Wait_policy</code> template parameter.
+ * <p>
+ * A wait policy instance is used for each side, i.e. for waiting getter and waiting putter.
+ * It provides:
+ * <ul>
+ *   <li><code>template<typename Pred> bool wait(Pred satisfied, const int timeoutMS)</code>,
+ *       blocking until <code>satisfied()</code> returns true or the timeout in milliseconds expired.
+ *       A timeout of zero waits infinitely. Returns false on timeout, otherwise true.</li>
+ *   <li><code>void notify()</code>,
+ *       called by the opposite side after releasing the new read- or write-position.</li>
+ *   <li><code>constexpr static const bool uses_notify</code>, true if <code>notify()</code> is not a no-op.</li>
+ * </ul>
+ * </p>
+ * <p>
+ * The predicate shall load the opposite position with SC ordering.
+ * Policies sleeping in the kernel, i.e. ringbuffer_wait_cv and ringbuffer_wait_futex,
+ * register their sleeper before re-checking the predicate, while <code>notify()</code>
+ * issues an SC fence before checking for registered sleepers.
+ * Hence the notification is only paid for if a sleeper is actually registered.
+ * The spinning policies don't require any notification.
+ * </p>
+ * <p>
+ * ringbuffer_wait_eventfd additionally exposes a pollable file descriptor,
+ * allowing one thread to multiplex many ring buffers and other file descriptors via epoll or poll.
+ * </p>
+ * <p>
+ * Number of spins between timeout checks as well as before yielding or sleeping is given by spin_count.
+ * </p>
+ */
+namespace ringbuffer_wait {
+    /** Number of spins before yielding or sleeping, as well as between timeout checks while spinning. */
+    constexpr static const int spin_count = 128;
+
+    /** Returns the absolute timeout for the given relative timeoutMS, which shall be greater than zero. */
+    inline std::chrono::steady_clock::time_point deadline(const int timeoutMS) noexcept {
+        return std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMS);
+    }
+}
+
+/**
+ * Busy spinning wait policy using cpu_relax(), lowest latency but occupying a CPU while waiting.
+ * @see ringbuffer_wait
+ */
+class ringbuffer_wait_spin {
+    public:
+        constexpr static const bool uses_notify = false;
+
+        template<typename Pred>
+        bool wait(Pred satisfied, const int timeoutMS) noexcept {
+            const std::chrono::steady_clock::time_point t1 = 0 < timeoutMS ? ringbuffer_wait::deadline(timeoutMS) : std::chrono::steady_clock::time_point();
+            while( true ) {
+                for(int i=0; i<ringbuffer_wait::spin_count; i++) {
+                    if( satisfied() ) {
+                        return true;
+                    }
+                    cpu_relax();
+                }
+                if( 0 < timeoutMS && std::chrono::steady_clock::now() >= t1 ) {
+                    return satisfied();
+                }
+            }
+        }
+
+        void notify() noexcept { }
+};
+
+/**
+ * Spin then yield wait policy, spinning ringbuffer_wait::spin_count times
+ * using cpu_relax() before each std::this_thread::yield().
+ * @see ringbuffer_wait
+ */
+class ringbuffer_wait_yield {
+    public:
+        constexpr static const bool uses_notify = false;
+
+        template<typename Pred>
+        bool wait(Pred satisfied, const int timeoutMS) noexcept {
+            const std::chrono::steady_clock::time_point t1 = 0 < timeoutMS ? ringbuffer_wait::deadline(timeoutMS) : std::chrono::steady_clock::time_point();
+            while( true ) {
+                for(int i=0; i<ringbuffer_wait::spin_count; i++) {
+                    if( satisfied() ) {
+                        return true;
+                    }
+                    cpu_relax();
+                }
+                if( 0 < timeoutMS && std::chrono::steady_clock::now() >= t1 ) {
+                    return satisfied();
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        void notify() noexcept { }
+};
+
+/**
+ * Spin then futex wait policy, spinning ringbuffer_wait::spin_count times
+ * before sleeping on a Linux futex.
+ * <p>
+ * The futex word is a sequence number, incremented by notify() if a sleeper is registered.
+ * Spurious wakeups are handled by re-checking the predicate.
+ * </p>
+ * <p>
+ * If <code>process_shared</code> is true, the instance may reside in shared memory
+ * and wait and notify may be called from different processes, see jau::shm_ringbuffer.
+ * Otherwise the cheaper process private futex operations are used.
+ * </p>
+ * @see ringbuffer_wait
+ * @see ringbuffer_wait_futex
+ * @see ringbuffer_wait_futex_shared
+ */
+template<bool process_shared>
+class ringbuffer_wait_futex_impl {
+    private:
+        std::atomic<int> seq = 0;        // futex word
+        sc_atomic_int sleepers = 0;      // SC-DRF w/ notify()
+
+        static_assert(sizeof(std::atomic<int>) == sizeof(int), "std::atomic<int> not usable as futex word");
+
+        int * futex_word() noexcept { return reinterpret_cast<int*>(&seq); }
+
+        constexpr static const int op_wait = process_shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE;
+        constexpr static const int op_wake = process_shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE;
+
+        static long futex(int * uaddr, const int op, const int val, const struct timespec * timeout) noexcept {
+            return ::syscall(SYS_futex, uaddr, op, val, timeout, nullptr, 0);
+        }
+
+    public:
+        constexpr static const bool uses_notify = true;
+
+        template<typename Pred>
+        bool wait(Pred satisfied, const int timeoutMS) noexcept {
+            for(int i=0; i<ringbuffer_wait::spin_count; i++) {
+                if( satisfied() ) {
+                    return true;
+                }
+                cpu_relax();
+            }
+            const std::chrono::steady_clock::time_point t1 = 0 < timeoutMS ? ringbuffer_wait::deadline(timeoutMS) : std::chrono::steady_clock::time_point();
+            bool res = true;
+            sleepers++; // SC-DRF register before re-checking the predicate, see notify()
+            while( true ) {
+                const int s = seq.load(std::memory_order_seq_cst);
+                if( satisfied() ) {
+                    break;
+                }
+                if( 0 == timeoutMS ) {
+                    futex(futex_word(), op_wait, s, nullptr);
+                } else {
+                    const std::chrono::nanoseconds left = t1 - std::chrono::steady_clock::now();
+                    if( left.count() <= 0 ) {
+                        res = satisfied();
+                        break;
+                    }
+                    struct timespec ts;
+                    ts.tv_sec = static_cast<time_t>( left.count() / 1000000000L );
+                    ts.tv_nsec = static_cast<long>( left.count() % 1000000000L );
+                    futex(futex_word(), op_wait, s, &ts);
+                }
+            }
+            sleepers--;
+            return res;
+        }
+
+        void notify() noexcept {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if( 0 < sleepers ) {
+                seq.fetch_add(1, std::memory_order_seq_cst);
+                futex(futex_word(), op_wake, INT32_MAX, nullptr);
+            }
+        }
+};
+
+/** Spin then process private futex wait policy, see ringbuffer_wait_futex_impl. */
+typedef ringbuffer_wait_futex_impl<false> ringbuffer_wait_futex;
+
+/** Spin then process shared futex wait policy, see ringbuffer_wait_futex_impl. */
+typedef ringbuffer_wait_futex_impl<true> ringbuffer_wait_futex_shared;
+
+/**
+ * Condition variable wait policy, the default, sleeping on a std::condition_variable.
+ * @see ringbuffer_wait
+ */
+class ringbuffer_wait_cv {
+    private:
+        std::mutex sync;                 // Memory-Model (MM) guaranteed sequential consistency (SC) between acquire and release
+        std::condition_variable cv;
+        sc_atomic_int sleepers = 0;      // SC-DRF w/ notify()
+
+    public:
+        constexpr static const bool uses_notify = true;
+
+        template<typename Pred>
+        bool wait(Pred satisfied, const int timeoutMS) noexcept {
+            std::unique_lock<std::mutex> lock(sync); // SC-DRF w/ notify() via same lock
+            sleepers++; // SC-DRF register before re-checking the predicate, see notify()
+            bool res = true;
+            if( 0 == timeoutMS ) {
+                while( !satisfied() ) {
+                    cv.wait(lock);
+                }
+            } else {
+                const std::chrono::steady_clock::time_point t1 = ringbuffer_wait::deadline(timeoutMS);
+                while( !satisfied() ) {
+                    std::cv_status s = cv.wait_until(lock, t1);
+                    if( std::cv_status::timeout == s && !satisfied() ) {
+                        res = false;
+                        break;
+                    }
+                }
+            }
+            sleepers--;
+            return res;
+        }
+
+        void notify() noexcept {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if( 0 < sleepers ) {
+                {
+                    std::unique_lock<std::mutex> lock(sync); // SC-DRF w/ waiter via same lock
+                }
+                cv.notify_all(); // notify waiting getter or putter
+            }
+        }
+};
+
+/**
+ * Pollable eventfd wait policy, signaling readiness via a Linux eventfd
+ * to be multiplexed via epoll or poll, see ringbuffer::getReadEventFD() and ringbuffer::getWriteEventFD().
+ * <p>
+ * Signals are edge-coalesced: notify() only writes to the eventfd
+ * if it has not been signaled since the last acknowledge().
+ * Hence a burst of put operations costs a single <code>write</code> system call,
+ * signaling the transition to non-empty for the getter or to not-full for the putter,
+ * as observed since the waiting side's last acknowledge().
+ * </p>
+ * <p>
+ * A multiplexing thread shall call acknowledge() once the eventfd became readable
+ * _before_ processing the ring buffer until empty for the getter or full for the putter,
+ * otherwise the eventfd stays readable, i.e. level triggered.
+ * An element enqueued after acknowledge() signals the eventfd again, hence no transition is lost.
+ * </p>
+ * <p>
+ * The blocking operations poll the eventfd and acknowledge themselves,
+ * hence each side shall either use the blocking operations or multiplex the eventfd.
+ * </p>
+ * <p>
+ * If the eventfd could not be created, getEventFD() returns -1 and the blocking operations yield instead.
+ * </p>
+ * @see ringbuffer_wait
+ */
+class ringbuffer_wait_eventfd {
+    private:
+        int fd;
+        sc_atomic_bool signaled = false; // SC-DRF w/ acknowledge()
+
+        void pollImpl(const int timeoutMS) noexcept {
+            if( 0 > fd ) {
+                std::this_thread::yield();
+                return;
+            }
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            ::poll(&pfd, 1, 0 < timeoutMS ? timeoutMS : -1);
+        }
+
+    public:
+        constexpr static const bool uses_notify = true;
+
+        ringbuffer_wait_eventfd() noexcept
+        : fd( ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) ) { }
+
+        ringbuffer_wait_eventfd(const ringbuffer_wait_eventfd&) = delete;
+        ringbuffer_wait_eventfd& operator=(const ringbuffer_wait_eventfd&) = delete;
+
+        ~ringbuffer_wait_eventfd() noexcept {
+            if( 0 <= fd ) {
+                ::close(fd);
+            }
+        }
+
+        /** Returns the non-blocking eventfd, readable if signaled, or -1 if it could not be created. */
+        int getEventFD() const noexcept { return fd; }
+
+        /**
+         * Acknowledges the signal, clearing the eventfd's readiness and re-arming notify().
+         * <p>
+         * The eventfd is drained before re-arming, hence a concurrent notify() either
+         * is observed by the caller's subsequent ring buffer operation or signals the eventfd again.
+         * </p>
+         */
+        void acknowledge() noexcept {
+            if( 0 <= fd ) {
+                eventfd_t v;
+                (void) ::eventfd_read(fd, &v);
+            }
+            signaled = false; // SC-DRF w/ notify()
+        }
+
+        template<typename Pred>
+        bool wait(Pred satisfied, const int timeoutMS) noexcept {
+            const std::chrono::steady_clock::time_point t1 = 0 < timeoutMS ? ringbuffer_wait::deadline(timeoutMS) : std::chrono::steady_clock::time_point();
+            while( true ) {
+                acknowledge();
+                if( satisfied() ) {
+                    return true;
+                }
+                int left = 0;
+                if( 0 < timeoutMS ) {
+                    left = static_cast<int>( std::chrono::duration_cast<std::chrono::milliseconds>(t1 - std::chrono::steady_clock::now()).count() );
+                    if( left <= 0 ) {
+                        return satisfied();
+                    }
+                }
+                pollImpl(left);
+            }
+        }
+
+        void notify() noexcept {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if( !signaled && !signaled.exchange(true) && 0 <= fd ) { // edge-coalesced: only the first notification since acknowledge()
+                (void) ::eventfd_write(fd, 1);
+            }
+        }
+};
+
+} /* namespace jau */
+
+#endif /* JAU_RINGBUFFER_WAIT_HPP_ */
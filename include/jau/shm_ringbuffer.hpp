@@ -0,0 +1,500 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_SHM_RINGBUFFER_HPP_
+#define JAU_SHM_RINGBUFFER_HPP_
+
+#include <type_traits>
+#include <atomic>
+#include <algorithm>
+#include <new>
+
+#include <cstring>
+#include <string>
+#include <cstdint>
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <jau/basic_types.hpp>
+#include <jau/int_math.hpp>
+#include <jau/ringbuffer_wait.hpp>
+#include <jau/ringbuffer_counter.hpp>
+
+namespace jau {
+
+/**
+ * Role of a process attached to a jau::shm_ringbuffer, i.e. getter, putter or both.
+ */
+enum class shm_role : uint8_t {
+    /** Attached as getter, the single consumer. */
+    getter = 0b01,
+    /** Attached as putter, the single producer. */
+    putter = 0b10,
+    /** Attached as getter and putter, e.g. for testing within one process. */
+    both   = 0b11
+};
+
+/**
+ * Inter-process Single Producer Single Consumer (SPSC) ring buffer for trivially copyable value types,
+ * residing in a named POSIX shared memory segment and
+ * exposing <i>lock-free</i> {@link #get(T&) get*(..)} and {@link #put(const T&) put*(..)} methods
+ * like jau::value_ringbuffer.
+ * <p>
+ * The segment holds a header with the capacity and the attached getter and putter process ids,
+ * as well as the ringbuffer_counter_state, i.e. the free running read and write counters, their cached copies
+ * and the futex sequence counters, followed by the element array.
+ * All shared state are address-free lock-free atomics, hence the segment may be mapped at different addresses.
+ * </p>
+ * <p>
+ * Blocking operations use the process shared ringbuffer_wait_futex_shared within the segment,
+ * i.e. the getter and putter process may sleep and notify each other.
+ * </p>
+ * <p>
+ * Attach and detach semantics:
+ * <ul>
+ *   <li>The first attaching process creates and initializes the segment, following processes validate its
+ *       header against T and the capacity. Creation and validation are serialized via <code>flock(2)</code>.</li>
+ *   <li>Each role may only be held by one live process, attaching to a role held by another live process fails.
+ *       A role held by a terminated process is taken over, i.e. a restarting peer re-attaches
+ *       and continues with the persistent read or write counter.</li>
+ *   <li>An element becomes visible only after it has been copied completely,
+ *       hence a putter terminating within a put operation never publishes a partial element.</li>
+ *   <li>The destructor detaches the roles of this process, the segment persists until {@link #unlink()}.</li>
+ *   <li>A peer restart can be detected via {@link #getAttachCount()}, a blocked operation is not interrupted
+ *       by a terminated peer, hence a timeout shall be used if the peer may terminate.</li>
+ * </ul>
+ * </p>
+ * <p>
+ * The net capacity is rounded up to a power of two and
+ * each side keeps a cached copy of the opposite counter on its own cache line within the segment,
+ * owned by the single process attached in the respective role, see ringbuffer_counter.
+ * </p>
+ * <p>
+ * Implementation uses POSIX <code>shm_open(3)</code> and <code>mmap(2)</code> as well as Linux futex.
+ * </p>
+ * @see jau::value_ringbuffer
+ * @see jau::ringbuffer_wait_futex_shared
+ */
+template <typename T, typename Size_type>
+class shm_ringbuffer {
+    public:
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        static_assert(std::is_default_constructible_v<T>, "T must be default constructible");
+        static_assert(alignof(T) <= 64, "T alignment exceeds cache line size");
+
+        /** The process shared wait strategy used by the blocking operations, see ringbuffer_wait. */
+        typedef ringbuffer_wait_futex_shared wait_policy_type;
+
+    private:
+        /** Assumed cache line size, separating getter and putter owned state. */
+        constexpr static const std::size_t cache_line_size = 64;
+
+        /** Segment magic, i.e. 'jaushmrb'. */
+        constexpr static const uint64_t shm_magic = 0x6a617573686d7262ULL;
+
+        /** Segment layout version, incremented on incompatible changes. */
+        constexpr static const uint32_t shm_version = 2;
+
+        typedef ringbuffer_counter<Size_type, wait_policy_type, ringbuffer_pow2_index<Size_type>, true /* shared_state */> counter_type;
+
+        /** Shared memory segment header, followed by the element array at header_size. */
+        struct header_t {
+            // Shared state, final after initialization
+            std::atomic<uint64_t> magic;     // stored last w/ release, see initHeader()
+            uint32_t version;
+            uint32_t element_size;
+            uint64_t capacity;
+            std::atomic<uint64_t> attachCount; // incremented on each attach
+            std::atomic<int32_t> getterPid;  // zero if detached
+            std::atomic<int32_t> putterPid;  // zero if detached
+
+            typename counter_type::state_type counters; // Getter and putter owned state on separate cache lines
+        };
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "std::atomic<uint64_t> not address-free");
+        static_assert(std::atomic<int32_t>::is_always_lock_free, "std::atomic<int32_t> not address-free");
+
+        constexpr static const std::size_t header_size = ( ( sizeof(header_t) + cache_line_size - 1 ) / cache_line_size ) * cache_line_size;
+
+        const std::string name_;
+        const shm_role role_;
+        std::size_t mapSize;
+        header_t * hdr;
+        T * array;
+        counter_type counter;            // Attached to the segment's counter state
+
+        constexpr static Size_type capacityImpl(const Size_type capacity) noexcept {
+            return counter_type::roundCapacity(capacity);
+        }
+
+        constexpr static std::size_t segmentSize(const uint64_t capacity) noexcept {
+            return header_size + static_cast<std::size_t>(capacity) * sizeof(T);
+        }
+
+        static std::string errnoString(const std::string& msg, const int err) {
+            return msg+": errno "+std::to_string(err)+" "+strerror(err);
+        }
+
+        static bool isAlive(const int32_t pid) noexcept {
+            return 0 == ::kill(pid, 0) || EPERM == errno;
+        }
+
+        static bool hasRole(const shm_role r, const shm_role bit) noexcept {
+            return 0 != ( static_cast<uint8_t>(r) & static_cast<uint8_t>(bit) );
+        }
+
+        /** Creates the header and releases the magic last. Caller holds the exclusive flock. */
+        void initHeader(const uint64_t capacity) noexcept {
+            hdr = new (hdr) header_t(); // zero counters and pids, default futex words
+            hdr->version = shm_version;
+            hdr->element_size = sizeof(T);
+            hdr->capacity = capacity;
+            hdr->attachCount.store(0, std::memory_order_relaxed);
+            hdr->getterPid.store(0, std::memory_order_relaxed);
+            hdr->putterPid.store(0, std::memory_order_relaxed);
+            hdr->magic.store(shm_magic, std::memory_order_release);
+        }
+
+        /** Registers the given role bit of this process, throws IllegalStateException if held by another live process. */
+        static void attachRole(std::atomic<int32_t>& rolePid, const int32_t self, const std::string& roleName, const std::string& name) {
+            const int32_t cur = rolePid.load(std::memory_order_acquire);
+            if( 0 != cur && self != cur && isAlive(cur) ) {
+                throw IllegalStateException("shm_ringbuffer "+name+": "+roleName+" role held by live pid "+std::to_string(cur), E_FILE_LINE);
+            }
+            rolePid.store(self, std::memory_order_release); // take over a detached or terminated peer's role
+        }
+
+        static void detachRole(std::atomic<int32_t>& rolePid, int32_t self) noexcept {
+            rolePid.compare_exchange_strong(self, 0, std::memory_order_acq_rel);
+        }
+
+        /** Maps the segment of given size, returns nullptr on failure w/ errno set. */
+        static header_t * mapImpl(const int fd, const std::size_t size) noexcept {
+            void * p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            return MAP_FAILED == p ? nullptr : static_cast<header_t*>(p);
+        }
+
+        void openImpl(const bool create, const Size_type capacity) {
+            const int fd = ::shm_open(name_.c_str(), O_RDWR | ( create ? O_CREAT : 0 ), 0600);
+            if( 0 > fd ) {
+                throw RuntimeException(errnoString("shm_open "+name_+" failed", errno), E_FILE_LINE);
+            }
+            try {
+                ::flock(fd, LOCK_EX); // serialize creation and validation
+                struct stat st;
+                if( 0 != ::fstat(fd, &st) ) {
+                    throw RuntimeException(errnoString("fstat "+name_+" failed", errno), E_FILE_LINE);
+                }
+                if( 0 == st.st_size ) {
+                    if( !create ) {
+                        throw IllegalStateException("shm_ringbuffer "+name_+" not initialized", E_FILE_LINE);
+                    }
+                    const uint64_t cap = capacityImpl(capacity);
+                    mapSize = segmentSize(cap);
+                    if( 0 != ::ftruncate(fd, static_cast<off_t>(mapSize)) ) {
+                        throw OutOfMemoryError(errnoString("ftruncate "+name_+" "+std::to_string(mapSize)+" failed", errno), E_FILE_LINE);
+                    }
+                    if( nullptr == ( hdr = mapImpl(fd, mapSize) ) ) {
+                        throw OutOfMemoryError(errnoString("mmap "+name_+" "+std::to_string(mapSize)+" failed", errno), E_FILE_LINE);
+                    }
+                    initHeader(cap);
+                } else {
+                    mapSize = static_cast<std::size_t>(st.st_size);
+                    if( mapSize < header_size ) {
+                        throw IllegalArgumentException("shm_ringbuffer "+name_+" size "+std::to_string(mapSize)+" too small", E_FILE_LINE);
+                    }
+                    if( nullptr == ( hdr = mapImpl(fd, mapSize) ) ) {
+                        throw OutOfMemoryError(errnoString("mmap "+name_+" "+std::to_string(mapSize)+" failed", errno), E_FILE_LINE);
+                    }
+                    if( shm_magic != hdr->magic.load(std::memory_order_acquire) || shm_version != hdr->version ||
+                        sizeof(T) != hdr->element_size || segmentSize(hdr->capacity) != mapSize ||
+                        ( create && capacityImpl(capacity) != hdr->capacity ) )
+                    {
+                        const std::string msg = "shm_ringbuffer "+name_+" incompatible: version "+std::to_string(hdr->version)+
+                                ", element size "+std::to_string(hdr->element_size)+" != "+std::to_string(sizeof(T))+
+                                ", capacity "+std::to_string(hdr->capacity)+", size "+std::to_string(mapSize);
+                        ::munmap(hdr, mapSize);
+                        hdr = nullptr;
+                        throw IllegalArgumentException(msg, E_FILE_LINE);
+                    }
+                }
+                const int32_t self = static_cast<int32_t>( ::getpid() );
+                try {
+                    if( hasRole(role_, shm_role::getter) ) {
+                        attachRole(hdr->getterPid, self, "getter", name_);
+                    }
+                    if( hasRole(role_, shm_role::putter) ) {
+                        attachRole(hdr->putterPid, self, "putter", name_);
+                    }
+                } catch (...) {
+                    if( hasRole(role_, shm_role::getter) ) {
+                        detachRole(hdr->getterPid, self);
+                    }
+                    ::munmap(hdr, mapSize);
+                    hdr = nullptr;
+                    throw;
+                }
+                hdr->attachCount.fetch_add(1, std::memory_order_acq_rel);
+            } catch (...) {
+                ::flock(fd, LOCK_UN);
+                ::close(fd);
+                throw;
+            }
+            ::flock(fd, LOCK_UN); // explicit, as the mapping references the open file description
+            ::close(fd); // mapping keeps the segment alive
+            array = static_cast<T*>( static_cast<void*>( reinterpret_cast<uint8_t*>(hdr) + header_size ) ); // cache line aligned
+            counter.setCapacity( static_cast<Size_type>( hdr->capacity ) );
+            counter.attach( &hdr->counters );
+        }
+
+        Size_type getNImpl(T * dst, Size_type min_count, const Size_type max_count, const bool remove, const bool blocking, const int timeoutMS) noexcept {
+            min_count = std::min(min_count, std::min(max_count, counter.capacity()));
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            Size_type available = counter.available(localReadCount, max_count); // SC-DRF acquire atomic writeCount if less than max_count appear available
+            if( available < min_count ) {
+                if( !blocking || !counter.waitForElements(localReadCount, min_count, timeoutMS) ) {
+                    return 0;
+                }
+                available = counter.cachedAvailable(localReadCount);
+            }
+            const ringbuffer_span<T, Size_type> s = counter.span(array, localReadCount, std::min(available, max_count));
+            if( 0 == s.size() ) {
+                return 0;
+            }
+            ::memcpy(reinterpret_cast<void*>(dst), reinterpret_cast<const void*>(s.data1), s.size1 * sizeof(T));
+            if( 0 < s.size2 ) {
+                ::memcpy(reinterpret_cast<void*>(dst + s.size1), reinterpret_cast<const void*>(s.data2), s.size2 * sizeof(T)); // wrap-around
+            }
+            if( remove ) {
+                counter.advanceRead(localReadCount, s.size()); // SC-DRF release atomic readCount, once per batch
+            }
+            return s.size();
+        }
+
+        Size_type putNImpl(const T * src, Size_type min_count, const Size_type count, const bool blocking, const int timeoutMS) noexcept {
+            min_count = std::min(min_count, std::min(count, counter.capacity()));
+            const uint64_t localWriteCount = counter.loadWriteCount(); // owned by putter
+            Size_type freeSlots = counter.freeSlots(localWriteCount, count); // SC-DRF acquire atomic readCount if less than count appear free
+            if( freeSlots < min_count ) {
+                if( !blocking || !counter.waitForFreeSlots(localWriteCount, min_count, timeoutMS) ) {
+                    return 0;
+                }
+                freeSlots = counter.cachedFreeSlots(localWriteCount);
+            }
+            const ringbuffer_span<T, Size_type> s = counter.span(array, localWriteCount, std::min(freeSlots, count));
+            if( 0 == s.size() ) {
+                return 0;
+            }
+            ::memcpy(reinterpret_cast<void*>(s.data1), reinterpret_cast<const void*>(src), s.size1 * sizeof(T));
+            if( 0 < s.size2 ) {
+                ::memcpy(reinterpret_cast<void*>(s.data2), reinterpret_cast<const void*>(src + s.size1), s.size2 * sizeof(T)); // wrap-around
+            }
+            counter.advanceWrite(localWriteCount, s.size()); // SC-DRF release atomic writeCount, once per batch
+            return s.size();
+        }
+
+    public:
+        /** Returns a short string representation incl. size/capacity and internal r/w counter (impl. dependent). */
+        std::string toString() const noexcept {
+            const std::string es = isEmpty() ? ", empty" : "";
+            const std::string fs = isFull() ? ", full" : "";
+            return "shm_ringbuffer<?>["+name_+", size "+std::to_string(getSize())+" / "+std::to_string(counter.capacity())+
+                    ", writeCount "+std::to_string(hdr->counters.writeCount.load())+", readCount "+std::to_string(hdr->counters.readCount.load())+
+                    ", getter "+std::to_string(hdr->getterPid.load())+", putter "+std::to_string(hdr->putterPid.load())+
+                    ", attached "+std::to_string(hdr->attachCount.load())+es+fs+"]";
+        }
+
+        /**
+         * Attaches to the named shared memory segment in the given role, creating and initializing it if not existing.
+         * @param name the shared memory object name, see <code>shm_open(3)</code>, e.g. <code>/my_ringbuffer</code>
+         * @param capacity the minimum net capacity, rounded up to a power of two
+         * @param role the role of this process
+         * @throws RuntimeException if the segment could not be opened
+         * @throws OutOfMemoryError if the segment could not be created
+         * @throws IllegalArgumentException if the existing segment is incompatible w/ T or the capacity
+         * @throws IllegalStateException if the role is held by another live process
+         */
+        shm_ringbuffer(const std::string& name, const Size_type capacity, const shm_role role)
+        : name_(name), role_(role), mapSize(0), hdr(nullptr), array(nullptr), counter(1)
+        {
+            openImpl(true, capacity);
+        }
+
+        /**
+         * Attaches to the existing named shared memory segment in the given role.
+         * @param name the shared memory object name, see <code>shm_open(3)</code>
+         * @param role the role of this process
+         * @throws RuntimeException if the segment does not exist
+         * @throws IllegalArgumentException if the segment is incompatible w/ T
+         * @throws IllegalStateException if the segment is not initialized or the role is held by another live process
+         */
+        shm_ringbuffer(const std::string& name, const shm_role role)
+        : name_(name), role_(role), mapSize(0), hdr(nullptr), array(nullptr), counter(1)
+        {
+            openImpl(false, 0);
+        }
+
+        /** Detaches the roles of this process and unmaps the segment, which persists until {@link #unlink()}. */
+        ~shm_ringbuffer() noexcept {
+            const int32_t self = static_cast<int32_t>( ::getpid() );
+            if( hasRole(role_, shm_role::getter) ) {
+                detachRole(hdr->getterPid, self);
+            }
+            if( hasRole(role_, shm_role::putter) ) {
+                detachRole(hdr->putterPid, self);
+            }
+            ::munmap(hdr, mapSize);
+        }
+
+        shm_ringbuffer(const shm_ringbuffer &_source) = delete;
+        shm_ringbuffer& operator=(const shm_ringbuffer &_source) = delete;
+
+        /**
+         * Removes the named shared memory segment, already attached processes keep their mapping.
+         * @return true if successful, otherwise false w/ errno set by <code>shm_unlink(3)</code>
+         */
+        static bool unlink(const std::string& name) noexcept {
+            return 0 == ::shm_unlink(name.c_str());
+        }
+
+        /** Returns the shared memory object name. */
+        const std::string& name() const noexcept { return name_; }
+
+        /** Returns the role of this process. */
+        shm_role role() const noexcept { return role_; }
+
+        /** Returns the net capacity, a power of two. */
+        Size_type capacity() const noexcept { return counter.capacity(); }
+
+        /**
+         * Returns true if the given role is attached by a live process.
+         * <p>
+         * A terminated process which did not detach is detected via <code>kill(pid, 0)</code>.
+         * </p>
+         */
+        bool isAttached(const shm_role role) const noexcept {
+            const int32_t g = hdr->getterPid.load(std::memory_order_acquire);
+            const int32_t p = hdr->putterPid.load(std::memory_order_acquire);
+            const bool ga = !hasRole(role, shm_role::getter) || ( 0 != g && isAlive(g) );
+            const bool pa = !hasRole(role, shm_role::putter) || ( 0 != p && isAlive(p) );
+            return ga && pa;
+        }
+
+        /** Returns the number of attach operations since creation, allowing to detect a peer restart. */
+        uint64_t getAttachCount() const noexcept { return hdr->attachCount.load(std::memory_order_acquire); }
+
+        /** Returns the number of elements in this ring buffer. */
+        Size_type getSize() const noexcept { return counter.getSize(); }
+
+        /** Returns the number of free slots available to put.  */
+        Size_type getFreeSlots() const noexcept { return counter.capacity() - counter.getSize(); }
+
+        /** Returns true if this ring buffer is empty, otherwise false. */
+        bool isEmpty() const noexcept { return 0 == counter.getSize(); }
+
+        /** Returns true if this ring buffer is full, otherwise false. */
+        bool isFull() const noexcept { return counter.capacity() <= counter.getSize(); }
+
+        /**
+         * Drops up to {@code count} oldest enqueued elements, a getter operation.
+         * @return the number of dropped elements
+         */
+        Size_type drop(const Size_type count) noexcept {
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            const Size_type dropCount = std::min(count, counter.available(localReadCount, count));
+            if( 0 < dropCount ) {
+                counter.advanceRead(localReadCount, dropCount); // SC-DRF release atomic readCount
+            }
+            return dropCount;
+        }
+
+        /** Dequeues the oldest enqueued element into dst if available, otherwise returns false. */
+        bool get(T& dst) noexcept {
+            return 1 == getNImpl(&dst, 1, 1, true, false, 0);
+        }
+
+        /**
+         * Dequeues the oldest enqueued element into dst,
+         * blocking until an element becomes available or timeoutMS expired.
+         * @param timeoutMS 0 for infinite blocking, otherwise timeout in milliseconds
+         * @return false on timeout, otherwise true
+         */
+        bool getBlocking(T& dst, const int timeoutMS=0) noexcept {
+            return 1 == getNImpl(&dst, 1, 1, true, true, timeoutMS);
+        }
+
+        /** Peeks the next element into dst w/o dequeuing it if available, otherwise returns false. */
+        bool peek(T& dst) noexcept {
+            return 1 == getNImpl(&dst, 1, 1, false, false, 0);
+        }
+
+        /** Dequeues up to max_count oldest enqueued elements by copying them into the given dst array, see ringbuffer::getN(). */
+        Size_type getN(T * dst, const Size_type max_count) noexcept {
+            return getNImpl(dst, 1, max_count, true, false, 0);
+        }
+
+        /** Dequeues up to max_count oldest enqueued elements after blocking until at least min_count are available, see ringbuffer::getNBlocking(). */
+        Size_type getNBlocking(T * dst, const Size_type min_count, const Size_type max_count, const int timeoutMS=0) noexcept {
+            return getNImpl(dst, min_count, max_count, true, true, timeoutMS);
+        }
+
+        /** Enqueues the given element by copy if a free slot is available, otherwise returns false. */
+        bool put(const T & e) noexcept {
+            return 1 == putNImpl(&e, 1, 1, false, 0);
+        }
+
+        /**
+         * Enqueues the given element by copy,
+         * blocking until a free slot becomes available or timeoutMS expired.
+         * @param timeoutMS 0 for infinite blocking, otherwise timeout in milliseconds
+         * @return false on timeout, otherwise true
+         */
+        bool putBlocking(const T & e, const int timeoutMS=0) noexcept {
+            return 1 == putNImpl(&e, 1, 1, true, timeoutMS);
+        }
+
+        /** Enqueues up to count elements of the given src array by copy, see ringbuffer::putN(). */
+        Size_type putN(const T * src, const Size_type count) noexcept {
+            return putNImpl(src, 1, count, false, 0);
+        }
+
+        /** Enqueues up to count elements of the given src array after blocking until at least min_count free slots are available, see ringbuffer::putNBlocking(). */
+        Size_type putNBlocking(const T * src, const Size_type min_count, const Size_type count, const int timeoutMS=0) noexcept {
+            return putNImpl(src, min_count, count, true, timeoutMS);
+        }
+};
+
+} /* namespace jau */
+
+/** \example test_shm_ringbuffer01.cpp
+ * This C++ unit test validates jau::shm_ringbuffer between two processes,
+ * including attach/detach and the restart of a peer.
+ */
+
+#endif /* JAU_SHM_RINGBUFFER_HPP_ */
@@ -0,0 +1,58 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_SMALL_DYN_ARRAY_HPP_
+#define JAU_SMALL_DYN_ARRAY_HPP_
+
+#include <jau/darray.hpp>
+
+namespace jau {
+
+    /**
+     * Dynamic linear array storage with small-buffer optimization,
+     * i.e. a jau::darray with an inline capacity of <code>N</code> elements stored within the instance itself.
+     * <p>
+     * jau::small_darray is jau::darray using its inline capacity template parameter,
+     * i.e. it only allocates storage via allocator_type if its size exceeds the inline capacity <code>N</code>.<br>
+     * Hence short lists up to <code>N</code> elements, e.g. listener or characteristic lists,
+     * cause no allocation at all.
+     * </p>
+     * <p>
+     * See jau::darray for the inline capacity semantics
+     * as well as Non-Type Template Parameter <code>use_memmove</code>, <code>use_realloc</code> and <code>sec_mem</code>.
+     * </p>
+     * @tparam Value_type the value type
+     * @tparam N the inline capacity in elements, should be greater than zero
+     * @see jau::darray
+     */
+    template <typename Value_type, jau::nsize_t N, typename Alloc_type = jau::callocator<Value_type>, typename Size_type = jau::nsize_t,
+              bool use_memmove = jau::is_trivially_relocatable_v<Value_type>,
+              bool use_realloc = std::is_base_of_v<jau::callocator<Value_type>, Alloc_type>,
+              bool sec_mem = false
+             >
+    using small_darray = darray<Value_type, Alloc_type, Size_type, use_memmove, use_realloc, sec_mem, N>;
+
+} /* namespace jau */
+
+#endif /* JAU_SMALL_DYN_ARRAY_HPP_ */
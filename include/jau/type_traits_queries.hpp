@@ -303,6 +303,9 @@ namespace jau {
     METHOD_CHECKER(has_to_string, to_string, std::string, ())
     template <typename _Tp> inline constexpr bool has_to_string_v = has_to_string<_Tp>::value;
 
+    METHOD_CHECKER(has_hash_code, hash_code, std::size_t, ())
+    template <typename _Tp> inline constexpr bool has_hash_code_v = has_hash_code<_Tp>::value;
+
     // Author: Sven Gothel
 
     /// Checker for member of pointer '->' operator with convertible pointer return, no arguments
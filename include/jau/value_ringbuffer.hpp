@@ -0,0 +1,500 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef JAU_VALUE_RINGBUFFER_HPP_
+#define JAU_VALUE_RINGBUFFER_HPP_
+
+#include <type_traits>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+#include <cstring>
+#include <string>
+#include <cstdint>
+
+#include <jau/debug.hpp>
+#include <jau/basic_types.hpp>
+#include <jau/int_math.hpp>
+#include <jau/ordered_atomic.hpp>
+#include <jau/ringbuffer_wait.hpp>
+#include <jau/ringbuffer_span.hpp>
+#include <jau/ringbuffer_counter.hpp>
+
+namespace jau {
+
+/**
+ * Ring buffer implementation for trivially copyable value types,
+ * exposing <i>lock-free</i> {@link #get(T&) get*(..)} and {@link #put(const T&) put*(..)} methods
+ * like jau::ringbuffer, but w/o requiring a <code>nullelem</code> sentinel.
+ * <p>
+ * Elements are stored by value within the internal array and copied in and out,
+ * i.e. no heap allocation nor reference counting is required per element, e.g. for small packet descriptors.<br>
+ * T must be trivially copyable and default constructible.<br>
+ * Success is signaled by the boolean result of the get operations, hence a consumed slot is not reset.
+ * </p>
+ * <p>
+ * The net capacity is rounded up to a power of two and the internal array holds exactly this many elements.
+ * Free running 64-bit read and write counters are used, i.e. no slot must be kept open to distinguish full from empty
+ * and the array index is derived via a bitmask.
+ * </p>
+ * <p>
+ * Getter and putter owned state are placed on separate cache lines
+ * and each side keeps a cached copy of the opposite counter, see jau::ringbuffer.
+ * </p>
+ * <p>
+ * The zero-copy operations {@link #reserveWrite()} and {@link #peekRead()}
+ * expose the ring buffer storage directly via a ringbuffer_span_guard, allowing to construct and parse large records in place.
+ * </p>
+ * <p>
+ * Thread safety and the <code>multi_pc</code> and <code>Wait_policy</code> template parameter are identical to jau::ringbuffer.
+ * </p>
+ * <p>
+ * Following methods are getter operations in SPSC mode, i.e. shall only be called by the getter thread:
+ * <ul>
+ *  <li>{@link #clear()}</li>
+ *  <li>{@link #drop(int)}</li>
+ * </ul>
+ * </p>
+ * @see jau::ringbuffer
+ */
+template <typename T, typename Size_type, bool multi_pc=true, typename Wait_policy=ringbuffer_wait_cv>
+class value_ringbuffer {
+    public:
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        static_assert(std::is_default_constructible_v<T>, "T must be default constructible");
+
+        /** True if multiple getter and putter threads are supported, otherwise Single Producer Single Consumer (SPSC) mode. */
+        constexpr static const bool uses_multi_pc = multi_pc;
+
+        /** The wait strategy used by the blocking operations, see ringbuffer_wait. */
+        typedef Wait_policy wait_policy_type;
+
+        /** View of up to two contiguous storage segments, returned by the zero-copy operations. */
+        typedef ringbuffer_span<T, Size_type> span_type;
+
+        /** RAII guard of a read span, returned by peekRead(). */
+        typedef ringbuffer_span_guard<value_ringbuffer, T, Size_type, false> read_span_type;
+
+        /** RAII guard of a write span, returned by reserveWrite(). */
+        typedef ringbuffer_span_guard<value_ringbuffer, T, Size_type, true> write_span_type;
+
+    private:
+        template<typename, typename, typename, bool> friend class ringbuffer_span_guard;
+
+        /** Assumed cache line size, separating getter and putter owned state. */
+        constexpr static const std::size_t cache_line_size = 64;
+
+        typedef ringbuffer_counter<Size_type, Wait_policy, ringbuffer_pow2_index<Size_type>> counter_type;
+
+        T * const array;                 // Synchronized due to MM's data-race-free SC (SC-DRF) between [atomic] acquire/release
+        counter_type counter;            // Read and write counter, cached copies and wait objects on separate cache lines
+
+        alignas(cache_line_size) std::mutex syncMultiRead;  // Memory-Model (MM) guaranteed sequential consistency (SC) between acquire and release
+        alignas(cache_line_size) std::mutex syncMultiWrite; // ditto
+
+        Size_type dropImpl(const Size_type count) noexcept {
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            const Size_type dropCount = std::min(count, counter.available(localReadCount, count));
+            if( 0 == dropCount ) {
+                return 0;
+            }
+            counter.advanceRead(localReadCount, dropCount); // SC-DRF release atomic readCount
+            return dropCount;
+        }
+
+        bool getImpl(T & dst, const bool remove, const bool blocking, const int timeoutMS) noexcept {
+            std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // _not_ sync'ing w/ putImpl
+            if constexpr ( multi_pc ) {
+                lockMultiRead.lock(); // acquire syncMultiRead
+            }
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            if( 0 == counter.available(localReadCount, 1) ) { // SC-DRF acquire atomic writeCount if appearing empty, sync'ing with putImpl
+                if( !blocking || !counter.waitForElements(localReadCount, 1, timeoutMS) ) {
+                    return false;
+                }
+            }
+            dst = array[counter.index(localReadCount)]; // SC-DRF
+            if( remove ) {
+                counter.advanceRead(localReadCount, 1); // SC-DRF release atomic readCount
+            }
+            return true;
+        }
+
+        bool putImpl(const T & e, const bool blocking, const int timeoutMS) noexcept {
+            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock); // _not_ sync'ing w/ getImpl
+            if constexpr ( multi_pc ) {
+                lockMultiWrite.lock(); // acquire syncMultiWrite
+            }
+            const uint64_t localWriteCount = counter.loadWriteCount(); // owned by putter
+            if( 0 == counter.freeSlots(localWriteCount, 1) ) { // SC-DRF acquire atomic readCount if appearing full, sync'ing with getImpl
+                if( !blocking || !counter.waitForFreeSlots(localWriteCount, 1, timeoutMS) ) {
+                    return false;
+                }
+            }
+            array[counter.index(localWriteCount)] = e; // SC-DRF
+            counter.advanceWrite(localWriteCount, 1); // SC-DRF release atomic writeCount
+            return true;
+        }
+
+        Size_type getNImpl(T * dst, Size_type min_count, const Size_type max_count, const bool blocking, const int timeoutMS) noexcept {
+            std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // _not_ sync'ing w/ putImpl
+            if constexpr ( multi_pc ) {
+                lockMultiRead.lock(); // acquire syncMultiRead
+            }
+            const span_type s = readSpanImpl(min_count, max_count, blocking, timeoutMS);
+            if( 0 == s.size() ) {
+                return 0;
+            }
+            ::memcpy(reinterpret_cast<void*>(dst), reinterpret_cast<const void*>(s.data1), s.size1 * sizeof(T));
+            if( 0 < s.size2 ) {
+                ::memcpy(reinterpret_cast<void*>(dst + s.size1), reinterpret_cast<const void*>(s.data2), s.size2 * sizeof(T)); // wrap-around
+            }
+            counter.advanceRead(counter.loadReadCount(), s.size()); // SC-DRF release atomic readCount, once per batch
+            return s.size();
+        }
+
+        Size_type putNImpl(const T * src, Size_type min_count, const Size_type count, const bool blocking, const int timeoutMS) noexcept {
+            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock); // _not_ sync'ing w/ getImpl
+            if constexpr ( multi_pc ) {
+                lockMultiWrite.lock(); // acquire syncMultiWrite
+            }
+            const span_type s = writeSpanImpl(min_count, count, blocking, timeoutMS);
+            if( 0 == s.size() ) {
+                return 0;
+            }
+            ::memcpy(reinterpret_cast<void*>(s.data1), reinterpret_cast<const void*>(src), s.size1 * sizeof(T));
+            if( 0 < s.size2 ) {
+                ::memcpy(reinterpret_cast<void*>(s.data2), reinterpret_cast<const void*>(src + s.size1), s.size2 * sizeof(T)); // wrap-around
+            }
+            counter.advanceWrite(counter.loadWriteCount(), s.size()); // SC-DRF release atomic writeCount, once per batch
+            return s.size();
+        }
+
+        /** Returns the span of up to max_count available elements, waiting for min_count if blocking. Caller holds syncMultiRead in multi_pc mode. */
+        span_type readSpanImpl(Size_type min_count, const Size_type max_count, const bool blocking, const int timeoutMS) noexcept {
+            min_count = std::min(min_count, std::min(max_count, counter.capacity()));
+            const uint64_t localReadCount = counter.loadReadCount(); // owned by getter
+            Size_type available = counter.available(localReadCount, max_count); // SC-DRF acquire atomic writeCount if less than max_count appear available
+            if( available < min_count ) {
+                if( !blocking || !counter.waitForElements(localReadCount, min_count, timeoutMS) ) {
+                    return span_type();
+                }
+                available = counter.cachedAvailable(localReadCount);
+            }
+            return counter.span(array, localReadCount, std::min(available, max_count));
+        }
+
+        /** Returns the span of up to max_count free slots, waiting for min_count if blocking. Caller holds syncMultiWrite in multi_pc mode. */
+        span_type writeSpanImpl(Size_type min_count, const Size_type max_count, const bool blocking, const int timeoutMS) noexcept {
+            min_count = std::min(min_count, std::min(max_count, counter.capacity()));
+            const uint64_t localWriteCount = counter.loadWriteCount(); // owned by putter
+            Size_type freeSlots = counter.freeSlots(localWriteCount, max_count); // SC-DRF acquire atomic readCount if less than max_count appear free
+            if( freeSlots < min_count ) {
+                if( !blocking || !counter.waitForFreeSlots(localWriteCount, min_count, timeoutMS) ) {
+                    return span_type();
+                }
+                freeSlots = counter.cachedFreeSlots(localWriteCount);
+            }
+            return counter.span(array, localWriteCount, std::min(freeSlots, max_count));
+        }
+
+        /** Acquires syncMultiRead in multi_pc mode, released by endRead(). */
+        span_type peekReadImpl(Size_type min_count, const Size_type max_count, const bool blocking, const int timeoutMS) noexcept {
+            if constexpr ( multi_pc ) {
+                syncMultiRead.lock(); // acquire syncMultiRead, released by endRead()
+            }
+            return readSpanImpl(min_count, max_count, blocking, timeoutMS);
+        }
+
+        /** Acquires syncMultiWrite in multi_pc mode, released by endWrite(). */
+        span_type reserveWriteImpl(Size_type min_count, const Size_type max_count, const bool blocking, const int timeoutMS) noexcept {
+            if constexpr ( multi_pc ) {
+                syncMultiWrite.lock(); // acquire syncMultiWrite, released by endWrite()
+            }
+            return writeSpanImpl(min_count, max_count, blocking, timeoutMS);
+        }
+
+        /** Dequeues the first count elements viewed by the preceding peekReadImpl() call and releases syncMultiRead in multi_pc mode, called by read_span_type. */
+        void endRead(const Size_type count) noexcept {
+            if( 0 < count ) {
+                counter.advanceRead(counter.loadReadCount(), count); // SC-DRF release atomic readCount
+            }
+            if constexpr ( multi_pc ) {
+                syncMultiRead.unlock(); // release syncMultiRead, acquired by peekReadImpl()
+            }
+        }
+
+        /** Enqueues the first count slots reserved by the preceding reserveWriteImpl() call and releases syncMultiWrite in multi_pc mode, called by write_span_type. */
+        void endWrite(const Size_type count) noexcept {
+            if( 0 < count ) {
+                counter.advanceWrite(counter.loadWriteCount(), count); // SC-DRF release atomic writeCount
+            }
+            if constexpr ( multi_pc ) {
+                syncMultiWrite.unlock(); // release syncMultiWrite, acquired by reserveWriteImpl()
+            }
+        }
+
+    public:
+        /** Returns a short string representation incl. size/capacity and internal r/w counter (impl. dependent). */
+        std::string toString() const noexcept {
+            const std::string es = isEmpty() ? ", empty" : "";
+            const std::string fs = isFull() ? ", full" : "";
+            return "value_ringbuffer<?>[size "+std::to_string(getSize())+" / "+std::to_string(counter.capacity())+
+                    ", writeCount "+std::to_string(counter.state().writeCount.load())+", readCount "+std::to_string(counter.state().readCount.load())+es+fs+"]";
+        }
+
+        /**
+         * Create an empty ring buffer instance w/ the given minimum net <code>capacity</code>,
+         * rounded up to a power of two.
+         * @param capacity the minimum net capacity of the ring buffer
+         */
+        value_ringbuffer(const Size_type capacity) noexcept
+        : array(new T[counter_type::roundCapacity(capacity)]), counter(capacity)
+        { }
+
+        ~value_ringbuffer() noexcept {
+            delete[] array;
+        }
+
+        value_ringbuffer(const value_ringbuffer &_source) = delete;
+        value_ringbuffer& operator=(const value_ringbuffer &_source) = delete;
+
+        /** Returns the net capacity of this ring buffer, a power of two. */
+        Size_type capacity() const noexcept { return counter.capacity(); }
+
+        /**
+         * Releasing all elements.
+         * <p>
+         * {@link #isEmpty()} will return <code>true</code> and
+         * {@link #getSize()} will return <code>0</code> after calling this method.
+         * </p>
+         */
+        void clear() noexcept {
+            if constexpr ( multi_pc ) {
+                std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock);          // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
+                std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock);        // otherwise RAII-style relinquish via destructor
+                std::lock(lockMultiRead, lockMultiWrite);
+                dropImpl(counter.capacity());
+            } else {
+                dropImpl(counter.capacity());
+            }
+        }
+
+        /** Returns the number of elements in this ring buffer. */
+        Size_type getSize() const noexcept { return counter.getSize(); }
+
+        /** Returns the number of free slots available to put.  */
+        Size_type getFreeSlots() const noexcept { return counter.capacity() - counter.getSize(); }
+
+        /** Returns true if this ring buffer is empty, otherwise false. */
+        bool isEmpty() const noexcept { return 0 == counter.getSize(); }
+
+        /** Returns true if this ring buffer is full, otherwise false. */
+        bool isFull() const noexcept { return counter.capacity() <= counter.getSize(); }
+
+        /**
+         * Dequeues the oldest enqueued element if available, copying it to dst.
+         * <p>
+         * Method is non blocking and returns immediately;.
+         * </p>
+         * @return true if an element has been dequeued, otherwise false if empty.
+         */
+        bool get(T & dst) noexcept {
+            return getImpl(dst, true, false, 0);
+        }
+
+        /**
+         * Dequeues the oldest enqueued element, copying it to dst.
+         * <p>
+         * <code>timeoutMS</code> defaults to zero,
+         * i.e. infinitive blocking until an element available via put.<br>
+         * Otherwise this methods blocks for the given milliseconds.
+         * </p>
+         * @return true if an element has been dequeued, otherwise false if timeout occurred.
+         */
+        bool getBlocking(T & dst, const int timeoutMS=0) noexcept {
+            return getImpl(dst, true, true, timeoutMS);
+        }
+
+        /**
+         * Peeks the next element at the read position w/o modifying the read counter, nor blocking.
+         * @return true if an element has been copied to dst, otherwise false if empty.
+         */
+        bool peek(T & dst) noexcept {
+            return getImpl(dst, false, false, 0);
+        }
+
+        /**
+         * Peeks the next element at the read position w/o modifying the read counter, but with blocking.
+         * @return true if an element has been copied to dst, otherwise false if timeout occurred.
+         */
+        bool peekBlocking(T & dst, const int timeoutMS=0) noexcept {
+            return getImpl(dst, false, true, timeoutMS);
+        }
+
+        /**
+         * Drops up to {@code count} oldest enqueued elements.
+         * @return the number of dropped elements
+         */
+        Size_type drop(const Size_type count) noexcept {
+            if constexpr ( multi_pc ) {
+                std::unique_lock<std::mutex> lockMultiRead(syncMultiRead, std::defer_lock); // utilize std::lock(r, w), allowing mixed order waiting on read/write ops
+                std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock); // otherwise RAII-style relinquish via destructor
+                std::lock(lockMultiRead, lockMultiWrite);
+                return dropImpl(count);
+            } else {
+                return dropImpl(count);
+            }
+        }
+
+        /**
+         * Dequeues up to max_count oldest enqueued elements, copying them into the given dst array.
+         * @see ringbuffer::getN()
+         */
+        Size_type getN(T * dst, const Size_type max_count) noexcept {
+            return getNImpl(dst, 1, max_count, false, 0);
+        }
+
+        /**
+         * Dequeues up to max_count oldest enqueued elements after blocking until at least min_count elements are available.
+         * @see ringbuffer::getNBlocking()
+         */
+        Size_type getNBlocking(T * dst, const Size_type min_count, const Size_type max_count, const int timeoutMS=0) noexcept {
+            return getNImpl(dst, min_count, max_count, true, timeoutMS);
+        }
+
+        /**
+         * Enqueues up to count elements of the given src array by copying them into this ringbuffer storage.
+         * @see ringbuffer::putN()
+         */
+        Size_type putN(const T * src, const Size_type count) noexcept {
+            return putNImpl(src, 1, count, false, 0);
+        }
+
+        /**
+         * Enqueues up to count elements of the given src array after blocking until at least min_count free slots are available.
+         * @see ringbuffer::putNBlocking()
+         */
+        Size_type putNBlocking(const T * src, const Size_type min_count, const Size_type count, const int timeoutMS=0) noexcept {
+            return putNImpl(src, min_count, count, true, timeoutMS);
+        }
+
+        /**
+         * Enqueues the given element by copying it into this ringbuffer storage.
+         * <p>
+         * Method is non blocking and returns immediately;.
+         * </p>
+         * @return true if successful, otherwise false in case buffer is full.
+         */
+        bool put(const T & e) noexcept {
+            return putImpl(e, false, 0);
+        }
+
+        /**
+         * Enqueues the given element by copying it into this ringbuffer storage.
+         * <p>
+         * <code>timeoutMS</code> defaults to zero,
+         * i.e. infinitive blocking until a free slot becomes available via get.<br>
+         * Otherwise this methods blocks for the given milliseconds.
+         * </p>
+         * @return true if successful, otherwise false in case timeout occurred.
+         */
+        bool putBlocking(const T & e, const int timeoutMS=0) noexcept {
+            return putImpl(e, true, timeoutMS);
+        }
+
+        /**
+         * Returns a view of up to max_count oldest enqueued elements within the ring buffer storage w/o dequeuing them,
+         * allowing to parse elements in place.
+         * <p>
+         * The returned guard dequeues all viewed elements at destruction,
+         * or the first <code>count</code> viewed elements at its explicit early read_span_type::release().
+         * In <code>multi_pc</code> mode, the multi-read mutex is held until then, even if the returned span is empty.
+         * </p>
+         * @see ringbuffer::peekRead()
+         */
+        read_span_type peekRead(const Size_type max_count) noexcept {
+            return read_span_type(*this, peekReadImpl(1, max_count, false, 0));
+        }
+
+        /**
+         * Returns a view of up to max_count oldest enqueued elements within the ring buffer storage w/o dequeuing them,
+         * blocking until at least min_count elements are available, see {@link #peekRead()}.
+         * @see ringbuffer::peekReadBlocking()
+         */
+        read_span_type peekReadBlocking(const Size_type min_count, const Size_type max_count, const int timeoutMS=0) noexcept {
+            return read_span_type(*this, peekReadImpl(min_count, max_count, true, timeoutMS));
+        }
+
+        /**
+         * Returns a view of up to max_count free slots within the ring buffer storage,
+         * allowing to construct elements in place.
+         * <p>
+         * The returned guard enqueues all reserved slots at destruction,
+         * or the first <code>count</code> written slots at its explicit early write_span_type::commit().
+         * In <code>multi_pc</code> mode, the multi-write mutex is held until then, even if the returned span is empty.
+         * </p>
+         * @see ringbuffer::reserveWrite()
+         */
+        write_span_type reserveWrite(const Size_type max_count) noexcept {
+            return write_span_type(*this, reserveWriteImpl(1, max_count, false, 0));
+        }
+
+        /**
+         * Returns a view of up to max_count free slots within the ring buffer storage,
+         * blocking until at least min_count free slots are available, see {@link #reserveWrite()}.
+         * @see ringbuffer::reserveWriteBlocking()
+         */
+        write_span_type reserveWriteBlocking(const Size_type min_count, const Size_type max_count, const int timeoutMS=0) noexcept {
+            return write_span_type(*this, reserveWriteImpl(min_count, max_count, true, timeoutMS));
+        }
+
+        /**
+         * Blocks until at least <code>count</code> free slots become available.
+         * <p>
+         * Shall only be called by the putter thread in SPSC mode.
+         * </p>
+         */
+        void waitForFreeSlots(const Size_type count) noexcept {
+            std::unique_lock<std::mutex> lockMultiWrite(syncMultiWrite, std::defer_lock); // _not_ sync'ing w/ getImpl
+            if constexpr ( multi_pc ) {
+                lockMultiWrite.lock(); // acquire syncMultiWrite
+            }
+            const uint64_t localWriteCount = counter.loadWriteCount(); // owned by putter
+            if( counter.freeSlots(localWriteCount, count) < count ) {
+                counter.waitForFreeSlots(localWriteCount, count, 0);
+            }
+        }
+};
+
+} /* namespace jau */
+
+/** \example test_lfringbuffer_perf01.cpp
+ * This C++ unit test also benchmarks jau::value_ringbuffer against jau::ringbuffer of heap allocated std::shared_ptr elements.
+ */
+
+#endif /* JAU_VALUE_RINGBUFFER_HPP_ */
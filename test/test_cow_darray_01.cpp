@@ -27,6 +27,7 @@
 #include <cstring>
 #include <random>
 #include <vector>
+#include <thread>
 
 #define CATCH_CONFIG_RUNNER
 // #define CATCH_CONFIG_MAIN
@@ -40,14 +41,17 @@
 #include <jau/basic_algos.hpp>
 #include <jau/basic_types.hpp>
 #include <jau/darray.hpp>
+#include <jau/small_darray.hpp>
 #include <jau/cow_darray.hpp>
 #include <jau/cow_vector.hpp>
 #include <jau/counting_allocator.hpp>
 #include <jau/callocator.hpp>
 #include <jau/counting_callocator.hpp>
+#include <jau/aligned_callocator.hpp>
+#include <jau/epoch_reclaim.hpp>
 
 /**
- * Test general use of jau::darray, jau::cow_darray and jau::cow_vector.
+ * Test general use of jau::darray, jau::small_darray, jau::cow_darray and jau::cow_vector.
  */
 using namespace jau;
 
@@ -443,3 +447,628 @@ TEST_CASE( "JAU DArray Test 02 - jau::darray value_type behavior (type traits)",
 /**********************************************************************************************************************************************/
 /**********************************************************************************************************************************************/
 
+
+template<class Payload>
+using SmallPayloadList = jau::small_darray<Payload, 4, jau::counting_callocator<Payload>>;
+
+template<class Payload>
+static void testSmallDArrayValueType(const std::string& type_id, Payload (*make)(int)) {
+    static typename SmallPayloadList<Payload>::equal_comparator payloadEqComparator =
+            [](const Payload &a, const Payload &b) -> bool { return a == b; };
+
+    SmallPayloadList<Payload> data;
+    print_container_info("SmallPayloadList<"+type_id+">", data);
+    REQUIRE( true == data.is_inline() );
+    REQUIRE( 4 == data.capacity() );
+
+    // fill inline capacity w/o allocation
+    for(int i=0; i<4; i++) {
+        REQUIRE( true == data.push_back_unique( make(i), payloadEqComparator ) );
+    }
+    REQUIRE( false == data.push_back_unique( make(2), payloadEqComparator ) );
+    REQUIRE( 4 == data.size() );
+    REQUIRE( true == data.is_inline() );
+    REQUIRE( 0 == data.get_allocator_ref().alloc_count );
+
+    // copy and move of inline storage
+    {
+        SmallPayloadList<Payload> data2(data);
+        REQUIRE( true == data2.is_inline() );
+        REQUIRE( data == data2 );
+
+        SmallPayloadList<Payload> data3( std::move(data2) );
+        REQUIRE( true == data3.is_inline() );
+        REQUIRE( 0 == data2.size() );
+        REQUIRE( data == data3 );
+
+        data2 = data3;
+        REQUIRE( data2 == data3 );
+        REQUIRE( true == data2.is_inline() );
+    }
+
+    // spill to allocated storage
+    data.push_back( make(4) );
+    REQUIRE( 5 == data.size() );
+    REQUIRE( false == data.is_inline() );
+    REQUIRE( 1 == data.get_allocator_ref().alloc_count );
+    for(int i=0; i<5; i++) {
+        REQUIRE( make(i) == data[i] );
+    }
+    for(int i=5; i<32; i++) {
+        data.push_back( make(i) );
+    }
+    REQUIRE( 32 == data.size() );
+    for(int i=0; i<32; i++) {
+        REQUIRE( make(i) == data[i] );
+    }
+    {
+        SmallPayloadList<Payload> data2(data);
+        REQUIRE( false == data2.is_inline() );
+        REQUIRE( data == data2 );
+
+        // swap w/ mixed storage
+        SmallPayloadList<Payload> data3 { make(100), make(101) };
+        REQUIRE( true == data3.is_inline() );
+        data3.swap(data2);
+        REQUIRE( 32 == data3.size() );
+        REQUIRE( false == data3.is_inline() );
+        REQUIRE( 2 == data2.size() );
+        REQUIRE( true == data2.is_inline() );
+        REQUIRE( make(101) == data2[1] );
+        REQUIRE( data == data3 );
+    }
+
+    // erase and insert
+    REQUIRE( 1 == data.erase_matching( make(7), true, payloadEqComparator ) );
+    REQUIRE( 31 == data.size() );
+    REQUIRE( make(8) == data[7] );
+    data.insert(data.cbegin()+7, make(7));
+    data.erase(data.begin()+4, data.cend());
+    REQUIRE( 4 == data.size() );
+    for(int i=0; i<4; i++) {
+        REQUIRE( make(i) == data[i] );
+    }
+
+    // clear returns to inline storage
+    data.clear();
+    REQUIRE( true == data.is_inline() );
+    REQUIRE( 4 == data.capacity() );
+    REQUIRE( 0 == data.get_allocator_ref().alloc_balance );
+    printf("SmallPayloadList<%s>: %s\n\n", type_id.c_str(), data.get_info().c_str());
+}
+
+static uint64_t makeUInt64(int i) { return static_cast<uint64_t>(i); }
+static DataType01 makeDataType01(int i) { return DataType01( static_cast<uint64_t>(i) ); }
+static std::shared_ptr<DataType01> makeSharedDataType01(int i) {
+    static std::vector<std::shared_ptr<DataType01>> cache;
+    while( static_cast<int>( cache.size() ) <= i ) {
+        cache.push_back( std::make_shared<DataType01>( static_cast<uint64_t>(cache.size()) ) );
+    }
+    return cache[i];
+}
+
+/** Value type w/ a potentially throwing move constructor, not trivially relocatable. */
+struct ThrowingMove {
+    int value;
+    ThrowingMove(int v) noexcept : value(v) {}
+    ThrowingMove(const ThrowingMove& o) noexcept = default;
+    ThrowingMove(ThrowingMove&& o) noexcept(false) : value(o.value) {}
+    ThrowingMove& operator=(const ThrowingMove& o) noexcept = default;
+    ThrowingMove& operator=(ThrowingMove&& o) noexcept(false) { value = o.value; return *this; }
+    bool operator==(const ThrowingMove& o) const noexcept { return value == o.value; }
+};
+
+TEST_CASE( "JAU DArray Test 03 - jau::small_darray inline capacity", "[datatype][jau][darray]" ) {
+    testSmallDArrayValueType<uint64_t>("uint64_t", makeUInt64);
+    testSmallDArrayValueType<DataType01>("DataType01", makeDataType01);
+    testSmallDArrayValueType<std::shared_ptr<DataType01>>("std::shared_ptr<DataType01>", makeSharedDataType01);
+
+    // moving inline elements may only throw w/ a throwing move constructor of a non trivially relocatable value_type
+    static_assert( std::is_nothrow_move_constructible_v<jau::small_darray<uint64_t, 4>> );
+    static_assert( std::is_nothrow_move_assignable_v<jau::small_darray<std::shared_ptr<DataType01>, 4>> );
+    static_assert( std::is_nothrow_move_constructible_v<jau::darray<ThrowingMove>> );
+    static_assert( std::is_nothrow_swappable_v<jau::darray<ThrowingMove>> );
+    static_assert( !std::is_nothrow_move_constructible_v<jau::small_darray<ThrowingMove, 4>> );
+    static_assert( !std::is_nothrow_move_assignable_v<jau::small_darray<ThrowingMove, 4>> );
+    static_assert( !std::is_nothrow_swappable_v<jau::small_darray<ThrowingMove, 4>> );
+    {
+        jau::small_darray<ThrowingMove, 4> data { 1, 2 };
+        jau::small_darray<ThrowingMove, 4> data2( std::move(data) );
+        REQUIRE( true == data2.is_inline() );
+        REQUIRE( 2 == data2.size() );
+        REQUIRE( ThrowingMove(2) == data2[1] );
+        jau::small_darray<ThrowingMove, 4> data3 { 3, 4, 5, 6, 7 };
+        data3.swap(data2);
+        REQUIRE( 2 == data3.size() );
+        REQUIRE( 5 == data2.size() );
+        REQUIRE( ThrowingMove(7) == data2[4] );
+    }
+}
+
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+
+template<class Cont>
+static typename Cont::value_type getElem(const Cont& c, const jau::nsize_t i,
+        std::enable_if_t< jau::is_cow_type<Cont>::value, bool> = true )
+{
+    return (*c.snapshot())[i];
+}
+
+template<class Cont>
+static typename Cont::value_type getElem(const Cont& c, const jau::nsize_t i,
+        std::enable_if_t< !jau::is_cow_type<Cont>::value, bool> = true )
+{
+    return c[i];
+}
+
+template<class Cont>
+static void testDArrayEraseIf(const std::string& type_id) {
+    Cont data;
+    for(int i=0; i<100; i++) {
+        data.push_back( makeDataType01(i) );
+    }
+    // erase 10%, i.e. every 10th element
+    REQUIRE( 10 == data.erase_if( [](const DataType01& e) -> bool { return 0 == e.address.b[0] % 10; } ) );
+    REQUIRE( 90 == data.size() );
+    // erase 50%, i.e. every odd element
+    REQUIRE( 50 == data.erase_if( [](const DataType01& e) -> bool { return 1 == e.address.b[0] % 2; } ) );
+    REQUIRE( 40 == data.size() );
+    for(jau::nsize_t i=0; i<data.size(); i++) {
+        const int j = static_cast<int>( i + i/4 ) * 2 + 2; // 2, 4, 6, 8, 12, ..
+        REQUIRE( makeDataType01(j) == getElem(data, i) );
+    }
+    REQUIRE( 0 == data.erase_if( [](const DataType01& e) -> bool { return 1 == e.address.b[0] % 2; } ) );
+
+    // erase first, run, last and a duplicate position
+    const std::vector<jau::nsize_t> positions { 0, 5, 6, 7, 7, 39 };
+    REQUIRE( 5 == data.erase_indices(positions.cbegin(), positions.cend()) );
+    REQUIRE( 35 == data.size() );
+    REQUIRE( makeDataType01(4) == getElem(data, 0) );
+    REQUIRE( makeDataType01(12) == getElem(data, 3) );
+    REQUIRE( makeDataType01(22) == getElem(data, 4) );
+    REQUIRE( makeDataType01(96) == getElem(data, 34) );
+
+    const std::vector<jau::nsize_t> unordered { 3, 2 };
+    REQUIRE_THROWS_AS( data.erase_indices(unordered.cbegin(), unordered.cend()), jau::IllegalArgumentException );
+    const std::vector<jau::nsize_t> outofbounds { 2, 35 };
+    REQUIRE_THROWS_AS( data.erase_indices(outofbounds.cbegin(), outofbounds.cend()), jau::IndexOutOfBoundsException );
+    REQUIRE( 35 == data.size() );
+
+    data.push_back( makeDataType01(4) );
+    REQUIRE( 2 == data.erase_matching( makeDataType01(4), true, [](const DataType01 &a, const DataType01 &b) -> bool { return a == b; } ) );
+    REQUIRE( 34 == data.size() );
+    printf("EraseIf %s: %s\n\n", type_id.c_str(), data.toString().c_str());
+}
+
+template<class T>
+static void testDArrayEraseIfThrow() {
+    // a throwing predicate keeps erased elements erased and all others compacted in order
+    T data;
+    for(int i=0; i<100; i++) {
+        data.push_back( makeSharedDataType01(i) );
+    }
+    REQUIRE_THROWS_AS( data.erase_if( [](const std::shared_ptr<DataType01>& e) -> bool {
+        if( 50 == e->address.b[0] ) {
+            throw jau::IllegalStateException("pred", E_FILE_LINE);
+        }
+        return 0 == e->address.b[0] % 2;
+    } ), jau::IllegalStateException );
+    REQUIRE( 75 == data.size() );
+    for(int i=0; i<25; i++) {
+        REQUIRE( makeSharedDataType01(2*i+1) == data[i] );
+    }
+    for(int i=25; i<75; i++) {
+        REQUIRE( makeSharedDataType01(i+25) == data[i] );
+        REQUIRE( nullptr != data[i] );
+    }
+    REQUIRE( 2 == makeSharedDataType01(0).use_count() ); // cache and this temporary
+    REQUIRE( 3 == makeSharedDataType01(1).use_count() ); // cache, data and this temporary
+}
+
+TEST_CASE( "JAU DArray Test 04 - erase_if and erase_indices", "[datatype][jau][darray]" ) {
+    testDArrayEraseIf<jau::darray<DataType01>>("darray_def");
+    testDArrayEraseIf<jau::darray<DataType01, jau::callocator<DataType01>, jau::nsize_t, true, true>>("darray_mmm");
+    testDArrayEraseIf<jau::small_darray<DataType01, 8>>("small_darray_def_8");
+    testDArrayEraseIf<jau::cow_darray<DataType01>>("cow_darray_def");
+
+    {
+        // cow_darray: exactly one copy-on-write, if any
+        jau::cow_darray<std::shared_ptr<DataType01>> data;
+        for(int i=0; i<100; i++) {
+            data.push_back( makeSharedDataType01(i) );
+        }
+        std::shared_ptr<jau::darray<std::shared_ptr<DataType01>>> snap0 = data.snapshot();
+        REQUIRE( 0 == data.erase_if( [](const std::shared_ptr<DataType01>& e) -> bool { return nullptr == e; } ) );
+        REQUIRE( snap0 == data.snapshot() );
+
+        REQUIRE( 50 == data.erase_if( [](const std::shared_ptr<DataType01>& e) -> bool { return 0 == e->address.b[0] % 2; } ) );
+        REQUIRE( snap0 != data.snapshot() );
+        REQUIRE( 100 == snap0->size() );
+        REQUIRE( 50 == data.size() );
+        REQUIRE( makeSharedDataType01(1) == data.snapshot()->at(0) );
+        REQUIRE( 4 == makeSharedDataType01(1).use_count() ); // cache, snap0, data and this temporary
+        REQUIRE( 3 == makeSharedDataType01(0).use_count() ); // cache, snap0 and this temporary
+    }
+    testDArrayEraseIfThrow<jau::darray<std::shared_ptr<DataType01>>>();
+    testDArrayEraseIfThrow<jau::small_darray<std::shared_ptr<DataType01>, 8>>();
+}
+
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+
+template<class Cont>
+static void testDArrayUninitialized(const std::string& type_id) {
+    uint8_t source[1000];
+    for(int i=0; i<1000; ++i) {
+        source[i] = static_cast<uint8_t>(i);
+    }
+    Cont data;
+    REQUIRE( nullptr == data.append_uninitialized(0) );
+    REQUIRE( 0 == data.size() );
+
+    // 'read' 1000 bytes in chunks of 64, each chunk partially filled by 50 bytes
+    int src_pos = 0;
+    while( src_pos < 1000 ) {
+        const int chunk = 64;
+        const int n = std::min(50, 1000 - src_pos);
+        const jau::nsize_t size0 = data.size();
+        uint8_t* p = data.append_uninitialized(chunk);
+        REQUIRE( size0 + chunk == data.size() );
+        REQUIRE( data.data() + size0 == p );
+        memcpy(p, source + src_pos, n);
+        data.truncate( data.size() - chunk + n );
+        REQUIRE( size0 + n == data.size() );
+        src_pos += n;
+    }
+    REQUIRE( 1000 == data.size() );
+    REQUIRE( 1000 < data.capacity() );
+    REQUIRE( 0 == memcmp(data.data(), source, 1000) );
+
+    data.shrink_to_fit();
+    REQUIRE( 1000 == data.capacity() );
+    REQUIRE( 0 == memcmp(data.data(), source, 1000) );
+
+    uint8_t* p = data.resize_uninitialized(2000);
+    REQUIRE( 2000 == data.size() );
+    REQUIRE( 2000 == data.capacity() );
+    REQUIRE( data.data() == p );
+    REQUIRE( 0 == memcmp(p, source, 1000) );
+    memcpy(p + 1000, source, 1000);
+    REQUIRE( 0 == memcmp(p + 1000, source, 1000) );
+
+    data.resize_uninitialized(10);
+    REQUIRE( 10 == data.size() );
+    REQUIRE( 2000 == data.capacity() );
+    data.truncate(20);
+    REQUIRE( 10 == data.size() );
+    REQUIRE( 0 == memcmp(data.data(), source, 10) );
+
+    data.truncate(0);
+    data.shrink_to_fit();
+    REQUIRE( 0 == data.size() );
+    REQUIRE( 0 == data.capacity() );
+    printf("Uninitialized %s: OK\n", type_id.c_str());
+}
+
+TEST_CASE( "JAU DArray Test 05 - uninitialized resize and append", "[datatype][jau][darray]" ) {
+    testDArrayUninitialized<jau::darray<uint8_t>>("darray_u8_def");
+    testDArrayUninitialized<jau::darray<uint8_t, jau::callocator<uint8_t>, jau::nsize_t, true, false>>("darray_u8_memcpy");
+    testDArrayUninitialized<jau::darray<uint8_t, jau::callocator<uint8_t>, jau::nsize_t, true, true, true>>("darray_u8_secmem");
+    testDArrayUninitialized<jau::darray<uint8_t, std::allocator<uint8_t>>>("darray_u8_stdalloc");
+}
+
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+
+template<class Cont, class Payload>
+static void testDArrayAligned(const std::string& type_id, const std::size_t count, Payload (*makePayload)(int i)) {
+    typedef typename Cont::allocator_type alloc_t;
+    Cont data;
+    bool passed_threshold = false;
+    for(std::size_t i=0; i<count; ++i) {
+        const typename Cont::value_type* p0 = data.data();
+        data.push_back( makePayload(static_cast<int>(i)) );
+        if( p0 != data.data() ) {
+            // storage changed
+            REQUIRE( 0 == reinterpret_cast<uintptr_t>(data.data()) % alloc_t::alignment );
+        }
+        if( data.capacity() * sizeof(Payload) >= alloc_t::hugepage_threshold ) {
+            passed_threshold = true;
+        }
+    }
+    REQUIRE( passed_threshold );
+    REQUIRE( count == data.size() );
+    for(std::size_t i=0; i<count; ++i) {
+        REQUIRE( makePayload(static_cast<int>(i)) == data[i] );
+    }
+
+    // mapped -> mapped
+    data.shrink_to_fit();
+    REQUIRE( count == data.capacity() );
+    REQUIRE( 0 == reinterpret_cast<uintptr_t>(data.data()) % alloc_t::alignment );
+    REQUIRE( makePayload(static_cast<int>(count-1)) == data[count-1] );
+
+    // mapped -> heap
+    data.truncate(10);
+    data.shrink_to_fit();
+    REQUIRE( 10 == data.capacity() );
+    REQUIRE( 0 == reinterpret_cast<uintptr_t>(data.data()) % alloc_t::alignment );
+    for(int i=0; i<10; ++i) {
+        REQUIRE( makePayload(i) == data[i] );
+    }
+    printf("Aligned %s: %s\n", type_id.c_str(), data.get_info().c_str());
+}
+
+TEST_CASE( "JAU DArray Test 06 - aligned_callocator w/ huge pages", "[datatype][jau][darray]" ) {
+    typedef jau::aligned_callocator<uint64_t, 64, 64*1024> alloc_u64_t;
+    typedef jau::aligned_callocator<DataType01, 64, 64*1024> alloc_dt01_t;
+    REQUIRE( true == jau::darray<uint64_t, alloc_u64_t>::uses_realloc );
+    REQUIRE( false == jau::darray<DataType01, alloc_dt01_t>::uses_memmove );
+
+    testDArrayAligned<jau::darray<uint64_t, alloc_u64_t>, uint64_t>("darray_u64_a64", 100000, makeUInt64);
+    testDArrayAligned<jau::darray<uint64_t, jau::aligned_callocator<uint64_t, 32, 0>>, uint64_t>("darray_u64_a32_nomap", 10000, makeUInt64);
+    testDArrayAligned<jau::darray<DataType01, alloc_dt01_t>, DataType01>("darray_dt01_a64", 10000, makeDataType01);
+    testDArrayAligned<jau::darray<uint64_t, alloc_u64_t, jau::nsize_t, true, true, true>, uint64_t>("darray_u64_a64_secmem", 100000, makeUInt64);
+}
+
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+
+template<class CoW>
+static void testCoWEpochView(const std::string& type_id) {
+    typedef typename CoW::storage_t storage_t;
+    typedef typename CoW::value_type value_type;
+    jau::epoch_domain& domain = jau::epoch_domain::get();
+
+    CoW data;
+    for(int i=0; i<10; ++i) { data.push_back( value_type(i) ); }
+    std::weak_ptr<storage_t> store0_ref = data.snapshot();
+    {
+        typename CoW::epoch_view_t view = data.epoch_view();
+        REQUIRE( 10 == view.size() );
+        const storage_t* store0 = view.storage();
+
+        // replaced store is retired, not released while view exists
+        data.clear();
+        REQUIRE( 0 == data.size() );
+        domain.reclaim();
+        REQUIRE( false == store0_ref.expired() );
+        REQUIRE( store0 == view.storage() );
+        REQUIRE( 10 == view.size() );
+        for(int i=0; i<10; ++i) {
+            REQUIRE( value_type(i) == view[i] );
+        }
+        {
+            typename CoW::epoch_view_t view2 = data.epoch_view(); // nested
+            REQUIRE( 0 == view2.size() );
+            REQUIRE( view2.begin() == view2.end() );
+        }
+        // leaving the nested view keeps the outer critical section
+        REQUIRE( false == store0_ref.expired() );
+    }
+    // leaving the last critical section releases the retired store
+    REQUIRE( true == store0_ref.expired() );
+
+    // concurrent readers, validating each view's consistent content
+    const int reader_count = 4;
+    const int writes = 2000;
+    jau::sc_atomic_bool done(false);
+    jau::sc_atomic_int bad_views(0);
+    std::vector<std::thread> readers;
+    for(int r=0; r<reader_count; ++r) {
+        readers.push_back( std::thread( [&data, &done, &bad_views]() {
+            while( !done ) {
+                typename CoW::epoch_view_t view = data.epoch_view();
+                typename CoW::size_type i=0;
+                for(const value_type& e : view) {
+                    if( !( value_type(i++) == e ) ) {
+                        bad_views++;
+                        break;
+                    }
+                }
+            }
+        } ) );
+    }
+    for(int w=0; w<writes; ++w) {
+        storage_t s;
+        for(int i=0; i < 1 + w % 64; ++i) { s.push_back( value_type(i) ); }
+        data.set_store( std::make_shared<storage_t>( std::move(s) ) );
+    }
+    done = true;
+    for(std::thread& t : readers) { t.join(); }
+    REQUIRE( 0 == bad_views );
+    {
+        // replaced store w/o readers is released right away
+        std::weak_ptr<storage_t> store1_ref = data.snapshot();
+        data.clear();
+        REQUIRE( true == store1_ref.expired() );
+    }
+    printf("EpochView %s: OK\n", type_id.c_str());
+}
+
+TEST_CASE( "JAU DArray Test 07 - cow_darray and cow_vector epoch_view", "[datatype][jau][darray][cow]" ) {
+    testCoWEpochView<jau::cow_darray<uint64_t>>("cow_darray_u64");
+    testCoWEpochView<jau::cow_darray<DataType01>>("cow_darray_dt01");
+    testCoWEpochView<jau::cow_vector<uint64_t>>("cow_vector_u64");
+}
+
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+
+TEST_CASE( "JAU DArray Test 08 - cow_darray transaction", "[datatype][jau][darray][cow]" ) {
+    typedef jau::cow_darray<uint64_t> cow_t;
+    static_assert( std::is_nothrow_move_assignable_v<cow_t> );
+    static_assert( std::is_nothrow_swappable_v<cow_t> );
+    cow_t data;
+    for(uint64_t i=0; i<10; ++i) { data.push_back(i); }
+
+    {
+        cow_t::storage_ref_t store0 = data.snapshot();
+        cow_t::transaction_t tx = data.transaction();
+        REQUIRE( true == tx.is_active() );
+        tx->pop_back();
+        tx->pop_back();
+        tx->push_back(100);
+        tx->erase(tx->begin());
+        tx.store().insert(tx->begin(), 200);
+        REQUIRE( 9 == tx->size() );
+
+        // not yet published
+        REQUIRE( store0 == data.snapshot() );
+        REQUIRE( 10 == data.size() );
+
+        tx.commit();
+        REQUIRE( false == tx.is_active() );
+        REQUIRE( store0 != data.snapshot() );
+        REQUIRE_THROWS_AS( tx.store(), jau::IllegalStateException );
+        tx.commit(); // no-op
+    }
+    {
+        const jau::darray<uint64_t> exp { 200, 1, 2, 3, 4, 5, 6, 7, 100 };
+        REQUIRE( exp == *data.snapshot() );
+    }
+    {
+        cow_t::storage_ref_t store0 = data.snapshot();
+        {
+            cow_t::transaction_t tx = data.transaction();
+            tx->clear();
+            tx->push_back(1);
+        } // rollback via dtor
+        REQUIRE( store0 == data.snapshot() );
+        REQUIRE( 9 == data.size() );
+
+        cow_t::transaction_t tx = data.transaction();
+        tx->clear();
+        tx.rollback();
+        REQUIRE( false == tx.is_active() );
+        REQUIRE( store0 == data.snapshot() );
+
+        data.push_back(300); // write mutex released
+        REQUIRE( 10 == data.size() );
+    }
+    {
+        // write operations on the transaction's thread would be lost on commit
+        cow_t::storage_ref_t store0 = data.snapshot();
+        cow_t::transaction_t tx = data.transaction();
+        tx->push_back(400);
+        REQUIRE_THROWS_AS( data.push_back(500), jau::IllegalStateException );
+        REQUIRE_THROWS_AS( data.erase_if( [](const uint64_t& e) -> bool { return 0 == e; } ), jau::IllegalStateException );
+        REQUIRE_THROWS_AS( data.copy_store(), jau::IllegalStateException );
+        REQUIRE_THROWS_AS( data.transaction(), jau::IllegalStateException );
+        REQUIRE( store0 == data.snapshot() );
+
+        cow_t::transaction_t tx2( std::move(tx) ); // moved transaction stays open
+        REQUIRE_THROWS_AS( data.push_back(500), jau::IllegalStateException );
+        tx2.commit();
+        REQUIRE( 11 == data.size() );
+        REQUIRE( 400 == data.snapshot()->back() );
+        data.push_back(500);
+        REQUIRE( 12 == data.size() );
+    }
+}
+
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+
+TEST_CASE( "JAU DArray Test 09 - cow_darray store pool", "[datatype][jau][darray][cow]" ) {
+    typedef jau::cow_darray<uint64_t, jau::counting_callocator<uint64_t>> cow_t;
+    cow_t data(100);
+    for(uint64_t i=0; i<100; ++i) { data.push_back(i); }
+    data.set_store_pool(2);
+
+    // warm up: first copy misses, second reuses the initially replaced store
+    data.pop_back();
+    data.pop_back();
+    REQUIRE( 1 == data.store_pool_hits() );
+    REQUIRE( 1 == data.store_pool_misses() );
+    const std::size_t alloc_count0 = jau::counting_callocator<uint64_t>::total_alloc_count;
+
+    for(int i=0; i<50; ++i) {
+        data.push_back(1000); // in place
+        data.pop_back();      // copy into pooled store
+    }
+    REQUIRE( 51 == data.store_pool_hits() );
+    REQUIRE( 1 == data.store_pool_misses() );
+    REQUIRE( 98 == data.size() );
+    {
+        cow_t::storage_ref_t store = data.snapshot();
+        for(uint64_t i=0; i<98; ++i) { REQUIRE( i == (*store)[i] ); }
+    }
+    // reused stores don't allocate
+    REQUIRE( alloc_count0 == jau::counting_callocator<uint64_t>::total_alloc_count );
+
+    {
+        // pooled stores still referenced by a reader are not reused
+        cow_t::storage_ref_t snap1 = data.snapshot();
+        data.pop_back(); // hit, pooling snap1's store
+        cow_t::storage_ref_t snap2 = data.snapshot();
+        data.pop_back(); // miss, pooled store referenced by snap1
+        REQUIRE( 52 == data.store_pool_hits() );
+        REQUIRE( 2 == data.store_pool_misses() );
+        REQUIRE( 98 == snap1->size() );
+        REQUIRE( 97 == snap2->size() );
+        REQUIRE( 96 == data.size() );
+        REQUIRE( 95 == (*data.snapshot())[95] );
+        REQUIRE( 97 == (*snap1)[97] );
+    }
+
+    // transaction copies via copy_store()
+    {
+        cow_t::transaction_t tx = data.transaction();
+        tx->push_back(2000);
+        tx.commit();
+    }
+    REQUIRE( 53 == data.store_pool_hits() );
+    REQUIRE( 97 == data.size() );
+    REQUIRE( 2000 == (*data.snapshot())[96] );
+
+    data.set_store_pool(0);
+    data.pop_back();
+    REQUIRE( 53 == data.store_pool_hits() );
+    REQUIRE( 2 == data.store_pool_misses() );
+    REQUIRE( 96 == data.size() );
+
+    {
+        // move assignment keeps the target's pool, pooling its replaced store
+        data.set_store_pool(2);
+        data.pop_back(); // miss, pooling the replaced store
+        cow_t data2(100);
+        data2.set_store_pool(2);
+        data2 = std::move(data);
+        REQUIRE( 95 == data2.size() );
+        REQUIRE( 0 == data2.store_pool_hits() );
+        REQUIRE( 0 == data2.store_pool_misses() );
+        data2.pop_back(); // hit, reusing data2's replaced store
+        REQUIRE( 1 == data2.store_pool_hits() );
+        REQUIRE( 0 == data2.store_pool_misses() );
+        REQUIRE( 94 == data2.size() );
+
+        cow_t data3( std::move(data2) );
+        data3.pop_back(); // hit, reusing the moved pool
+        REQUIRE( 1 == data3.store_pool_hits() );
+        REQUIRE( 93 == data3.size() );
+    }
+    {
+        // elements of pooled stores are destructed once unreferenced, not at reuse
+        typedef jau::cow_darray<std::shared_ptr<DataType01>> cow2_t;
+        std::shared_ptr<DataType01> e0 = std::make_shared<DataType01>( static_cast<uint64_t>(0) );
+        cow2_t data2;
+        data2.set_store_pool(2);
+        data2.push_back(e0);
+        REQUIRE( 2 == e0.use_count() );
+        data2.clear(); // unreferenced replaced store
+        REQUIRE( 1 == e0.use_count() );
+
+        data2.push_back(e0);
+        cow2_t::storage_ref_t snap = data2.snapshot();
+        data2.clear(); // replaced store referenced by snap
+        REQUIRE( 2 == e0.use_count() );
+        snap = nullptr;
+        data2.push_back( std::make_shared<DataType01>( static_cast<uint64_t>(1) ) ); // next write operation
+        REQUIRE( 1 == e0.use_count() );
+    }
+}
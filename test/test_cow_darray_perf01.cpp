@@ -27,6 +27,7 @@
 #include <cstring>
 #include <random>
 #include <vector>
+#include <thread>
 
 #define CATCH_CONFIG_RUNNER
 // #define CATCH_CONFIG_MAIN
@@ -38,14 +39,16 @@
 #include <jau/basic_types.hpp>
 #include <jau/basic_algos.hpp>
 #include <jau/darray.hpp>
+#include <jau/small_darray.hpp>
 #include <jau/cow_darray.hpp>
 #include <jau/cow_vector.hpp>
+#include <jau/cow_pvector.hpp>
 #include <jau/counting_allocator.hpp>
 #include <jau/callocator.hpp>
 #include <jau/counting_callocator.hpp>
 
 /**
- * Performance test of jau::darray, jau::cow_darray and jau::cow_vector.
+ * Performance test of jau::darray, jau::small_darray, jau::cow_darray and jau::cow_vector.
  */
 using namespace jau;
 
@@ -439,6 +442,324 @@ static bool test_02_seq_fillunique_find_itr(const std::string& type_id, const Si
     return data.size() == 0;
 }
 
+/****************************************************************************************
+ ****************************************************************************************/
+
+template<class T, typename Size_type>
+static std::size_t test_03_seq_fill_small_lists_footprint(const Size_type list_count, const Size_type size0) {
+    std::size_t alloc_count = 0;
+    for(Size_type j=0; j<list_count; ++j) {
+        T data;
+        test_00_seq_fill_unique_itr<T, Size_type>(data, size0);
+        REQUIRE(data.size() == size0);
+        test_00_list_itr<T>(data);
+        alloc_count += data.get_allocator().alloc_count;
+    }
+    return alloc_count;
+}
+
+template<class T, typename Size_type>
+static bool test_03_seq_fill_small_lists(const Size_type list_count, const Size_type size0) {
+    int some_number = 0;
+    for(Size_type j=0; j<list_count; ++j) {
+        T data;
+        test_00_seq_fill_unique_itr<T, Size_type>(data, size0);
+        some_number += test_00_list_itr<T>(data);
+    }
+    return some_number > 0;
+}
+
+template<class T, typename Size_type>
+static bool test_04_shared_fill_insert_erase(const Size_type size0) {
+    static std::vector<std::shared_ptr<DataType01>> source;
+    if( source.size() < size0 ) {
+        Addr48Bit a0(start_addr);
+        source.clear();
+        for(Size_type i=0; i<size0 && a0.next(); ++i) {
+            source.push_back( std::make_shared<DataType01>(a0, static_cast<uint8_t>(1)) );
+        }
+    }
+    T data;
+    for(Size_type i=0; i<size0; ++i) {
+        data.push_back( source[i] ); // grow
+    }
+    REQUIRE(data.size() == size0);
+
+    const Size_type count = size0 / 10;
+    for(Size_type i=0; i<count; ++i) {
+        data.insert(data.cbegin(), source[i]); // shift all right
+    }
+    REQUIRE(data.size() == size0 + count);
+    for(Size_type i=0; i<count; ++i) {
+        data.erase(data.cbegin()); // shift all left
+    }
+    REQUIRE(data.size() == size0);
+    REQUIRE(*data[0] == *source[0]);
+    return data.size() == size0;
+}
+
+static bool erase_pred(const DataType01& e, const int percent) {
+    const std::size_t idx = e.address.b[0] + 256 * e.address.b[1];
+    return 0 == idx % ( 100 / percent );
+}
+
+template<class T, typename Size_type>
+static void test_05_erase_loop(T& data, const int percent,
+        std::enable_if_t< is_cow_type<T>::value, bool> = true )
+{
+    typename T::iterator it = data.begin(); // one copy_store, erase shifts all elements right of it
+    while( !it.is_end() ) {
+        if( erase_pred(*it, percent) ) {
+            it.erase();
+        } else {
+            ++it;
+        }
+    }
+    it.write_back();
+}
+
+template<class T, typename Size_type>
+static void test_05_erase_loop(T& data, const int percent,
+        std::enable_if_t< !is_cow_type<T>::value, bool> = true )
+{
+    for(Size_type i = data.size(); i-- > 0; ) {
+        if( erase_pred(data[i], percent) ) {
+            data.erase(data.begin() + i); // shifts all elements right of i
+        }
+    }
+}
+
+template<class T, typename Size_type>
+static void test_05_erase_if(T& data, const int percent,
+        std::enable_if_t< is_darray_type<T>::value, bool> = true )
+{
+    data.erase_if( [percent](const DataType01& e) -> bool { return erase_pred(e, percent); } );
+}
+
+template<class T, typename Size_type>
+static void test_05_erase_if(T& data, const int percent,
+        std::enable_if_t< !is_darray_type<T>::value, bool> = true )
+{
+    data.erase( std::remove_if(data.begin(), data.end(),
+                               [percent](const DataType01& e) -> bool { return erase_pred(e, percent); } ), data.end() );
+}
+
+template<class T, typename Size_type>
+static bool test_05_seq_fill_erase(const Size_type size0, const int percent, const bool use_erase_if) {
+    T data;
+    test_00_seq_fill<T, Size_type>(data, size0);
+    REQUIRE(data.size() == size0);
+
+    if( use_erase_if ) {
+        test_05_erase_if<T, Size_type>(data, percent);
+    } else {
+        test_05_erase_loop<T, Size_type>(data, percent);
+    }
+    const Size_type expected = size0 - ( size0 + ( 100 / percent ) - 1 ) / ( 100 / percent );
+    REQUIRE(data.size() == expected);
+    return data.size() == expected;
+}
+
+enum class byte_fill_mode : int { push_back, zero_fill, uninitialized };
+
+template<class T>
+static void test_06_fill_chunk(T& data, const uint8_t* chunk, const std::size_t chunk_size, const byte_fill_mode mode,
+        std::enable_if_t< is_darray_type<T>::value, bool> = true )
+{
+    switch( mode ) {
+        case byte_fill_mode::push_back:
+            for(std::size_t i=0; i<chunk_size; ++i) {
+                data.push_back( chunk[i] );
+            }
+            break;
+        case byte_fill_mode::zero_fill: {
+            // no zero-filled resize available
+            const uint8_t zero = 0;
+            for(std::size_t i=0; i<chunk_size; ++i) {
+                data.push_back( zero );
+            }
+            memcpy(data.data() + data.size() - chunk_size, chunk, chunk_size);
+            break;
+        }
+        case byte_fill_mode::uninitialized:
+            memcpy(data.append_uninitialized(chunk_size), chunk, chunk_size);
+            break;
+    }
+}
+
+template<class T>
+static void test_06_fill_chunk(T& data, const uint8_t* chunk, const std::size_t chunk_size, const byte_fill_mode mode,
+        std::enable_if_t< !is_darray_type<T>::value, bool> = true )
+{
+    if( byte_fill_mode::push_back == mode ) {
+        for(std::size_t i=0; i<chunk_size; ++i) {
+            data.push_back( chunk[i] );
+        }
+    } else {
+        const std::size_t size0 = data.size();
+        data.resize(size0 + chunk_size); // zero-fill
+        memcpy(data.data() + size0, chunk, chunk_size);
+    }
+}
+
+template<class T>
+static bool test_06_fill_bytes(const std::size_t total_size, const std::size_t chunk_size, const byte_fill_mode mode) {
+    static std::vector<uint8_t> chunk;
+    if( chunk.size() != chunk_size ) {
+        chunk.resize(chunk_size);
+        for(std::size_t i=0; i<chunk_size; ++i) {
+            chunk[i] = static_cast<uint8_t>(i);
+        }
+    }
+    T data;
+    for(std::size_t i=0; i<total_size; i+=chunk_size) {
+        test_06_fill_chunk(data, chunk.data(), chunk_size, mode);
+    }
+    REQUIRE(data.size() == total_size);
+    REQUIRE(data[total_size-1] == static_cast<uint8_t>(chunk_size-1));
+    return data.size() == total_size;
+}
+
+enum class cow_read_mode : int { snapshot, epoch_view };
+
+template<class T>
+static uint64_t test_07_read_once(const T& data, const cow_read_mode mode) {
+    if( cow_read_mode::snapshot == mode ) {
+        typename T::storage_ref_t store = data.snapshot();
+        return store->size() + (*store)[store->size()-1];
+    } else {
+        typename T::epoch_view_t view = data.epoch_view();
+        return view.size() + view[view.size()-1];
+    }
+}
+
+template<class T>
+static bool test_07_read_concurrent(const T& data, const int reader_count, const int reads_per_reader, const cow_read_mode mode) {
+    const uint64_t expected = data.size() + data.size() - 1;
+    std::vector<uint64_t> sums(static_cast<std::size_t>(reader_count), 0);
+    std::vector<std::thread> readers;
+    for(int r=0; r<reader_count; ++r) {
+        readers.push_back( std::thread( [&data, &sums, r, reads_per_reader, mode]() {
+            uint64_t sum = 0;
+            for(int i=0; i<reads_per_reader; ++i) {
+                sum += test_07_read_once(data, mode);
+            }
+            sums[static_cast<std::size_t>(r)] = sum;
+        } ) );
+    }
+    for(std::thread& t : readers) { t.join(); }
+    for(uint64_t sum : sums) {
+        REQUIRE( expected * static_cast<uint64_t>(reads_per_reader) == sum );
+    }
+    return true;
+}
+
+static bool dt01_equal(const DataType01& a, const DataType01& b) { return a == b; }
+
+template<class T>
+static bool test_08_update_percall(T& data, const std::size_t updates) {
+    const DataType01 first = *data.cbegin();
+    for(std::size_t i=0; i<updates; ++i) {
+        switch( i % 3 ) {
+            case 0: data.push_back( DataType01( static_cast<uint64_t>(i) ) ); break;
+            case 1: data.pop_back(); break;
+            default:
+                data.erase_matching( first, false, dt01_equal );
+                data.push_back( first );
+                break;
+        }
+    }
+    return data.size() > 0;
+}
+
+template<class T>
+static bool test_08_update_transaction(T& data, const std::size_t updates) {
+    const DataType01 first = *data.cbegin();
+    typename T::transaction_t tx = data.transaction();
+    for(std::size_t i=0; i<updates; ++i) {
+        switch( i % 3 ) {
+            case 0: tx->push_back( DataType01( static_cast<uint64_t>(i) ) ); break;
+            case 1: tx->pop_back(); break;
+            default:
+                tx->erase( std::find( tx->begin(), tx->end(), first ) );
+                tx->push_back( first );
+                break;
+        }
+    }
+    tx.commit();
+    return data.size() > 0;
+}
+
+template<class T>
+static bool test_08_update(const std::size_t size, const std::size_t updates, const bool transaction) {
+    T data;
+    for(std::size_t i=0; i<size; ++i) {
+        data.push_back( DataType01( static_cast<uint64_t>(i) ) );
+    }
+    const std::size_t exp_size = size + ( updates + 2 ) / 3 - ( updates + 1 ) / 3;
+    const bool res = transaction ? test_08_update_transaction(data, updates) : test_08_update_percall(data, updates);
+    REQUIRE( exp_size == data.size() );
+    return res;
+}
+
+template<class T>
+static bool test_09_steady_writes(const std::size_t size, const std::size_t writes, const typename T::size_type pool_size, const bool print) {
+    T data(size);
+    for(std::size_t i=0; i<size; ++i) {
+        data.push_back( static_cast<uint64_t>(i) );
+    }
+    data.set_store_pool(pool_size);
+    const std::size_t alloc_count0 = T::allocator_type::total_alloc_count;
+    for(std::size_t i=0; i<writes; ++i) {
+        data.pop_back();
+        data.push_back( static_cast<uint64_t>(size-1) );
+    }
+    REQUIRE( size == data.size() );
+    if( print ) {
+        printf("SteadyWrites size %zu, writes %zu, pool %zu: store allocations %zu, pool hits %zu, misses %zu\n",
+                size, writes, (std::size_t)pool_size, T::allocator_type::total_alloc_count - alloc_count0,
+                data.store_pool_hits(), data.store_pool_misses());
+    }
+    return data.size() == size;
+}
+
+static void test_10_set(jau::cow_darray<uint64_t>& data, const std::size_t i, const uint64_t value) {
+    jau::cow_darray<uint64_t>::transaction_t tx = data.transaction();
+    (*tx)[i] = value;
+    tx.commit();
+}
+static uint64_t test_10_get(const jau::cow_darray<uint64_t>& data, const std::size_t i) {
+    return (*data.snapshot())[i];
+}
+
+static void test_10_set(jau::cow_pvector<uint64_t>& data, const std::size_t i, const uint64_t value) {
+    data.set(i, value);
+}
+static uint64_t test_10_get(const jau::cow_pvector<uint64_t>& data, const std::size_t i) {
+    return data.get(i);
+}
+
+template<class T>
+static T test_10_create(const std::size_t size) {
+    typename T::storage_t store;
+    for(std::size_t i=0; i<size; ++i) {
+        store.push_back( static_cast<uint64_t>(i) );
+    }
+    return T(store);
+}
+
+template<class T>
+static bool test_10_update_single(T& data, const std::size_t updates) {
+    const std::size_t size = data.size();
+    for(std::size_t k=0; k<updates; ++k) {
+        const std::size_t i = ( k * 7919 ) % size;
+        test_10_set(data, i, static_cast<uint64_t>(k + size));
+        REQUIRE( k + size == test_10_get(data, i) );
+    }
+    REQUIRE( size == data.size() );
+    return data.size() == size;
+}
+
 /****************************************************************************************
  ****************************************************************************************/
 
@@ -597,6 +918,182 @@ static bool benchmark_fillunique_find_itr(const std::string& title_pre, const st
     return true;
 }
 
+template<class T, typename Size_type>
+static std::size_t footprint_fill_small_lists(const std::string& type_id, const Size_type size0) {
+    const Size_type list_count = 1000;
+    const std::size_t alloc_count = test_03_seq_fill_small_lists_footprint<T, Size_type>(list_count, size0);
+    printf("Mem: %s: %s lists x %s elements: %s allocations\n",
+            type_id.c_str(), to_decstring(list_count, ',', 5).c_str(), to_decstring(size0, ',', 1).c_str(),
+            to_decstring(alloc_count, ',', 5).c_str());
+    return alloc_count;
+}
+
+template<class T, typename Size_type>
+static bool benchmark_fill_small_lists(const std::string& title_pre) {
+    {
+        T data;
+        print_container_info(title_pre, data);
+    }
+    if( catch_auto_run ) {
+        test_03_seq_fill_small_lists<T, Size_type>(100, 8);
+        return true;
+    }
+    BENCHMARK(title_pre+" FillSmall_Lists 1000 x 2") {
+        return test_03_seq_fill_small_lists<T, Size_type>(1000, 2);
+    };
+    BENCHMARK(title_pre+" FillSmall_Lists 1000 x 4") {
+        return test_03_seq_fill_small_lists<T, Size_type>(1000, 4);
+    };
+    BENCHMARK(title_pre+" FillSmall_Lists 1000 x 8") {
+        return test_03_seq_fill_small_lists<T, Size_type>(1000, 8);
+    };
+    return true;
+}
+
+template<class T, typename Size_type>
+static bool benchmark_shared_fill_insert_erase(const std::string& title_pre) {
+    {
+        T data;
+        print_container_info(title_pre, data);
+    }
+    if( catch_perf_analysis ) {
+        BENCHMARK(title_pre+" FillInsErase_Shared 1000") {
+            return test_04_shared_fill_insert_erase<T, Size_type>(1000);
+        };
+        return true;
+    }
+    if( catch_auto_run ) {
+        test_04_shared_fill_insert_erase<T, Size_type>(50);
+        return true;
+    }
+    BENCHMARK(title_pre+" FillInsErase_Shared 50") {
+        return test_04_shared_fill_insert_erase<T, Size_type>(50);
+    };
+    BENCHMARK(title_pre+" FillInsErase_Shared 100") {
+        return test_04_shared_fill_insert_erase<T, Size_type>(100);
+    };
+    BENCHMARK(title_pre+" FillInsErase_Shared 1000") {
+        return test_04_shared_fill_insert_erase<T, Size_type>(1000);
+    };
+    return true;
+}
+
+template<class T, typename Size_type>
+static bool benchmark_fillseq_erase(const std::string& title_pre, const bool use_erase_if) {
+    {
+        T data;
+        print_container_info(title_pre, data);
+    }
+    if( catch_perf_analysis ) {
+        BENCHMARK(title_pre+" FillSeq_Erase 10k, 10%") {
+            return test_05_seq_fill_erase<T, Size_type>(10000, 10, use_erase_if);
+        };
+        BENCHMARK(title_pre+" FillSeq_Erase 10k, 50%") {
+            return test_05_seq_fill_erase<T, Size_type>(10000, 50, use_erase_if);
+        };
+        return true;
+    }
+    if( catch_auto_run ) {
+        test_05_seq_fill_erase<T, Size_type>(1000, 10, use_erase_if);
+        test_05_seq_fill_erase<T, Size_type>(1000, 50, use_erase_if);
+        return true;
+    }
+    BENCHMARK(title_pre+" FillSeq_Erase 10k, 10%") {
+        return test_05_seq_fill_erase<T, Size_type>(10000, 10, use_erase_if);
+    };
+    BENCHMARK(title_pre+" FillSeq_Erase 10k, 50%") {
+        return test_05_seq_fill_erase<T, Size_type>(10000, 50, use_erase_if);
+    };
+    return true;
+}
+
+template<class T>
+static bool benchmark_fill_bytes(const std::string& title_pre, const byte_fill_mode mode) {
+    if( catch_perf_analysis ) {
+        BENCHMARK(title_pre+" FillBytes 4MiB, 64KiB chunks") {
+            return test_06_fill_bytes<T>(4*1024*1024, 64*1024, mode);
+        };
+        return true;
+    }
+    if( catch_auto_run ) {
+        test_06_fill_bytes<T>(64*1024, 4*1024, mode);
+        return true;
+    }
+    BENCHMARK(title_pre+" FillBytes 4MiB, 64KiB chunks") {
+        return test_06_fill_bytes<T>(4*1024*1024, 64*1024, mode);
+    };
+    return true;
+}
+
+template<class T>
+static bool benchmark_read_concurrent(const std::string& title_pre, const cow_read_mode mode) {
+    T data;
+    for(uint64_t i=0; i<1000; ++i) {
+        data.push_back(i);
+    }
+    if( catch_auto_run ) {
+        test_07_read_concurrent<T>(data, 1, 1000, mode);
+        test_07_read_concurrent<T>(data, 4, 1000, mode);
+        return true;
+    }
+    for(int reader_count = 1; reader_count <= 32; reader_count *= 2) {
+        BENCHMARK(title_pre+" Read 10k/reader, readers "+std::to_string(reader_count)) {
+            return test_07_read_concurrent<T>(data, reader_count, 10000, mode);
+        };
+    }
+    return true;
+}
+
+template<class T>
+static bool benchmark_update(const std::string& title_pre, const bool transaction) {
+    if( catch_perf_analysis ) {
+        BENCHMARK(title_pre+" Update 100 of 1000") {
+            return test_08_update<T>(1000, 100, transaction);
+        };
+        return true;
+    }
+    if( catch_auto_run ) {
+        test_08_update<T>(100, 10, transaction);
+        return true;
+    }
+    BENCHMARK(title_pre+" Update 100 of 1000") {
+        return test_08_update<T>(1000, 100, transaction);
+    };
+    BENCHMARK(title_pre+" Update 1000 of 1000") {
+        return test_08_update<T>(1000, 1000, transaction);
+    };
+    return true;
+}
+
+template<class T>
+static bool benchmark_steady_writes(const std::string& title_pre, const typename T::size_type pool_size) {
+    if( catch_auto_run ) {
+        test_09_steady_writes<T>(100, 100, pool_size, true);
+        return true;
+    }
+    test_09_steady_writes<T>(1000, 1000, pool_size, true);
+    BENCHMARK(title_pre+" SteadyWrites 1000 of 1000") {
+        return test_09_steady_writes<T>(1000, 1000, pool_size, false);
+    };
+    return true;
+}
+
+template<class T>
+static bool benchmark_update_single(const std::string& title_pre) {
+    if( catch_auto_run ) {
+        T data = test_10_create<T>(1000);
+        test_10_update_single<T>(data, 100);
+        return true;
+    }
+    for(const std::size_t size : { 1000, 100000, 1000000 }) {
+        T data = test_10_create<T>(size);
+        BENCHMARK(title_pre+" UpdateSingle 1 of "+std::to_string(size)) {
+            return test_10_update_single<T>(data, 1);
+        };
+    }
+    return true;
+}
+
 /****************************************************************************************
  ****************************************************************************************/
 
@@ -695,3 +1192,123 @@ TEST_CASE( "Perf Test 02 - Fill Unique and List, empty and reserve", "[datatype]
 #endif
 }
 
+
+TEST_CASE( "Memory Footprint 02 - Fill Unique Small Lists", "[datatype][footprint][small]" ) {
+    if( catch_perf_analysis ) {
+        return;
+    }
+    typedef jau::darray<DataType01, counting_callocator<DataType01>, jau::nsize_t> darray_t;
+    typedef jau::small_darray<DataType01, 8, counting_callocator<DataType01>, jau::nsize_t> small_darray_t;
+    {
+        small_darray_t data;
+        print_container_info("small_darray_def_8", data);
+    }
+    for(jau::nsize_t size0 = 2; size0 <= 16; size0 *= 2) {
+        const std::size_t c_stdvec = footprint_fill_small_lists< std::vector<DataType01, counting_allocator<DataType01>>, std::size_t>("stdvec_def_empty_     ", size0);
+        const std::size_t c_darray = footprint_fill_small_lists< darray_t, jau::nsize_t>("darray_def_empty_     ", size0);
+        const std::size_t c_small  = footprint_fill_small_lists< small_darray_t, jau::nsize_t>("small_darray_def_8    ", size0);
+        REQUIRE( 0 < c_stdvec );
+        REQUIRE( 0 < c_darray );
+        if( size0 <= small_darray_t::inline_capacity ) {
+            REQUIRE( 0 == c_small );
+        } else {
+            REQUIRE( c_small <= c_darray );
+        }
+    }
+}
+
+TEST_CASE( "Perf Test 03 - Fill Unique Small Lists", "[datatype][unique][small]" ) {
+    if( catch_perf_analysis ) {
+        benchmark_fill_small_lists< jau::darray<DataType01, jau::callocator<DataType01>, jau::nsize_t>, jau::nsize_t>("JAU_DArray_def_empty_itr");
+        benchmark_fill_small_lists< jau::small_darray<DataType01, 8, jau::callocator<DataType01>, jau::nsize_t>, jau::nsize_t>("JAU_SDArray_def_8_itr");
+        return;
+    }
+    benchmark_fill_small_lists< std::vector<DataType01, std::allocator<DataType01>>,                        std::size_t>("STD_Vector_def_empty_itr");
+    benchmark_fill_small_lists< jau::darray<DataType01, jau::callocator<DataType01>, jau::nsize_t>,         jau::nsize_t>("JAU_DArray_def_empty_itr");
+    benchmark_fill_small_lists< jau::darray<DataType01, jau::callocator<DataType01>, jau::nsize_t, true, true>, jau::nsize_t>("JAU_DArray_mmm_empty_itr");
+    benchmark_fill_small_lists< jau::small_darray<DataType01, 8, jau::callocator<DataType01>, jau::nsize_t>, jau::nsize_t>("JAU_SDArray_def_8_itr");
+    benchmark_fill_small_lists< jau::small_darray<DataType01, 8, jau::callocator<DataType01>, jau::nsize_t, true, true>, jau::nsize_t>("JAU_SDArray_mmm_8_itr");
+}
+
+TEST_CASE( "Perf Test 04 - Fill, Insert and Erase Shared Pointer, relocatable", "[datatype][shared]" ) {
+    typedef std::shared_ptr<DataType01> SharedDataType01;
+    REQUIRE( true == jau::darray<SharedDataType01>::uses_memmove );
+
+    if( catch_perf_analysis ) {
+        benchmark_shared_fill_insert_erase< jau::darray<SharedDataType01, jau::callocator<SharedDataType01>, jau::nsize_t, false, true>, jau::nsize_t>("JAU_DArray_shared_move_itr");
+        benchmark_shared_fill_insert_erase< jau::darray<SharedDataType01>, jau::nsize_t>("JAU_DArray_shared_reloc_itr");
+        return;
+    }
+    benchmark_shared_fill_insert_erase< std::vector<SharedDataType01, std::allocator<SharedDataType01>>,                              std::size_t>("STD_Vector_shared_itr");
+    benchmark_shared_fill_insert_erase< jau::darray<SharedDataType01, jau::callocator<SharedDataType01>, jau::nsize_t, false, true>, jau::nsize_t>("JAU_DArray_shared_move_itr");
+    benchmark_shared_fill_insert_erase< jau::darray<SharedDataType01>,                                                              jau::nsize_t>("JAU_DArray_shared_reloc_itr");
+}
+
+TEST_CASE( "Perf Test 05 - Fill Sequential and Erase 10% and 50%, loop and erase_if", "[datatype][erase]" ) {
+    if( catch_perf_analysis ) {
+        benchmark_fillseq_erase< jau::darray<DataType01, jau::callocator<DataType01>, jau::nsize_t>,     jau::nsize_t>("JAU_DArray_def_erase_if", true);
+        benchmark_fillseq_erase< jau::cow_darray<DataType01, jau::callocator<DataType01>, jau::nsize_t>, jau::nsize_t>("COW_DArray_def_erase_if", true);
+        return;
+    }
+    benchmark_fillseq_erase< std::vector<DataType01, std::allocator<DataType01>>,                            std::size_t>("STD_Vector_def_erase_loop", false);
+    benchmark_fillseq_erase< std::vector<DataType01, std::allocator<DataType01>>,                            std::size_t>("STD_Vector_def_remove_if", true);
+
+    benchmark_fillseq_erase< jau::darray<DataType01, jau::callocator<DataType01>, jau::nsize_t>,             jau::nsize_t>("JAU_DArray_def_erase_loop", false);
+    benchmark_fillseq_erase< jau::darray<DataType01, jau::callocator<DataType01>, jau::nsize_t>,             jau::nsize_t>("JAU_DArray_def_erase_if", true);
+    benchmark_fillseq_erase< jau::darray<DataType01, jau::callocator<DataType01>, jau::nsize_t, true, true>, jau::nsize_t>("JAU_DArray_mmm_erase_loop", false);
+    benchmark_fillseq_erase< jau::darray<DataType01, jau::callocator<DataType01>, jau::nsize_t, true, true>, jau::nsize_t>("JAU_DArray_mmm_erase_if", true);
+
+    benchmark_fillseq_erase< jau::cow_darray<DataType01, jau::callocator<DataType01>, jau::nsize_t>,         jau::nsize_t>("COW_DArray_def_erase_loop", false);
+    benchmark_fillseq_erase< jau::cow_darray<DataType01, jau::callocator<DataType01>, jau::nsize_t>,         jau::nsize_t>("COW_DArray_def_erase_if", true);
+}
+
+TEST_CASE( "Perf Test 06 - Fill Byte Buffer, push_back, zero-fill and uninitialized", "[datatype][bytes]" ) {
+    if( catch_perf_analysis ) {
+        benchmark_fill_bytes< jau::darray<uint8_t> >("JAU_DArray_u8_uninit", byte_fill_mode::uninitialized);
+        return;
+    }
+    benchmark_fill_bytes< std::vector<uint8_t> >("STD_Vector_u8_push_back", byte_fill_mode::push_back);
+    benchmark_fill_bytes< std::vector<uint8_t> >("STD_Vector_u8_zero_fill", byte_fill_mode::zero_fill);
+    benchmark_fill_bytes< jau::darray<uint8_t> >("JAU_DArray_u8_push_back", byte_fill_mode::push_back);
+    benchmark_fill_bytes< jau::darray<uint8_t> >("JAU_DArray_u8_zero_fill", byte_fill_mode::zero_fill);
+    benchmark_fill_bytes< jau::darray<uint8_t> >("JAU_DArray_u8_uninit", byte_fill_mode::uninitialized);
+}
+
+TEST_CASE( "Perf Test 07 - Concurrent Readers, shared_ptr snapshot and epoch_view", "[datatype][cow][concurrent]" ) {
+    if( catch_perf_analysis ) {
+        benchmark_read_concurrent< jau::cow_darray<uint64_t> >("COW_DArray_u64_epoch_view", cow_read_mode::epoch_view);
+        return;
+    }
+    benchmark_read_concurrent< jau::cow_darray<uint64_t> >("COW_DArray_u64_snapshot", cow_read_mode::snapshot);
+    benchmark_read_concurrent< jau::cow_darray<uint64_t> >("COW_DArray_u64_epoch_view", cow_read_mode::epoch_view);
+    benchmark_read_concurrent< jau::cow_vector<uint64_t> >("COW_Vector_u64_snapshot", cow_read_mode::snapshot);
+    benchmark_read_concurrent< jau::cow_vector<uint64_t> >("COW_Vector_u64_epoch_view", cow_read_mode::epoch_view);
+}
+
+TEST_CASE( "Perf Test 08 - Update Sequential, per call and transaction", "[datatype][cow][transaction]" ) {
+    if( catch_perf_analysis ) {
+        benchmark_update< jau::cow_darray<DataType01> >("COW_DArray_def_transaction", true);
+        return;
+    }
+    benchmark_update< jau::cow_darray<DataType01> >("COW_DArray_def_percall", false);
+    benchmark_update< jau::cow_darray<DataType01> >("COW_DArray_def_transaction", true);
+}
+
+TEST_CASE( "Perf Test 09 - Steady Writes, w/o and w/ store pool", "[datatype][cow][pool]" ) {
+    typedef jau::cow_darray<uint64_t, jau::counting_callocator<uint64_t>> cow_t;
+    if( catch_perf_analysis ) {
+        benchmark_steady_writes< cow_t >("COW_DArray_u64_cnt_pool2", 2);
+        return;
+    }
+    benchmark_steady_writes< cow_t >("COW_DArray_u64_cnt_nopool", 0);
+    benchmark_steady_writes< cow_t >("COW_DArray_u64_cnt_pool2", 2);
+}
+
+TEST_CASE( "Perf Test 10 - Update Single Element, cow_darray and cow_pvector", "[datatype][cow][pvector]" ) {
+    if( catch_perf_analysis ) {
+        benchmark_update_single< jau::cow_pvector<uint64_t> >("COW_PVector_u64");
+        return;
+    }
+    benchmark_update_single< jau::cow_darray<uint64_t> >("COW_DArray_u64");
+    benchmark_update_single< jau::cow_pvector<uint64_t> >("COW_PVector_u64");
+}
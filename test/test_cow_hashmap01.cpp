@@ -0,0 +1,153 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+#include <vector>
+#include <thread>
+
+#define CATCH_CONFIG_RUNNER
+// #define CATCH_CONFIG_MAIN
+#include <catch2/catch_amalgamated.hpp>
+#include <jau/test/catch2_ext.hpp>
+
+#include "test_datatype01.hpp"
+
+#include <jau/basic_types.hpp>
+#include <jau/cow_hashmap.hpp>
+
+/**
+ * Test general use of jau::cow_hashmap, incl. concurrent lock-free readers.
+ */
+using namespace jau;
+
+static uint64_t makeUInt64(int i) { return static_cast<uint64_t>(i); }
+static DataType01 makeDataType01(int i) { return DataType01( static_cast<uint64_t>(i) ); }
+
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+
+TEST_CASE( "JAU CoW_HashMap Test 01 - jau::cow_hashmap", "[datatype][jau][cow][hashmap]" ) {
+    typedef jau::cow_hashmap<Addr48Bit, DataType01> map_t;
+    REQUIRE( true == jau::has_hash_code_v<Addr48Bit> );
+    REQUIRE( true == jau::has_hash_code_v<DataType01> );
+    REQUIRE( false == jau::has_hash_code_v<uint64_t> );
+    {
+        map_t data;
+        REQUIRE( data.empty() );
+        REQUIRE( map_t::stripe_count == data.bucket_count() );
+        for(int i=0; i<1000; ++i) {
+            REQUIRE( true == data.insert( std::make_pair( Addr48Bit( makeUInt64(i) ), makeDataType01(i) ) ) );
+        }
+        REQUIRE( 1000 == data.size() );
+        REQUIRE( 1000 <= data.bucket_count() ); // grown
+        REQUIRE( false == data.insert( std::make_pair( Addr48Bit( makeUInt64(42) ), makeDataType01(0) ) ) );
+        {
+            DataType01 v;
+            REQUIRE( true == data.get( Addr48Bit( makeUInt64(42) ), v ) );
+            REQUIRE( makeDataType01(42) == v );
+            REQUIRE( false == data.get( Addr48Bit( makeUInt64(1000) ), v ) );
+            REQUIRE( false == data.contains( Addr48Bit( makeUInt64(1000) ) ) );
+        }
+        REQUIRE( false == data.insert_or_assign( Addr48Bit( makeUInt64(42) ), makeDataType01(4242) ) );
+        REQUIRE( true == data.insert_or_assign( Addr48Bit( makeUInt64(1000) ), makeDataType01(1000) ) );
+        {
+            DataType01 v;
+            REQUIRE( true == data.get( Addr48Bit( makeUInt64(42) ), v ) );
+            REQUIRE( makeDataType01(4242) == v );
+        }
+        REQUIRE( 1001 == data.size() );
+        REQUIRE( 1 == data.erase( Addr48Bit( makeUInt64(1000) ) ) );
+        REQUIRE( 0 == data.erase( Addr48Bit( makeUInt64(1000) ) ) );
+        REQUIRE( 1000 == data.size() );
+
+        REQUIRE( 500 == data.erase_if( [](const map_t::value_type& e) -> bool { return 0 == e.first.b[0] % 2; } ) );
+        REQUIRE( 500 == data.size() );
+        {
+            std::size_t n = 0;
+            data.for_each( [&n](const map_t::value_type& e) { ++n; REQUIRE( 1 == e.first.b[0] % 2 ); } );
+            REQUIRE( 500 == n );
+        }
+        const map_t::size_type buckets = data.bucket_count();
+        data.clear();
+        REQUIRE( data.empty() );
+        REQUIRE( buckets == data.bucket_count() );
+        REQUIRE( false == data.contains( Addr48Bit( makeUInt64(1) ) ) );
+        data.reserve( 4 * buckets );
+        REQUIRE( 4 * buckets == data.bucket_count() );
+    }
+    {
+        // std::hash fallback and initializer list
+        jau::cow_hashmap<uint64_t, uint64_t> data { { 1, 10 }, { 2, 20 }, { 1, 30 } };
+        REQUIRE( 2 == data.size() );
+        uint64_t v = 0;
+        REQUIRE( true == data.get(1, v) );
+        REQUIRE( 10 == v );
+    }
+    {
+        // concurrent lock-free readers while writers insert and erase on distinct stripes
+        map_t data;
+        for(int i=0; i<500; ++i) {
+            data.insert( std::make_pair( Addr48Bit( makeUInt64(i) ), makeDataType01(i) ) );
+        }
+        const int reader_count = 4;
+        std::vector<int> errors(reader_count, 0);
+        jau::sc_atomic_bool done(false);
+        std::vector<std::thread> readers;
+        for(int r=0; r<reader_count; ++r) {
+            readers.push_back( std::thread( [&data, &errors, &done, r]() {
+                while( !done ) {
+                    for(int i=0; i<500; ++i) {
+                        DataType01 v;
+                        if( !data.get( Addr48Bit( makeUInt64(i) ), v ) || !( makeDataType01(i) == v ) ) {
+                            ++errors[static_cast<std::size_t>(r)];
+                        }
+                    }
+                }
+            } ) );
+        }
+        std::vector<std::thread> writers;
+        for(int w=0; w<2; ++w) {
+            writers.push_back( std::thread( [&data, w]() {
+                for(int k=0; k<20; ++k) {
+                    for(int i=1000+w*1000; i<1000+w*1000+200; ++i) {
+                        data.insert( std::make_pair( Addr48Bit( makeUInt64(i) ), makeDataType01(i) ) );
+                    }
+                    for(int i=1000+w*1000; i<1000+w*1000+200; ++i) {
+                        data.erase( Addr48Bit( makeUInt64(i) ) );
+                    }
+                }
+            } ) );
+        }
+        for(std::thread& t : writers) { t.join(); }
+        done = true;
+        for(std::thread& t : readers) { t.join(); }
+        for(int e : errors) {
+            REQUIRE( 0 == e );
+        }
+        REQUIRE( 500 == data.size() );
+    }
+    jau::epoch_domain::get().reclaim();
+}
@@ -137,6 +137,16 @@ inline bool operator==(const Addr48Bit& lhs, const Addr48Bit& rhs) noexcept {
 inline bool operator!=(const Addr48Bit& lhs, const Addr48Bit& rhs) noexcept
 { return !(lhs == rhs); }
 
+/** Orders by the 48-bit value, i.e. b[5] being the most significant byte. */
+inline bool operator<(const Addr48Bit& lhs, const Addr48Bit& rhs) noexcept {
+    for(int i=5; i>=0; --i) {
+        if( lhs.b[i] != rhs.b[i] ) {
+            return lhs.b[i] < rhs.b[i];
+        }
+    }
+    return false;
+}
+
 
 class DataType01 {
     public:
@@ -214,6 +224,13 @@ inline bool operator==(const DataType01& lhs, const DataType01& rhs) noexcept {
 inline bool operator!=(const DataType01& lhs, const DataType01& rhs) noexcept
 { return !(lhs == rhs); }
 
+inline bool operator<(const DataType01& lhs, const DataType01& rhs) noexcept {
+    if( lhs.address != rhs.address ) {
+        return lhs.address < rhs.address;
+    }
+    return lhs.type < rhs.type;
+}
+
 // injecting specialization of std::hash to namespace std of our types above
 namespace std
 {
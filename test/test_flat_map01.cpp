@@ -0,0 +1,115 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+#include <vector>
+
+#define CATCH_CONFIG_RUNNER
+// #define CATCH_CONFIG_MAIN
+#include <catch2/catch_amalgamated.hpp>
+#include <jau/test/catch2_ext.hpp>
+
+#include "test_datatype01.hpp"
+
+#include <jau/basic_types.hpp>
+#include <jau/flat_map.hpp>
+#include <jau/cow_flat_map.hpp>
+
+/**
+ * Test general use of the darray based jau::flat_map and jau::cow_flat_map.
+ */
+using namespace jau;
+
+static uint64_t makeUInt64(int i) { return static_cast<uint64_t>(i); }
+static DataType01 makeDataType01(int i) { return DataType01( static_cast<uint64_t>(i) ); }
+
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+
+TEST_CASE( "JAU FlatMap Test 01 - jau::flat_map and jau::cow_flat_map", "[datatype][jau][darray][flat_map]" ) {
+    {
+        jau::flat_map<uint64_t, DataType01> data;
+        for(int i=99; i>=0; --i) {
+            REQUIRE( true == data.try_emplace( makeUInt64(i), makeUInt64(i) ).second );
+        }
+        REQUIRE( 100 == data.size() );
+        REQUIRE( false == data.try_emplace( makeUInt64(42), makeUInt64(0) ).second );
+        REQUIRE( makeDataType01(42) == data.at( makeUInt64(42) ) );
+        REQUIRE( false == data.insert( std::make_pair( makeUInt64(42), makeDataType01(0) ) ).second );
+        REQUIRE( makeDataType01(42) == data.at( makeUInt64(42) ) );
+        REQUIRE( false == data.insert_or_assign( makeUInt64(42), makeDataType01(0) ).second );
+        REQUIRE( makeDataType01(0) == data.at( makeUInt64(42) ) );
+        data[ makeUInt64(42) ] = makeDataType01(42);
+        REQUIRE( makeDataType01(42) == data.at( makeUInt64(42) ) );
+        REQUIRE( 100 == data.size() );
+
+        REQUIRE( DataType01() == data[ makeUInt64(200) ] );
+        REQUIRE( 101 == data.size() );
+        REQUIRE( 1 == data.erase( makeUInt64(200) ) );
+        REQUIRE_THROWS_AS( data.at( makeUInt64(200) ), jau::IllegalArgumentException );
+
+        for(int i=0; i<100; ++i) {
+            REQUIRE( makeUInt64(i) == data.cbegin()[i].first );
+            REQUIRE( makeDataType01(i) == data.find( makeUInt64(i) )->second );
+        }
+
+        // bulk insert-merge retains existing elements and the first of duplicates
+        std::vector<std::pair<uint64_t, DataType01>> bulk;
+        for(int i=149; i>=90; --i) { bulk.push_back( std::make_pair( makeUInt64(i), makeDataType01(0) ) ); }
+        bulk.push_back( std::make_pair( makeUInt64(120), makeDataType01(1) ) );
+        REQUIRE( 50 == data.insert(bulk.cbegin(), bulk.cend()) );
+        REQUIRE( 150 == data.size() );
+        REQUIRE( makeDataType01(90) == data.at( makeUInt64(90) ) );
+        REQUIRE( makeDataType01(0) == data.at( makeUInt64(120) ) );
+        REQUIRE( 50 == data.erase_if( [](const std::pair<uint64_t, DataType01>& e) -> bool { return 100 <= e.first; } ) );
+        REQUIRE( 100 == data.size() );
+    }
+    {
+        jau::cow_flat_map<uint64_t, DataType01> data;
+        for(int i=0; i<100; ++i) {
+            REQUIRE( true == data.insert( std::make_pair( makeUInt64(i), makeDataType01(i) ) ) );
+        }
+        std::shared_ptr<jau::flat_map<uint64_t, DataType01>> snap0 = data.snapshot();
+        REQUIRE( false == data.insert( std::make_pair( makeUInt64(42), makeDataType01(0) ) ) );
+        REQUIRE( 0 == data.erase( makeUInt64(100) ) );
+        REQUIRE( snap0 == data.snapshot() );
+
+        DataType01 res;
+        REQUIRE( true == data.get( makeUInt64(42), res ) );
+        REQUIRE( makeDataType01(42) == res );
+        REQUIRE( false == data.get( makeUInt64(100), res ) );
+
+        REQUIRE( false == data.insert_or_assign( makeUInt64(42), makeDataType01(0) ) );
+        REQUIRE( snap0 != data.snapshot() );
+        REQUIRE( true == data.get( makeUInt64(42), res ) );
+        REQUIRE( makeDataType01(0) == res );
+        REQUIRE( makeDataType01(42) == snap0->at( makeUInt64(42) ) );
+        REQUIRE( true == data.contains( makeUInt64(99) ) );
+        REQUIRE( 1 == data.erase( makeUInt64(99) ) );
+        REQUIRE( false == data.contains( makeUInt64(99) ) );
+        REQUIRE( 99 == data.size() );
+    }
+}
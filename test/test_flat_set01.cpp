@@ -0,0 +1,175 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#define CATCH_CONFIG_RUNNER
+// #define CATCH_CONFIG_MAIN
+#include <catch2/catch_amalgamated.hpp>
+#include <jau/test/catch2_ext.hpp>
+
+#include "test_datatype01.hpp"
+
+#include <jau/basic_algos.hpp>
+#include <jau/basic_types.hpp>
+#include <jau/darray.hpp>
+#include <jau/flat_set.hpp>
+#include <jau/cow_flat_set.hpp>
+
+/**
+ * Test general use of the darray based jau::flat_set and jau::cow_flat_set.
+ */
+using namespace jau;
+
+static DataType01 makeDataType01(int i) { return DataType01( static_cast<uint64_t>(i) ); }
+
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+
+TEST_CASE( "JAU FlatSet Test 01 - jau::lower_bound and jau::upper_bound", "[datatype][jau][darray][flat_set]" ) {
+    jau::darray<int> data;
+    for(int n=0; n<40; ++n) {
+        // sorted w/ duplicates
+        REQUIRE( std::is_sorted(data.cbegin(), data.cend()) );
+        for(int v=-1; v<=n/2+1; ++v) {
+            REQUIRE( std::lower_bound(data.cbegin(), data.cend(), v) == jau::lower_bound(data.cbegin(), data.cend(), v, std::less<int>()) );
+            REQUIRE( std::upper_bound(data.cbegin(), data.cend(), v) == jau::upper_bound(data.cbegin(), data.cend(), v, std::less<int>()) );
+        }
+        data.push_back( n/2 );
+    }
+}
+
+TEST_CASE( "JAU FlatSet Test 02 - jau::flat_set and jau::cow_flat_set", "[datatype][jau][darray][flat_set]" ) {
+    {
+        jau::flat_set<DataType01> data;
+        std::vector<int> order;
+        for(int i=0; i<100; ++i) { order.push_back(i); }
+        std::mt19937 rng(42);
+        std::shuffle(order.begin(), order.end(), rng);
+
+        for(int i : order) {
+            REQUIRE( true == data.insert( makeDataType01(i) ).second );
+        }
+        REQUIRE( 100 == data.size() );
+        REQUIRE( false == data.insert( makeDataType01(42) ).second );
+        REQUIRE( false == data.emplace( static_cast<uint64_t>(42) ).second );
+        REQUIRE( 100 == data.size() );
+        REQUIRE( std::is_sorted(data.cbegin(), data.cend()) );
+        for(int i=0; i<100; ++i) {
+            REQUIRE( makeDataType01(i) == data[i] );
+            REQUIRE( data.contains( makeDataType01(i) ) );
+            REQUIRE( data.cbegin() + i == data.find( makeDataType01(i) ) );
+        }
+        REQUIRE( data.cend() == data.find( makeDataType01(100) ) );
+        REQUIRE( 0 == data.count( makeDataType01(100) ) );
+
+        // bulk insert-merge: [50, 150) w/ duplicates, 50 new
+        std::vector<DataType01> bulk;
+        for(int i=149; i>=50; --i) { bulk.push_back( makeDataType01(i) ); }
+        bulk.push_back( makeDataType01(120) );
+        REQUIRE( 50 == data.insert(bulk.cbegin(), bulk.cend()) );
+        REQUIRE( 150 == data.size() );
+        REQUIRE( std::is_sorted(data.cbegin(), data.cend()) );
+        REQUIRE( makeDataType01(149) == data[149] );
+        REQUIRE( 0 == data.insert(bulk.cbegin(), bulk.cend()) );
+
+        auto range = data.equal_range( makeDataType01(120) );
+        REQUIRE( data.cbegin() + 120 == range.first );
+        REQUIRE( data.cbegin() + 121 == range.second );
+        REQUIRE( data.cbegin() + 121 == data.upper_bound( makeDataType01(120) ) );
+
+        REQUIRE( 1 == data.erase( makeDataType01(120) ) );
+        REQUIRE( 0 == data.erase( makeDataType01(120) ) );
+        REQUIRE( data.cbegin() + 120 == data.lower_bound( makeDataType01(120) ) );
+        REQUIRE( makeDataType01(121) == *data.lower_bound( makeDataType01(120) ) );
+        REQUIRE( 74 == data.erase_if( [](const DataType01& e) -> bool { return 0 == e.address.b[0] % 2; } ) );
+        REQUIRE( 75 == data.size() );
+        REQUIRE( makeDataType01(1) == data[0] );
+        REQUIRE( makeDataType01(149) == data[74] );
+
+        jau::flat_set<DataType01> data2 { makeDataType01(3), makeDataType01(1), makeDataType01(3) };
+        REQUIRE( 2 == data2.size() );
+        REQUIRE( makeDataType01(1) == data2[0] );
+        REQUIRE( data2 != data );
+        printf("FlatSet: %s\n", data2.toString().c_str());
+    }
+    {
+        jau::cow_flat_set<DataType01> data;
+        for(int i=99; i>=0; --i) {
+            REQUIRE( true == data.insert( makeDataType01(i) ) );
+        }
+        REQUIRE( 100 == data.size() );
+
+        // no copy-on-write if not modified
+        std::shared_ptr<jau::flat_set<DataType01>> snap0 = data.snapshot();
+        REQUIRE( false == data.insert( makeDataType01(42) ) );
+        REQUIRE( 0 == data.erase( makeDataType01(100) ) );
+        REQUIRE( 0 == data.erase_if( [](const DataType01& e) -> bool { return 200 == e.address.b[0]; } ) );
+        REQUIRE( snap0 == data.snapshot() );
+
+        std::vector<DataType01> bulk;
+        for(int i=0; i<150; ++i) { bulk.push_back( makeDataType01(i) ); }
+        REQUIRE( 50 == data.insert(bulk.cbegin(), bulk.cend()) );
+        REQUIRE( snap0 != data.snapshot() );
+        REQUIRE( 100 == snap0->size() );
+        REQUIRE( 150 == data.size() );
+        REQUIRE( data.contains( makeDataType01(149) ) );
+        REQUIRE( false == snap0->contains( makeDataType01(149) ) );
+
+        REQUIRE( 1 == data.erase( makeDataType01(149) ) );
+        REQUIRE( 75 == data.erase_if( [](const DataType01& e) -> bool { return 0 == e.address.b[0] % 2; } ) );
+        REQUIRE( 74 == data.size() );
+        data.clear();
+        REQUIRE( data.empty() );
+        REQUIRE( 100 == snap0->size() );
+    }
+    {
+        // equivalent but distinguishable elements: keep the first occurrence, retain existing
+        typedef std::pair<int, int> elem_t; // key, tag
+        struct KeyLess {
+            bool operator()(const elem_t& a, const elem_t& b) const noexcept { return a.first < b.first; }
+        };
+        std::vector<elem_t> bulk;
+        for(int tag=0; tag<4; ++tag) {
+            for(int key=31; key>=0; --key) { bulk.push_back( elem_t(key, tag) ); }
+        }
+        jau::flat_set<elem_t, KeyLess> data { elem_t(5, 100) };
+        REQUIRE( 31 == data.insert(bulk.cbegin(), bulk.cend()) );
+        REQUIRE( 32 == data.size() );
+        for(int key=0; key<32; ++key) {
+            REQUIRE( key == data[key].first );
+            REQUIRE( ( 5 == key ? 100 : 0 ) == data[key].second );
+        }
+
+        jau::flat_set<elem_t, KeyLess> data2 { elem_t(1, 1), elem_t(0, 1), elem_t(1, 2), elem_t(0, 2) };
+        REQUIRE( 2 == data2.size() );
+        REQUIRE( elem_t(0, 1) == data2[0] );
+        REQUIRE( elem_t(1, 1) == data2[1] );
+    }
+}
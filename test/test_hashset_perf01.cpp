@@ -28,6 +28,8 @@
 #include <random>
 #include <vector>
 #include <unordered_set>
+#include <thread>
+#include <mutex>
 
 #define CATCH_CONFIG_RUNNER
 // #define CATCH_CONFIG_MAIN
@@ -44,6 +46,9 @@
 #include <jau/darray.hpp>
 #include <jau/cow_darray.hpp>
 #include <jau/cow_vector.hpp>
+#include <jau/flat_set.hpp>
+#include <jau/cow_flat_set.hpp>
+#include <jau/cow_hashmap.hpp>
 
 using namespace jau;
 
@@ -148,6 +153,54 @@ static void test_00_seq_fill_unique_hash(T& data, const std::size_t size) {
     REQUIRE(fi == size);
 }
 
+template<class T>
+static void test_00_seq_find_flat(T& data) {
+    Addr48Bit a0(start_addr);
+    const std::size_t size = data.size();
+    std::size_t fi = 0, i=0;
+
+    for(; i<size && a0.next(); ++i) {
+        DataType01 elem(a0, static_cast<uint8_t>(1));
+        if( data.contains(elem) ) {
+            ++fi;
+        }
+    }
+    REQUIRE(fi == i);
+}
+
+static bool is_inserted(const bool res) { return res; }
+
+template<class I>
+static bool is_inserted(const std::pair<I, bool>& res) { return res.second; }
+
+template<class T>
+static void test_00_seq_fill_unique_flat(T& data, const std::size_t size) {
+    Addr48Bit a0(start_addr);
+    std::size_t i=0, fi=0;
+
+    for(; i<size && a0.next(); ++i) {
+        if( is_inserted( data.emplace(a0, static_cast<uint8_t>(1)) ) ) {
+            ++fi;
+        }
+    }
+    REQUIRE(i == data.size());
+    REQUIRE(fi == size);
+}
+
+template<class T>
+static void test_00_seq_fill_bulk_flat(T& data, const std::size_t size) {
+    jau::darray<DataType01> elems(size);
+    Addr48Bit a0(start_addr);
+    std::size_t i=0;
+
+    for(; i<size && a0.next(); ++i) {
+        elems.emplace_back( a0, static_cast<uint8_t>(1) );
+    }
+    const std::size_t fi = data.insert(elems.cbegin(), elems.cend());
+    REQUIRE(i == data.size());
+    REQUIRE(fi == size);
+}
+
 template<class T>
 static void print_mem(const std::string& pre, const T& data) {
     std::size_t bytes_element = sizeof(DataType01);
@@ -237,6 +290,25 @@ static bool test_01_seq_fill_list_hash(const std::string& type_id, const std::si
     return data.size() == 0;
 }
 
+template<class T>
+static bool test_01_seq_fill_list_flat(const std::string& type_id, const std::size_t size0, const bool do_print_mem) {
+    T data;
+    REQUIRE(0 == data.get_allocator().memory_usage);
+    REQUIRE(data.size() == 0);
+
+    test_00_seq_fill_unique_flat(data, size0);
+    REQUIRE(0 != data.get_allocator().memory_usage);
+    REQUIRE(data.size() == size0);
+
+    test_00_list_itr<T>(data);
+    REQUIRE(data.size() == size0);
+    if( do_print_mem ) { print_mem(type_id+" 01 (full_)", data); }
+
+    data.clear();
+    REQUIRE(data.size() == 0);
+    return data.size() == 0;
+}
+
 template<class T, typename Size_type>
 static bool test_02_seq_fillunique_find_itr(const std::string& type_id, const Size_type size0, const Size_type reserve0) {
     (void)type_id;
@@ -284,6 +356,126 @@ static bool test_02_seq_fillunique_find_hash(const std::string& type_id, const s
     return data.size() == 0;
 }
 
+template<class T>
+static bool test_02_seq_fillunique_find_flat(const std::string& type_id, const std::size_t size0, const bool bulk) {
+    (void)type_id;
+    T data;
+    REQUIRE(data.size() == 0);
+
+    if( bulk ) {
+        test_00_seq_fill_bulk_flat(data, size0);
+    } else {
+        test_00_seq_fill_unique_flat(data, size0);
+    }
+    REQUIRE(data.size() == size0);
+
+    test_00_seq_find_flat(data);
+    REQUIRE(data.size() == size0);
+
+    data.clear();
+    REQUIRE(data.size() == 0);
+    return data.size() == 0;
+}
+
+/** std::unordered_set guarded by a mutex, the blocking reference for concurrent lookups */
+class locked_hashset {
+    private:
+        mutable std::mutex mtx;
+        std::unordered_set<DataType01> set;
+
+    public:
+        bool insert(const DataType01& x) {
+            std::lock_guard<std::mutex> lock(mtx);
+            return set.insert(x).second;
+        }
+        bool contains(const DataType01& x) const {
+            std::lock_guard<std::mutex> lock(mtx);
+            return set.find(x) != set.end();
+        }
+        std::size_t erase(const DataType01& x) {
+            std::lock_guard<std::mutex> lock(mtx);
+            return set.erase(x);
+        }
+        std::size_t size() const {
+            std::lock_guard<std::mutex> lock(mtx);
+            return set.size();
+        }
+};
+
+typedef jau::cow_hashmap<Addr48Bit, DataType01> DataType01Map;
+
+static void test_03_add(DataType01Map& data, const DataType01& elem) { data.insert( std::make_pair( elem.address, elem ) ); }
+static void test_03_add(jau::cow_flat_set<DataType01>& data, const DataType01& elem) { data.insert(elem); }
+static void test_03_add(jau::cow_darray<DataType01>& data, const DataType01& elem) { data.push_back(elem); }
+static void test_03_add(locked_hashset& data, const DataType01& elem) { data.insert(elem); }
+
+static bool test_03_contains(const DataType01Map& data, const DataType01& elem) { return data.contains(elem.address); }
+static bool test_03_contains(const jau::cow_flat_set<DataType01>& data, const DataType01& elem) { return data.contains(elem); }
+static bool test_03_contains(const jau::cow_darray<DataType01>& data, const DataType01& elem) { return nullptr != jau::find_const(data, elem); }
+static bool test_03_contains(const locked_hashset& data, const DataType01& elem) { return data.contains(elem); }
+
+template<class T>
+static void test_03_fill(T& data, const std::size_t size) {
+    Addr48Bit a0(start_addr);
+    for(std::size_t i=0; i<size && a0.next(); ++i) {
+        test_03_add(data, DataType01(a0, static_cast<uint8_t>(1)));
+    }
+}
+
+template<class T>
+static bool test_03_find_concurrent(const T& data, const std::size_t size, const int reader_count) {
+    std::vector<std::size_t> found(static_cast<std::size_t>(reader_count), 0);
+    std::vector<std::thread> readers;
+    for(int r=0; r<reader_count; ++r) {
+        readers.push_back( std::thread( [&data, &found, size, r]() {
+            Addr48Bit a0(start_addr);
+            std::size_t fi = 0;
+            for(std::size_t i=0; i<size && a0.next(); ++i) {
+                if( test_03_contains(data, DataType01(a0, static_cast<uint8_t>(1))) ) {
+                    ++fi;
+                }
+            }
+            found[static_cast<std::size_t>(r)] = fi;
+        } ) );
+    }
+    for(std::thread& t : readers) { t.join(); }
+    for(std::size_t fi : found) {
+        REQUIRE( size == fi );
+    }
+    return true;
+}
+
+static bool test_04_erase(DataType01Map& data, const DataType01& elem) { return 1 == data.erase(elem.address); }
+static bool test_04_erase(locked_hashset& data, const DataType01& elem) { return 1 == data.erase(elem); }
+
+/** Each writer inserts, then erases its own distinct range of <code>size</code> keys. */
+template<class T>
+static bool test_04_write_concurrent(T& data, const std::size_t size, const int writer_count) {
+    std::vector<std::size_t> done(static_cast<std::size_t>(writer_count), 0);
+    std::vector<std::thread> writers;
+    for(int w=0; w<writer_count; ++w) {
+        writers.push_back( std::thread( [&data, &done, size, w]() {
+            const uint64_t a0 = static_cast<uint64_t>(w+1) << 32;
+            std::size_t di = 0;
+            for(std::size_t i=0; i<size; ++i) {
+                test_03_add(data, DataType01(Addr48Bit(a0+i), static_cast<uint8_t>(1)));
+            }
+            for(std::size_t i=0; i<size; ++i) {
+                if( test_04_erase(data, DataType01(Addr48Bit(a0+i), static_cast<uint8_t>(1))) ) {
+                    ++di;
+                }
+            }
+            done[static_cast<std::size_t>(w)] = di;
+        } ) );
+    }
+    for(std::thread& t : writers) { t.join(); }
+    for(std::size_t di : done) {
+        REQUIRE( size == di );
+    }
+    REQUIRE( 0 == data.size() );
+    return true;
+}
+
 /****************************************************************************************
  ****************************************************************************************/
 
@@ -308,6 +500,16 @@ static bool footprint_fillseq_list_hash(const std::string& type_id, const bool d
     return true;
 }
 
+template<class T>
+static bool footprint_fillseq_list_flat(const std::string& type_id) {
+    test_01_seq_fill_list_flat<T>(type_id, 50, true);
+    if( !catch_auto_run ) {
+        test_01_seq_fill_list_flat<T>(type_id, 100, true);
+        test_01_seq_fill_list_flat<T>(type_id, 1000, true);
+    }
+    return true;
+}
+
 template<class T, typename Size_type>
 static bool benchmark_fillunique_find_itr(const std::string& title_pre, const std::string& type_id,
                                           const bool do_rserv) {
@@ -365,6 +567,63 @@ static bool benchmark_fillunique_find_hash(const std::string& title_pre, const s
     return true;
 }
 
+template<class T>
+static bool benchmark_fillunique_find_flat(const std::string& title_pre, const std::string& type_id,
+                                           const bool bulk) {
+    if( catch_perf_analysis ) {
+        BENCHMARK(title_pre+" FillUni_List 1000") {
+            return test_02_seq_fillunique_find_flat<T>(type_id, 1000, bulk);
+        };
+        return true;
+    }
+    if( catch_auto_run ) {
+        test_02_seq_fillunique_find_flat<T>(type_id, 50, bulk);
+        return true;
+    }
+    BENCHMARK(title_pre+" FillUni_List 50") {
+        return test_02_seq_fillunique_find_flat<T>(type_id, 50, bulk);
+    };
+    BENCHMARK(title_pre+" FillUni_List 100") {
+        return test_02_seq_fillunique_find_flat<T>(type_id, 100, bulk);
+    };
+    BENCHMARK(title_pre+" FillUni_List 1000") {
+        return test_02_seq_fillunique_find_flat<T>(type_id, 1000, bulk);
+    };
+    return true;
+}
+
+template<class T>
+static bool benchmark_find_concurrent(const std::string& title_pre, const std::size_t size) {
+    T data;
+    test_03_fill(data, size);
+    if( catch_auto_run ) {
+        test_03_find_concurrent(data, size, 1);
+        test_03_find_concurrent(data, size, 4);
+        return true;
+    }
+    for(int reader_count = 1; reader_count <= 16; reader_count *= 2) {
+        BENCHMARK(title_pre+" Find "+std::to_string(size)+"/reader, readers "+std::to_string(reader_count)) {
+            return test_03_find_concurrent(data, size, reader_count);
+        };
+    }
+    return true;
+}
+
+template<class T>
+static bool benchmark_write_concurrent(const std::string& title_pre, T& data, const std::size_t size) {
+    if( catch_auto_run ) {
+        test_04_write_concurrent(data, size, 1);
+        test_04_write_concurrent(data, size, 4);
+        return true;
+    }
+    for(int writer_count = 1; writer_count <= 16; writer_count *= 2) {
+        BENCHMARK(title_pre+" InsErase "+std::to_string(size)+"/writer, writers "+std::to_string(writer_count)) {
+            return test_04_write_concurrent(data, size, writer_count);
+        };
+    }
+    return true;
+}
+
 /****************************************************************************************
  ****************************************************************************************/
 TEST_CASE( "Memory Footprint 01 - Fill Sequential and List", "[datatype][footprint]" ) {
@@ -372,6 +631,7 @@ TEST_CASE( "Memory Footprint 01 - Fill Sequential and List", "[datatype][footpri
         footprint_fillseq_list_hash("hash__set_empty_", false);
         footprint_fillseq_list_itr< jau::cow_vector<DataType01, counting_allocator<DataType01>>,                std::size_t>("cowstdvec_empty_", false);
         footprint_fillseq_list_itr< jau::cow_darray<DataType01, counting_callocator<DataType01>, jau::nsize_t>, jau::nsize_t>("cowdarray_empty_", false);
+        footprint_fillseq_list_flat< jau::flat_set<DataType01, std::less<DataType01>, counting_callocator<DataType01>> >("flat__set_empty_");
         return;
     }
     footprint_fillseq_list_hash("hash__set_empty_", false);
@@ -379,6 +639,7 @@ TEST_CASE( "Memory Footprint 01 - Fill Sequential and List", "[datatype][footpri
     footprint_fillseq_list_itr< jau::darray<DataType01, counting_callocator<DataType01>, jau::nsize_t>, jau::nsize_t>("darray_empty_", false);
     footprint_fillseq_list_itr< jau::cow_vector<DataType01, counting_allocator<DataType01>>,                std::size_t>("cowstdvec_empty_", false);
     footprint_fillseq_list_itr< jau::cow_darray<DataType01, counting_callocator<DataType01>, jau::nsize_t>, jau::nsize_t>("cowdarray_empty_", false);
+    footprint_fillseq_list_flat< jau::flat_set<DataType01, std::less<DataType01>, counting_callocator<DataType01>> >("flat__set_empty_");
 }
 
 TEST_CASE( "Perf Test 02 - Fill Unique and List, empty and reserve", "[datatype][unique]" ) {
@@ -386,6 +647,8 @@ TEST_CASE( "Perf Test 02 - Fill Unique and List, empty and reserve", "[datatype]
         benchmark_fillunique_find_hash("HashSet_NoOrdr_empty", "hash__set_empty_", false);
         benchmark_fillunique_find_itr< jau::cow_vector<DataType01, std::allocator<DataType01>>,                std::size_t>("COW_Vector_empty_itr", "cowstdvec_empty_", false);
         benchmark_fillunique_find_itr< jau::cow_darray<DataType01, jau::callocator<DataType01>, jau::nsize_t>, jau::nsize_t>("COW_DArray_empty_itr", "cowdarray_empty_", false);
+        benchmark_fillunique_find_flat< jau::flat_set<DataType01> >("FlatSet_Sorted_empty", "flat__set_empty_", false);
+        benchmark_fillunique_find_flat< jau::cow_flat_set<DataType01> >("COW_FlatSet_Srt_empty", "cowflatset_empty_", false);
 
         return;
     }
@@ -394,6 +657,10 @@ TEST_CASE( "Perf Test 02 - Fill Unique and List, empty and reserve", "[datatype]
     benchmark_fillunique_find_itr< jau::darray<DataType01, jau::callocator<DataType01>, jau::nsize_t>, jau::nsize_t>("JAU_DArray_empty_itr", "darray_empty_", false);
     benchmark_fillunique_find_itr< jau::cow_vector<DataType01, std::allocator<DataType01>>,                std::size_t>("COW_Vector_empty_itr", "cowstdvec_empty_", false);
     benchmark_fillunique_find_itr< jau::cow_darray<DataType01, jau::callocator<DataType01>, jau::nsize_t>, jau::nsize_t>("COW_DArray_empty_itr", "cowdarray_empty_", false);
+    benchmark_fillunique_find_flat< jau::flat_set<DataType01> >("FlatSet_Sorted_empty", "flat__set_empty_", false);
+    benchmark_fillunique_find_flat< jau::flat_set<DataType01> >("FlatSet_Sorted_bulk_", "flat__set_bulk__", true);
+    benchmark_fillunique_find_flat< jau::cow_flat_set<DataType01> >("COW_FlatSet_Srt_empty", "cowflatset_empty_", false);
+    benchmark_fillunique_find_flat< jau::cow_flat_set<DataType01> >("COW_FlatSet_Srt_bulk_", "cowflatset_bulk__", true);
 
     benchmark_fillunique_find_hash("HashSet_NoOrdr_rserv", "hash__set_empty_", true);
     benchmark_fillunique_find_itr< std::vector<DataType01, std::allocator<DataType01>>,                    std::size_t>("STD_Vector_rserv_itr", "stdvec_rserv", true);
@@ -402,3 +669,25 @@ TEST_CASE( "Perf Test 02 - Fill Unique and List, empty and reserve", "[datatype]
     benchmark_fillunique_find_itr< jau::cow_darray<DataType01, jau::callocator<DataType01>, jau::nsize_t>, jau::nsize_t>("COW_DArray_rserv_itr", "cowdarray_rserv", true);
 
 }
+
+TEST_CASE( "Perf Test 03 - Concurrent Lookups, reader thread scaling", "[datatype][concurrent]" ) {
+    if( catch_perf_analysis ) {
+        benchmark_find_concurrent< DataType01Map >("COW_HashMap_lockfree", 1000);
+        return;
+    }
+    benchmark_find_concurrent< DataType01Map >("COW_HashMap_lockfree", 1000);
+    benchmark_find_concurrent< locked_hashset >("HashSet_Mutex_locked", 1000);
+    benchmark_find_concurrent< jau::cow_flat_set<DataType01> >("COW_FlatSet_Srt_find", 1000);
+    benchmark_find_concurrent< jau::cow_darray<DataType01> >("COW_DArray_lin_find_", 1000);
+}
+
+TEST_CASE( "Perf Test 04 - Concurrent Writes, writer thread scaling", "[datatype][concurrent]" ) {
+    DataType01Map map(16*1000); // no table growth, i.e. writers only lock their key's stripe
+    locked_hashset set;
+    if( catch_perf_analysis ) {
+        benchmark_write_concurrent< DataType01Map >("COW_HashMap_striped", map, 1000);
+        return;
+    }
+    benchmark_write_concurrent< DataType01Map >("COW_HashMap_striped", map, 1000);
+    benchmark_write_concurrent< locked_hashset >("HashSet_Mutex_locked", set, 1000);
+}
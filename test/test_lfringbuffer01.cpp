@@ -26,12 +26,17 @@
 #include <cinttypes>
 #include <cstring>
 #include <memory>
+#include <unistd.h>
+#include <poll.h>
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch_amalgamated.hpp>
 #include <jau/test/catch2_ext.hpp>
 
 #include <jau/ringbuffer.hpp>
+#include <jau/fixed_ringbuffer.hpp>
+#include <jau/value_ringbuffer.hpp>
+#include <jau/byte_ringbuffer.hpp>
 
 using namespace jau;
 
@@ -40,6 +45,7 @@ class Integer {
     jau::nsize_t value;
 
         Integer(jau::nsize_t v) : value(v) {}
+        Integer() noexcept : value(0) {}
 
         Integer(const Integer &o) noexcept = default;
         Integer(Integer &&o) noexcept = default;
@@ -58,6 +64,35 @@ std::shared_ptr<Integer> NullInteger = nullptr;
 typedef std::shared_ptr<Integer> SharedType;
 typedef ringbuffer<SharedType, nullptr, jau::nsize_t> SharedTypeRingbuffer;
 
+typedef Integer* RawType;
+typedef ringbuffer<RawType, nullptr, jau::nsize_t> RawTypeRingbuffer;
+
+typedef fixed_ringbuffer<SharedType, nullptr, jau::nsize_t, 11> SharedTypeFixedRingbuffer;
+typedef fixed_ringbuffer<RawType, nullptr, jau::nsize_t, 16, false /* multi_pc */> RawTypeFixedRingbufferSPSC;
+
+typedef value_ringbuffer<Integer, jau::nsize_t> ValueTypeRingbuffer;
+
+typedef byte_ringbuffer<> ByteRingbuffer;
+
+typedef ringbuffer<SharedType, nullptr, jau::nsize_t, true /* multi_pc */, ringbuffer_wait_cv, ringbuffer_stats_atomic> SharedTypeStatsRingbuffer;
+
+typedef ringbuffer<SharedType, nullptr, jau::nsize_t, false /* multi_pc */, ringbuffer_wait_eventfd> SharedTypeEventFDRingbufferSPSC;
+
+/** Returns true if the given fd is readable w/o blocking. */
+static bool isReadable(const int fd) {
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    return 1 == ::poll(&pfd, 1, 0) && 0 != ( pfd.revents & POLLIN );
+}
+
+/** Returns the eventfd's counter w/o acknowledging, i.e. number of signals. */
+static uint64_t peekEventFD(const int fd) {
+    eventfd_t v = 0;
+    if( 0 == ::eventfd_read(fd, &v) ) {
+        ::eventfd_write(fd, v);
+    }
+    return v;
+}
+
 // Test examples.
 class TestRingbuffer01 {
   private:
@@ -340,8 +375,562 @@ class TestRingbuffer01 {
         REQUIRE_MSG("not full "+rb->toString(), !rb->isFull());
     }
 
+    template<class Ringbuffer, typename Value_type>
+    void test_BatchImpl(std::vector<Value_type>& source, const jau::nsize_t pos) {
+        const jau::nsize_t capacity = source.size();
+        Ringbuffer rb(capacity);
+        std::vector<Value_type> sink(capacity+4);
+
+        // move read/write position to pos, so the batch wraps around the array's end
+        for(jau::nsize_t i=0; i<pos; i++) {
+            REQUIRE_MSG("move.put "+rb.toString(), rb.put( source[i] ) );
+            REQUIRE_MSG("move.get "+rb.toString(), source[i] == rb.get() );
+        }
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+        REQUIRE_MSG("getN empty "+rb.toString(), 0 == rb.getN(sink.data(), capacity));
+        REQUIRE_MSG("getNBlocking timeout "+rb.toString(), 0 == rb.getNBlocking(sink.data(), 1, capacity, 10));
+
+        // putN limited by free slots
+        REQUIRE_MSG("putN partial "+rb.toString(), 5 == rb.putN(source.data(), 5));
+        REQUIRE_MSG("putN remaining "+rb.toString(), capacity-5 == rb.putN(source.data()+5, capacity));
+        REQUIRE_MSG("full size "+rb.toString(), capacity == rb.getSize());
+        REQUIRE_MSG("full-1 "+rb.toString(), rb.isFull());
+        REQUIRE_MSG("full-2 "+rb.toString(), rb.isFull2());
+        REQUIRE_MSG("putN full "+rb.toString(), 0 == rb.putN(source.data(), 1));
+        REQUIRE_MSG("putNBlocking timeout "+rb.toString(), 0 == rb.putNBlocking(source.data(), 1, 1, 10));
+
+        // getN limited by max_count, then by available elements
+        REQUIRE_MSG("getN partial "+rb.toString(), 3 == rb.getN(sink.data(), 3));
+        REQUIRE_MSG("getNBlocking remaining "+rb.toString(), capacity-3 == rb.getNBlocking(sink.data()+3, capacity-3, sink.size()-3));
+        REQUIRE_MSG("empty-1 "+rb.toString(), rb.isEmpty());
+        REQUIRE_MSG("empty-2 "+rb.toString(), rb.isEmpty2());
+        for(jau::nsize_t i=0; i<capacity; i++) {
+            REQUIRE_MSG("value at getN #"+std::to_string(i), source[i] == sink[i]);
+        }
+
+        // single ops remain aligned w/ batch ops
+        REQUIRE_MSG("put single "+rb.toString(), rb.put( source[0] ) );
+        REQUIRE_MSG("getN single "+rb.toString(), 1 == rb.getN(sink.data(), capacity));
+        REQUIRE_MSG("value single", source[0] == sink[0]);
+    }
+
   public:
 
+    void test07_Overwrite() {
+        std::vector<SharedType> source = createIntArray(25, 0);
+        SharedTypeStatsRingbuffer rb(10);
+        for(jau::nsize_t i=0; i<10; i++) {
+            REQUIRE_MSG("no overwrite #"+std::to_string(i)+" "+rb.toString(), false == rb.putOverwrite(source[i]));
+        }
+        REQUIRE_MSG("full "+rb.toString(), rb.isFull());
+        for(jau::nsize_t i=10; i<25; i++) {
+            REQUIRE_MSG("overwrite #"+std::to_string(i)+" "+rb.toString(), true == rb.putOverwrite(source[i]));
+            REQUIRE_MSG("full "+rb.toString(), rb.isFull());
+        }
+        // the newest 10 elements remain in order, overwritten ones released
+        for(jau::nsize_t i=0; i<15; i++) {
+            REQUIRE_MSG("released ref #"+std::to_string(i), 1 == source[i].use_count());
+        }
+        for(jau::nsize_t i=15; i<25; i++) {
+            SharedType svI = rb.get();
+            REQUIRE_MSG("not empty at read #"+std::to_string(i)+": "+rb.toString(), svI!=nullptr);
+            REQUIRE_MSG("value at read #"+std::to_string(i)+": "+rb.toString(), i == svI->intValue());
+        }
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+
+        // partially consumed, no overwrite
+        REQUIRE( false == rb.putOverwrite(source[0]) );
+        REQUIRE( source[0] == rb.get() );
+
+        const ringbuffer_stats_snapshot st = rb.getStats();
+        REQUIRE_MSG("puts "+st.toString(), 26 == st.puts);
+        REQUIRE_MSG("overwrites "+st.toString(), 15 == st.overwrites);
+        REQUIRE_MSG("drops "+st.toString(), 0 == st.drops);
+        REQUIRE_MSG("highWaterMark "+st.toString(), 10 == st.highWaterMark);
+    }
+
+    void test08_EventFD() {
+        std::vector<SharedType> source = createIntArray(10, 0);
+        SharedTypeEventFDRingbufferSPSC rb(10);
+        const int rfd = rb.getReadEventFD();
+        const int wfd = rb.getWriteEventFD();
+        REQUIRE_MSG("read eventfd", 0 <= rfd);
+        REQUIRE_MSG("write eventfd", 0 <= wfd);
+        REQUIRE_MSG("read not signaled", !isReadable(rfd));
+        REQUIRE_MSG("write not signaled", !isReadable(wfd));
+
+        // empty -> non-empty signaled once, coalescing following puts
+        for(jau::nsize_t i=0; i<10; i++) {
+            REQUIRE( rb.put(source[i]) );
+        }
+        REQUIRE_MSG("read signaled", isReadable(rfd));
+        REQUIRE_MSG("read signaled once", 1 == peekEventFD(rfd));
+        REQUIRE_MSG("put full "+rb.toString(), !rb.put(source[0]));
+
+        // acknowledge and drain, following put signals again
+        rb.acknowledgeRead();
+        REQUIRE_MSG("read acknowledged", !isReadable(rfd));
+        REQUIRE( source[0] == rb.get() );
+        REQUIRE_MSG("write signaled", isReadable(wfd));
+        rb.acknowledgeWrite();
+        REQUIRE( 9 == rb.drop(9) );
+        REQUIRE_MSG("write signaled once", 1 == peekEventFD(wfd));
+        REQUIRE_MSG("read not signaled", !isReadable(rfd));
+        REQUIRE( rb.put(source[0]) );
+        REQUIRE( rb.put(source[1]) );
+        REQUIRE_MSG("read signaled once", 1 == peekEventFD(rfd));
+
+        // blocking operations acknowledge themselves
+        REQUIRE( source[0] == rb.getBlocking(10) );
+        REQUIRE( source[1] == rb.getBlocking(10) );
+        REQUIRE_MSG("getBlocking timeout "+rb.toString(), nullptr == rb.getBlocking(10));
+        REQUIRE_MSG("read acknowledged", !isReadable(rfd));
+    }
+
+    void test10_Batch_Shared() {
+        std::vector<SharedType> source = createIntArray(11, 0);
+        for(jau::nsize_t pos=0; pos<=11; pos++) {
+            test_BatchImpl<SharedTypeRingbuffer, SharedType>(source, pos);
+        }
+        for(jau::nsize_t i=0; i<source.size(); i++) {
+            REQUIRE_MSG("released ref #"+std::to_string(i), 1 == source[i].use_count());
+        }
+    }
+
+    void test11_Batch_Raw() {
+        std::vector<Integer> values;
+        std::vector<RawType> source;
+        for(jau::nsize_t i=0; i<11; i++) {
+            values.push_back(Integer(i));
+        }
+        for(jau::nsize_t i=0; i<11; i++) {
+            source.push_back(&values[i]);
+        }
+        REQUIRE( true == RawTypeRingbuffer::uses_memcpy );
+        REQUIRE( false == SharedTypeRingbuffer::uses_memcpy );
+        for(jau::nsize_t pos=0; pos<=11; pos++) {
+            test_BatchImpl<RawTypeRingbuffer, RawType>(source, pos);
+        }
+    }
+
+    void test12_Batch_WaitPolicies() {
+        std::vector<SharedType> source = createIntArray(11, 0);
+        for(jau::nsize_t pos=0; pos<=11; pos++) {
+            test_BatchImpl<ringbuffer<SharedType, nullptr, jau::nsize_t, true,  ringbuffer_wait_futex>, SharedType>(source, pos);
+            test_BatchImpl<ringbuffer<SharedType, nullptr, jau::nsize_t, false, ringbuffer_wait_yield>, SharedType>(source, pos);
+            test_BatchImpl<ringbuffer<SharedType, nullptr, jau::nsize_t, false, ringbuffer_wait_spin>,  SharedType>(source, pos);
+        }
+    }
+
+    void test13_Pow2Capacity() {
+        REQUIRE( true  == jau::is_power_of_2<jau::nsize_t>(16) );
+        REQUIRE( false == jau::is_power_of_2<jau::nsize_t>(12) );
+        REQUIRE( false == jau::is_power_of_2<jau::nsize_t>(0) );
+        REQUIRE( 16 == jau::round_to_power_of_2<jau::nsize_t>(12) );
+        REQUIRE( 16 == jau::round_to_power_of_2<jau::nsize_t>(16) );
+        REQUIRE(  1 == jau::round_to_power_of_2<jau::nsize_t>(0) );
+
+        SharedTypeRingbuffer rb(11, true /* pow2 */);
+        REQUIRE_MSG("pow2 "+rb.toString(), rb.isPow2Capacity());
+        REQUIRE_MSG("capacity "+rb.toString(), 16 == rb.capacity());
+        REQUIRE_MSG("empty-1 "+rb.toString(), rb.isEmpty());
+        REQUIRE_MSG("empty-2 "+rb.toString(), rb.isEmpty2());
+
+        for(jau::nsize_t pos=0; pos<=rb.capacity(); pos++) {
+            movePutGetImpl(rb, pos);
+            writeTestImpl(rb, 16, 16, 0);
+            REQUIRE_MSG("full-1 "+rb.toString(), rb.isFull());
+            REQUIRE_MSG("full-2 "+rb.toString(), rb.isFull2());
+            REQUIRE_MSG("put full "+rb.toString(), !rb.put( SharedType( new Integer(100) ) ) );
+            readTestImpl(rb, true, 16, 16, 0);
+            REQUIRE_MSG("empty-1 "+rb.toString(), rb.isEmpty());
+            REQUIRE_MSG("empty-2 "+rb.toString(), rb.isEmpty2());
+        }
+
+        writeTestImpl(rb, 16, 10, 0);
+        rb.recapacity(20);
+        REQUIRE_MSG("pow2 "+rb.toString(), rb.isPow2Capacity());
+        REQUIRE_MSG("capacity "+rb.toString(), 32 == rb.capacity());
+        REQUIRE_MSG("size "+rb.toString(), 10 == rb.getSize());
+        readTestImpl(rb, true, 32, 10, 0);
+    }
+
+    template<class Ringbuffer, typename Value_type>
+    void test_FixedImpl(std::vector<Value_type>& source, const jau::nsize_t pos) {
+        const jau::nsize_t capacity = source.size();
+        Ringbuffer rb;
+        std::vector<Value_type> sink(capacity+4);
+        REQUIRE_MSG("capacity "+rb.toString(), capacity == rb.capacity());
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+        REQUIRE_MSG("get empty "+rb.toString(), nullptr == rb.get());
+        REQUIRE_MSG("peek empty "+rb.toString(), nullptr == rb.peek());
+        REQUIRE_MSG("getBlocking timeout "+rb.toString(), nullptr == rb.getBlocking(10));
+
+        // move read/write counter to pos, so operations wrap around the array's end
+        for(jau::nsize_t i=0; i<pos; i++) {
+            REQUIRE_MSG("move.put "+rb.toString(), rb.put( source[i] ) );
+            REQUIRE_MSG("move.get "+rb.toString(), source[i] == rb.get() );
+        }
+
+        // single ops, using all capacity slots
+        for(jau::nsize_t i=0; i<capacity; i++) {
+            REQUIRE_MSG("put #"+std::to_string(i)+": "+rb.toString(), rb.put( source[i] ) );
+        }
+        REQUIRE_MSG("full size "+rb.toString(), capacity == rb.getSize());
+        REQUIRE_MSG("full "+rb.toString(), rb.isFull());
+        REQUIRE_MSG("no free slots "+rb.toString(), 0 == rb.getFreeSlots());
+        REQUIRE_MSG("put full "+rb.toString(), !rb.put( source[0] ) );
+        REQUIRE_MSG("putBlocking timeout "+rb.toString(), !rb.putBlocking( source[0], 10 ) );
+        REQUIRE_MSG("peek "+rb.toString(), source[0] == rb.peek() );
+        for(jau::nsize_t i=0; i<capacity; i++) {
+            REQUIRE_MSG("get #"+std::to_string(i)+": "+rb.toString(), source[i] == rb.get() );
+        }
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+
+        // batch ops
+        REQUIRE_MSG("putN partial "+rb.toString(), 5 == rb.putN(source.data(), 5));
+        REQUIRE_MSG("putN remaining "+rb.toString(), capacity-5 == rb.putN(source.data()+5, capacity));
+        REQUIRE_MSG("full "+rb.toString(), rb.isFull());
+        REQUIRE_MSG("putNBlocking timeout "+rb.toString(), 0 == rb.putNBlocking(source.data(), 1, 1, 10));
+        REQUIRE_MSG("getN partial "+rb.toString(), 3 == rb.getN(sink.data(), 3));
+        REQUIRE_MSG("getNBlocking remaining "+rb.toString(), capacity-3 == rb.getNBlocking(sink.data()+3, capacity-3, sink.size()-3));
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+        for(jau::nsize_t i=0; i<capacity; i++) {
+            REQUIRE_MSG("value at getN #"+std::to_string(i), source[i] == sink[i]);
+        }
+
+        // drop and clear
+        REQUIRE_MSG("putN "+rb.toString(), 5 == rb.putN(source.data(), 5));
+        REQUIRE_MSG("drop "+rb.toString(), 2 == rb.drop(2));
+        REQUIRE_MSG("get after drop "+rb.toString(), source[2] == rb.get() );
+        rb.clear();
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+        REQUIRE_MSG("free slots "+rb.toString(), capacity == rb.getFreeSlots());
+    }
+
+    void test14_Fixed_Shared() {
+        std::vector<SharedType> source = createIntArray(11, 0);
+        REQUIRE( false == SharedTypeFixedRingbuffer::is_pow2_capacity );
+        for(jau::nsize_t pos=0; pos<=11; pos++) {
+            test_FixedImpl<SharedTypeFixedRingbuffer, SharedType>(source, pos);
+        }
+        for(jau::nsize_t i=0; i<source.size(); i++) {
+            REQUIRE_MSG("released ref #"+std::to_string(i), 1 == source[i].use_count());
+        }
+    }
+
+    void test15_Fixed_Raw() {
+        std::vector<Integer> values;
+        std::vector<RawType> source;
+        for(jau::nsize_t i=0; i<16; i++) {
+            values.push_back(Integer(i));
+        }
+        for(jau::nsize_t i=0; i<16; i++) {
+            source.push_back(&values[i]);
+        }
+        REQUIRE( true == RawTypeFixedRingbufferSPSC::is_pow2_capacity );
+        REQUIRE( true == RawTypeFixedRingbufferSPSC::uses_memcpy );
+        for(jau::nsize_t pos=0; pos<=16; pos++) {
+            test_FixedImpl<RawTypeFixedRingbufferSPSC, RawType>(source, pos);
+        }
+    }
+
+    void test16_Value() {
+        ValueTypeRingbuffer rb(11);
+        REQUIRE_MSG("capacity "+rb.toString(), 16 == rb.capacity());
+        std::vector<Integer> source;
+        for(jau::nsize_t i=0; i<16; i++) {
+            source.push_back(Integer(i));
+        }
+        std::vector<Integer> sink(20, Integer(0));
+        Integer v(100);
+
+        for(jau::nsize_t pos=0; pos<=16; pos++) {
+            REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+            REQUIRE_MSG("get empty "+rb.toString(), !rb.get(v));
+            REQUIRE_MSG("peek empty "+rb.toString(), !rb.peek(v));
+            REQUIRE_MSG("getBlocking timeout "+rb.toString(), !rb.getBlocking(v, 10));
+            REQUIRE_MSG("unchanged dst", 100 == v.intValue());
+
+            // move read/write counter to pos, so operations wrap around the array's end
+            for(jau::nsize_t i=0; i<pos; i++) {
+                REQUIRE( rb.put( source[i] ) );
+                REQUIRE( rb.get( v ) );
+                REQUIRE( i == v.intValue() );
+            }
+
+            // single ops, using all capacity slots
+            for(jau::nsize_t i=0; i<16; i++) {
+                REQUIRE_MSG("put #"+std::to_string(i)+": "+rb.toString(), rb.put( source[i] ) );
+            }
+            REQUIRE_MSG("full "+rb.toString(), rb.isFull());
+            REQUIRE_MSG("put full "+rb.toString(), !rb.put( source[0] ) );
+            REQUIRE_MSG("putBlocking timeout "+rb.toString(), !rb.putBlocking( source[0], 10 ) );
+            REQUIRE_MSG("peek "+rb.toString(), rb.peek(v) );
+            REQUIRE_MSG("peek value "+rb.toString(), 0 == v.intValue() );
+            for(jau::nsize_t i=0; i<16; i++) {
+                REQUIRE_MSG("get #"+std::to_string(i)+": "+rb.toString(), rb.get(v) );
+                REQUIRE_MSG("value #"+std::to_string(i)+": "+rb.toString(), i == v.intValue() );
+            }
+
+            // batch ops
+            REQUIRE_MSG("putN partial "+rb.toString(), 5 == rb.putN(source.data(), 5));
+            REQUIRE_MSG("putN remaining "+rb.toString(), 11 == rb.putN(source.data()+5, 16));
+            REQUIRE_MSG("putNBlocking timeout "+rb.toString(), 0 == rb.putNBlocking(source.data(), 1, 1, 10));
+            REQUIRE_MSG("getN partial "+rb.toString(), 3 == rb.getN(sink.data(), 3));
+            REQUIRE_MSG("getNBlocking remaining "+rb.toString(), 13 == rb.getNBlocking(sink.data()+3, 13, sink.size()-3));
+            for(jau::nsize_t i=0; i<16; i++) {
+                REQUIRE_MSG("value at getN #"+std::to_string(i), i == sink[i].intValue());
+            }
+
+            // drop and clear
+            REQUIRE( 5 == rb.putN(source.data(), 5) );
+            REQUIRE_MSG("drop "+rb.toString(), 2 == rb.drop(2));
+            REQUIRE_MSG("get after drop "+rb.toString(), rb.get(v) );
+            REQUIRE_MSG("value after drop "+rb.toString(), 2 == v.intValue() );
+            rb.clear();
+            REQUIRE_MSG("free slots "+rb.toString(), 16 == rb.getFreeSlots());
+            v = Integer(100);
+        }
+    }
+
+    template<class Ringbuffer, typename Value_type>
+    bool test_ZeroCopyImpl(Ringbuffer& rb, std::vector<Value_type>& source, const jau::nsize_t pos) {
+        const jau::nsize_t capacity = rb.capacity();
+        typedef typename Ringbuffer::read_span_type read_span_type;
+        typedef typename Ringbuffer::write_span_type write_span_type;
+
+        // move read/write position to pos, so the spans wrap around the array's end
+        REQUIRE( pos == rb.putN(source.data(), pos) );
+        {
+            read_span_type s = rb.peekRead(capacity);
+            REQUIRE_MSG("peekRead size "+rb.toString(), pos == s.size());
+        } // guard dequeues all viewed elements
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+        {
+            read_span_type s = rb.peekRead(capacity);
+            REQUIRE_MSG("peekRead empty "+rb.toString(), s.empty());
+        }
+        {
+            read_span_type s = rb.peekReadBlocking(1, capacity, 10);
+            REQUIRE_MSG("peekReadBlocking timeout "+rb.toString(), s.empty());
+        }
+
+        // reserve all, construct in place, commit partially
+        bool wrapped;
+        {
+            write_span_type s = rb.reserveWrite(capacity+4);
+            REQUIRE_MSG("reserveWrite size "+rb.toString(), capacity == s.size());
+            wrapped = 0 < s.size2;
+            for(jau::nsize_t i=0; i<s.size(); i++) {
+                s[i] = source[i];
+            }
+            s.commit(5);
+            REQUIRE_MSG("committed empty "+rb.toString(), s.empty());
+            s.commit(1); // no-op
+        }
+        REQUIRE_MSG("size 5 "+rb.toString(), 5 == rb.getSize());
+        {
+            // no commit if destructed due to an exception
+            try {
+                write_span_type s = rb.reserveWrite(capacity);
+                REQUIRE_MSG("reserveWrite remaining "+rb.toString(), capacity-5 == s.size());
+                throw jau::RuntimeException("abort", E_FILE_LINE);
+            } catch (const jau::RuntimeException&) { }
+            REQUIRE_MSG("size 5 after abort "+rb.toString(), 5 == rb.getSize());
+        }
+        {
+            write_span_type s = rb.reserveWrite(capacity);
+            REQUIRE_MSG("reserveWrite remaining "+rb.toString(), capacity-5 == s.size());
+            for(jau::nsize_t i=0; i<s.size(); i++) {
+                s[i] = source[5+i];
+            }
+        } // guard enqueues all reserved slots
+        REQUIRE_MSG("full "+rb.toString(), rb.isFull());
+        {
+            write_span_type s = rb.reserveWrite(1);
+            REQUIRE_MSG("reserveWrite full "+rb.toString(), s.empty());
+        }
+        {
+            write_span_type s = rb.reserveWriteBlocking(1, 1, 10);
+            REQUIRE_MSG("reserveWriteBlocking timeout "+rb.toString(), s.empty());
+        }
+
+        // parse in place, release partially
+        {
+            read_span_type s = rb.peekRead(capacity);
+            REQUIRE_MSG("peekRead all "+rb.toString(), capacity == s.size());
+            for(jau::nsize_t i=0; i<3; i++) {
+                REQUIRE_MSG("peekRead value #"+std::to_string(i), source[i] == s[i]);
+            }
+            s.release(3);
+            REQUIRE_MSG("released empty "+rb.toString(), s.empty());
+        }
+        {
+            // no release if destructed due to an exception
+            try {
+                read_span_type s = rb.peekRead(capacity);
+                REQUIRE_MSG("peekRead remaining "+rb.toString(), capacity-3 == s.size());
+                throw jau::RuntimeException("abort", E_FILE_LINE);
+            } catch (const jau::RuntimeException&) { }
+            REQUIRE_MSG("size after abort "+rb.toString(), capacity-3 == rb.getSize());
+        }
+        {
+            read_span_type s = rb.peekReadBlocking(capacity-3, capacity);
+            REQUIRE_MSG("peekReadBlocking remaining "+rb.toString(), capacity-3 == s.size());
+            for(jau::nsize_t i=0; i<s.size(); i++) {
+                REQUIRE_MSG("peekRead value #"+std::to_string(3+i), source[3+i] == s[i]);
+            }
+        }
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+        return wrapped;
+    }
+
+  public:
+
+    void test17_ZeroCopy() {
+        jau::nsize_t wrapped = 0;
+        {
+            std::vector<SharedType> source = createIntArray(11, 0);
+            for(jau::nsize_t pos=0; pos<=11; pos++) {
+                SharedTypeRingbuffer rb(11);
+                wrapped += test_ZeroCopyImpl(rb, source, pos) ? 1 : 0;
+            }
+            REQUIRE_MSG("wrapped spans", 10 == wrapped);
+            for(jau::nsize_t i=0; i<source.size(); i++) {
+                REQUIRE_MSG("released ref #"+std::to_string(i), 1 == source[i].use_count());
+            }
+            for(jau::nsize_t pos=0; pos<=11; pos++) {
+                ringbuffer<SharedType, nullptr, jau::nsize_t, false /* multi_pc */> rb(11);
+                test_ZeroCopyImpl(rb, source, pos);
+            }
+        }
+        {
+            std::vector<Integer> source;
+            for(jau::nsize_t i=0; i<16; i++) {
+                source.push_back(Integer(i));
+            }
+            wrapped = 0;
+            for(jau::nsize_t pos=0; pos<=16; pos++) {
+                ValueTypeRingbuffer rb(16);
+                wrapped += test_ZeroCopyImpl(rb, source, pos) ? 1 : 0;
+            }
+            REQUIRE_MSG("wrapped spans", 15 == wrapped);
+        }
+    }
+
+    void test18_Mirrored() {
+        ByteRingbuffer rb(1000);
+        const std::size_t capacity = rb.capacity();
+        REQUIRE_MSG("pow2 capacity "+rb.toString(), jau::is_power_of_2(capacity));
+        REQUIRE_MSG("min capacity "+rb.toString(), 1000 <= capacity);
+        REQUIRE_MSG("page capacity "+rb.toString(), static_cast<std::size_t>( ::sysconf(_SC_PAGESIZE) ) <= capacity);
+
+        std::vector<uint8_t> source(capacity), sink(capacity);
+        for(std::size_t i=0; i<capacity; i++) {
+            source[i] = static_cast<uint8_t>(i * 7);
+        }
+        // move read/write counter close to the array's end, so all regions wrap around
+        const std::size_t pos = capacity - 5;
+        REQUIRE( pos == rb.putN(source.data(), pos) );
+        REQUIRE( pos == rb.getN(sink.data(), capacity) );
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+
+        // contiguous write region across the array's end
+        {
+            ByteRingbuffer::write_span_type s = rb.reserveWrite(capacity+4);
+            REQUIRE_MSG("reserveWrite size "+rb.toString(), capacity == s.size1);
+            REQUIRE_MSG("reserveWrite contiguous "+rb.toString(), 0 == s.size2);
+            ::memcpy(s.data1, source.data(), capacity);
+            s.commit(capacity);
+        }
+        REQUIRE_MSG("full "+rb.toString(), rb.isFull());
+        REQUIRE_MSG("putNBlocking timeout "+rb.toString(), 0 == rb.putNBlocking(source.data(), 1, 1, 10));
+
+        // contiguous read region across the array's end, mirrored content
+        {
+            ByteRingbuffer::read_span_type s = rb.peekRead(capacity);
+            REQUIRE_MSG("peekRead size "+rb.toString(), capacity == s.size1);
+            REQUIRE_MSG("peekRead contiguous "+rb.toString(), 0 == s.size2);
+            REQUIRE_MSG("peekRead content "+rb.toString(), 0 == ::memcmp(s.data1, source.data(), capacity));
+            s.release(10);
+        }
+        REQUIRE( capacity-10 == rb.getNBlocking(sink.data(), capacity-10, capacity) );
+        REQUIRE( 0 == ::memcmp(sink.data(), source.data()+10, capacity-10) );
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+        REQUIRE_MSG("getNBlocking timeout "+rb.toString(), 0 == rb.getNBlocking(sink.data(), 1, 1, 10));
+
+        // drop and clear
+        REQUIRE( 20 == rb.putN(source.data(), 20) );
+        REQUIRE_MSG("drop "+rb.toString(), 5 == rb.drop(5));
+        REQUIRE_MSG("size "+rb.toString(), 15 == rb.getSize());
+        rb.clear();
+        REQUIRE_MSG("free slots "+rb.toString(), capacity == rb.getFreeSlots());
+
+        // direct read(2) and write(2) of the contiguous regions via pipe
+        int fds[2];
+        REQUIRE( 0 == ::pipe(fds) );
+        REQUIRE( 100 == rb.putN(source.data(), 100) );
+        REQUIRE_MSG("writeTo "+rb.toString(), 100 == rb.writeTo(fds[1], capacity));
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+        REQUIRE_MSG("readFrom "+rb.toString(), 100 == rb.readFrom(fds[0], capacity));
+        REQUIRE( 100 == rb.getN(sink.data(), capacity) );
+        REQUIRE( 0 == ::memcmp(sink.data(), source.data(), 100) );
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    void test19_Stats() {
+        std::vector<SharedType> source = createIntArray(10, 0);
+        std::vector<SharedType> sink(10);
+        SharedTypeStatsRingbuffer rb(10);
+        REQUIRE_MSG("zero "+rb.getStats().toString(), 0 == rb.getStats().puts);
+
+        REQUIRE_MSG("get empty "+rb.toString(), nullptr == rb.get());
+        REQUIRE_MSG("getN empty "+rb.toString(), 0 == rb.getN(sink.data(), 10));
+        REQUIRE_MSG("getBlocking timeout "+rb.toString(), nullptr == rb.getBlocking(10));
+
+        REQUIRE( rb.put(source[0]) );
+        REQUIRE( 6 == rb.putN(source.data()+1, 6) );
+        {
+            SharedTypeStatsRingbuffer::write_span_type s = rb.reserveWrite(3);
+            REQUIRE( 3 == s.size() );
+            for(jau::nsize_t i=0; i<s.size(); i++) {
+                s[i] = source[7+i];
+            }
+            s.commit(3);
+        }
+        REQUIRE_MSG("full "+rb.toString(), rb.isFull());
+        REQUIRE_MSG("put full "+rb.toString(), !rb.put(source[0]));
+        REQUIRE_MSG("putBlocking timeout "+rb.toString(), !rb.putBlocking(source[0], 10));
+
+        REQUIRE( nullptr != rb.get() );
+        REQUIRE( 3 == rb.getN(sink.data(), 3) );
+        {
+            SharedTypeStatsRingbuffer::read_span_type s = rb.peekRead(2);
+            REQUIRE( 2 == s.size() );
+            s.release(2);
+        }
+        REQUIRE_MSG("drop "+rb.toString(), 4 == rb.drop(10));
+
+        const ringbuffer_stats_snapshot st = rb.getStats();
+        REQUIRE_MSG("puts "+st.toString(), 10 == st.puts);
+        REQUIRE_MSG("gets "+st.toString(), 6 == st.gets);
+        REQUIRE_MSG("putFailures "+st.toString(), 1 == st.putFailures);
+        REQUIRE_MSG("getFailures "+st.toString(), 2 == st.getFailures);
+        REQUIRE_MSG("putWaits "+st.toString(), 1 == st.putWaits);
+        REQUIRE_MSG("getWaits "+st.toString(), 1 == st.getWaits);
+        REQUIRE_MSG("putBlockedNS "+st.toString(), 10000000 <= st.putBlockedNS);
+        REQUIRE_MSG("getBlockedNS "+st.toString(), 10000000 <= st.getBlockedNS);
+        REQUIRE_MSG("drops "+st.toString(), 4 == st.drops);
+        REQUIRE_MSG("highWaterMark "+st.toString(), 10 == st.highWaterMark);
+
+        // disabled policy
+        SharedTypeRingbuffer rb0(10);
+        REQUIRE( rb0.put(source[0]) );
+        REQUIRE_MSG("disabled "+rb0.getStats().toString(), 0 == rb0.getStats().puts);
+    }
+
     void test20_GrowFull01_Begin() {
         test_GrowFullImpl(11, 0);
     }
@@ -375,6 +964,18 @@ METHOD_AS_TEST_CASE( TestRingbuffer01::test03_FullReadReset,     "Test TestRingb
 METHOD_AS_TEST_CASE( TestRingbuffer01::test04_EmptyWriteClear,   "Test TestRingbuffer 01- 04");
 METHOD_AS_TEST_CASE( TestRingbuffer01::test05_ReadResetMid01,    "Test TestRingbuffer 01- 05");
 METHOD_AS_TEST_CASE( TestRingbuffer01::test06_ReadResetMid02,    "Test TestRingbuffer 01- 06");
+METHOD_AS_TEST_CASE( TestRingbuffer01::test07_Overwrite,         "Test TestRingbuffer 01- 07");
+METHOD_AS_TEST_CASE( TestRingbuffer01::test08_EventFD,           "Test TestRingbuffer 01- 08");
+METHOD_AS_TEST_CASE( TestRingbuffer01::test10_Batch_Shared,      "Test TestRingbuffer 01- 10");
+METHOD_AS_TEST_CASE( TestRingbuffer01::test11_Batch_Raw,         "Test TestRingbuffer 01- 11");
+METHOD_AS_TEST_CASE( TestRingbuffer01::test12_Batch_WaitPolicies, "Test TestRingbuffer 01- 12");
+METHOD_AS_TEST_CASE( TestRingbuffer01::test13_Pow2Capacity,      "Test TestRingbuffer 01- 13");
+METHOD_AS_TEST_CASE( TestRingbuffer01::test14_Fixed_Shared,      "Test TestRingbuffer 01- 14");
+METHOD_AS_TEST_CASE( TestRingbuffer01::test15_Fixed_Raw,         "Test TestRingbuffer 01- 15");
+METHOD_AS_TEST_CASE( TestRingbuffer01::test16_Value,             "Test TestRingbuffer 01- 16");
+METHOD_AS_TEST_CASE( TestRingbuffer01::test17_ZeroCopy,          "Test TestRingbuffer 01- 17");
+METHOD_AS_TEST_CASE( TestRingbuffer01::test18_Mirrored,          "Test TestRingbuffer 01- 18");
+METHOD_AS_TEST_CASE( TestRingbuffer01::test19_Stats,             "Test TestRingbuffer 01- 19");
 METHOD_AS_TEST_CASE( TestRingbuffer01::test20_GrowFull01_Begin,  "Test TestRingbuffer 01- 20");
 METHOD_AS_TEST_CASE( TestRingbuffer01::test21_GrowFull02_Begin1, "Test TestRingbuffer 01- 21");
 METHOD_AS_TEST_CASE( TestRingbuffer01::test22_GrowFull03_Begin2, "Test TestRingbuffer 01- 22");
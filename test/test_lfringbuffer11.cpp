@@ -28,12 +28,15 @@
 #include <memory>
 #include <thread>
 #include <pthread.h>
+#include <sys/epoll.h>
+#include <unistd.h>
 
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch_amalgamated.hpp>
 #include <jau/test/catch2_ext.hpp>
 
 #include <jau/ringbuffer.hpp>
+#include <jau/value_ringbuffer.hpp>
 
 using namespace jau;
 
@@ -59,6 +62,20 @@ std::shared_ptr<Integer> NullInteger = nullptr;
 
 typedef std::shared_ptr<Integer> SharedType;
 typedef ringbuffer<SharedType, nullptr, jau::nsize_t> SharedTypeRingbuffer;
+typedef ringbuffer<SharedType, nullptr, jau::nsize_t, false /* multi_pc */> SharedTypeRingbufferSPSC;
+typedef ringbuffer<SharedType, nullptr, jau::nsize_t, false /* multi_pc */, ringbuffer_wait_futex> SharedTypeRingbufferSPSCFutex;
+typedef ringbuffer<SharedType, nullptr, jau::nsize_t, true  /* multi_pc */, ringbuffer_wait_yield> SharedTypeRingbufferYield;
+typedef ringbuffer<SharedType, nullptr, jau::nsize_t, false /* multi_pc */, ringbuffer_wait_spin>  SharedTypeRingbufferSPSCSpin;
+typedef ringbuffer<SharedType, nullptr, jau::nsize_t, true  /* multi_pc */, ringbuffer_wait_cv, ringbuffer_stats_atomic> SharedTypeRingbufferStats;
+typedef ringbuffer<SharedType, nullptr, jau::nsize_t, false /* multi_pc */, ringbuffer_wait_eventfd> SharedTypeRingbufferEventFD;
+
+/** Trivially copyable value type, e.g. a packet descriptor. */
+struct Packet {
+    jau::nsize_t seq;
+    uint8_t payload[28];
+};
+typedef value_ringbuffer<Packet, jau::nsize_t> PacketRingbuffer;
+typedef value_ringbuffer<Packet, jau::nsize_t, false /* multi_pc */> PacketRingbufferSPSC;
 
 // Test examples.
 class TestRingbuffer11 {
@@ -111,6 +128,216 @@ class TestRingbuffer11 {
         (void)msg;
     }
 
+    void getThreadTypeSPSC(const std::string msg, std::shared_ptr<SharedTypeRingbufferSPSC> rb, jau::nsize_t len, jau::nsize_t startValue) {
+        for(jau::nsize_t i=0; i<len; i++) {
+            SharedType svI = rb->getBlocking();
+            REQUIRE_MSG("not empty at read #"+std::to_string(i+1)+": "+rb->toString(), svI!=nullptr);
+            REQUIRE_MSG("value at read #"+std::to_string(i+1)+": "+rb->toString(), startValue+i == svI->intValue());
+        }
+        (void)msg;
+    }
+
+    void putThreadTypeSPSC(const std::string msg, std::shared_ptr<SharedTypeRingbufferSPSC> rb, jau::nsize_t len, jau::nsize_t startValue) {
+        for(jau::nsize_t i=0; i<len; i++) {
+            rb->putBlocking( SharedType( new Integer(startValue+i) ) );
+        }
+        (void)msg;
+    }
+
+    template<class Ringbuffer>
+    void getThreadTypeBatch(const std::string msg, std::shared_ptr<Ringbuffer> rb, jau::nsize_t len, jau::nsize_t startValue) {
+        std::vector<SharedType> sink(32);
+        jau::nsize_t i=0;
+        while( i<len ) {
+            const jau::nsize_t count = rb->getNBlocking(sink.data(), std::min<jau::nsize_t>(8, len-i), sink.size());
+            REQUIRE_MSG("not empty at read #"+std::to_string(i+1)+": "+rb->toString(), 0 < count);
+            for(jau::nsize_t j=0; j<count; j++, i++) {
+                REQUIRE_MSG("not null at read #"+std::to_string(i+1)+": "+rb->toString(), sink[j]!=nullptr);
+                REQUIRE_MSG("value at read #"+std::to_string(i+1)+": "+rb->toString(), startValue+i == sink[j]->intValue());
+            }
+        }
+        (void)msg;
+    }
+
+    template<class Ringbuffer>
+    void putThreadTypeBatch(const std::string msg, std::shared_ptr<Ringbuffer> rb, jau::nsize_t len, jau::nsize_t startValue) {
+        std::vector<SharedType> source = createIntArray(len, startValue);
+        jau::nsize_t i=0;
+        while( i<len ) {
+            const jau::nsize_t count = std::min<jau::nsize_t>(24, len-i);
+            i += rb->putNBlocking(source.data()+i, count, count);
+        }
+        (void)msg;
+    }
+
+    template<class Ringbuffer>
+    void test_Read1Write1_BatchImpl(const std::string& title) {
+        INFO_STR("\n\n"+title+"\n");
+        jau::nsize_t capacity = 100;
+        std::shared_ptr<Ringbuffer> rb = std::make_shared<Ringbuffer>(capacity);
+        REQUIRE_MSG("empty size "+rb->toString(), 0 == rb->getSize());
+        REQUIRE_MSG("empty "+rb->toString(), rb->isEmpty());
+
+        std::thread getThread01(&TestRingbuffer11::getThreadTypeBatch<Ringbuffer>, this, title+".get01", rb, 100*capacity, 0); // @suppress("Invalid arguments")
+        std::thread putThread01(&TestRingbuffer11::putThreadTypeBatch<Ringbuffer>, this, title+".put01", rb, 100*capacity, 0); // @suppress("Invalid arguments")
+        putThread01.join();
+        getThread01.join();
+
+        REQUIRE_MSG("empty "+rb->toString(), rb->isEmpty());
+        REQUIRE_MSG("empty size "+rb->toString(), 0 == rb->getSize());
+    }
+
+    template<class Ringbuffer>
+    void getThreadTypeValue(const std::string msg, std::shared_ptr<Ringbuffer> rb, jau::nsize_t len, const bool batch) {
+        std::vector<Packet> sink(32);
+        jau::nsize_t i=0;
+        while( i<len ) {
+            jau::nsize_t count;
+            if( batch ) {
+                count = rb->getNBlocking(sink.data(), std::min<jau::nsize_t>(8, len-i), sink.size());
+            } else {
+                count = rb->getBlocking(sink[0]) ? 1 : 0;
+            }
+            REQUIRE_MSG("not empty at read #"+std::to_string(i+1)+": "+rb->toString(), 0 < count);
+            for(jau::nsize_t j=0; j<count; j++, i++) {
+                REQUIRE_MSG("value at read #"+std::to_string(i+1)+": "+rb->toString(), i == sink[j].seq);
+                REQUIRE_MSG("payload at read #"+std::to_string(i+1)+": "+rb->toString(), (uint8_t)i == sink[j].payload[27]);
+            }
+        }
+        (void)msg;
+    }
+
+    template<class Ringbuffer>
+    void putThreadTypeValue(const std::string msg, std::shared_ptr<Ringbuffer> rb, jau::nsize_t len, const bool batch) {
+        std::vector<Packet> source(len);
+        for(jau::nsize_t i=0; i<len; i++) {
+            source[i].seq = i;
+            memset(source[i].payload, (uint8_t)i, sizeof(source[i].payload));
+        }
+        jau::nsize_t i=0;
+        while( i<len ) {
+            if( batch ) {
+                const jau::nsize_t count = std::min<jau::nsize_t>(24, len-i);
+                i += rb->putNBlocking(source.data()+i, count, count);
+            } else if( rb->putBlocking(source[i]) ) {
+                i++;
+            }
+        }
+        (void)msg;
+    }
+
+    template<class Ringbuffer>
+    void getThreadTypeZeroCopy(const std::string msg, std::shared_ptr<Ringbuffer> rb, jau::nsize_t len) {
+        jau::nsize_t i=0;
+        while( i<len ) {
+            typename Ringbuffer::read_span_type s = rb->peekReadBlocking(1, 32);
+            REQUIRE_MSG("not empty at read #"+std::to_string(i+1)+": "+rb->toString(), 0 < s.size());
+            for(jau::nsize_t j=0; j<s.size(); j++, i++) {
+                REQUIRE_MSG("value at read #"+std::to_string(i+1)+": "+rb->toString(), i == s[j].seq);
+                REQUIRE_MSG("payload at read #"+std::to_string(i+1)+": "+rb->toString(), (uint8_t)i == s[j].payload[27]);
+            }
+        } // guard dequeues all viewed elements
+        (void)msg;
+    }
+
+    template<class Ringbuffer>
+    void putThreadTypeZeroCopy(const std::string msg, std::shared_ptr<Ringbuffer> rb, jau::nsize_t len) {
+        jau::nsize_t i=0;
+        while( i<len ) {
+            typename Ringbuffer::write_span_type s = rb->reserveWriteBlocking(1, std::min<jau::nsize_t>(24, len-i));
+            for(jau::nsize_t j=0; j<s.size(); j++) {
+                s[j].seq = i+j;
+                memset(s[j].payload, (uint8_t)(i+j), sizeof(s[j].payload));
+            }
+            i += s.size();
+            s.commit(s.size());
+        }
+        (void)msg;
+    }
+
+    /** Getter alternating get, getN and peekRead, received values must increase strictly up to the last put value. */
+    void getThreadTypeOverwrite(const std::string msg, std::shared_ptr<SharedTypeRingbufferStats> rb, jau::nsize_t len, jau::nsize_t* received) {
+        std::vector<SharedType> sink(8);
+        jau::nsize_t next = 0; // minimum next value
+        jau::nsize_t n = 0;
+        while( next < len ) {
+            jau::nsize_t count = 0;
+            switch( n % 3 ) {
+                case 0: {
+                    sink[0] = rb->getBlocking();
+                    count = nullptr != sink[0] ? 1 : 0;
+                } break;
+                case 1: {
+                    count = rb->getNBlocking(sink.data(), 1, sink.size());
+                } break;
+                default: {
+                    SharedTypeRingbufferStats::read_span_type s = rb->peekReadBlocking(1, sink.size());
+                    count = s.size();
+                    for(jau::nsize_t j=0; j<count; j++) {
+                        sink[j] = s[j];
+                    }
+                    s.release(count);
+                } break;
+            }
+            REQUIRE_MSG("not empty at read #"+std::to_string(n)+": "+rb->toString(), 0 < count);
+            for(jau::nsize_t j=0; j<count; j++) {
+                REQUIRE_MSG("not null at read #"+std::to_string(n)+": "+rb->toString(), sink[j]!=nullptr);
+                REQUIRE_MSG("increasing at read #"+std::to_string(n)+": "+rb->toString(), next <= sink[j]->intValue());
+                next = sink[j]->intValue() + 1;
+                sink[j] = nullptr;
+            }
+            n += count;
+        }
+        *received = n;
+        (void)msg;
+    }
+
+    void putThreadTypeOverwrite(const std::string msg, std::shared_ptr<SharedTypeRingbufferStats> rb, jau::nsize_t len) {
+        for(jau::nsize_t i=0; i<len; i++) {
+            rb->putOverwrite( SharedType( new Integer(i) ) );
+        }
+        (void)msg;
+    }
+
+    void putThreadTypeEventFD(const std::string msg, std::shared_ptr<SharedTypeRingbufferEventFD> rb, jau::nsize_t len) {
+        for(jau::nsize_t i=0; i<len; i++) {
+            REQUIRE_MSG(msg+": put #"+std::to_string(i)+": "+rb->toString(), rb->putBlocking( SharedType( new Integer(i) ), 5000 ) );
+        }
+    }
+
+    template<class Ringbuffer>
+    void test_Read1Write1_ZeroCopyImpl(const std::string& title) {
+        INFO_STR("\n\n"+title+"\n");
+        jau::nsize_t capacity = 100;
+        std::shared_ptr<Ringbuffer> rb = std::make_shared<Ringbuffer>(capacity);
+
+        std::thread getThread01(&TestRingbuffer11::getThreadTypeZeroCopy<Ringbuffer>, this, title+".get01", rb, 100*capacity); // @suppress("Invalid arguments")
+        std::thread putThread01(&TestRingbuffer11::putThreadTypeZeroCopy<Ringbuffer>, this, title+".put01", rb, 100*capacity); // @suppress("Invalid arguments")
+        putThread01.join();
+        getThread01.join();
+
+        REQUIRE_MSG("empty "+rb->toString(), rb->isEmpty());
+        REQUIRE_MSG("empty size "+rb->toString(), 0 == rb->getSize());
+    }
+
+    template<class Ringbuffer>
+    void test_Read1Write1_ValueImpl(const std::string& title, const bool batch) {
+        INFO_STR("\n\n"+title+"\n");
+        jau::nsize_t capacity = 100;
+        std::shared_ptr<Ringbuffer> rb = std::make_shared<Ringbuffer>(capacity);
+        REQUIRE_MSG("capacity "+rb->toString(), 128 == rb->capacity());
+        REQUIRE_MSG("empty size "+rb->toString(), 0 == rb->getSize());
+        REQUIRE_MSG("empty "+rb->toString(), rb->isEmpty());
+
+        std::thread getThread01(&TestRingbuffer11::getThreadTypeValue<Ringbuffer>, this, title+".get01", rb, 100*capacity, batch); // @suppress("Invalid arguments")
+        std::thread putThread01(&TestRingbuffer11::putThreadTypeValue<Ringbuffer>, this, title+".put01", rb, 100*capacity, batch); // @suppress("Invalid arguments")
+        putThread01.join();
+        getThread01.join();
+
+        REQUIRE_MSG("empty "+rb->toString(), rb->isEmpty());
+        REQUIRE_MSG("empty size "+rb->toString(), 0 == rb->getSize());
+    }
+
   public:
 
     void test01_Read1Write1() {
@@ -185,6 +412,122 @@ class TestRingbuffer11 {
         REQUIRE_MSG("empty size "+rb->toString(), 0 == rb->getSize());
     }
 
+    void test04_Read1Write1_SPSC() {
+        INFO_STR("\n\ntest04_Read1Write1_SPSC\n");
+        jau::nsize_t capacity = 100;
+        std::shared_ptr<SharedTypeRingbufferSPSC> rb = std::make_shared<SharedTypeRingbufferSPSC>(capacity);
+        REQUIRE_MSG("empty size "+rb->toString(), 0 == rb->getSize());
+        REQUIRE_MSG("empty "+rb->toString(), rb->isEmpty());
+
+        // 100 times the capacity, forcing getter and putter to block on each other
+        std::thread getThread01(&TestRingbuffer11::getThreadTypeSPSC, this, "test04.get01", rb, 100*capacity, 0); // @suppress("Invalid arguments")
+        std::thread putThread01(&TestRingbuffer11::putThreadTypeSPSC, this, "test04.put01", rb, 100*capacity, 0); // @suppress("Invalid arguments")
+        putThread01.join();
+        getThread01.join();
+
+        REQUIRE_MSG("empty "+rb->toString(), rb->isEmpty());
+        REQUIRE_MSG("empty size "+rb->toString(), 0 == rb->getSize());
+    }
+
+    void test05_Read1Write1_Batch() {
+        test_Read1Write1_BatchImpl<SharedTypeRingbuffer>("test05_Read1Write1_Batch");
+    }
+
+    void test06_Read1Write1_Batch_SPSC() {
+        test_Read1Write1_BatchImpl<SharedTypeRingbufferSPSC>("test06_Read1Write1_Batch_SPSC");
+    }
+
+    void test07_Read1Write1_Batch_WaitPolicies() {
+        test_Read1Write1_BatchImpl<SharedTypeRingbufferSPSCFutex>("test07_Read1Write1_Batch_SPSC_Futex");
+        test_Read1Write1_BatchImpl<SharedTypeRingbufferYield>("test07_Read1Write1_Batch_Yield");
+        test_Read1Write1_BatchImpl<SharedTypeRingbufferSPSCSpin>("test07_Read1Write1_Batch_SPSC_Spin");
+    }
+
+    void test08_Read1Write1_Value() {
+        test_Read1Write1_ValueImpl<PacketRingbuffer>("test08_Read1Write1_Value", false);
+        test_Read1Write1_ValueImpl<PacketRingbufferSPSC>("test08_Read1Write1_Value_SPSC", false);
+        test_Read1Write1_ValueImpl<PacketRingbuffer>("test08_Read1Write1_Value_Batch", true);
+        test_Read1Write1_ValueImpl<PacketRingbufferSPSC>("test08_Read1Write1_Value_Batch_SPSC", true);
+    }
+
+    void test09_Read1Write1_ZeroCopy() {
+        test_Read1Write1_ZeroCopyImpl<PacketRingbuffer>("test09_Read1Write1_ZeroCopy");
+        test_Read1Write1_ZeroCopyImpl<PacketRingbufferSPSC>("test09_Read1Write1_ZeroCopy_SPSC");
+    }
+
+    void test10_Read1Write1_Overwrite() {
+        INFO_STR("\n\ntest10_Read1Write1_Overwrite\n");
+        const jau::nsize_t capacity = 16;
+        const jau::nsize_t len = 100000;
+        std::shared_ptr<SharedTypeRingbufferStats> rb = std::make_shared<SharedTypeRingbufferStats>(capacity);
+        jau::nsize_t received = 0;
+
+        std::thread getThread01(&TestRingbuffer11::getThreadTypeOverwrite, this, "test10.get01", rb, len, &received); // @suppress("Invalid arguments")
+        std::thread putThread01(&TestRingbuffer11::putThreadTypeOverwrite, this, "test10.put01", rb, len); // @suppress("Invalid arguments")
+        putThread01.join();
+        getThread01.join();
+
+        const ringbuffer_stats_snapshot st = rb->getStats();
+        REQUIRE_MSG("empty "+rb->toString(), rb->isEmpty());
+        REQUIRE_MSG("puts "+st.toString(), len == st.puts);
+        REQUIRE_MSG("gets "+st.toString(), received == st.gets);
+        REQUIRE_MSG("received + overwritten "+st.toString(), len == received + st.overwrites);
+        REQUIRE_MSG("highWaterMark "+st.toString(), capacity >= st.highWaterMark);
+    }
+
+    /** One epoll thread multiplexing the getter side of several eventfd ring buffers, each fed by its own putter thread. */
+    void test11_EpollMultiplex() {
+        INFO_STR("\n\ntest11_EpollMultiplex\n");
+        const jau::nsize_t ring_count = 4;
+        const jau::nsize_t capacity = 16;
+        const jau::nsize_t len = 10000;
+        std::vector<std::shared_ptr<SharedTypeRingbufferEventFD>> rbs;
+        std::vector<jau::nsize_t> next(ring_count, 0);
+        const int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+        REQUIRE( 0 <= epfd );
+        for(jau::nsize_t r=0; r<ring_count; r++) {
+            rbs.push_back( std::make_shared<SharedTypeRingbufferEventFD>(capacity) );
+            struct epoll_event ev;
+            ev.events = EPOLLIN;
+            ev.data.u32 = r;
+            REQUIRE( 0 == ::epoll_ctl(epfd, EPOLL_CTL_ADD, rbs[r]->getReadEventFD(), &ev) );
+        }
+        std::vector<std::thread> putThreads;
+        for(jau::nsize_t r=0; r<ring_count; r++) {
+            putThreads.push_back( std::thread(&TestRingbuffer11::putThreadTypeEventFD, this, "test11.put"+std::to_string(r), rbs[r], len) ); // @suppress("Invalid arguments")
+        }
+
+        jau::nsize_t done = 0, wakeups = 0;
+        while( done < ring_count ) {
+            struct epoll_event events[ring_count];
+            const int n = ::epoll_wait(epfd, events, ring_count, 5000);
+            REQUIRE_MSG("epoll_wait no timeout", 0 < n);
+            for(int i=0; i<n; i++) {
+                const jau::nsize_t r = events[i].data.u32;
+                rbs[r]->acknowledgeRead(); // before draining, re-arming the signal
+                SharedType svI;
+                while( nullptr != ( svI = rbs[r]->get() ) ) {
+                    REQUIRE_MSG("ring "+std::to_string(r)+" in order "+rbs[r]->toString(), next[r] == svI->intValue());
+                    next[r]++;
+                }
+                if( len == next[r] ) {
+                    REQUIRE( 0 == ::epoll_ctl(epfd, EPOLL_CTL_DEL, rbs[r]->getReadEventFD(), nullptr) );
+                    done++;
+                }
+                wakeups++;
+            }
+        }
+        for(std::thread& t : putThreads) {
+            t.join();
+        }
+        ::close(epfd);
+        INFO_STR("test11: "+std::to_string(ring_count*len)+" elements, "+std::to_string(wakeups)+" wakeups");
+        for(jau::nsize_t r=0; r<ring_count; r++) {
+            REQUIRE_MSG("ring "+std::to_string(r)+" complete", len == next[r]);
+            REQUIRE_MSG("ring "+std::to_string(r)+" empty "+rbs[r]->toString(), rbs[r]->isEmpty());
+        }
+    }
+
     void test_list() {
         test01_Read1Write1();
         test02_Read4Write1();
@@ -197,6 +540,17 @@ class TestRingbuffer11 {
         test03_Read8Write2();
         test03_Read8Write2();
         test03_Read8Write2();
+
+        test04_Read1Write1_SPSC();
+        test04_Read1Write1_SPSC();
+
+        test05_Read1Write1_Batch();
+        test06_Read1Write1_Batch_SPSC();
+        test07_Read1Write1_Batch_WaitPolicies();
+        test08_Read1Write1_Value();
+        test09_Read1Write1_ZeroCopy();
+        test10_Read1Write1_Overwrite();
+        test11_EpollMultiplex();
     }
 };
 
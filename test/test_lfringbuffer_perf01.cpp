@@ -0,0 +1,1039 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define CATCH_CONFIG_RUNNER
+// #define CATCH_CONFIG_MAIN
+#include <catch2/catch_amalgamated.hpp>
+#include <jau/test/catch2_ext.hpp>
+
+#include <jau/ringbuffer.hpp>
+#include <jau/fixed_ringbuffer.hpp>
+#include <jau/value_ringbuffer.hpp>
+#include <jau/byte_ringbuffer.hpp>
+#include <jau/darray.hpp>
+#include <jau/shm_ringbuffer.hpp>
+
+/**
+ * Performance test of jau::ringbuffer, comparing the multi_pc mode against the SPSC mode,
+ * single against batch operations as well as the handoff latency of the wait policies.
+ * <p>
+ * Further compares the index wrap-around of jau::ringbuffer w/ and w/o power of two capacity
+ * against jau::fixed_ringbuffer's compile-time capacity and a modulo baseline_ringbuffer.
+ * </p>
+ * <p>
+ * The ping-pong round trip between two threads pinned to separate CPUs
+ * exposes the cache line transfers between getter and putter,
+ * comparing the separated and cached counters against the baseline_ringbuffer's shared cache line.
+ * </p>
+ * <p>
+ * Transferring small value types via jau::value_ringbuffer is compared against
+ * heap allocated std::shared_ptr elements via jau::ringbuffer.
+ * </p>
+ * <p>
+ * Large records are transferred by copy via put/get and in place via their span guards returned by reserveWrite and peekRead.
+ * </p>
+ * <p>
+ * Variable length framed byte messages are parsed in place within jau::byte_ringbuffer's contiguous regions
+ * and compared against copying the wrapped around regions of a jau::value_ringbuffer<uint8_t> into a jau::darray<uint8_t>.
+ * </p>
+ * <p>
+ * Packets are transferred between two processes via jau::shm_ringbuffer and compared against a pipe,
+ * measuring throughput as well as the round trip latency.
+ * </p>
+ * <p>
+ * The overhead of the ringbuffer_stats_atomic statistics policy is measured against the disabled default.
+ * </p>
+ */
+using namespace jau;
+
+class Integer {
+    public:
+        jau::nsize_t value;
+
+        Integer(jau::nsize_t v) : value(v) {}
+        Integer() noexcept : value(0) {}
+};
+
+typedef Integer* IntegerPtr;
+
+typedef ringbuffer<IntegerPtr, nullptr, jau::nsize_t>                        IntegerRingbufferMulti;
+typedef ringbuffer<IntegerPtr, nullptr, jau::nsize_t, false /* multi_pc */>  IntegerRingbufferSPSC;
+typedef ringbuffer<IntegerPtr, nullptr, jau::nsize_t, true  /* multi_pc */, ringbuffer_wait_cv, ringbuffer_stats_atomic>  IntegerRingbufferMultiStats;
+typedef ringbuffer<IntegerPtr, nullptr, jau::nsize_t, false /* multi_pc */, ringbuffer_wait_cv, ringbuffer_stats_atomic>  IntegerRingbufferSPSCStats;
+
+typedef fixed_ringbuffer<IntegerPtr, nullptr, jau::nsize_t, 1000, false /* multi_pc */>  IntegerFixedRingbufferSPSC1000;
+typedef fixed_ringbuffer<IntegerPtr, nullptr, jau::nsize_t, 1024, false /* multi_pc */>  IntegerFixedRingbufferSPSC1024;
+
+/**
+ * Baseline SPSC ring buffer, replicating the original jau::ringbuffer index scheme and layout:
+ * <ul>
+ *   <li>one slot kept open, i.e. an internal array of capacity <i>plus one</i></li>
+ *   <li>wrap-around of the read and write position via modulo, i.e. an integer division per step</li>
+ *   <li>read and write position adjacent on one cache line, the opposite position reloaded on every operation</li>
+ * </ul>
+ * Only the API used by the single thread and the ping-pong benchmark is provided.
+ */
+template <typename T, std::nullptr_t nullelem, typename Size_type, typename Wait_policy=ringbuffer_wait_cv>
+class baseline_ringbuffer {
+    private:
+        const Size_type capacityPlusOne;
+        T * const array;
+        std::atomic<Size_type> readPos;
+        std::atomic<Size_type> writePos;
+        Wait_policy waitRead;
+        Wait_policy waitWrite;
+
+        T getImpl(const bool blocking, const int timeoutMS) noexcept {
+            const Size_type localReadPos = readPos.load(std::memory_order_relaxed);
+            if( localReadPos == writePos.load(std::memory_order_acquire) ) {
+                if( !blocking || !waitRead.wait( [&]() noexcept -> bool {
+                        return localReadPos != writePos.load(std::memory_order_seq_cst);
+                    }, timeoutMS) )
+                {
+                    return nullelem;
+                }
+            }
+            const Size_type pos = ( localReadPos + 1 ) % capacityPlusOne;
+            T r = std::move( array[pos] );
+            array[pos] = nullelem;
+            readPos.store(pos, std::memory_order_release);
+            if constexpr ( Wait_policy::uses_notify ) {
+                waitWrite.notify();
+            }
+            return r;
+        }
+
+        bool putImpl(const T & e, const bool blocking, const int timeoutMS) noexcept {
+            const Size_type pos = ( writePos.load(std::memory_order_relaxed) + 1 ) % capacityPlusOne;
+            if( pos == readPos.load(std::memory_order_acquire) ) {
+                if( !blocking || !waitWrite.wait( [&]() noexcept -> bool {
+                        return pos != readPos.load(std::memory_order_seq_cst);
+                    }, timeoutMS) )
+                {
+                    return false;
+                }
+            }
+            array[pos] = e;
+            writePos.store(pos, std::memory_order_release);
+            if constexpr ( Wait_policy::uses_notify ) {
+                waitRead.notify();
+            }
+            return true;
+        }
+
+    public:
+        baseline_ringbuffer(const Size_type capacity) noexcept
+        : capacityPlusOne(capacity + 1), array(new T[capacityPlusOne]), readPos(0), writePos(0) {}
+
+        ~baseline_ringbuffer() noexcept { delete[] array; }
+
+        baseline_ringbuffer(const baseline_ringbuffer &_source) = delete;
+        baseline_ringbuffer& operator=(const baseline_ringbuffer &_source) = delete;
+
+        Size_type capacity() const noexcept { return capacityPlusOne - 1; }
+        bool isEmpty() const noexcept { return readPos.load() == writePos.load(); }
+
+        T get() noexcept { return getImpl(false, 0); }
+        T getBlocking(const int timeoutMS=0) noexcept { return getImpl(true, timeoutMS); }
+        bool put(const T & e) noexcept { return putImpl(e, false, 0); }
+        bool putBlocking(const T & e, const int timeoutMS=0) noexcept { return putImpl(e, true, timeoutMS); }
+};
+
+/****************************************************************************************
+ ****************************************************************************************/
+
+static std::vector<Integer> createIntArray(const jau::nsize_t count) {
+    std::vector<Integer> array(count);
+    for(jau::nsize_t i=0; i<count; i++) {
+        array[i].value = i;
+    }
+    return array;
+}
+
+template<class Ringbuffer>
+static void putThreadType01(Ringbuffer* rb, std::vector<Integer>* source, const bool blocking, const jau::nsize_t batch) {
+    const jau::nsize_t count = source->size();
+    if( 0 < batch ) {
+        std::vector<IntegerPtr> buffer(batch);
+        jau::nsize_t i=0;
+        while( i<count ) {
+            const jau::nsize_t n = std::min(batch, count-i);
+            for(jau::nsize_t j=0; j<n; j++) {
+                buffer[j] = &(*source)[i+j];
+            }
+            jau::nsize_t j=0;
+            while( j<n ) {
+                if( blocking ) {
+                    j += rb->putNBlocking( buffer.data()+j, n-j, n-j );
+                } else {
+                    const jau::nsize_t k = rb->putN( buffer.data()+j, n-j );
+                    if( 0 == k ) {
+                        std::this_thread::yield();
+                    }
+                    j += k;
+                }
+            }
+            i += n;
+        }
+        return;
+    }
+    for(jau::nsize_t i=0; i<count; i++) {
+        IntegerPtr e = &(*source)[i];
+        if( blocking ) {
+            rb->putBlocking( e );
+        } else {
+            while( !rb->put( e ) ) {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
+
+/**
+ * One putter and one getter thread transferring all source elements through the given ringbuffer.
+ * <p>
+ * If batch is greater than zero, putN*() and getN*() are used with up to batch elements per call.
+ * </p>
+ * @return true if all elements have been received in order
+ */
+template<class Ringbuffer>
+static bool test_1p1c(Ringbuffer& rb, std::vector<Integer>& source, const bool blocking, const jau::nsize_t batch) {
+    const jau::nsize_t count = source.size();
+    std::thread putThread01(putThreadType01<Ringbuffer>, &rb, &source, blocking, batch); // @suppress("Invalid arguments")
+    bool in_order = true;
+    if( 0 < batch ) {
+        std::vector<IntegerPtr> buffer(batch);
+        jau::nsize_t i=0;
+        while( i<count ) {
+            jau::nsize_t n;
+            if( blocking ) {
+                n = rb.getNBlocking(buffer.data(), 1, batch);
+            } else {
+                while( 0 == ( n = rb.getN(buffer.data(), batch) ) ) {
+                    std::this_thread::yield();
+                }
+            }
+            for(jau::nsize_t j=0; j<n; j++, i++) {
+                in_order = in_order && nullptr != buffer[j] && i == buffer[j]->value;
+            }
+        }
+        putThread01.join();
+        return in_order && rb.isEmpty();
+    }
+    for(jau::nsize_t i=0; i<count; i++) {
+        IntegerPtr e;
+        if( blocking ) {
+            e = rb.getBlocking();
+        } else {
+            while( nullptr == ( e = rb.get() ) ) {
+                std::this_thread::yield();
+            }
+        }
+        in_order = in_order && nullptr != e && i == e->value;
+    }
+    putThread01.join();
+    return in_order && rb.isEmpty();
+}
+
+template<class Ringbuffer>
+static void print_ops_per_sec(const std::string& type_id, const jau::nsize_t capacity, const jau::nsize_t count,
+                              const bool blocking, const jau::nsize_t batch, const int loops)
+{
+    Ringbuffer rb(capacity);
+    std::vector<Integer> source = createIntArray(count);
+    const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for(int i=0; i<loops; i++) {
+        REQUIRE( true == test_1p1c(rb, source, blocking, batch) );
+    }
+    const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    const double secs = std::chrono::duration<double>(t1 - t0).count();
+    const double ops = (double)count * (double)loops;
+    printf("%s: capacity %u, blocking %d, batch %u: %u elements x %d loops in %.3f ms, %.2f Mops/s\n",
+            type_id.c_str(), (unsigned int)capacity, blocking, (unsigned int)batch, (unsigned int)count, loops,
+            secs * 1000.0, ops / secs / 1000000.0);
+}
+
+template<class Ringbuffer>
+static bool benchmark_1p1c(const std::string& title_pre, const jau::nsize_t capacity, const bool blocking, const jau::nsize_t batch=0) {
+    const std::string title = title_pre + (blocking ? " Blocking" : " NonBlock") + ( 0 < batch ? " Batch"+std::to_string(batch) : "" );
+    if( catch_auto_run ) {
+        print_ops_per_sec<Ringbuffer>(title, capacity, 10000, blocking, batch, 1);
+        return true;
+    }
+    print_ops_per_sec<Ringbuffer>(title, capacity, 1000000, blocking, batch, 5);
+    {
+        Ringbuffer rb(capacity);
+        std::vector<Integer> source = createIntArray(10000);
+        BENCHMARK(title+" 1P1C 10000") {
+            return test_1p1c(rb, source, blocking, batch);
+        };
+    }
+    return true;
+}
+
+/**
+ * Single thread put and get of all source elements, in chunks of up to the given ringbuffer's capacity,
+ * i.e. measuring the per-op cost w/o any thread contention.
+ * @return true if all elements have been received in order
+ */
+template<class Ringbuffer>
+static bool test_single(Ringbuffer& rb, std::vector<Integer>& source) {
+    const jau::nsize_t count = source.size();
+    const jau::nsize_t chunk = rb.capacity();
+    bool in_order = true;
+    for(jau::nsize_t i=0; i<count; i+=chunk) {
+        const jau::nsize_t n = std::min(chunk, count-i);
+        for(jau::nsize_t j=0; j<n; j++) {
+            rb.put( &source[i+j] );
+        }
+        for(jau::nsize_t j=0; j<n; j++) {
+            const IntegerPtr e = rb.get();
+            in_order = in_order && nullptr != e && i+j == e->value;
+        }
+    }
+    return in_order && rb.isEmpty();
+}
+
+template<class Ringbuffer>
+static bool benchmark_single(const std::string& title, Ringbuffer& rb) {
+    const jau::nsize_t count = catch_auto_run ? 10000 : 1000000;
+    const int loops = catch_auto_run ? 1 : 10;
+    std::vector<Integer> source = createIntArray(count);
+    const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for(int i=0; i<loops; i++) {
+        REQUIRE( true == test_single(rb, source) );
+    }
+    const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    const double ops = 2.0 * (double)count * (double)loops; // put + get
+    printf("%s: capacity %u: %u elements x %d loops, %.3f ns/op, %.2f Mops/s\n",
+            title.c_str(), (unsigned int)rb.capacity(), (unsigned int)count, loops, ns / ops, ops / ns * 1000.0);
+    if( !catch_auto_run ) {
+        std::vector<Integer> source2 = createIntArray(10000);
+        BENCHMARK(title+" Single 10000") {
+            return test_single(rb, source2);
+        };
+    }
+    return true;
+}
+
+/**
+ * Index step micro benchmark, stepping a position count times through an array of given size
+ * via modulo, compare-wrap or bitmask, the latter only valid for a power of two size.
+ */
+static void benchmark_index_step(const jau::nsize_t size, const jau::nsize_t count) {
+    volatile jau::nsize_t vsize = size; // defeat constant propagation of the runtime divisor
+    const jau::nsize_t rsize = vsize;
+    const jau::nsize_t mask = rsize - 1;
+    jau::nsize_t sum = 0;
+
+    auto run = [&](const std::string& title, auto step) {
+        jau::nsize_t pos = 0;
+        const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        for(jau::nsize_t i=0; i<count; i++) {
+            pos = step(pos);
+            sum += pos;
+        }
+        const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        printf("Index step %s, size %u: %.3f ns/step\n", title.c_str(), (unsigned int)size, ns / (double)count);
+    };
+    run("modulo ", [&](const jau::nsize_t p) { return ( p + 1 ) % rsize; });
+    run("compare", [&](const jau::nsize_t p) { return p + 1 < rsize ? p + 1 : 0; });
+    if( jau::is_power_of_2(size) ) {
+        run("bitmask", [&](const jau::nsize_t p) { return ( p + 1 ) & mask; });
+    }
+    REQUIRE( 0 < sum );
+}
+
+/****************************************************************************************
+ ****************************************************************************************/
+
+/** Handoff element, carrying the steady_clock timestamp of its put operation. */
+struct TimeStamp {
+    std::chrono::steady_clock::time_point t0;
+};
+typedef TimeStamp* TimeStampPtr;
+
+template<class Ringbuffer>
+static void putThreadLatency(Ringbuffer* rb, std::vector<TimeStamp>* source, const std::chrono::microseconds pause) {
+    for(TimeStamp& e : *source) {
+        // wait until the previous element has been taken, excluding queueing delays from the handoff latency
+        while( !rb->isEmpty() ) {
+            std::this_thread::yield();
+        }
+        // let the getter block, i.e. spin, yield or sleep, before the next handoff
+        const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now() + pause;
+        while( std::chrono::steady_clock::now() < t1 ) {
+            cpu_relax();
+        }
+        e.t0 = std::chrono::steady_clock::now();
+        rb->putBlocking( &e );
+    }
+}
+
+/**
+ * Measures the handoff latency from putBlocking() to the return of a blocking getBlocking(),
+ * printing the p50, p99 and p999 percentiles.
+ */
+template<class Ringbuffer>
+static void test_latency(const std::string& type_id, const jau::nsize_t count, const std::chrono::microseconds pause) {
+    Ringbuffer rb(64);
+    std::vector<TimeStamp> source(count);
+    std::vector<int64_t> latencies(count);
+
+    std::thread putThread01(putThreadLatency<Ringbuffer>, &rb, &source, pause); // @suppress("Invalid arguments")
+    for(jau::nsize_t i=0; i<count; i++) {
+        TimeStampPtr e = rb.getBlocking();
+        const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+        REQUIRE( nullptr != e );
+        latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - e->t0).count();
+    }
+    putThread01.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](const double p) -> double {
+        return (double)latencies[ std::min<jau::nsize_t>(count-1, (jau::nsize_t)( p * count )) ] / 1000.0;
+    };
+    printf("%s: handoff latency of %u samples: p50 %.3f us, p99 %.3f us, p999 %.3f us, max %.3f us\n",
+            type_id.c_str(), (unsigned int)count, percentile(0.50), percentile(0.99), percentile(0.999),
+            (double)latencies[count-1] / 1000.0);
+}
+
+template<class Wait_policy>
+static bool benchmark_latency(const std::string& title_pre) {
+    typedef ringbuffer<TimeStampPtr, nullptr, jau::nsize_t, false /* multi_pc */, Wait_policy> TimeStampRingbufferSPSC;
+    typedef ringbuffer<TimeStampPtr, nullptr, jau::nsize_t, true  /* multi_pc */, Wait_policy> TimeStampRingbufferMulti;
+    const jau::nsize_t count = catch_auto_run ? 1000 : 100000;
+    test_latency<TimeStampRingbufferSPSC>(title_pre+" SPSC ", count, std::chrono::microseconds(20));
+    test_latency<TimeStampRingbufferMulti>(title_pre+" Multi", count, std::chrono::microseconds(20));
+    return true;
+}
+
+/****************************************************************************************
+ ****************************************************************************************/
+
+/** Trivially copyable 32 byte packet descriptor. */
+struct Packet {
+    jau::nsize_t seq;
+    uint8_t payload[32 - sizeof(jau::nsize_t)];
+};
+typedef std::shared_ptr<Packet> SharedPacket;
+
+/**
+ * One putter and one getter thread transferring count packets,
+ * either by value via jau::value_ringbuffer or as heap allocated std::shared_ptr via jau::ringbuffer.
+ * @return true if all packets have been received in order
+ */
+template<class Ringbuffer, bool by_value>
+static bool test_1p1c_packet(Ringbuffer& rb, const jau::nsize_t count) {
+    std::thread putThread01([&rb, count]() {
+        for(jau::nsize_t i=0; i<count; i++) {
+            if constexpr ( by_value ) {
+                Packet p;
+                p.seq = i;
+                p.payload[0] = (uint8_t)i;
+                rb.putBlocking( p );
+            } else {
+                SharedPacket p = std::make_shared<Packet>();
+                p->seq = i;
+                p->payload[0] = (uint8_t)i;
+                rb.putBlocking( std::move(p) );
+            }
+        }
+    });
+    bool in_order = true;
+    for(jau::nsize_t i=0; i<count; i++) {
+        if constexpr ( by_value ) {
+            Packet p;
+            in_order = rb.getBlocking( p ) && in_order && i == p.seq && (uint8_t)i == p.payload[0];
+        } else {
+            SharedPacket p = rb.getBlocking();
+            in_order = in_order && nullptr != p && i == p->seq && (uint8_t)i == p->payload[0];
+        }
+    }
+    putThread01.join();
+    return in_order && rb.isEmpty();
+}
+
+template<class Ringbuffer, bool by_value>
+static bool benchmark_1p1c_packet(const std::string& title, const jau::nsize_t capacity) {
+    const jau::nsize_t count = catch_auto_run ? 10000 : 1000000;
+    const int loops = catch_auto_run ? 1 : 5;
+    Ringbuffer rb(capacity);
+    const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for(int i=0; i<loops; i++) {
+        REQUIRE( true == test_1p1c_packet<Ringbuffer, by_value>(rb, count) );
+    }
+    const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    const double secs = std::chrono::duration<double>(t1 - t0).count();
+    const double ops = (double)count * (double)loops;
+    printf("%s: capacity %u: %u packets x %d loops in %.3f ms, %.2f Mops/s\n",
+            title.c_str(), (unsigned int)capacity, (unsigned int)count, loops, secs * 1000.0, ops / secs / 1000000.0);
+    return true;
+}
+
+/** Trivially copyable 256 byte record. */
+struct Record {
+    jau::nsize_t seq;
+    uint8_t payload[256 - sizeof(jau::nsize_t)];
+};
+typedef value_ringbuffer<Record, jau::nsize_t, false /* multi_pc */> RecordRingbufferSPSC;
+
+/**
+ * One putter and one getter thread transferring count records,
+ * either by copy via putBlocking/getBlocking or in place via the zero-copy operations.
+ * @return true if all records have been received in order
+ */
+static bool test_1p1c_record(RecordRingbufferSPSC& rb, const jau::nsize_t count, const bool zero_copy) {
+    std::thread putThread01([&rb, count, zero_copy]() {
+        if( zero_copy ) {
+            jau::nsize_t i=0;
+            while( i<count ) {
+                RecordRingbufferSPSC::write_span_type s = rb.reserveWriteBlocking(1, 16);
+                for(jau::nsize_t j=0; j<s.size(); j++) {
+                    s[j].seq = i+j;
+                    s[j].payload[0] = (uint8_t)(i+j);
+                }
+                i += s.size();
+            }
+        } else {
+            Record r;
+            for(jau::nsize_t i=0; i<count; i++) {
+                r.seq = i;
+                r.payload[0] = (uint8_t)i;
+                rb.putBlocking( r );
+            }
+        }
+    });
+    bool in_order = true;
+    if( zero_copy ) {
+        jau::nsize_t i=0;
+        while( i<count ) {
+            RecordRingbufferSPSC::read_span_type s = rb.peekReadBlocking(1, 16);
+            for(jau::nsize_t j=0; j<s.size(); j++, i++) {
+                in_order = in_order && i == s[j].seq && (uint8_t)i == s[j].payload[0];
+            }
+        }
+    } else {
+        Record r;
+        for(jau::nsize_t i=0; i<count; i++) {
+            in_order = rb.getBlocking( r ) && in_order && i == r.seq && (uint8_t)i == r.payload[0];
+        }
+    }
+    putThread01.join();
+    return in_order && rb.isEmpty();
+}
+
+static bool benchmark_1p1c_record(const std::string& title, const jau::nsize_t capacity, const bool zero_copy) {
+    const jau::nsize_t count = catch_auto_run ? 10000 : 1000000;
+    const int loops = catch_auto_run ? 1 : 5;
+    RecordRingbufferSPSC rb(capacity);
+    const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for(int i=0; i<loops; i++) {
+        REQUIRE( true == test_1p1c_record(rb, count, zero_copy) );
+    }
+    const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    const double secs = std::chrono::duration<double>(t1 - t0).count();
+    const double ops = (double)count * (double)loops;
+    printf("%s: capacity %u, %u byte records: %u x %d loops in %.3f ms, %.2f Mops/s\n",
+            title.c_str(), (unsigned int)capacity, (unsigned int)sizeof(Record), (unsigned int)count, loops,
+            secs * 1000.0, ops / secs / 1000000.0);
+    return true;
+}
+
+/** Byte stream ring buffer w/ contiguous regions, as well as the two segment byte ring buffer to compare against. */
+typedef byte_ringbuffer<false /* multi_pc */> ByteRingbufferSPSC;
+typedef value_ringbuffer<uint8_t, jau::nsize_t, false /* multi_pc */> ByteValueRingbufferSPSC;
+
+/** Payload size of the i-th frame, varying between 16 and 1024 bytes. */
+static uint32_t frame_payload_size(const jau::nsize_t i) {
+    return 16 + static_cast<uint32_t>( ( i * 37 ) % 1009 );
+}
+
+/**
+ * Parses all complete frames of [data, data+size), each a uint32_t payload size followed by its payload.
+ * @return number of consumed bytes
+ */
+static std::size_t parse_frames(const uint8_t * data, const std::size_t size, jau::nsize_t& frames, uint64_t& checksum) {
+    std::size_t off = 0;
+    while( off + sizeof(uint32_t) <= size ) {
+        uint32_t len;
+        ::memcpy(&len, data + off, sizeof(len));
+        if( off + sizeof(uint32_t) + len > size ) {
+            break;
+        }
+        const uint8_t * payload = data + off + sizeof(uint32_t);
+        for(uint32_t j=0; j<len; j++) {
+            checksum += payload[j];
+        }
+        off += sizeof(uint32_t) + len;
+        ++frames;
+    }
+    return off;
+}
+
+/**
+ * One putter thread enqueuing count whole frames and one getter thread parsing them,
+ * either in place within the contiguous regions of jau::byte_ringbuffer
+ * or after copying the regions of jau::value_ringbuffer<uint8_t> into a jau::darray<uint8_t>.
+ * @return checksum of all parsed payloads
+ */
+template<class Ringbuffer, bool mirrored>
+static uint64_t test_1p1c_frames(Ringbuffer& rb, const jau::nsize_t count) {
+    std::thread putThread01([&rb, count]() {
+        std::vector<uint8_t> frame(sizeof(uint32_t) + 1024);
+        for(jau::nsize_t i=0; i<count; i++) {
+            const uint32_t len = frame_payload_size(i);
+            ::memcpy(frame.data(), &len, sizeof(len));
+            ::memset(frame.data() + sizeof(uint32_t), static_cast<uint8_t>(i), len);
+            const uint32_t total = sizeof(uint32_t) + len;
+            rb.putNBlocking(frame.data(), total, total); // whole frames only
+        }
+    });
+    jau::nsize_t frames = 0;
+    uint64_t checksum = 0;
+    if constexpr ( mirrored ) {
+        while( frames < count ) {
+            typename Ringbuffer::read_span_type s = rb.peekReadBlocking(sizeof(uint32_t), rb.capacity());
+            s.release( parse_frames(s.data1, s.size1, frames, checksum) );
+        }
+    } else {
+        jau::darray<uint8_t> buffer(2 * rb.capacity());
+        while( frames < count ) {
+            {
+                typename Ringbuffer::read_span_type s = rb.peekReadBlocking(sizeof(uint32_t), rb.capacity());
+                buffer.push_back(s.data1, s.data1 + s.size1);
+                buffer.push_back(s.data2, s.data2 + s.size2);
+            }
+            const std::size_t consumed = parse_frames(buffer.data(), buffer.size(), frames, checksum);
+            buffer.erase(buffer.begin(), buffer.cbegin() + consumed);
+        }
+    }
+    putThread01.join();
+    return checksum;
+}
+
+template<class Ringbuffer, bool mirrored>
+static bool benchmark_1p1c_frames(const std::string& title, const jau::nsize_t capacity) {
+    const jau::nsize_t count = catch_auto_run ? 10000 : 1000000;
+    const int loops = catch_auto_run ? 1 : 5;
+    uint64_t expected = 0;
+    std::size_t bytes = 0;
+    for(jau::nsize_t i=0; i<count; i++) {
+        expected += static_cast<uint64_t>( static_cast<uint8_t>(i) ) * frame_payload_size(i);
+        bytes += sizeof(uint32_t) + frame_payload_size(i);
+    }
+    Ringbuffer rb(capacity);
+    const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for(int i=0; i<loops; i++) {
+        REQUIRE( expected == test_1p1c_frames<Ringbuffer, mirrored>(rb, count) );
+        REQUIRE( true == rb.isEmpty() );
+    }
+    const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    const double secs = std::chrono::duration<double>(t1 - t0).count();
+    printf("%s: capacity %u: %u frames, %.1f MiB x %d loops in %.3f ms, %.2f GiB/s\n",
+            title.c_str(), (unsigned int)rb.capacity(), (unsigned int)count, (double)bytes / 1024.0 / 1024.0, loops,
+            secs * 1000.0, (double)bytes * (double)loops / secs / 1024.0 / 1024.0 / 1024.0);
+    return true;
+}
+
+typedef shm_ringbuffer<Packet, jau::nsize_t> PacketShmRingbuffer;
+
+static std::string shm_name(const std::string& suffix) {
+    return "/jau_test_lfringbuffer_perf01_"+std::to_string(::getpid())+"_"+suffix;
+}
+
+/** Writes or reads all count bytes of the given buffer, returns false on error or end of file. */
+static bool pipe_transfer(const int fd, uint8_t * buffer, std::size_t count, const bool write) {
+    while( 0 < count ) {
+        const ssize_t n = write ? ::write(fd, buffer, count) : ::read(fd, buffer, count);
+        if( 0 >= n ) {
+            return false;
+        }
+        buffer += n;
+        count -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+static bool wait_child(const pid_t pid) {
+    int status = 0;
+    return pid == ::waitpid(pid, &status, 0) && WIFEXITED(status) && 0 == WEXITSTATUS(status);
+}
+
+/**
+ * Transfers count packets in batches from a forked putter process to this getter process,
+ * either via jau::shm_ringbuffer or via a pipe.
+ */
+static bool benchmark_2proc_throughput(const std::string& title, const jau::nsize_t count, const jau::nsize_t batch, const bool use_shm) {
+    const std::string name = shm_name("tp");
+    std::unique_ptr<PacketShmRingbuffer> rb;
+    int fds[2] = { -1, -1 };
+    if( use_shm ) {
+        PacketShmRingbuffer::unlink(name);
+        rb = std::make_unique<PacketShmRingbuffer>(name, 1024, shm_role::getter);
+    } else {
+        REQUIRE( 0 == ::pipe(fds) );
+    }
+    std::vector<Packet> buffer(batch);
+    const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    const pid_t putter = ::fork();
+    if( 0 == putter ) {
+        bool ok = true;
+        if( use_shm ) {
+            PacketShmRingbuffer prb(name, shm_role::putter);
+            for(jau::nsize_t i=0; ok && i<count; i+=batch) {
+                for(jau::nsize_t j=0; j<batch; j++) {
+                    buffer[j].seq = i+j;
+                }
+                ok = batch == prb.putNBlocking(buffer.data(), batch, batch);
+            }
+        } else {
+            for(jau::nsize_t i=0; ok && i<count; i+=batch) {
+                for(jau::nsize_t j=0; j<batch; j++) {
+                    buffer[j].seq = i+j;
+                }
+                ok = pipe_transfer(fds[1], reinterpret_cast<uint8_t*>(buffer.data()), batch * sizeof(Packet), true);
+            }
+        }
+        ::_exit(ok ? 0 : 1);
+    }
+    REQUIRE( 0 < putter );
+    bool in_order = true;
+    for(jau::nsize_t i=0; i<count; ) {
+        jau::nsize_t n;
+        if( use_shm ) {
+            n = rb->getNBlocking(buffer.data(), 1, batch);
+        } else {
+            n = pipe_transfer(fds[0], reinterpret_cast<uint8_t*>(buffer.data()), batch * sizeof(Packet), false) ? batch : 0;
+        }
+        for(jau::nsize_t j=0; j<n; j++, i++) {
+            in_order = in_order && i == buffer[j].seq;
+        }
+        if( 0 == n ) {
+            break;
+        }
+    }
+    const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    REQUIRE( true == wait_child(putter) );
+    REQUIRE( true == in_order );
+    if( use_shm ) {
+        rb = nullptr;
+        PacketShmRingbuffer::unlink(name);
+    } else {
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+    const double secs = std::chrono::duration<double>(t1 - t0).count();
+    printf("%s: %u packets of %u bytes, batch %u in %.3f ms, %.2f Mops/s\n",
+            title.c_str(), (unsigned int)count, (unsigned int)sizeof(Packet), (unsigned int)batch, secs * 1000.0, (double)count / secs / 1000000.0);
+    return true;
+}
+
+/**
+ * Ping-pong round trip of a single packet between this process and a forked echo process,
+ * either via two jau::shm_ringbuffer or via two pipes.
+ */
+static bool benchmark_2proc_pingpong(const std::string& title, const jau::nsize_t count, const bool use_shm) {
+    const std::string ping_name = shm_name("ping"), pong_name = shm_name("pong");
+    std::unique_ptr<PacketShmRingbuffer> ping, pong;
+    int ping_fds[2] = { -1, -1 }, pong_fds[2] = { -1, -1 };
+    if( use_shm ) {
+        PacketShmRingbuffer::unlink(ping_name);
+        PacketShmRingbuffer::unlink(pong_name);
+        ping = std::make_unique<PacketShmRingbuffer>(ping_name, 64, shm_role::putter);
+        pong = std::make_unique<PacketShmRingbuffer>(pong_name, 64, shm_role::getter);
+    } else {
+        REQUIRE( 0 == ::pipe(ping_fds) );
+        REQUIRE( 0 == ::pipe(pong_fds) );
+    }
+    const pid_t echo = ::fork();
+    if( 0 == echo ) {
+        bool ok = true;
+        Packet p;
+        if( use_shm ) {
+            PacketShmRingbuffer eping(ping_name, shm_role::getter), epong(pong_name, shm_role::putter);
+            for(jau::nsize_t i=0; ok && i<count; i++) {
+                ok = eping.getBlocking(p) && epong.putBlocking(p);
+            }
+        } else {
+            for(jau::nsize_t i=0; ok && i<count; i++) {
+                ok = pipe_transfer(ping_fds[0], reinterpret_cast<uint8_t*>(&p), sizeof(p), false) &&
+                     pipe_transfer(pong_fds[1], reinterpret_cast<uint8_t*>(&p), sizeof(p), true);
+            }
+        }
+        ::_exit(ok ? 0 : 1);
+    }
+    REQUIRE( 0 < echo );
+    bool in_order = true;
+    Packet p;
+    const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for(jau::nsize_t i=0; i<count; i++) {
+        p.seq = i;
+        if( use_shm ) {
+            in_order = ping->putBlocking(p) && pong->getBlocking(p) && in_order && i == p.seq;
+        } else {
+            in_order = pipe_transfer(ping_fds[1], reinterpret_cast<uint8_t*>(&p), sizeof(p), true) &&
+                       pipe_transfer(pong_fds[0], reinterpret_cast<uint8_t*>(&p), sizeof(p), false) && in_order && i == p.seq;
+        }
+    }
+    const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    REQUIRE( true == wait_child(echo) );
+    REQUIRE( true == in_order );
+    if( use_shm ) {
+        ping = nullptr;
+        pong = nullptr;
+        PacketShmRingbuffer::unlink(ping_name);
+        PacketShmRingbuffer::unlink(pong_name);
+    } else {
+        for(int fd : { ping_fds[0], ping_fds[1], pong_fds[0], pong_fds[1] }) {
+            ::close(fd);
+        }
+    }
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    printf("%s: %u round trips: %.3f ns/round-trip\n", title.c_str(), (unsigned int)count, ns / (double)count);
+    return true;
+}
+
+/** Pins the given thread to the given CPU modulo the number of available CPUs, returns false on failure. */
+static bool pin_thread(const pthread_t thread, const unsigned int cpu) {
+    const unsigned int cpu_count = std::max(1U, std::thread::hardware_concurrency());
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu % cpu_count, &cpuset);
+    return 0 == pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+}
+
+/** Allows the given thread to run on all available CPUs again. */
+static void unpin_thread(const pthread_t thread) {
+    const unsigned int cpu_count = std::max(1U, std::thread::hardware_concurrency());
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for(unsigned int i=0; i<cpu_count; i++) {
+        CPU_SET(i, &cpuset);
+    }
+    pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+}
+
+/** Echo thread, returning each element received from ping via pong. */
+template<class Ringbuffer>
+static void pingpong_echo(Ringbuffer* ping, Ringbuffer* pong, const jau::nsize_t count) {
+    for(jau::nsize_t i=0; i<count; i++) {
+        pong->putBlocking( ping->getBlocking() );
+    }
+}
+
+/**
+ * Ping-pong round trip of a single element between this thread and an echo thread,
+ * pinned to CPU 0 and 1 respectively.
+ */
+template<class Ringbuffer>
+static bool benchmark_pingpong(const std::string& title, Ringbuffer& ping, Ringbuffer& pong, const jau::nsize_t count) {
+    Integer value(1);
+    std::thread echo(pingpong_echo<Ringbuffer>, &ping, &pong, count); // @suppress("Invalid arguments")
+    const bool pinned = pin_thread(echo.native_handle(), 1) && pin_thread(pthread_self(), 0);
+    bool in_order = true;
+    const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for(jau::nsize_t i=0; i<count; i++) {
+        ping.putBlocking( &value );
+        in_order = in_order && &value == pong.getBlocking();
+    }
+    const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+    echo.join();
+    unpin_thread(pthread_self());
+    const unsigned int cpu_count = std::max(1U, std::thread::hardware_concurrency());
+    const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    printf("%s: %u round trips, pinned %d on %u cpus: %.3f ns/round-trip\n",
+            title.c_str(), (unsigned int)count, pinned, cpu_count, ns / (double)count);
+    REQUIRE( true == in_order );
+    REQUIRE( true == ping.isEmpty() );
+    REQUIRE( true == pong.isEmpty() );
+    return true;
+}
+
+/****************************************************************************************
+ ****************************************************************************************/
+
+TEST_CASE( "Perf Test 01 - 1 Putter 1 Getter, multi_pc vs SPSC", "[ringbuffer][spsc]" ) {
+    benchmark_1p1c<IntegerRingbufferMulti>("RB_Multi_cap0064", 64, false);
+    benchmark_1p1c<IntegerRingbufferSPSC> ("RB_SPSC__cap0064", 64, false);
+    benchmark_1p1c<IntegerRingbufferMulti>("RB_Multi_cap0064", 64, true);
+    benchmark_1p1c<IntegerRingbufferSPSC> ("RB_SPSC__cap0064", 64, true);
+
+    benchmark_1p1c<IntegerRingbufferMulti>("RB_Multi_cap1024", 1024, false);
+    benchmark_1p1c<IntegerRingbufferSPSC> ("RB_SPSC__cap1024", 1024, false);
+    benchmark_1p1c<IntegerRingbufferMulti>("RB_Multi_cap1024", 1024, true);
+    benchmark_1p1c<IntegerRingbufferSPSC> ("RB_SPSC__cap1024", 1024, true);
+}
+
+TEST_CASE( "Perf Test 02 - 1 Putter 1 Getter, batch getN/putN", "[ringbuffer][batch]" ) {
+    benchmark_1p1c<IntegerRingbufferMulti>("RB_Multi_cap1024", 1024, false, 64);
+    benchmark_1p1c<IntegerRingbufferSPSC> ("RB_SPSC__cap1024", 1024, false, 64);
+    benchmark_1p1c<IntegerRingbufferMulti>("RB_Multi_cap1024", 1024, true, 64);
+    benchmark_1p1c<IntegerRingbufferSPSC> ("RB_SPSC__cap1024", 1024, true, 64);
+
+    benchmark_1p1c<IntegerRingbufferMulti>("RB_Multi_cap1024", 1024, true, 256);
+    benchmark_1p1c<IntegerRingbufferSPSC> ("RB_SPSC__cap1024", 1024, true, 256);
+}
+
+TEST_CASE( "Perf Test 03 - Handoff latency percentiles per wait policy", "[ringbuffer][latency]" ) {
+    benchmark_latency<ringbuffer_wait_spin> ("RB_Wait_Spin_");
+    benchmark_latency<ringbuffer_wait_yield>("RB_Wait_Yield");
+    benchmark_latency<ringbuffer_wait_futex>("RB_Wait_Futex");
+    benchmark_latency<ringbuffer_wait_cv>   ("RB_Wait_CV___");
+}
+
+/**
+ * The non-sleeping ringbuffer_wait_spin policy is used for the single thread comparison,
+ * as the SC fence of a sleeping policy's notify() would dominate the per-op cost.
+ */
+TEST_CASE( "Perf Test 04 - Single thread, modulo vs pow2 mask vs compile-time capacity", "[ringbuffer][pow2][fixed]" ) {
+    const jau::nsize_t count = catch_auto_run ? 1000000 : 100000000;
+    benchmark_index_step(1001, count);
+    benchmark_index_step(1024, count);
+    {
+        baseline_ringbuffer<IntegerPtr, nullptr, jau::nsize_t, ringbuffer_wait_spin> rb(1000);
+        benchmark_single("RBB_SPSC_cap1000_modulo_", rb);
+    }
+    {
+        ringbuffer<IntegerPtr, nullptr, jau::nsize_t, false /* multi_pc */, ringbuffer_wait_spin> rb(1000);
+        benchmark_single("RB_SPSC__cap1000_compare", rb);
+    }
+    {
+        ringbuffer<IntegerPtr, nullptr, jau::nsize_t, false /* multi_pc */, ringbuffer_wait_spin> rb(1000, true /* pow2 */);
+        benchmark_single("RB_SPSC__cap1024_pow2___", rb);
+    }
+    {
+        fixed_ringbuffer<IntegerPtr, nullptr, jau::nsize_t, 1000, false /* multi_pc */, ringbuffer_wait_spin> rb;
+        benchmark_single("RBF_SPSC_cap1000_const__", rb);
+    }
+    {
+        fixed_ringbuffer<IntegerPtr, nullptr, jau::nsize_t, 1024, false /* multi_pc */, ringbuffer_wait_spin> rb;
+        benchmark_single("RBF_SPSC_cap1024_pow2___", rb);
+    }
+    {
+        std::vector<Integer> source = createIntArray(10000);
+        IntegerRingbufferSPSC rb(1000, true /* pow2 */);
+        REQUIRE( true == test_1p1c(rb, source, true, 0) );
+        IntegerFixedRingbufferSPSC1024 rbf;
+        REQUIRE( true == test_1p1c(rbf, source, true, 0) );
+        REQUIRE( true == test_1p1c(rbf, source, true, 64) );
+    }
+}
+
+/**
+ * The baseline_ringbuffer variants keep the original adjacent read and write position,
+ * reloading the opposite one on every operation, exposing the cost of the shared cache line.
+ */
+TEST_CASE( "Perf Test 05 - Two core ping-pong round trip", "[ringbuffer][pingpong]" ) {
+    const jau::nsize_t count = catch_auto_run ? 10000 : 1000000;
+    {
+        baseline_ringbuffer<IntegerPtr, nullptr, jau::nsize_t, ringbuffer_wait_yield> ping(64), pong(64);
+        benchmark_pingpong("RBB_SPSC_Yield", ping, pong, count);
+    }
+    {
+        ringbuffer<IntegerPtr, nullptr, jau::nsize_t, false /* multi_pc */, ringbuffer_wait_yield> ping(64), pong(64);
+        benchmark_pingpong("RB_SPSC__Yield", ping, pong, count);
+    }
+    {
+        fixed_ringbuffer<IntegerPtr, nullptr, jau::nsize_t, 64, false /* multi_pc */, ringbuffer_wait_yield> ping, pong;
+        benchmark_pingpong("RBF_SPSC_Yield", ping, pong, count);
+    }
+    {
+        ringbuffer<IntegerPtr, nullptr, jau::nsize_t, true  /* multi_pc */, ringbuffer_wait_yield> ping(64), pong(64);
+        benchmark_pingpong("RB_Multi_Yield", ping, pong, count);
+    }
+    {
+        baseline_ringbuffer<IntegerPtr, nullptr, jau::nsize_t, ringbuffer_wait_futex> ping(64), pong(64);
+        benchmark_pingpong("RBB_SPSC_Futex", ping, pong, count);
+    }
+    {
+        ringbuffer<IntegerPtr, nullptr, jau::nsize_t, false /* multi_pc */, ringbuffer_wait_futex> ping(64), pong(64);
+        benchmark_pingpong("RB_SPSC__Futex", ping, pong, count);
+    }
+    if( 1 < std::thread::hardware_concurrency() ) {
+        {
+            baseline_ringbuffer<IntegerPtr, nullptr, jau::nsize_t, ringbuffer_wait_spin> ping(64), pong(64);
+            benchmark_pingpong("RBB_SPSC_Spin_", ping, pong, count);
+        }
+        {
+            ringbuffer<IntegerPtr, nullptr, jau::nsize_t, false /* multi_pc */, ringbuffer_wait_spin> ping(64), pong(64);
+            benchmark_pingpong("RB_SPSC__Spin_", ping, pong, count);
+        }
+        {
+            fixed_ringbuffer<IntegerPtr, nullptr, jau::nsize_t, 64, false /* multi_pc */, ringbuffer_wait_spin> ping, pong;
+            benchmark_pingpong("RBF_SPSC_Spin_", ping, pong, count);
+        }
+    }
+}
+
+TEST_CASE( "Perf Test 06 - 1 Putter 1 Getter, value type vs shared_ptr packets", "[ringbuffer][value]" ) {
+    benchmark_1p1c_packet<ringbuffer<SharedPacket, nullptr, jau::nsize_t, false /* multi_pc */>, false>("RB_SPSC__SharedPacket", 1024);
+    benchmark_1p1c_packet<value_ringbuffer<Packet, jau::nsize_t, false /* multi_pc */>, true>       ("RBV_SPSC_ValuePacket_", 1024);
+    benchmark_1p1c_packet<ringbuffer<SharedPacket, nullptr, jau::nsize_t>, false>                   ("RB_Multi_SharedPacket", 1024);
+    benchmark_1p1c_packet<value_ringbuffer<Packet, jau::nsize_t>, true>                             ("RBV_Multi_ValuePacket", 1024);
+}
+
+TEST_CASE( "Perf Test 07 - 1 Putter 1 Getter, large records copy vs zero-copy", "[ringbuffer][value][zerocopy]" ) {
+    benchmark_1p1c_record("RBV_SPSC_Record_Copy____", 256, false);
+    benchmark_1p1c_record("RBV_SPSC_Record_ZeroCopy", 256, true);
+}
+
+TEST_CASE( "Perf Test 08 - 1 Putter 1 Getter, framed bytes mirrored in place vs copy into darray", "[ringbuffer][bytes][zerocopy]" ) {
+    benchmark_1p1c_frames<ByteValueRingbufferSPSC, false>("RBV_SPSC_Frames_CopyDArray", 64*1024);
+    benchmark_1p1c_frames<ByteRingbufferSPSC, true>      ("RBB_SPSC_Frames_Mirrored__", 64*1024);
+}
+
+TEST_CASE( "Perf Test 09 - Two processes, shared memory vs pipe", "[ringbuffer][shm]" ) {
+    const jau::nsize_t count = catch_auto_run ? 10000 : 1000000;
+    const jau::nsize_t rt_count = catch_auto_run ? 1000 : 100000;
+    benchmark_2proc_throughput("Pipe_2Proc_Batch01", count,  1, false);
+    benchmark_2proc_throughput("Shm__2Proc_Batch01", count,  1, true);
+    benchmark_2proc_throughput("Pipe_2Proc_Batch64", count, 64, false);
+    benchmark_2proc_throughput("Shm__2Proc_Batch64", count, 64, true);
+    benchmark_2proc_pingpong("Pipe_2Proc_PingPong", rt_count, false);
+    benchmark_2proc_pingpong("Shm__2Proc_PingPong", rt_count, true);
+}
+
+TEST_CASE( "Perf Test 10 - 1 Putter 1 Getter, statistics disabled vs enabled", "[ringbuffer][stats]" ) {
+    benchmark_1p1c<IntegerRingbufferSPSC>      ("RB_SPSC__cap1024______", 1024, true);
+    benchmark_1p1c<IntegerRingbufferSPSCStats> ("RB_SPSC__cap1024_Stats", 1024, true);
+    benchmark_1p1c<IntegerRingbufferMulti>     ("RB_Multi_cap1024______", 1024, true);
+    benchmark_1p1c<IntegerRingbufferMultiStats>("RB_Multi_cap1024_Stats", 1024, true);
+    benchmark_1p1c<IntegerRingbufferSPSC>      ("RB_SPSC__cap1024______", 1024, true, 64);
+    benchmark_1p1c<IntegerRingbufferSPSCStats> ("RB_SPSC__cap1024_Stats", 1024, true, 64);
+}
@@ -0,0 +1,452 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <pthread.h>
+#include <time.h>
+
+#define CATCH_CONFIG_RUNNER
+// #define CATCH_CONFIG_MAIN
+#include <catch2/catch_amalgamated.hpp>
+#include <jau/test/catch2_ext.hpp>
+
+#include <jau/ringbuffer.hpp>
+#include <jau/value_ringbuffer.hpp>
+#include <jau/environment.hpp>
+#include <jau/version.hpp>
+
+/**
+ * Benchmark suite of jau::ringbuffer and jau::value_ringbuffer under 1P1C, NP1C and NPMC load,
+ * sweeping element kind and size, SPSC vs multi_pc mode, wait policy, capacity and thread count.
+ * <p>
+ * Each run reports the throughput in ops/sec, the handoff latency percentiles from put to get
+ * and the thread CPU time per op of the putter and getter side.
+ * </p>
+ * <p>
+ * Properties, see jau::environment::getProperty():
+ * <ul>
+ *   <li><code>jau.bench.json=&lt;file&gt;</code> writes all results as JSON to the given file,
+ *       allowing to diff runs between jaulib versions.</li>
+ *   <li><code>jau.bench.pin=true</code> pins each putter and getter thread to its own CPU modulo the number of CPUs.</li>
+ * </ul>
+ * </p>
+ * <p>
+ * Without command-line arguments, i.e. as a CI unit test, only a reduced sweep w/ few elements is run.
+ * </p>
+ */
+using namespace jau;
+
+/** Sequence number of the poison sample, terminating a getter. */
+constexpr static const uint64_t poison_seq = UINT64_MAX;
+
+/** Transferred sample of sample_size bytes, carrying its sequence number, putter and put timestamp. */
+template<std::size_t sample_size>
+struct Sample {
+    uint64_t seq;
+    int64_t t0; // steady_clock nanoseconds at put
+    uint32_t producer;
+    uint8_t payload[sample_size - 20];
+};
+typedef Sample<32> Sample32;
+typedef Sample<64> Sample64;
+typedef Sample<256> Sample256;
+static_assert(32 == sizeof(Sample32), "Sample32 size");
+static_assert(64 == sizeof(Sample64), "Sample64 size");
+static_assert(256 == sizeof(Sample256), "Sample256 size");
+
+static int64_t now_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int64_t thread_cpu_ns() noexcept {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000L + ts.tv_nsec;
+}
+
+static bool pinning() {
+    static const bool v = jau::environment::getBooleanProperty("jau.bench.pin", false);
+    return v;
+}
+
+/** Pins the calling thread to the given CPU modulo the number of available CPUs, returns false on failure. */
+static bool pin_this_thread(const unsigned int cpu) {
+    const unsigned int cpu_count = std::max(1U, std::thread::hardware_concurrency());
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu % cpu_count, &cpuset);
+    return 0 == pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+}
+
+/****************************************************************************************
+ ****************************************************************************************/
+
+template<class Wait_policy> const char* wait_name();
+template<> const char* wait_name<ringbuffer_wait_cv>() { return "cv"; }
+template<> const char* wait_name<ringbuffer_wait_futex>() { return "futex"; }
+template<> const char* wait_name<ringbuffer_wait_yield>() { return "yield"; }
+template<> const char* wait_name<ringbuffer_wait_spin>() { return "spin"; }
+
+/**
+ * Elements are pointers into each putter's preallocated samples, transferred via jau::ringbuffer.
+ */
+template<class Sample_type, bool multi_pc, class Wait_policy>
+struct ptr_adapter {
+    typedef Sample_type sample_type;
+    typedef Sample_type* value_type;
+    typedef ringbuffer<value_type, nullptr, jau::nsize_t, multi_pc, Wait_policy> ringbuffer_type;
+    typedef Wait_policy wait_policy_type;
+    constexpr static const bool is_multi_pc = multi_pc;
+
+    static const char* name() { return "ringbuffer<T*>"; }
+
+    /** Per putter element source, outliving the getters. */
+    struct source {
+        std::vector<Sample_type> samples;
+        jau::nsize_t next = 0;
+
+        source(const jau::nsize_t count) : samples(count) {}
+
+        value_type make(const Sample_type& s) noexcept { samples[next] = s; return &samples[next++]; }
+    };
+    static const Sample_type& sample(const value_type& e) noexcept { return *e; }
+    static void getBlocking(ringbuffer_type& rb, value_type& e) noexcept { e = rb.getBlocking(); }
+};
+
+/**
+ * Elements are heap allocated std::shared_ptr per put, transferred via jau::ringbuffer.
+ */
+template<class Sample_type, bool multi_pc, class Wait_policy>
+struct shared_adapter {
+    typedef Sample_type sample_type;
+    typedef std::shared_ptr<Sample_type> value_type;
+    typedef ringbuffer<value_type, nullptr, jau::nsize_t, multi_pc, Wait_policy> ringbuffer_type;
+    typedef Wait_policy wait_policy_type;
+    constexpr static const bool is_multi_pc = multi_pc;
+
+    static const char* name() { return "ringbuffer<shared_ptr<T>>"; }
+
+    struct source {
+        source(const jau::nsize_t) {}
+
+        value_type make(const Sample_type& s) { return std::make_shared<Sample_type>(s); }
+    };
+    static const Sample_type& sample(const value_type& e) noexcept { return *e; }
+    static void getBlocking(ringbuffer_type& rb, value_type& e) noexcept { e = rb.getBlocking(); }
+};
+
+/**
+ * Elements are the samples themselves, copied via jau::value_ringbuffer.
+ */
+template<class Sample_type, bool multi_pc, class Wait_policy>
+struct value_adapter {
+    typedef Sample_type sample_type;
+    typedef Sample_type value_type;
+    typedef value_ringbuffer<value_type, jau::nsize_t, multi_pc, Wait_policy> ringbuffer_type;
+    typedef Wait_policy wait_policy_type;
+    constexpr static const bool is_multi_pc = multi_pc;
+
+    static const char* name() { return "value_ringbuffer<T>"; }
+
+    struct source {
+        source(const jau::nsize_t) {}
+
+        value_type make(const Sample_type& s) noexcept { return s; }
+    };
+    static const Sample_type& sample(const value_type& e) noexcept { return e; }
+    static void getBlocking(ringbuffer_type& rb, value_type& e) noexcept { rb.getBlocking(e); }
+};
+
+/****************************************************************************************
+ ****************************************************************************************/
+
+struct bench_result {
+    std::string test;
+    std::string impl;
+    unsigned int element_size;
+    unsigned int sample_size;
+    bool multi_pc;
+    std::string wait;
+    unsigned int capacity;
+    unsigned int producers;
+    unsigned int consumers;
+    uint64_t elements;
+    bool pinned;
+    bool in_order;
+    double wall_ns;
+    double ops_per_sec;
+    int64_t latency_p50, latency_p90, latency_p99, latency_p999, latency_max;
+    double put_cpu_ns_per_op, get_cpu_ns_per_op;
+};
+
+static std::vector<bench_result> results;
+
+/** Writes all results as JSON to the file given by property <code>jau.bench.json</code>, if set. */
+static void write_json() {
+    const std::string path = jau::environment::getProperty("jau.bench.json");
+    if( 0 == path.length() ) {
+        return;
+    }
+    FILE * out = ::fopen(path.c_str(), "w");
+    REQUIRE_MSG("open "+path, nullptr != out);
+    fprintf(out, "{\n  \"benchmark\": \"test_lfringbuffer_perf02\",\n  \"jaulib_version\": \"%s\",\n", jau::VERSION);
+    fprintf(out, "  \"cpu_count\": %u,\n  \"auto_run\": %s,\n  \"results\": [\n",
+            std::max(1U, std::thread::hardware_concurrency()), catch_auto_run ? "true" : "false");
+    for(std::size_t i=0; i<results.size(); i++) {
+        const bench_result& r = results[i];
+        fprintf(out, "    { \"test\": \"%s\", \"impl\": \"%s\", \"element_size\": %u, \"sample_size\": %u, \"multi_pc\": %s, \"wait\": \"%s\",\n",
+                r.test.c_str(), r.impl.c_str(), r.element_size, r.sample_size, r.multi_pc ? "true" : "false", r.wait.c_str());
+        fprintf(out, "      \"capacity\": %u, \"producers\": %u, \"consumers\": %u, \"elements\": %" PRIu64 ", \"pinned\": %s, \"in_order\": %s,\n",
+                r.capacity, r.producers, r.consumers, r.elements, r.pinned ? "true" : "false", r.in_order ? "true" : "false");
+        fprintf(out, "      \"wall_ns\": %.0f, \"ops_per_sec\": %.1f,\n", r.wall_ns, r.ops_per_sec);
+        fprintf(out, "      \"latency_ns\": { \"p50\": %" PRId64 ", \"p90\": %" PRId64 ", \"p99\": %" PRId64 ", \"p999\": %" PRId64 ", \"max\": %" PRId64 " },\n",
+                r.latency_p50, r.latency_p90, r.latency_p99, r.latency_p999, r.latency_max);
+        fprintf(out, "      \"cpu_ns_per_op\": { \"put\": %.1f, \"get\": %.1f, \"total\": %.1f } }%s\n",
+                r.put_cpu_ns_per_op, r.get_cpu_ns_per_op, r.put_cpu_ns_per_op + r.get_cpu_ns_per_op,
+                i+1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+    ::fclose(out);
+}
+
+template<class Adapter>
+static void putThread(typename Adapter::ringbuffer_type* rb, typename Adapter::source* src, const uint32_t producer,
+                      const jau::nsize_t count, const unsigned int cpu, int64_t* cpu_ns)
+{
+    if( pinning() ) {
+        pin_this_thread(cpu);
+    }
+    const int64_t c0 = thread_cpu_ns();
+    typename Adapter::sample_type s;
+    ::memset(&s, 0, sizeof(s));
+    s.producer = producer;
+    for(jau::nsize_t i=0; i<count; i++) {
+        s.seq = i;
+        s.t0 = now_ns();
+        rb->putBlocking( src->make(s) );
+    }
+    *cpu_ns = thread_cpu_ns() - c0;
+}
+
+/** Getter until the poison sample, recording the handoff latency and checking the per putter order. */
+template<class Adapter>
+static void getThread(typename Adapter::ringbuffer_type* rb, const jau::nsize_t producers, const unsigned int cpu,
+                      std::vector<int64_t>* latencies, int64_t* cpu_ns, bool* in_order)
+{
+    if( pinning() ) {
+        pin_this_thread(cpu);
+    }
+    const int64_t c0 = thread_cpu_ns();
+    std::vector<uint64_t> next(producers, 0); // minimum next sequence number per putter
+    bool ok = true;
+    while( true ) {
+        typename Adapter::value_type e;
+        Adapter::getBlocking(*rb, e);
+        const typename Adapter::sample_type& s = Adapter::sample(e);
+        if( poison_seq == s.seq ) {
+            break;
+        }
+        latencies->push_back( now_ns() - s.t0 );
+        ok = ok && s.producer < producers && s.seq >= next[s.producer];
+        if( s.producer < producers ) {
+            next[s.producer] = s.seq + 1;
+        }
+    }
+    *cpu_ns = thread_cpu_ns() - c0;
+    *in_order = ok;
+}
+
+/**
+ * Transfers count samples from each of the given number of putter threads to the given number of getter threads,
+ * terminating each getter via a poison sample after all putters completed.
+ */
+template<class Adapter>
+static void run(const std::string& test, const jau::nsize_t capacity, const jau::nsize_t producers, const jau::nsize_t consumers,
+                const jau::nsize_t count)
+{
+    typedef typename Adapter::ringbuffer_type ringbuffer_type;
+    ringbuffer_type rb(capacity);
+    std::vector<typename Adapter::source> sources;
+    for(jau::nsize_t p=0; p<producers; p++) {
+        sources.emplace_back(count);
+    }
+    typename Adapter::source poison_source(consumers);
+    std::vector<std::vector<int64_t>> latencies(consumers);
+    std::vector<int64_t> put_cpu_ns(producers, 0), get_cpu_ns(consumers, 0);
+    std::unique_ptr<bool[]> in_order(new bool[consumers]);
+    for(jau::nsize_t c=0; c<consumers; c++) {
+        latencies[c].reserve( count * producers );
+    }
+
+    const int64_t t0 = now_ns();
+    std::vector<std::thread> getters, putters;
+    for(jau::nsize_t c=0; c<consumers; c++) {
+        getters.push_back( std::thread(getThread<Adapter>, &rb, producers, static_cast<unsigned int>(producers+c), // @suppress("Invalid arguments")
+                                       &latencies[c], &get_cpu_ns[c], &in_order[c]) );
+    }
+    for(jau::nsize_t p=0; p<producers; p++) {
+        putters.push_back( std::thread(putThread<Adapter>, &rb, &sources[p], static_cast<uint32_t>(p), count, // @suppress("Invalid arguments")
+                                       static_cast<unsigned int>(p), &put_cpu_ns[p]) );
+    }
+    for(std::thread& t : putters) {
+        t.join();
+    }
+    typename Adapter::sample_type poison;
+    ::memset(&poison, 0, sizeof(poison));
+    poison.seq = poison_seq;
+    for(jau::nsize_t c=0; c<consumers; c++) {
+        rb.putBlocking( poison_source.make(poison) );
+    }
+    for(std::thread& t : getters) {
+        t.join();
+    }
+    const int64_t t1 = now_ns();
+
+    bench_result r;
+    r.test = test;
+    r.impl = Adapter::name();
+    r.element_size = static_cast<unsigned int>( sizeof(typename Adapter::value_type) );
+    r.sample_size = static_cast<unsigned int>( sizeof(typename Adapter::sample_type) );
+    r.multi_pc = Adapter::is_multi_pc;
+    r.wait = wait_name<typename Adapter::wait_policy_type>();
+    r.capacity = static_cast<unsigned int>( capacity );
+    r.producers = static_cast<unsigned int>( producers );
+    r.consumers = static_cast<unsigned int>( consumers );
+    r.elements = static_cast<uint64_t>(count) * producers;
+    r.pinned = pinning();
+    r.in_order = true;
+
+    std::vector<int64_t> all;
+    all.reserve( r.elements );
+    for(jau::nsize_t c=0; c<consumers; c++) {
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+        r.in_order = r.in_order && in_order[c];
+    }
+    REQUIRE_MSG(test+": received all "+rb.toString(), r.elements == all.size());
+    REQUIRE_MSG(test+": in order", r.in_order);
+    REQUIRE_MSG(test+": empty "+rb.toString(), rb.isEmpty());
+    std::sort(all.begin(), all.end());
+    auto percentile = [&](const double p) -> int64_t {
+        return all[ std::min<std::size_t>(all.size()-1, static_cast<std::size_t>( p * static_cast<double>(all.size()) )) ];
+    };
+    r.wall_ns = static_cast<double>(t1 - t0);
+    r.ops_per_sec = static_cast<double>(r.elements) * 1e9 / r.wall_ns;
+    r.latency_p50 = percentile(0.50);
+    r.latency_p90 = percentile(0.90);
+    r.latency_p99 = percentile(0.99);
+    r.latency_p999 = percentile(0.999);
+    r.latency_max = all[all.size()-1];
+    int64_t put_cpu = 0, get_cpu = 0;
+    for(const int64_t v : put_cpu_ns) { put_cpu += v; }
+    for(const int64_t v : get_cpu_ns) { get_cpu += v; }
+    r.put_cpu_ns_per_op = static_cast<double>(put_cpu) / static_cast<double>(r.elements);
+    r.get_cpu_ns_per_op = static_cast<double>(get_cpu) / static_cast<double>(r.elements);
+
+    printf("%s: %s[%u bytes] %s %-5s cap %5u, %uP%uC: %.3f Mops/s, latency p50 %.3f p99 %.3f p999 %.3f us, cpu put %.1f get %.1f ns/op\n",
+            test.c_str(), r.impl.c_str(), r.sample_size, r.multi_pc ? "multi" : "spsc ", r.wait.c_str(), r.capacity,
+            r.producers, r.consumers, r.ops_per_sec / 1e6,
+            static_cast<double>(r.latency_p50) / 1e3, static_cast<double>(r.latency_p99) / 1e3, static_cast<double>(r.latency_p999) / 1e3,
+            r.put_cpu_ns_per_op, r.get_cpu_ns_per_op);
+    results.push_back(r);
+}
+
+/** Number of samples per putter. */
+static jau::nsize_t sample_count() {
+    return catch_auto_run ? 2000 : 200000;
+}
+
+static std::vector<jau::nsize_t> capacities() {
+    if( catch_auto_run ) {
+        return { 64, 1024 };
+    }
+    return { 64, 1024, 16384 };
+}
+
+/** Sweeps all capacities w/ the given putter and getter thread count pairs. */
+template<class Adapter>
+static void sweep(const std::string& test, const std::vector<std::pair<jau::nsize_t, jau::nsize_t>>& threads) {
+    for(const jau::nsize_t capacity : capacities()) {
+        for(const std::pair<jau::nsize_t, jau::nsize_t>& t : threads) {
+            run<Adapter>(test, capacity, t.first, t.second, sample_count());
+        }
+    }
+}
+
+/** Sweeps the sleeping and yielding wait policies, as well as the futex and busy spinning ones w/o auto_run. */
+template<template<class, bool, class> class Adapter, class Sample_type, bool multi_pc>
+static void sweep_waits(const std::string& test, const std::vector<std::pair<jau::nsize_t, jau::nsize_t>>& threads, const bool spin) {
+    sweep<Adapter<Sample_type, multi_pc, ringbuffer_wait_cv>>(test, threads);
+    sweep<Adapter<Sample_type, multi_pc, ringbuffer_wait_yield>>(test, threads);
+    if( !catch_auto_run ) {
+        sweep<Adapter<Sample_type, multi_pc, ringbuffer_wait_futex>>(test, threads);
+        if( spin ) {
+            sweep<Adapter<Sample_type, multi_pc, ringbuffer_wait_spin>>(test, threads);
+        }
+    }
+}
+
+/****************************************************************************************
+ ****************************************************************************************/
+
+TEST_CASE( "Bench Test 01 - 1P1C, SPSC vs multi_pc, element kind and size", "[ringbuffer][1p1c]" ) {
+    const std::vector<std::pair<jau::nsize_t, jau::nsize_t>> threads = { { 1, 1 } };
+    sweep_waits<ptr_adapter,    Sample32,  false>("1P1C", threads, true);
+    sweep_waits<ptr_adapter,    Sample32,  true >("1P1C", threads, true);
+    sweep_waits<shared_adapter, Sample64,  false>("1P1C", threads, true);
+    sweep_waits<shared_adapter, Sample64,  true >("1P1C", threads, true);
+    sweep_waits<value_adapter,  Sample64,  false>("1P1C", threads, true);
+    sweep_waits<value_adapter,  Sample64,  true >("1P1C", threads, true);
+    sweep_waits<value_adapter,  Sample256, false>("1P1C", threads, true);
+    sweep_waits<value_adapter,  Sample256, true >("1P1C", threads, true);
+    write_json();
+}
+
+TEST_CASE( "Bench Test 02 - NP1C, multi_pc", "[ringbuffer][np1c]" ) {
+    std::vector<std::pair<jau::nsize_t, jau::nsize_t>> threads = { { 2, 1 }, { 4, 1 } };
+    if( !catch_auto_run ) {
+        threads.push_back( { 8, 1 } );
+    }
+    sweep_waits<ptr_adapter,   Sample32, true>("NP1C", threads, false);
+    sweep_waits<value_adapter, Sample64, true>("NP1C", threads, false);
+    write_json();
+}
+
+TEST_CASE( "Bench Test 03 - NPMC, multi_pc", "[ringbuffer][npmc]" ) {
+    std::vector<std::pair<jau::nsize_t, jau::nsize_t>> threads = { { 2, 2 }, { 4, 4 } };
+    if( !catch_auto_run ) {
+        threads.push_back( { 4, 2 } );
+        threads.push_back( { 8, 8 } );
+    }
+    sweep_waits<ptr_adapter,   Sample32, true>("NPMC", threads, false);
+    sweep_waits<value_adapter, Sample64, true>("NPMC", threads, false);
+    write_json();
+}
@@ -0,0 +1,204 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <pthread.h>
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_amalgamated.hpp>
+#include <jau/test/catch2_ext.hpp>
+
+#include <jau/ringbuffer.hpp>
+#include <jau/mpmc_queue.hpp>
+
+using namespace jau;
+
+class Integer {
+    public:
+        jau::nsize_t value;
+
+        Integer(jau::nsize_t v) : value(v) {}
+
+        Integer(const Integer &o) noexcept = default;
+        Integer(Integer &&o) noexcept = default;
+        Integer& operator=(const Integer &o) noexcept = default;
+        Integer& operator=(Integer &&o) noexcept = default;
+
+        operator jau::nsize_t() const {
+            return value;
+        }
+        jau::nsize_t intValue() const { return value; }
+        static Integer valueOf(const jau::nsize_t i) { return Integer(i); }
+};
+
+typedef std::shared_ptr<Integer> SharedType;
+typedef mpmc_queue<SharedType, nullptr, jau::nsize_t> SharedTypeQueue;
+typedef mpmc_queue<SharedType, nullptr, jau::nsize_t, ringbuffer_wait_futex> SharedTypeQueueFutex;
+typedef ringbuffer<SharedType, nullptr, jau::nsize_t> SharedTypeRingbuffer;
+
+// Test examples.
+class TestMPMCQueue11 {
+  private:
+
+    /**
+     * Getter thread, taking len elements and counting each received value.
+     * Values of each putter thread must be received in ascending order.
+     */
+    template<class Queue>
+    void getThreadType01(const std::string msg, std::shared_ptr<Queue> rb, jau::nsize_t len,
+                         std::vector<std::atomic<int>>* received, const jau::nsize_t putterLen)
+    {
+        std::vector<jau::snsize_t> lastValue(received->size() / putterLen, -1);
+        for(jau::nsize_t i=0; i<len; i++) {
+            SharedType svI = rb->getBlocking();
+            REQUIRE_MSG("not empty at read #"+std::to_string(i+1)+": "+rb->toString(), svI!=nullptr);
+            const jau::nsize_t v = svI->intValue();
+            REQUIRE_MSG("value in range at read #"+std::to_string(i+1), v < received->size());
+            jau::snsize_t & last = lastValue[v / putterLen];
+            REQUIRE_MSG("value order at read #"+std::to_string(i+1), last < (jau::snsize_t)v);
+            last = v;
+            (*received)[v]++;
+        }
+        (void)msg;
+    }
+
+    template<class Queue>
+    void putThreadType01(const std::string msg, std::shared_ptr<Queue> rb, jau::nsize_t len, jau::nsize_t startValue) {
+        for(jau::nsize_t i=0; i<len; i++) {
+            rb->putBlocking( std::make_shared<Integer>(startValue+i) );
+        }
+        (void)msg;
+    }
+
+    /**
+     * Runs threadCount putter and threadCount getter threads concurrently,
+     * each putter enqueuing len elements and each getter dequeuing len elements.
+     * @return duration in milliseconds
+     */
+    template<class Queue>
+    double test_ReadNWriteNImpl(const std::string& title, const jau::nsize_t threadCount, const jau::nsize_t capacity, const jau::nsize_t len) {
+        std::shared_ptr<Queue> rb = std::make_shared<Queue>(capacity);
+        REQUIRE_MSG("empty size "+rb->toString(), 0 == rb->getSize());
+        REQUIRE_MSG("empty "+rb->toString(), rb->isEmpty());
+
+        std::vector<std::atomic<int>> received(threadCount*len);
+        for(std::atomic<int>& r : received) {
+            r = 0;
+        }
+        std::vector<std::thread> threads;
+        const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        for(jau::nsize_t i=0; i<threadCount; i++) {
+            threads.push_back( std::thread(&TestMPMCQueue11::getThreadType01<Queue>, this, title+".get"+std::to_string(i), rb, len, &received, len) ); // @suppress("Invalid arguments")
+            threads.push_back( std::thread(&TestMPMCQueue11::putThreadType01<Queue>, this, title+".put"+std::to_string(i), rb, len, i*len) ); // @suppress("Invalid arguments")
+        }
+        for(std::thread& t : threads) {
+            t.join();
+        }
+        const std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+        REQUIRE_MSG("empty "+rb->toString(), rb->isEmpty());
+        REQUIRE_MSG("empty size "+rb->toString(), 0 == rb->getSize());
+        for(jau::nsize_t i=0; i<received.size(); i++) {
+            REQUIRE_MSG("received once value "+std::to_string(i), 1 == received[i]);
+        }
+        const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        printf("%s: %u putter and getter threads, %u elements each: %.3f ms, %.2f Mops/s\n",
+                title.c_str(), (unsigned int)threadCount, (unsigned int)len, ms, (double)(threadCount*len) / ms / 1000.0);
+        return ms;
+    }
+
+  public:
+
+    void test01_SingleThreaded() {
+        INFO_STR("\n\ntest01_SingleThreaded\n");
+        const jau::nsize_t capacity = 11;
+        SharedTypeQueue rb(capacity);
+        REQUIRE_MSG("capacity "+rb.toString(), capacity == rb.capacity());
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+        REQUIRE_MSG("get empty "+rb.toString(), nullptr == rb.get());
+        REQUIRE_MSG("getBlocking timeout "+rb.toString(), nullptr == rb.getBlocking(10));
+
+        for(jau::nsize_t pos=0; pos<3*capacity; pos++) {
+            // fill up to full, wrapping around at varying positions
+            for(jau::nsize_t i=0; i<capacity; i++) {
+                REQUIRE_MSG("put #"+std::to_string(i)+": "+rb.toString(), rb.put( std::make_shared<Integer>(i) ) );
+            }
+            REQUIRE_MSG("full size "+rb.toString(), capacity == rb.getSize());
+            REQUIRE_MSG("full "+rb.toString(), rb.isFull());
+            REQUIRE_MSG("put full "+rb.toString(), !rb.put( std::make_shared<Integer>(100) ) );
+            REQUIRE_MSG("putBlocking timeout "+rb.toString(), !rb.putBlocking( std::make_shared<Integer>(100), 10 ) );
+            for(jau::nsize_t i=0; i<capacity; i++) {
+                SharedType svI = rb.get();
+                REQUIRE_MSG("not empty at read #"+std::to_string(i)+": "+rb.toString(), svI!=nullptr);
+                REQUIRE_MSG("value at read #"+std::to_string(i)+": "+rb.toString(), i == svI->intValue());
+            }
+            REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+            REQUIRE_MSG("free slots "+rb.toString(), capacity == rb.getFreeSlots());
+
+            // move positions
+            for(jau::nsize_t i=0; i<pos % capacity; i++) {
+                REQUIRE( rb.put( std::make_shared<Integer>(i) ) );
+                REQUIRE( i == rb.get()->intValue() );
+            }
+        }
+        for(jau::nsize_t i=0; i<5; i++) {
+            REQUIRE( rb.put( std::make_shared<Integer>(i) ) );
+        }
+        REQUIRE_MSG("drop "+rb.toString(), 2 == rb.drop(2));
+        REQUIRE_MSG("size "+rb.toString(), 3 == rb.getSize());
+        rb.clear();
+        REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+    }
+
+    void test02_ReadNWriteN_Scaling() {
+        INFO_STR("\n\ntest02_ReadNWriteN_Scaling\n");
+        const jau::nsize_t len = 10000;
+        for(jau::nsize_t n=1; n<=8; n*=2) {
+            test_ReadNWriteNImpl<SharedTypeQueue>     ("test02.mpmc_queue_cv___", n, 64, len);
+            test_ReadNWriteNImpl<SharedTypeQueueFutex>("test02.mpmc_queue_futex", n, 64, len);
+            test_ReadNWriteNImpl<SharedTypeRingbuffer>("test02.ringbuffer_multi", n, 64, len);
+        }
+    }
+
+    void test03_ReadNWriteN_SmallCapacity() {
+        INFO_STR("\n\ntest03_ReadNWriteN_SmallCapacity\n");
+        // forcing getter and putter to block on each other
+        test_ReadNWriteNImpl<SharedTypeQueue>     ("test03.mpmc_queue_cv___", 4, 2, 1000);
+        test_ReadNWriteNImpl<SharedTypeQueueFutex>("test03.mpmc_queue_futex", 4, 3, 1000);
+        {
+            SharedTypeQueue rb(1);
+            REQUIRE_MSG("minimum capacity "+rb.toString(), 2 == rb.capacity());
+        }
+    }
+};
+
+METHOD_AS_TEST_CASE( TestMPMCQueue11::test01_SingleThreaded,            "Test TestMPMCQueue 11- 01");
+METHOD_AS_TEST_CASE( TestMPMCQueue11::test02_ReadNWriteN_Scaling,       "Test TestMPMCQueue 11- 02");
+METHOD_AS_TEST_CASE( TestMPMCQueue11::test03_ReadNWriteN_SmallCapacity, "Test TestMPMCQueue 11- 03");
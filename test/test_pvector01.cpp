@@ -0,0 +1,193 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#define CATCH_CONFIG_RUNNER
+// #define CATCH_CONFIG_MAIN
+#include <catch2/catch_amalgamated.hpp>
+#include <jau/test/catch2_ext.hpp>
+
+#include <jau/basic_algos.hpp>
+#include <jau/basic_types.hpp>
+#include <jau/pvector.hpp>
+#include <jau/cow_pvector.hpp>
+
+/**
+ * Test general use of the persistent jau::pvector and its CoW variant jau::cow_pvector.
+ */
+using namespace jau;
+
+/**********************************************************************************************************************************************/
+/**********************************************************************************************************************************************/
+
+template<class PVec>
+static void testPVector(const std::string& type_id, const std::size_t count) {
+    typedef typename PVec::value_type value_type;
+    typedef typename PVec::size_type size_type;
+    auto make_value = [](std::size_t i) -> value_type { return value_type( std::to_string(i) ); };
+    std::vector<value_type> exp;
+    PVec data;
+    REQUIRE( data.empty() );
+
+    // push_back across chunk and level boundaries, each version stays an immutable snapshot
+    std::vector<PVec> versions;
+    for(std::size_t i=0; i<count; ++i) {
+        if( 0 == i % 97 ) { versions.push_back(data); }
+        data.push_back( make_value(i) );
+        exp.push_back( make_value(i) );
+    }
+    INFO_STR(type_id+": "+data.get_info());
+    REQUIRE( count == data.size() );
+    REQUIRE( std::equal(exp.cbegin(), exp.cend(), data.cbegin()) );
+    REQUIRE( make_value(count-1) == data.back() );
+    REQUIRE_THROWS_AS( data.at( static_cast<size_type>(count) ), jau::IndexOutOfBoundsException );
+    for(std::size_t v=0; v<versions.size(); ++v) {
+        const PVec& p = versions[v];
+        REQUIRE( v*97 == p.size() );
+        REQUIRE( std::equal(p.cbegin(), p.cend(), exp.cbegin()) );
+    }
+
+    // set copies the touched chunk and its path only
+    {
+        const PVec snap = data;
+        for(std::size_t i=0; i<count; i+=7) {
+            data.set( static_cast<size_type>(i), make_value(i+count) );
+            exp[i] = make_value(i+count);
+        }
+        REQUIRE( std::equal(exp.cbegin(), exp.cend(), data.cbegin()) );
+        REQUIRE( make_value(0) == snap[0] );
+        REQUIRE( make_value(count-1) == snap.back() );
+        REQUIRE( ( snap != data ) );
+        REQUIRE_THROWS_AS( data.set( static_cast<size_type>(count), make_value(0) ), jau::IndexOutOfBoundsException );
+    }
+
+    // erase_if keeps the leading chunks shared
+    {
+        PVec data2 = data;
+        const size_type erased = data2.erase_if( [](const value_type& e) -> bool { return '3' == e.back(); } );
+        std::vector<value_type> exp2 = exp;
+        exp2.erase( std::remove_if(exp2.begin(), exp2.end(), [](const value_type& e) -> bool { return '3' == e.back(); }), exp2.end() );
+        REQUIRE( exp.size() - exp2.size() == erased );
+        REQUIRE( exp2.size() == data2.size() );
+        REQUIRE( std::equal(exp2.cbegin(), exp2.cend(), data2.cbegin()) );
+        REQUIRE( 0 == data2.erase_if( [](const value_type& e) -> bool { return '3' == e.back(); } ) );
+        REQUIRE( std::equal(exp.cbegin(), exp.cend(), data.cbegin()) );
+    }
+
+    // pop_back down to empty, shrinking the tree
+    {
+        const PVec snap = data;
+        while( !data.empty() ) {
+            REQUIRE( exp.back() == data.back() );
+            data.pop_back();
+            exp.pop_back();
+            REQUIRE( exp.size() == data.size() );
+            if( 0 == exp.size() % 61 ) {
+                REQUIRE( std::equal(exp.cbegin(), exp.cend(), data.cbegin()) );
+            }
+        }
+        REQUIRE( 1 == data.depth() );
+        REQUIRE( count == snap.size() );
+        data.pop_back(); // no-op
+        REQUIRE( data.empty() );
+        data = snap;
+        REQUIRE( ( snap == data ) );
+    }
+}
+
+template<class CoW>
+static void testCoWPVector() {
+    typedef typename CoW::value_type value_type;
+    static_assert( std::is_nothrow_move_assignable_v<CoW> );
+    static_assert( std::is_nothrow_swappable_v<CoW> );
+    CoW data;
+    for(value_type i=0; i<1000; ++i) { data.push_back(i); }
+    REQUIRE( 1000 == data.size() );
+
+    typename CoW::storage_ref_t snap = data.snapshot();
+    data.set(500, 5000);
+    REQUIRE( 5000 == data.get(500) );
+    REQUIRE( 500 == (*snap)[500] );
+    REQUIRE_THROWS_AS( data.get(1000), jau::IndexOutOfBoundsException );
+
+    data.pop_back();
+    REQUIRE( 999 == data.size() );
+    REQUIRE( 1000 == snap->size() );
+
+    REQUIRE( false == data.push_back_unique(10, [](const value_type& a, const value_type& b) -> bool { return a == b; }) );
+    REQUIRE( true  == data.push_back_unique(2000, [](const value_type& a, const value_type& b) -> bool { return a == b; }) );
+    REQUIRE( 1 == data.erase_matching(2000, false, [](const value_type& a, const value_type& b) -> bool { return a == b; }) );
+    REQUIRE( 100 == data.erase_if( [](const value_type& e) -> bool { return 0 == e % 10; } ) );
+    REQUIRE( 899 == data.size() );
+    {
+        value_type sum = 0;
+        jau::for_each_const(data, [&sum](const value_type& e) { sum += e; });
+        REQUIRE( ( 998*999/2 - 10*99*100/2 ) == sum );
+    }
+    {
+        typename CoW::const_iterator it = data.cbegin();
+        REQUIRE( 899 == it.size() );
+        REQUIRE( 1 == *it );
+        it += 10;
+        REQUIRE( 12 == *it );
+        REQUIRE( 899 == it.cend() - it.cbegin() );
+    }
+    {
+        typename CoW::storage_ref_t store0 = data.snapshot();
+        typename CoW::transaction_t tx = data.transaction();
+        for(typename CoW::size_type i=0; i<tx->size(); ++i) {
+            tx->set(i, 0);
+        }
+        tx->push_back(1);
+        REQUIRE( store0 == data.snapshot() );
+        REQUIRE_THROWS_AS( data.push_back(2), jau::IllegalStateException );
+        tx.commit();
+        REQUIRE( 900 == data.size() );
+        REQUIRE( 1 == data.get(899) );
+        REQUIRE( 0 == data.get(0) );
+        REQUIRE( 12 == (*store0)[10] );
+    }
+    CoW data2 = data;
+    REQUIRE( data2 == data );
+    data2.clear();
+    REQUIRE( data2.empty() );
+    REQUIRE( 900 == data.size() );
+    data2.swap(data);
+    REQUIRE( data.empty() );
+    REQUIRE( 900 == data2.size() );
+}
+
+TEST_CASE( "JAU PVector Test 01 - jau::pvector and jau::cow_pvector", "[datatype][jau][pvector][cow]" ) {
+    testPVector< jau::pvector<std::string, jau::nsize_t, 1> >("pvector_string_b1", 300);
+    testPVector< jau::pvector<std::string, jau::nsize_t, 2> >("pvector_string_b2", 2000);
+    testPVector< jau::pvector<std::string> >("pvector_string_b5", 40000);
+    testCoWPVector< jau::cow_pvector<uint64_t, jau::nsize_t, 2> >();
+    testCoWPVector< jau::cow_pvector<uint64_t> >();
+}
@@ -0,0 +1,244 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2021 Gothel Software e.K.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch_amalgamated.hpp>
+#include <jau/test/catch2_ext.hpp>
+
+#include <jau/shm_ringbuffer.hpp>
+
+using namespace jau;
+
+/** Trivially copyable value type, e.g. a packet descriptor. */
+struct Packet {
+    uint64_t seq;
+    uint8_t payload[24];
+};
+typedef shm_ringbuffer<Packet, jau::nsize_t> PacketShmRingbuffer;
+
+/** Same segment accessed w/ a different element size. */
+typedef shm_ringbuffer<uint64_t, jau::nsize_t> UInt64ShmRingbuffer;
+
+static Packet createPacket(const uint64_t seq) {
+    Packet p;
+    p.seq = seq;
+    ::memset(p.payload, static_cast<uint8_t>(seq), sizeof(p.payload));
+    return p;
+}
+
+static bool isValid(const Packet& p, const uint64_t seq) {
+    return seq == p.seq && static_cast<uint8_t>(seq) == p.payload[0] && static_cast<uint8_t>(seq) == p.payload[sizeof(p.payload)-1];
+}
+
+/**
+ * Putter process body, attaching by name and putting [start, start+count) in batches of up to 7 packets.
+ * <p>
+ * If wait_fd is valid, blocks reading one byte from it after attaching and before putting.<br>
+ * If crash is true, terminates w/o detaching after putting.
+ * </p>
+ * @return process exit code, zero on success
+ */
+static int putterProcess(const std::string& name, const uint64_t start, const uint64_t count, const int wait_fd, const bool crash) {
+    try {
+        PacketShmRingbuffer rb(name, shm_role::putter);
+        if( 0 <= wait_fd ) {
+            char c;
+            if( 1 != ::read(wait_fd, &c, 1) ) {
+                return 2;
+            }
+        }
+        Packet batch[7];
+        uint64_t i = start;
+        while( i < start + count ) {
+            const jau::nsize_t n = static_cast<jau::nsize_t>( std::min<uint64_t>(7, start + count - i) );
+            for(jau::nsize_t j=0; j<n; j++) {
+                batch[j] = createPacket(i+j);
+            }
+            if( n != rb.putNBlocking(batch, n, n) ) {
+                return 3;
+            }
+            i += n;
+        }
+        if( crash ) {
+            ::_exit(0); // no detach
+        }
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
+
+/** Forks a putter process, see putterProcess(). */
+static pid_t forkPutter(const std::string& name, const uint64_t start, const uint64_t count, const int wait_fd, const bool crash) {
+    const pid_t pid = ::fork();
+    if( 0 == pid ) {
+        ::_exit( putterProcess(name, start, count, wait_fd, crash) ); // skip the inherited Catch2 state
+    }
+    return pid;
+}
+
+static int waitExitCode(const pid_t pid) {
+    int status = 0;
+    if( pid != ::waitpid(pid, &status, 0) || !WIFEXITED(status) ) {
+        return -1;
+    }
+    return WEXITSTATUS(status);
+}
+
+class TestShmRingbuffer01 {
+  private:
+    const std::string name = "/jau_test_shm_ringbuffer01_"+std::to_string(::getpid());
+
+  public:
+
+    void test01_SingleProcess() {
+        PacketShmRingbuffer::unlink(name);
+        {
+            REQUIRE_THROWS_AS( PacketShmRingbuffer(name, shm_role::getter), RuntimeException );
+
+            PacketShmRingbuffer rb(name, 10, shm_role::both);
+            REQUIRE_MSG("pow2 capacity "+rb.toString(), 16 == rb.capacity());
+            REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+            REQUIRE_MSG("attached "+rb.toString(), rb.isAttached(shm_role::both));
+            REQUIRE_MSG("attach count "+rb.toString(), 1 == rb.getAttachCount());
+
+            Packet p;
+            REQUIRE_MSG("get empty "+rb.toString(), !rb.get(p));
+            REQUIRE_MSG("getBlocking timeout "+rb.toString(), !rb.getBlocking(p, 10));
+
+            // move counters, so batch operations wrap around the array's end
+            for(uint64_t i=0; i<13; i++) {
+                REQUIRE( rb.put(createPacket(i)) );
+                REQUIRE( rb.get(p) );
+                REQUIRE( isValid(p, i) );
+            }
+            std::vector<Packet> source, sink(16);
+            for(uint64_t i=0; i<16; i++) {
+                source.push_back(createPacket(100+i));
+            }
+            REQUIRE_MSG("putN "+rb.toString(), 16 == rb.putN(source.data(), 20));
+            REQUIRE_MSG("full "+rb.toString(), rb.isFull());
+            REQUIRE_MSG("put full "+rb.toString(), !rb.put(source[0]));
+            REQUIRE_MSG("putBlocking timeout "+rb.toString(), !rb.putBlocking(source[0], 10));
+            REQUIRE_MSG("peek "+rb.toString(), rb.peek(p));
+            REQUIRE_MSG("peek value "+rb.toString(), isValid(p, 100));
+            REQUIRE_MSG("drop "+rb.toString(), 2 == rb.drop(2));
+            REQUIRE_MSG("getNBlocking "+rb.toString(), 14 == rb.getNBlocking(sink.data(), 14, 16));
+            for(uint64_t i=0; i<14; i++) {
+                REQUIRE_MSG("value #"+std::to_string(i), isValid(sink[i], 102+i));
+            }
+            REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+
+            // attach w/ same element size and capacity, as well as incompatible element size or capacity
+            {
+                PacketShmRingbuffer rb2(name, shm_role::getter);
+                REQUIRE_MSG("attach capacity "+rb2.toString(), 16 == rb2.capacity());
+                REQUIRE_MSG("attach count "+rb2.toString(), 2 == rb2.getAttachCount());
+                REQUIRE( rb.put(createPacket(200)) );
+                REQUIRE( rb2.get(p) );
+                REQUIRE( isValid(p, 200) );
+            }
+            REQUIRE_THROWS_AS( UInt64ShmRingbuffer(name, shm_role::getter), IllegalArgumentException );
+            REQUIRE_THROWS_AS( PacketShmRingbuffer(name, 64, shm_role::getter), IllegalArgumentException );
+        }
+        REQUIRE( PacketShmRingbuffer::unlink(name) );
+    }
+
+    void test02_TwoProcess() {
+        PacketShmRingbuffer::unlink(name);
+        {
+            const uint64_t count = 100000;
+            PacketShmRingbuffer rb(name, 64, shm_role::getter);
+            const pid_t putter = forkPutter(name, 0, count, -1, false);
+            REQUIRE( 0 < putter );
+
+            bool in_order = true;
+            Packet p;
+            for(uint64_t i=0; i<count; i++) {
+                in_order = rb.getBlocking(p, 5000) && in_order && isValid(p, i);
+            }
+            REQUIRE_MSG("in order "+rb.toString(), in_order);
+            REQUIRE_MSG("putter exit", 0 == waitExitCode(putter));
+            REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+            REQUIRE_MSG("putter detached "+rb.toString(), !rb.isAttached(shm_role::putter));
+            REQUIRE_MSG("attach count "+rb.toString(), 2 == rb.getAttachCount());
+        }
+        REQUIRE( PacketShmRingbuffer::unlink(name) );
+    }
+
+    void test03_PeerRestart() {
+        PacketShmRingbuffer::unlink(name);
+        {
+            const uint64_t count = 1000;
+            PacketShmRingbuffer rb(name, 64, shm_role::getter);
+            Packet p;
+            bool in_order = true;
+
+            // first putter terminates w/o detaching
+            const pid_t putter1 = forkPutter(name, 0, count/2, -1, true /* crash */);
+            REQUIRE( 0 < putter1 );
+            for(uint64_t i=0; i<count/2; i++) {
+                in_order = rb.getBlocking(p, 5000) && in_order && isValid(p, i);
+            }
+            REQUIRE_MSG("putter1 exit", 0 == waitExitCode(putter1));
+            REQUIRE_MSG("putter1 dead "+rb.toString(), !rb.isAttached(shm_role::putter));
+
+            // restarted putter takes over the stale role and continues w/ the persistent write counter
+            int fds[2];
+            REQUIRE( 0 == ::pipe(fds) );
+            const pid_t putter2 = forkPutter(name, count/2, count, fds[0], false);
+            REQUIRE( 0 < putter2 );
+            while( !rb.isAttached(shm_role::putter) ) {
+                ::usleep(1000);
+            }
+            REQUIRE_MSG("attach count "+rb.toString(), 3 == rb.getAttachCount());
+            REQUIRE_THROWS_AS( PacketShmRingbuffer(name, shm_role::putter), IllegalStateException );
+            REQUIRE( 1 == ::write(fds[1], "g", 1) );
+
+            for(uint64_t i=count/2; i<count/2+count; i++) {
+                in_order = rb.getBlocking(p, 5000) && in_order && isValid(p, i);
+            }
+            REQUIRE_MSG("in order "+rb.toString(), in_order);
+            REQUIRE_MSG("putter2 exit", 0 == waitExitCode(putter2));
+            REQUIRE_MSG("empty "+rb.toString(), rb.isEmpty());
+            ::close(fds[0]);
+            ::close(fds[1]);
+        }
+        REQUIRE( PacketShmRingbuffer::unlink(name) );
+    }
+};
+
+METHOD_AS_TEST_CASE( TestShmRingbuffer01::test01_SingleProcess, "Test TestShmRingbuffer 01- 01");
+METHOD_AS_TEST_CASE( TestShmRingbuffer01::test02_TwoProcess,    "Test TestShmRingbuffer 01- 02");
+METHOD_AS_TEST_CASE( TestShmRingbuffer01::test03_PeerRestart,   "Test TestShmRingbuffer 01- 03");
@@ -35,6 +35,8 @@
 #include <catch2/catch_amalgamated.hpp>
 
 #include <jau/type_traits_queries.hpp>
+#include <jau/cpp_lang_util.hpp>
+#include <jau/function_def.hpp>
 
 using namespace jau;
 
@@ -107,3 +109,20 @@ TEST_CASE( "01 Type Traits Queries") {
     CHECK_2(int_get, "int get()");
     CHECK_2(long_get, "long get()");
 }
+
+TEST_CASE( "02 Trivially Relocatable Type Trait") {
+    REQUIRE( true == jau::is_trivially_relocatable_v<int> );
+    REQUIRE( true == jau::is_trivially_relocatable_v<Not> );
+    REQUIRE( false == jau::is_trivially_relocatable_v<One> );
+    REQUIRE( true == jau::is_trivially_relocatable_v<std::shared_ptr<One>> );
+    REQUIRE( true == jau::is_trivially_relocatable_v<std::weak_ptr<One>> );
+    REQUIRE( true == jau::is_trivially_relocatable_v<std::unique_ptr<One>> );
+    REQUIRE( true == jau::is_trivially_relocatable_v<jau::FunctionDef<bool, int>> );
+    REQUIRE( true == jau::is_trivially_relocatable_v<std::pair<int, std::shared_ptr<One>>> );
+    REQUIRE( false == jau::is_trivially_relocatable_v<std::pair<int, One>> );
+#if defined(_LIBCPP_VERSION)
+    REQUIRE( true == jau::is_trivially_relocatable_v<std::string> );
+#else
+    REQUIRE( false == jau::is_trivially_relocatable_v<std::string> );
+#endif
+}